@@ -1,43 +1,62 @@
 TEMPLATE = lib
 DEFINES += DEVICEMODEL_LIBRARY
 CONFIG += c++11
-QT += core
+# 模型只依赖标准库与SimSdk，不链接Qt（qmake仅作为构建工具）
+CONFIG -= qt
 
-# The following define makes your compiler emit warnings if you use
-# any Qt feature that has been marked deprecated (the exact warnings
-# depend on your compiler). Please consult the documentation of the
-# deprecated API in order to know how to port your code away from it.
-DEFINES += QT_DEPRECATED_WARNINGS
-
-# You can also make your code fail to compile if it uses deprecated APIs.
-# In order to do so, uncomment the following line.
-# You can also select to disable deprecated APIs only up to a certain version of Qt.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+# 跟踪区段默认编出，qmake CONFIG+=devicemodel_trace 时编入（导出Chrome/Perfetto跟踪事件）
+devicemodel_trace {
+    DEFINES += DEVICEMODEL_TRACE
+}
 
 INCLUDEPATH += \
     $$PWD/../../../../../SDK/SimModel/Cpp/include/
 
-CONFIG(debug,debug|release){
-    LIBS += -L$$PWD/../../../../../SDK/SimModel/Cpp/bin/winDebug -lSimSdk
-    DESTDIR = $$PWD/../bin2/winDebug/
+win32 {
+    CONFIG(debug,debug|release){
+        LIBS += -L$$PWD/../../../../../SDK/SimModel/Cpp/bin/winDebug -lSimSdk
+        DESTDIR = $$PWD/../bin2/winDebug/
+    }
+    else {
+        LIBS += -L$$PWD/../../../../../SDK/SimModel/Cpp/bin/winRelease -lSimSdk
+        DESTDIR = $$PWD/../bin2/winRelease/
+    }
 }
 else {
-    LIBS += -L$$PWD/../../../../../SDK/SimModel/Cpp/bin/winRelease -lSimSdk
-    DESTDIR = $$PWD/../bin2/winRelease/
+    CONFIG(debug,debug|release){
+        LIBS += -L$$PWD/../../../../../SDK/SimModel/Cpp/bin/linuxDebug -lSimSdk
+        DESTDIR = $$PWD/../bin2/linuxDebug/
+    }
+    else {
+        LIBS += -L$$PWD/../../../../../SDK/SimModel/Cpp/bin/linuxRelease -lSimSdk
+        DESTDIR = $$PWD/../bin2/linuxRelease/
+    }
+    LIBS += -lpthread
 }
 
 SOURCES += \
     src/CreateDeviceModel.cpp \
     src/devicemodel.cpp \
-    src/common/DMLogger.cpp
+    src/FlatSoundList.cpp \
+    src/common/DMLogger.cpp \
+    src/common/SpectrumSlabPool.cpp \
+    src/common/TraceZone.cpp
 
 HEADERS += \
     src/CreateDeviceModel.h \
     src/DeviceTestInOut.h \
+    src/FlatSoundList.h \
     src/SonarConfig.h \
     src/common/define.h \
     src/devicemodel.h \
-    src/common/DMLogger.h
+    src/common/DMLogger.h \
+    src/common/TopicHash.h \
+    src/common/SpectrumBuffer.h \
+    src/common/SpectrumSlabPool.h \
+    src/common/MemoryAccount.h \
+    src/common/LatencyHistogram.h \
+    src/common/CounterRng.h \
+    src/common/TraceZone.h
 
 # Default rules for deployment.
 unix {
@@ -70,6 +70,7 @@
 #define 	DATA_TorpedoResult_Topic           "DATA_TorpedoResult_Topic"             //数据类接口  鱼雷报警处理结果输出
 #define     DATA_ActiveSonarResult_Topic		"DATA_ActiveSonarResult_Topic"	        //主动声纳处理结果输出
 #define     DATA_ScoutingSonarResult_Topic	  	"DATA_ScoutingSonarResult_Topic"		//侦察声纳处理结果输出
+#define     Data_DevicePerfStats_Topic		"Data_DevicePerfStats_Topic"			//数据类接口 声纳模型性能统计输出
 
 
 //蓝方行为模型输出
@@ -1231,3 +1232,36 @@ struct CData_Direct_DetectAnalysisOutput_Sonar
     int WorkState;//工作模式 0-被动 1-主动
     std::vector<float> DIMinusDT;//DI-DT值
 };
+
+
+//声纳模型性能统计输出 主题名称：Data_DevicePerfStats_Topic（按配置的仿真时间间隔发布，计数均为自启动或上次清零以来的累计值）
+#define DEVICE_PERF_PHASE_COUNT 6
+
+struct CData_DevicePhaseLatency
+{
+    uint64_t count;         //记录次数
+    uint64_t minNs;         //最小耗时(纳秒)
+    uint64_t meanNs;        //平均耗时(纳秒)
+    uint64_t p50Ns;         //50%分位耗时(纳秒)
+    uint64_t p90Ns;         //90%分位耗时(纳秒)
+    uint64_t p99Ns;         //99%分位耗时(纳秒)
+    uint64_t p999Ns;        //99.9%分位耗时(纳秒)
+    uint64_t maxNs;         //最大耗时(纳秒)
+};
+
+struct CData_DevicePerfStats
+{
+    long long platformId;                   //平台ID
+    long long time;                         //仿真时间(毫秒)
+    CData_DevicePhaseLatency phases[DEVICE_PERF_PHASE_COUNT];  //阶段耗时：0-接收 1-过期清理 2-扇区筛选 3-声纳方程 4-结果组装 5-发布
+    uint64_t steps;                         //步进次数
+    uint64_t messages;                      //接收消息数
+    uint64_t contactsIngested;              //目标接收次数（按声纳计）
+    uint64_t activeContacts;                //当前目标数（按声纳计）
+    uint64_t contactsEvaluated;             //声纳方程计算目标数（按声纳计）
+    uint64_t contactsPruned;                //其中上界剪枝跳过的目标数
+    uint64_t allocations;                   //频谱等缓存的累计分配次数
+    uint64_t memoryBytes;                   //当前缓存内存(字节)
+
+    CData_DevicePerfStats() { memset(this, 0, sizeof(CData_DevicePerfStats)); }
+};
@@ -0,0 +1,348 @@
+#include "FlatSoundList.h"
+
+#include <stdlib.h>
+#include <new>
+#include <algorithm>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace {
+
+uint8* flatAlignedAlloc(size_t size)
+{
+#ifdef _WIN32
+    return static_cast<uint8*>(_aligned_malloc(size, FLAT_SOUND_LIST_ALIGN));
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, FLAT_SOUND_LIST_ALIGN, size) != 0) {
+        return nullptr;
+    }
+    return static_cast<uint8*>(ptr);
+#endif
+}
+
+void flatAlignedFree(uint8* ptr)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+// 公共字段清零（频谱由调用方整体覆盖）
+void resetRecordFields(CFlatSoundRecord& record)
+{
+    memset(&record, 0, offsetof(CFlatSoundRecord, spectrumData));
+}
+
+// attach已保证频谱点数为FLAT_SOUND_SPECTRUM_SIZE
+void copySpectrumFromRecord(const CFlatSoundRecord& record, float* spectrumData)
+{
+    memcpy(spectrumData, record.spectrumData, sizeof(record.spectrumData));
+}
+
+} // namespace
+
+// ==================== FlatSoundListView ====================
+
+FlatSoundListView::FlatSoundListView()
+    : m_header(nullptr)
+    , m_records(nullptr)
+{
+}
+
+bool FlatSoundListView::attach(const void* data, uint32 length)
+{
+    m_header = nullptr;
+    m_records = nullptr;
+
+    if (!data || length < sizeof(CFlatSoundListHeader)) {
+        return false;
+    }
+
+    // 头与记录按alignas(64)声明，载荷起点、头大小与记录间距都须是其整数倍
+    if (reinterpret_cast<uintptr_t>(data) % alignof(CFlatSoundRecord) != 0) {
+        return false;
+    }
+
+    const CFlatSoundListHeader* header = static_cast<const CFlatSoundListHeader*>(data);
+    if (header->magic != FLAT_SOUND_LIST_MAGIC || header->version != FLAT_SOUND_LIST_VERSION) {
+        return false;
+    }
+
+    if (header->headerSize < sizeof(CFlatSoundListHeader) ||
+        header->headerSize % alignof(CFlatSoundRecord) != 0 ||
+        header->spectrumSize != FLAT_SOUND_SPECTRUM_SIZE ||
+        header->stride < sizeof(CFlatSoundRecord) ||
+        header->stride % alignof(CFlatSoundRecord) != 0) {
+        return false;
+    }
+
+    uint64 required = static_cast<uint64>(header->headerSize) +
+                      static_cast<uint64>(header->count) * header->stride;
+    if (required > length) {
+        return false;
+    }
+
+    m_header = header;
+    m_records = static_cast<const uint8*>(data) + header->headerSize;
+    return true;
+}
+
+size_t FlatSoundListView::requiredLength(uint32 count)
+{
+    return sizeof(CFlatSoundListHeader) + static_cast<size_t>(count) * sizeof(CFlatSoundRecord);
+}
+
+// ==================== FlatSoundListBuffer ====================
+
+FlatSoundListBuffer::FlatSoundListBuffer(FlatSoundKind kind)
+    : m_storage(nullptr)
+    , m_capacity(0)
+{
+    m_storage = flatAlignedAlloc(sizeof(CFlatSoundListHeader));
+    if (!m_storage) {
+        throw std::bad_alloc();
+    }
+    new (m_storage) CFlatSoundListHeader();
+    header()->kind = static_cast<uint16>(kind);
+    header()->stride = sizeof(CFlatSoundRecord);
+}
+
+FlatSoundListBuffer::~FlatSoundListBuffer()
+{
+    flatAlignedFree(m_storage);
+}
+
+void FlatSoundListBuffer::reserve(uint32 count)
+{
+    if (count <= m_capacity) {
+        return;
+    }
+
+    uint8* storage = flatAlignedAlloc(FlatSoundListView::requiredLength(count));
+    if (!storage) {
+        throw std::bad_alloc();
+    }
+    memcpy(storage, m_storage, length());
+    flatAlignedFree(m_storage);
+
+    m_storage = storage;
+    m_capacity = count;
+}
+
+CFlatSoundRecord& FlatSoundListBuffer::append()
+{
+    if (header()->count == m_capacity) {
+        reserve(std::max<uint32>(4, m_capacity * 2));
+    }
+
+    CFlatSoundRecord& record = this->record(header()->count);
+    resetRecordFields(record);
+    header()->count++;
+    return record;
+}
+
+void FlatSoundListBuffer::clear()
+{
+    header()->count = 0;
+}
+
+void FlatSoundListBuffer::setKind(FlatSoundKind kind)
+{
+    header()->kind = static_cast<uint16>(kind);
+}
+
+void FlatSoundListBuffer::setTime(int64 time)
+{
+    header()->time = time;
+}
+
+CFlatSoundRecord& FlatSoundListBuffer::record(uint32 index)
+{
+    return *reinterpret_cast<CFlatSoundRecord*>(m_storage + sizeof(CFlatSoundListHeader) +
+                                                static_cast<size_t>(index) * sizeof(CFlatSoundRecord));
+}
+
+uint32 FlatSoundListBuffer::length() const
+{
+    return static_cast<uint32>(FlatSoundListView::requiredLength(header()->count));
+}
+
+// ==================== 列表结构 -> 扁平格式 ====================
+
+void encodeFlatSoundList(const CMsg_PropagatedContinuousSoundListStruct& list, FlatSoundListBuffer& out)
+{
+    out.clear();
+    out.setKind(FLAT_SOUND_CONTINUOUS);
+    out.reserve(static_cast<uint32>(list.propagatedContinuousList.size()));
+
+    for (const auto& sound : list.propagatedContinuousList) {
+        CFlatSoundRecord& record = out.append();
+        record.arrivalSideAngle = sound.arrivalSideAngle;
+        record.arrivalPitchAngle = sound.arrivalPitchAngle;
+        record.targetDistance = sound.targetDistance;
+        record.platType = sound.platType;
+        memcpy(record.spectrumData, sound.spectrumData, sizeof(record.spectrumData));
+    }
+}
+
+void encodeFlatSoundList(const CMsg_PropagatedActivePulseSoundListStruct& list, FlatSoundListBuffer& out)
+{
+    out.clear();
+    out.setKind(FLAT_SOUND_ACTIVE_PULSE);
+    out.reserve(static_cast<uint32>(list.propagateActivePulseList.size()));
+
+    for (const auto& sound : list.propagateActivePulseList) {
+        CFlatSoundRecord& record = out.append();
+        record.arrivalSideAngle = sound.arrivalSideAngle;
+        record.arrivalPitchAngle = sound.arrivalPitchAngle;
+        record.targetDistance = sound.targetDistance;
+        record.platType = sound.targetType;
+        record.arrivalTime = sound.arrivalTime;
+        record.lastTime = sound.signalLength;
+        record.centralFreq = sound.centralFreq;
+        record.signalWidth = sound.signalWidth;
+        record.signalType = sound.signalType;
+        record.pulseWidth = sound.pulseWidth;
+        memcpy(record.spectrumData, sound.spectrumData, sizeof(record.spectrumData));
+    }
+}
+
+void encodeFlatSoundList(const CMsg_PropagatedCommPulseSoundListStruct& list, FlatSoundListBuffer& out)
+{
+    out.clear();
+    out.setKind(FLAT_SOUND_COMM_PULSE);
+    out.reserve(static_cast<uint32>(list.propagatedCommList.size()));
+
+    for (const auto& sound : list.propagatedCommList) {
+        CFlatSoundRecord& record = out.append();
+        record.arrivalSideAngle = sound.arrivalSideAngle;
+        record.arrivalPitchAngle = sound.arrivalPitchAngle;
+        record.targetDistance = sound.targetDistance;
+        record.platType = sound.targetType;
+        record.arrivalTime = sound.arrivalTime;
+        record.lastTime = sound.durationTime;
+        record.centralFreq = sound.centralFreq;
+        record.signalWidth = sound.signalWidth;
+        record.signalType = sound.signalType;
+        record.pulseWidth = sound.pulseWidth;
+        record.propLoss = sound.propLoss;
+        memcpy(record.spectrumData, sound.spectrumData, sizeof(record.spectrumData));
+    }
+}
+
+void encodeFlatSoundList(const CMsg_PropagatedInstantSoundListStruct& list, FlatSoundListBuffer& out)
+{
+    out.clear();
+    out.setKind(FLAT_SOUND_INSTANT);
+    out.reserve(static_cast<uint32>(list.propagatedInstantSoundList.size()));
+
+    for (const auto& sound : list.propagatedInstantSoundList) {
+        CFlatSoundRecord& record = out.append();
+        record.arrivalSideAngle = sound.arrivalSideAngle;
+        record.arrivalPitchAngle = sound.arrivalPitchAngle;
+        record.targetDistance = sound.targetDistance;
+        record.arrivalTime = sound.trrivalTime;
+        record.lastTime = sound.lastTime;
+        memcpy(record.spectrumData, sound.spectrumData, sizeof(record.spectrumData));
+    }
+}
+
+// ==================== 扁平格式 -> 列表结构 ====================
+
+bool decodeFlatSoundList(const FlatSoundListView& view, CMsg_PropagatedContinuousSoundListStruct& out)
+{
+    out.propagatedContinuousList.clear();
+    if (!view.isValid() || view.kind() != FLAT_SOUND_CONTINUOUS) {
+        return false;
+    }
+
+    for (uint32 i = 0; i < view.count(); i++) {
+        const CFlatSoundRecord& record = view.record(i);
+        out.propagatedContinuousList.emplace_back();
+        C_PropagatedContinuousSoundStruct& sound = out.propagatedContinuousList.back();
+        sound.arrivalSideAngle = record.arrivalSideAngle;
+        sound.arrivalPitchAngle = record.arrivalPitchAngle;
+        sound.targetDistance = record.targetDistance;
+        sound.platType = record.platType;
+        copySpectrumFromRecord(record, sound.spectrumData);
+    }
+    return true;
+}
+
+bool decodeFlatSoundList(const FlatSoundListView& view, CMsg_PropagatedActivePulseSoundListStruct& out)
+{
+    out.propagateActivePulseList.clear();
+    if (!view.isValid() || view.kind() != FLAT_SOUND_ACTIVE_PULSE) {
+        return false;
+    }
+
+    for (uint32 i = 0; i < view.count(); i++) {
+        const CFlatSoundRecord& record = view.record(i);
+        out.propagateActivePulseList.emplace_back();
+        C_PropagatedActivePulseSoundStruct& sound = out.propagateActivePulseList.back();
+        sound.arrivalSideAngle = record.arrivalSideAngle;
+        sound.arrivalPitchAngle = record.arrivalPitchAngle;
+        sound.targetDistance = record.targetDistance;
+        sound.targetType = record.platType;
+        sound.arrivalTime = record.arrivalTime;
+        sound.signalLength = static_cast<float>(record.lastTime);
+        sound.centralFreq = record.centralFreq;
+        sound.signalWidth = record.signalWidth;
+        sound.signalType = record.signalType;
+        sound.pulseWidth = record.pulseWidth;
+        copySpectrumFromRecord(record, sound.spectrumData);
+    }
+    return true;
+}
+
+bool decodeFlatSoundList(const FlatSoundListView& view, CMsg_PropagatedCommPulseSoundListStruct& out)
+{
+    out.propagatedCommList.clear();
+    if (!view.isValid() || view.kind() != FLAT_SOUND_COMM_PULSE) {
+        return false;
+    }
+
+    for (uint32 i = 0; i < view.count(); i++) {
+        const CFlatSoundRecord& record = view.record(i);
+        out.propagatedCommList.emplace_back();
+        C_PropagatedCommPulseSoundStruct& sound = out.propagatedCommList.back();
+        sound.arrivalSideAngle = record.arrivalSideAngle;
+        sound.arrivalPitchAngle = record.arrivalPitchAngle;
+        sound.targetDistance = record.targetDistance;
+        sound.targetType = record.platType;
+        sound.arrivalTime = record.arrivalTime;
+        sound.durationTime = static_cast<float>(record.lastTime);
+        sound.centralFreq = record.centralFreq;
+        sound.signalWidth = record.signalWidth;
+        sound.signalType = record.signalType;
+        sound.pulseWidth = record.pulseWidth;
+        sound.propLoss = record.propLoss;
+        copySpectrumFromRecord(record, sound.spectrumData);
+    }
+    return true;
+}
+
+bool decodeFlatSoundList(const FlatSoundListView& view, CMsg_PropagatedInstantSoundListStruct& out)
+{
+    out.propagatedInstantSoundList.clear();
+    if (!view.isValid() || view.kind() != FLAT_SOUND_INSTANT) {
+        return false;
+    }
+
+    for (uint32 i = 0; i < view.count(); i++) {
+        const CFlatSoundRecord& record = view.record(i);
+        out.propagatedInstantSoundList.emplace_back();
+        C_PropagatedInstantSoundStruct& sound = out.propagatedInstantSoundList.back();
+        sound.arrivalSideAngle = record.arrivalSideAngle;
+        sound.arrivalPitchAngle = record.arrivalPitchAngle;
+        sound.targetDistance = record.targetDistance;
+        sound.trrivalTime = record.arrivalTime;
+        sound.lastTime = record.lastTime;
+        copySpectrumFromRecord(record, sound.spectrumData);
+    }
+    return true;
+}
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "DeviceTestInOut.h"
+#include "SimBasicTypes.h"
+
+// 扁平格式的传播声主题名（载荷为连续内存，可跨进程/内存映射传递）
+#define MSG_PropagatedContinuousSound_Flat		"MSG_PropagatedContinuousSound_Flat"		//传播后连续声特性（扁平格式） 信源：信道
+#define MSG_PropagatedActivePulseSound_Flat		"MSG_PropagatedActivePulseSound_Flat"		//传播后主动脉冲声呐特性（扁平格式） 信源：信道
+#define MSG_PropagatedCommPulseSound_Flat		"MSG_PropagatedCommPulseSound_Flat"			//传播后通信脉冲声呐特性（扁平格式） 信源：信道
+#define MSG_PropagatedInstantSound_Flat			"MSG_PropagatedInstantSound_Flat"			//传播后瞬态声特性（扁平格式） 信源：信道
+
+#define FLAT_SOUND_LIST_MAGIC			0x4C465350u		// "PSFL"
+#define FLAT_SOUND_LIST_VERSION			1				// 格式版本，不兼容修改时递增
+#define FLAT_SOUND_LIST_ALIGN			64				// 头和记录的对齐字节数
+#define FLAT_SOUND_SPECTRUM_SIZE		5296			// 频谱点数
+
+/**
+ * 扁平传播声列表的记录类型
+ */
+enum FlatSoundKind
+{
+    FLAT_SOUND_CONTINUOUS = 1,		// 连续声   MSG_PropagatedContinuousSound
+    FLAT_SOUND_ACTIVE_PULSE = 2,	// 主动脉冲 MSG_PropagatedActivePulseSound
+    FLAT_SOUND_COMM_PULSE = 3,		// 通信脉冲 MSG_PropagatedCommPulseSound
+    FLAT_SOUND_INSTANT = 4			// 瞬态声   MSG_PropagatedInstantSound
+};
+
+/**
+ * 扁平传播声列表头（64字节）
+ * 内存布局：[头 headerSize字节][记录0 stride字节][记录1]...[记录count-1]
+ * 读取方按头中的headerSize/stride定位记录，新版本只在记录尾部追加字段
+ */
+struct alignas(FLAT_SOUND_LIST_ALIGN) CFlatSoundListHeader
+{
+    uint32 magic;					//魔数 FLAT_SOUND_LIST_MAGIC
+    uint16 version;					//格式版本
+    uint16 kind;					//记录类型 FlatSoundKind
+    uint32 headerSize;				//头大小（字节）
+    uint32 count;					//记录数
+    uint32 stride;					//记录间距（字节，64的整数倍）
+    uint32 spectrumSize;			//每条记录的频谱点数
+    int64 time;						//生成时间（ms）
+    uint8 reserved[32];				//保留
+
+    CFlatSoundListHeader() : magic(FLAT_SOUND_LIST_MAGIC)
+        , version(FLAT_SOUND_LIST_VERSION)
+        , kind(FLAT_SOUND_CONTINUOUS)
+        , headerSize(sizeof(CFlatSoundListHeader))
+        , count(0)
+        , stride(0)
+        , spectrumSize(FLAT_SOUND_SPECTRUM_SIZE)
+        , time(0)
+    {
+        memset(reserved, 0, sizeof(reserved));
+    }
+};
+
+/**
+ * 扁平传播声记录
+ * 前64字节为四类传播声的公共字段，频谱从64字节边界开始
+ * 通信内容、冲激响应等变长/大块字段不在扁平格式中传输
+ */
+struct alignas(FLAT_SOUND_LIST_ALIGN) CFlatSoundRecord
+{
+    float arrivalSideAngle;					//波达舷角
+    float arrivalPitchAngle;				//波达俯仰角
+    float targetDistance;					//目标距离，单位（米）
+    int32 platType;							//目标类型（连续声为平台类型，脉冲声为targetType）
+    int64 arrivalTime;						//波到达时间
+    double lastTime;						//持续时间（瞬态声lastTime / 脉冲声信号长度）
+    float centralFreq;						//中心频率
+    float signalWidth;						//信号带宽
+    int32 signalType;						//信号类型
+    float pulseWidth;						//脉宽
+    float propLoss;							//中心频率传播损失（通信脉冲）
+    uint32 contactId;						//目标在信道原始列表中的编号（从1开始），0为未设置，接收方按记录序号编号
+    uint8 reserved[8];						//保留，补齐到64字节
+    float spectrumData[FLAT_SOUND_SPECTRUM_SIZE];	//频谱数据	10Hz~40kHz,间隔2Hz(10Hz-10kHz)、间隔1kHz(10kHz-40kHz)
+};
+
+static_assert(sizeof(CFlatSoundListHeader) == FLAT_SOUND_LIST_ALIGN, "CFlatSoundListHeader must be 64 bytes");
+static_assert(offsetof(CFlatSoundRecord, spectrumData) == FLAT_SOUND_LIST_ALIGN, "spectrumData must start at 64 bytes");
+static_assert(sizeof(CFlatSoundRecord) % FLAT_SOUND_LIST_ALIGN == 0, "CFlatSoundRecord must be a multiple of 64 bytes");
+
+/**
+ * 扁平传播声列表的零拷贝读取器
+ * 只保存指向载荷的指针，载荷须在读取期间保持有效
+ */
+class FlatSoundListView
+{
+public:
+    FlatSoundListView();
+
+    /**
+     * 绑定载荷并校验魔数、版本、频谱点数、对齐（载荷起点、头大小与记录间距均为64字节的整数倍）、记录间距与长度
+     * @return 载荷合法返回true
+     */
+    bool attach(const void* data, uint32 length);
+
+    bool isValid() const { return m_header != nullptr; }
+    uint32 count() const { return m_header ? m_header->count : 0; }
+    uint16 kind() const { return m_header ? m_header->kind : 0; }
+    int64 time() const { return m_header ? m_header->time : 0; }
+    const CFlatSoundListHeader* header() const { return m_header; }
+
+    /**
+     * 第index条记录（调用方保证index < count()）
+     */
+    const CFlatSoundRecord& record(uint32 index) const
+    {
+        return *reinterpret_cast<const CFlatSoundRecord*>(m_records + static_cast<size_t>(index) * m_header->stride);
+    }
+
+    /**
+     * 载荷总字节数
+     */
+    static size_t requiredLength(uint32 count);
+
+private:
+    const CFlatSoundListHeader* m_header;
+    const uint8* m_records;
+};
+
+/**
+ * 扁平传播声列表的写缓冲（64字节对齐的连续内存）
+ */
+class FlatSoundListBuffer
+{
+public:
+    explicit FlatSoundListBuffer(FlatSoundKind kind = FLAT_SOUND_CONTINUOUS);
+    ~FlatSoundListBuffer();
+
+    /**
+     * 预留count条记录的空间
+     */
+    void reserve(uint32 count);
+
+    /**
+     * 追加一条记录，公共字段清零，频谱由调用方填充
+     */
+    CFlatSoundRecord& append();
+
+    /**
+     * 清空记录（保留已分配空间）
+     */
+    void clear();
+
+    void setKind(FlatSoundKind kind);
+    void setTime(int64 time);
+
+    uint32 count() const { return header()->count; }
+    CFlatSoundRecord& record(uint32 index);
+
+    const void* data() const { return m_storage; }
+    uint32 length() const;
+
+private:
+    // 禁止拷贝和赋值
+    FlatSoundListBuffer(const FlatSoundListBuffer&) = delete;
+    FlatSoundListBuffer& operator=(const FlatSoundListBuffer&) = delete;
+
+    CFlatSoundListHeader* header() const { return reinterpret_cast<CFlatSoundListHeader*>(m_storage); }
+
+    uint8* m_storage;
+    uint32 m_capacity;		// 可容纳的记录数
+};
+
+// *** 与现有列表结构的互转（兼容旧的std::list载荷） ***
+
+void encodeFlatSoundList(const CMsg_PropagatedContinuousSoundListStruct& list, FlatSoundListBuffer& out);
+void encodeFlatSoundList(const CMsg_PropagatedActivePulseSoundListStruct& list, FlatSoundListBuffer& out);
+void encodeFlatSoundList(const CMsg_PropagatedCommPulseSoundListStruct& list, FlatSoundListBuffer& out);
+void encodeFlatSoundList(const CMsg_PropagatedInstantSoundListStruct& list, FlatSoundListBuffer& out);
+
+bool decodeFlatSoundList(const FlatSoundListView& view, CMsg_PropagatedContinuousSoundListStruct& out);
+bool decodeFlatSoundList(const FlatSoundListView& view, CMsg_PropagatedActivePulseSoundListStruct& out);
+bool decodeFlatSoundList(const FlatSoundListView& view, CMsg_PropagatedCommPulseSoundListStruct& out);
+bool decodeFlatSoundList(const FlatSoundListView& view, CMsg_PropagatedInstantSoundListStruct& out);
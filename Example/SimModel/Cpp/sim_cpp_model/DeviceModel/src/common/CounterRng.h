@@ -0,0 +1,208 @@
+#ifndef COUNTERRNG_H
+#define COUNTERRNG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * 基于计数器的随机数发生器（Philox4x32-10）
+ * 输出只由(种子, 流, 位置)决定：第n块的4个32位值 = Philox(计数器{n, 流}, 密钥{种子})，
+ * 不依赖此前生成过什么，因此同一场景种子与实体ID在任意线程、任意调用顺序下都得到相同序列，
+ * 也可用seek直接跳到某一位置（例如按仿真步号取每步的噪声）。
+ * 每个实例只有几十字节状态，不共享全局状态，多线程各自持有实例即可，无需加锁。
+ * 批量接口按BATCH_BLOCKS块一组以结构数组方式计算各轮，循环体无分支，便于编译器向量化
+ */
+class CounterRng
+{
+public:
+    static const int BATCH_BLOCKS = 16;     // 批量生成时一组的块数（每块4个值）
+
+    /**
+     * @param seed 场景种子
+     * @param stream 流标识（实体ID、声纳ID等的组合），同一种子下不同的流互不相关
+     */
+    CounterRng(uint64_t seed, uint64_t stream)
+        : m_stream(stream)
+        , m_block(0)
+        , m_cached(4)
+    {
+        m_key[0] = static_cast<uint32_t>(seed);
+        m_key[1] = static_cast<uint32_t>(seed >> 32);
+        m_buffer[0] = m_buffer[1] = m_buffer[2] = m_buffer[3] = 0;
+    }
+
+    /**
+     * 组合实体ID与子通道为流标识（例如目标ID与声纳ID）
+     */
+    static uint64_t streamOf(int64_t entity, uint32_t channel)
+    {
+        return (static_cast<uint64_t>(entity) << 16) ^ channel;
+    }
+
+    /**
+     * 跳到第block块开头（每块4个值），丢弃当前块中未取走的值
+     */
+    void seek(uint64_t block)
+    {
+        m_block = block;
+        m_cached = 4;
+    }
+
+    /**
+     * 下一次取值所在的块
+     */
+    uint64_t position() const { return m_cached < 4 ? m_block - 1 : m_block; }
+
+    uint32_t nextUInt32()
+    {
+        if (m_cached >= 4) {
+            generateBlocks(m_block, 1, m_buffer);
+            m_block++;
+            m_cached = 0;
+        }
+        return m_buffer[m_cached++];
+    }
+
+    /**
+     * [0,1)均匀分布（24位精度）
+     */
+    float nextFloat() { return toUnitFloat(nextUInt32()); }
+
+    /**
+     * [lo,hi)均匀分布
+     */
+    float uniform(float lo, float hi) { return lo + (hi - lo) * nextFloat(); }
+
+    /**
+     * 批量取count个32位值，结果与逐个调用nextUInt32相同
+     */
+    void fillUInt32(uint32_t* out, size_t count)
+    {
+        size_t done = drainBuffer(out, count);
+
+        // 整组直接写入输出
+        while (count - done >= static_cast<size_t>(4 * BATCH_BLOCKS)) {
+            generateBlocks(m_block, BATCH_BLOCKS, out + done);
+            m_block += BATCH_BLOCKS;
+            done += 4 * BATCH_BLOCKS;
+        }
+        while (done < count) {
+            out[done++] = nextUInt32();
+        }
+    }
+
+    /**
+     * 批量取count个[lo,hi)均匀分布值，结果与逐个调用uniform相同
+     */
+    void fillUniform(float* out, size_t count, float lo, float hi)
+    {
+        float span = hi - lo;
+        size_t done = 0;
+        while (done < count && m_cached < 4) {
+            out[done++] = lo + span * toUnitFloat(m_buffer[m_cached++]);
+        }
+
+        uint32_t bits[4 * BATCH_BLOCKS];
+        while (count - done >= static_cast<size_t>(4 * BATCH_BLOCKS)) {
+            generateBlocks(m_block, BATCH_BLOCKS, bits);
+            m_block += BATCH_BLOCKS;
+            for (int i = 0; i < 4 * BATCH_BLOCKS; i++) {
+                out[done + i] = lo + span * toUnitFloat(bits[i]);
+            }
+            done += 4 * BATCH_BLOCKS;
+        }
+        while (done < count) {
+            out[done++] = uniform(lo, hi);
+        }
+    }
+
+    /**
+     * 单块Philox4x32-10（供校验与随机访问）
+     */
+    static void block(const uint32_t counter[4], const uint32_t key[2], uint32_t out[4])
+    {
+        uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3];
+        uint32_t k0 = key[0], k1 = key[1];
+        for (int round = 0; round < ROUNDS; round++) {
+            philoxRound(c0, c1, c2, c3, k0, k1);
+            k0 += WEYL_0;
+            k1 += WEYL_1;
+        }
+        out[0] = c0;
+        out[1] = c1;
+        out[2] = c2;
+        out[3] = c3;
+    }
+
+private:
+    static const int ROUNDS = 10;
+    static const uint32_t MULTIPLIER_0 = 0xD2511F53u;
+    static const uint32_t MULTIPLIER_1 = 0xCD9E8D57u;
+    static const uint32_t WEYL_0 = 0x9E3779B9u;
+    static const uint32_t WEYL_1 = 0xBB67AE85u;
+
+    static float toUnitFloat(uint32_t bits)
+    {
+        return static_cast<float>(bits >> 8) * (1.0f / 16777216.0f);
+    }
+
+    static void philoxRound(uint32_t& c0, uint32_t& c1, uint32_t& c2, uint32_t& c3, uint32_t k0, uint32_t k1)
+    {
+        uint64_t product0 = static_cast<uint64_t>(MULTIPLIER_0) * c0;
+        uint64_t product1 = static_cast<uint64_t>(MULTIPLIER_1) * c2;
+        uint32_t n0 = static_cast<uint32_t>(product1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = static_cast<uint32_t>(product0 >> 32) ^ c3 ^ k1;
+        c1 = static_cast<uint32_t>(product1);
+        c3 = static_cast<uint32_t>(product0);
+        c0 = n0;
+        c2 = n2;
+    }
+
+    /**
+     * 生成从firstBlock开始的blocks块（不超过BATCH_BLOCKS），按块顺序写入out[4 * blocks]
+     */
+    void generateBlocks(uint64_t firstBlock, int blocks, uint32_t* out) const
+    {
+        uint32_t c0[BATCH_BLOCKS], c1[BATCH_BLOCKS], c2[BATCH_BLOCKS], c3[BATCH_BLOCKS];
+        for (int i = 0; i < blocks; i++) {
+            uint64_t counter = firstBlock + static_cast<uint64_t>(i);
+            c0[i] = static_cast<uint32_t>(counter);
+            c1[i] = static_cast<uint32_t>(counter >> 32);
+            c2[i] = static_cast<uint32_t>(m_stream);
+            c3[i] = static_cast<uint32_t>(m_stream >> 32);
+        }
+
+        uint32_t k0 = m_key[0], k1 = m_key[1];
+        for (int round = 0; round < ROUNDS; round++) {
+            for (int i = 0; i < blocks; i++) {
+                philoxRound(c0[i], c1[i], c2[i], c3[i], k0, k1);
+            }
+            k0 += WEYL_0;
+            k1 += WEYL_1;
+        }
+
+        for (int i = 0; i < blocks; i++) {
+            out[4 * i] = c0[i];
+            out[4 * i + 1] = c1[i];
+            out[4 * i + 2] = c2[i];
+            out[4 * i + 3] = c3[i];
+        }
+    }
+
+    size_t drainBuffer(uint32_t* out, size_t count)
+    {
+        size_t done = 0;
+        while (done < count && m_cached < 4) {
+            out[done++] = m_buffer[m_cached++];
+        }
+        return done;
+    }
+
+    uint32_t m_key[2];
+    uint64_t m_stream;
+    uint64_t m_block;           // 下一个待生成的块
+    uint32_t m_buffer[4];       // 当前块
+    int m_cached;               // 当前块中已取走的值数（4为已取完）
+};
+
+#endif // COUNTERRNG_H
@@ -1,4 +1,5 @@
 #include "DMLogger.h"
+#include "TraceZone.h"
 #include <chrono>
 #include <iomanip>
 #include <ctime>
@@ -110,6 +111,8 @@ void Logger::empty(const char* function, int line, const std::string& message) {
 }
 
 void Logger::flush() {
+    TRACE_ZONE("Logger::flush");
+    std::lock_guard<std::mutex> lock(m_writeMutex);
     if (m_enableConsole) {
         std::cout.flush();
     }
@@ -145,6 +148,7 @@ std::string Logger::getTimestamp() const {
 }
 
 void Logger::writeLog(LogLevel level, const char* function, int line, const std::string& message) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
     std::stringstream logStream;
     logStream << "[" << getTimestamp() << "] ";
 
@@ -168,12 +172,14 @@ void Logger::writeLog(LogLevel level, const char* function, int line, const std:
 
     // 输出到文件
     if (m_fileOutputEnabled && m_enableFile && m_logFile.is_open()) {
+        TRACE_ZONE("Logger::writeFile");
         m_logFile << logLine << std::endl;
         m_logFile.flush();
     }
 }
 
 void Logger::writeLogEmpty(LogLevel level, const char* function, int line, const std::string& message) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
     std::stringstream logStream;
 
     // 对于empty类型的日志，也可以选择添加实体ID前缀
@@ -192,6 +198,7 @@ void Logger::writeLogEmpty(LogLevel level, const char* function, int line, const
 
     // 输出到文件
     if (m_fileOutputEnabled && m_enableFile && m_logFile.is_open()) {
+        TRACE_ZONE("Logger::writeFile");
         m_logFile << logLine << std::endl;
         m_logFile.flush();
     }
@@ -244,6 +251,7 @@ bool Logger::isInitialized() const {
 
 // 设置实体ID的方法
 void Logger::setEntityId(int64_t entityId) {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
     m_entityId = entityId;
     if (m_enableConsole) {
         std::cout << "Logger: Entity ID set to " << entityId << std::endl;
@@ -256,5 +264,6 @@ void Logger::setEntityId(int64_t entityId) {
 
 // 获取实体ID的方法
 int64_t Logger::getEntityId() const {
+    std::lock_guard<std::mutex> lock(m_writeMutex);
     return m_entityId;
 }
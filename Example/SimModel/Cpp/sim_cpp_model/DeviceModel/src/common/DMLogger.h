@@ -6,13 +6,15 @@
 #include <iostream>
 #include <sstream>
 #include <memory>
+#include <mutex>
 
 // 日志级别枚举
 enum class LogLevel {
     DEBUG = 0,
     INFO,
     WARN,
-    ERROR
+    ERROR,
+    OFF         // 关闭全部输出（基准测量时使用）
 };
 
 class Logger {
@@ -107,6 +109,7 @@ private:
     bool m_initialized = false;
     bool m_fileOutputEnabled = true;  // 文件输出开关
     int64_t m_entityId = -1;          // 实体ID，默认为-1表示未设置
+    mutable std::mutex m_writeMutex;  // 输出与实体ID互斥（多个模型可并行初始化、并行写日志）
 };
 
 // 模板方法实现
@@ -149,13 +152,21 @@ std::string Logger::formatString(const char* format, Args... args) {
     return std::string(buf.get(), buf.get() + size - 1);
 }
 
-// 便捷宏定义
-#define LOG_DEBUG(msg) Logger::getInstance().debug(__FUNCTION__, __LINE__, msg)
-#define LOG_INFO(msg) Logger::getInstance().info(__FUNCTION__, __LINE__, msg)
-#define LOG_WARN(msg) Logger::getInstance().warn(__FUNCTION__, __LINE__, msg)
-#define LOG_ERROR(msg) Logger::getInstance().error(__FUNCTION__, __LINE__, msg)
-
-#define LOG_EMPTY(msg) Logger::getInstance().empty(__FUNCTION__, __LINE__, msg)
+// 便捷宏定义（先判断级别，被过滤的日志不构造消息字符串）
+#define LOG_LEVEL_CALL(level, method, msg) \
+    do { \
+        Logger& logger_ = Logger::getInstance(); \
+        if (logger_.isEnabled(level)) { \
+            logger_.method(__FUNCTION__, __LINE__, msg); \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(msg) LOG_LEVEL_CALL(LogLevel::DEBUG, debug, msg)
+#define LOG_INFO(msg) LOG_LEVEL_CALL(LogLevel::INFO, info, msg)
+#define LOG_WARN(msg) LOG_LEVEL_CALL(LogLevel::WARN, warn, msg)
+#define LOG_ERROR(msg) LOG_LEVEL_CALL(LogLevel::ERROR, error, msg)
+
+#define LOG_EMPTY(msg) LOG_LEVEL_CALL(LogLevel::INFO, empty, msg)
 
 #define LOG_DEBUGF(format, ...) Logger::getInstance().debugf(__FUNCTION__, __LINE__, format, ##__VA_ARGS__)
 #define LOG_INFOF(format, ...) Logger::getInstance().infof(__FUNCTION__, __LINE__, format, ##__VA_ARGS__)
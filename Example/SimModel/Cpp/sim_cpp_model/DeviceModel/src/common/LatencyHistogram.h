@@ -0,0 +1,197 @@
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+#include <atomic>
+#include <chrono>
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * 延迟直方图（HDR风格的对数-线性分桶，纳秒，线程安全）
+ * 0~63ns逐纳秒计数；其余每个2的幂区间再等分为32个子桶，分位数的相对误差不超过1/32（约3%）；
+ * 约2^40ns（18分钟）以上的值计入最后一个桶。记录为O(1)的几次原子累加，不分配内存，
+ * 可在接收线程与流水线工作线程上同时记录、在界面线程上读取
+ */
+class LatencyHistogram
+{
+public:
+    static const int SUB_BUCKET_BITS = 5;
+    static const int SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static const int MAX_EXPONENT = 40;
+    static const int BUCKET_COUNT = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    /**
+     * 汇总（分位数为所在桶的上界，且不超过记录到的最大值）
+     */
+    struct Summary
+    {
+        uint64_t count;
+        uint64_t minNs;
+        uint64_t maxNs;
+        uint64_t meanNs;
+        uint64_t p50Ns;
+        uint64_t p90Ns;
+        uint64_t p99Ns;
+        uint64_t p999Ns;
+
+        Summary() : count(0), minNs(0), maxNs(0), meanNs(0), p50Ns(0), p90Ns(0), p99Ns(0), p999Ns(0) {}
+    };
+
+    LatencyHistogram() { reset(); }
+
+    void record(uint64_t ns)
+    {
+        m_buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        m_count.fetch_add(1, std::memory_order_relaxed);
+        m_sumNs.fetch_add(ns, std::memory_order_relaxed);
+
+        uint64_t current = m_minNs.load(std::memory_order_relaxed);
+        while (ns < current && !m_minNs.compare_exchange_weak(current, ns, std::memory_order_relaxed)) {
+        }
+        current = m_maxNs.load(std::memory_order_relaxed);
+        while (ns > current && !m_maxNs.compare_exchange_weak(current, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * 清零（与记录并发时，清零期间的少量记录可能部分丢失）
+     */
+    void reset()
+    {
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            m_buckets[i].store(0, std::memory_order_relaxed);
+        }
+        m_count.store(0, std::memory_order_relaxed);
+        m_sumNs.store(0, std::memory_order_relaxed);
+        m_minNs.store(UINT64_MAX, std::memory_order_relaxed);
+        m_maxNs.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+    Summary summary() const
+    {
+        Summary result;
+        uint64_t counts[BUCKET_COUNT];
+        uint64_t total = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+            total += counts[i];
+        }
+        if (total == 0) {
+            return result;
+        }
+
+        result.count = total;
+        result.minNs = m_minNs.load(std::memory_order_relaxed);
+        result.maxNs = m_maxNs.load(std::memory_order_relaxed);
+        result.meanNs = m_sumNs.load(std::memory_order_relaxed) / total;
+        result.p50Ns = percentile(counts, total, result.maxNs, 0.5);
+        result.p90Ns = percentile(counts, total, result.maxNs, 0.9);
+        result.p99Ns = percentile(counts, total, result.maxNs, 0.99);
+        result.p999Ns = percentile(counts, total, result.maxNs, 0.999);
+        return result;
+    }
+
+    static int bucketIndex(uint64_t ns)
+    {
+        if (ns < static_cast<uint64_t>(2 * SUB_BUCKET_COUNT)) {
+            return static_cast<int>(ns);
+        }
+        int exponent = highestBit(ns);
+        if (exponent >= MAX_EXPONENT) {
+            return BUCKET_COUNT - 1;
+        }
+        int sub = static_cast<int>(ns >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKET_COUNT;
+        return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT + sub;
+    }
+
+    /**
+     * 桶内的最大值（同一桶内的值视为相等）
+     */
+    static uint64_t bucketUpperBound(int index)
+    {
+        if (index < 2 * SUB_BUCKET_COUNT) {
+            return static_cast<uint64_t>(index);
+        }
+        int exponent = index / SUB_BUCKET_COUNT + SUB_BUCKET_BITS - 1;
+        int sub = index % SUB_BUCKET_COUNT;
+        int shift = exponent - SUB_BUCKET_BITS;
+        return (static_cast<uint64_t>(SUB_BUCKET_COUNT + sub + 1) << shift) - 1;
+    }
+
+private:
+    // 禁止拷贝和赋值
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    static int highestBit(uint64_t value)
+    {
+#if defined(_MSC_VER)
+        unsigned long index = 0;
+        _BitScanReverse64(&index, value);
+        return static_cast<int>(index);
+#else
+        return 63 - __builtin_clzll(value);
+#endif
+    }
+
+    static uint64_t percentile(const uint64_t* counts, uint64_t total, uint64_t maxNs, double quantile)
+    {
+        uint64_t rank = static_cast<uint64_t>(quantile * total + 0.5);
+        if (rank < 1) {
+            rank = 1;
+        }
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint64_t bound = bucketUpperBound(i);
+                return bound < maxNs ? bound : maxNs;
+            }
+        }
+        return maxNs;
+    }
+
+    std::atomic<uint64_t> m_buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sumNs;
+    std::atomic<uint64_t> m_minNs;
+    std::atomic<uint64_t> m_maxNs;
+};
+
+/**
+ * 作用域计时：析构时把经过的时间记入直方图；直方图为空时不读时钟
+ */
+class ScopedLatency
+{
+public:
+    explicit ScopedLatency(LatencyHistogram* histogram)
+        : m_histogram(histogram)
+    {
+        if (m_histogram) {
+            m_begin = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~ScopedLatency()
+    {
+        if (m_histogram) {
+            m_histogram->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - m_begin).count()));
+        }
+    }
+
+private:
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+    LatencyHistogram* m_histogram;
+    std::chrono::steady_clock::time_point m_begin;
+};
+
+#endif // LATENCYHISTOGRAM_H
@@ -0,0 +1,221 @@
+#ifndef MEMORYACCOUNT_H
+#define MEMORYACCOUNT_H
+
+#include <atomic>
+#include <new>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * 单类内存计数（当前字节数、块数、字节数峰值与累计分配次数，线程安全）
+ * 两种记账方式不可混用于同一计数：
+ * add/remove —— 由计数分配器在每次分配/释放时调用；
+ * set        —— 按容器容量整体刷新（无法替换分配器的SDK结构）。
+ * 挂接父计数后，变化同时累加到父计数，总量与总峰值因此也是O(1)的
+ */
+class MemoryCounter
+{
+public:
+    MemoryCounter() : m_parent(nullptr), m_bytes(0), m_blocks(0), m_peakBytes(0), m_allocations(0) {}
+
+    /**
+     * 挂接父计数（须在首次记账前调用）
+     */
+    void attachTo(MemoryCounter* parent) { m_parent = parent; }
+
+    void add(size_t bytes)
+    {
+        adjust(static_cast<int64_t>(bytes), 1);
+        countAllocation();
+    }
+    void remove(size_t bytes) { adjust(-static_cast<int64_t>(bytes), -1); }
+
+    void set(size_t bytes, size_t blocks)
+    {
+        int64_t oldBytes = m_bytes.exchange(static_cast<int64_t>(bytes), std::memory_order_relaxed);
+        int64_t oldBlocks = m_blocks.exchange(static_cast<int64_t>(blocks), std::memory_order_relaxed);
+        updatePeak(static_cast<int64_t>(bytes));
+        if (m_parent) {
+            m_parent->adjust(static_cast<int64_t>(bytes) - oldBytes, static_cast<int64_t>(blocks) - oldBlocks);
+        }
+    }
+
+    uint64_t bytes() const { return static_cast<uint64_t>(m_bytes.load(std::memory_order_relaxed)); }
+    uint64_t blocks() const { return static_cast<uint64_t>(m_blocks.load(std::memory_order_relaxed)); }
+    uint64_t peakBytes() const { return static_cast<uint64_t>(m_peakBytes.load(std::memory_order_relaxed)); }
+    uint64_t allocations() const { return m_allocations.load(std::memory_order_relaxed); }   // 只统计add
+
+private:
+    // 禁止拷贝和赋值
+    MemoryCounter(const MemoryCounter&) = delete;
+    MemoryCounter& operator=(const MemoryCounter&) = delete;
+
+    void adjust(int64_t bytesDelta, int64_t blocksDelta)
+    {
+        int64_t now = m_bytes.fetch_add(bytesDelta, std::memory_order_relaxed) + bytesDelta;
+        m_blocks.fetch_add(blocksDelta, std::memory_order_relaxed);
+        updatePeak(now);
+        if (m_parent) {
+            m_parent->adjust(bytesDelta, blocksDelta);
+        }
+    }
+
+    void countAllocation()
+    {
+        m_allocations.fetch_add(1, std::memory_order_relaxed);
+        if (m_parent) {
+            m_parent->countAllocation();
+        }
+    }
+
+    void updatePeak(int64_t bytes)
+    {
+        int64_t peak = m_peakBytes.load(std::memory_order_relaxed);
+        while (bytes > peak &&
+               !m_peakBytes.compare_exchange_weak(peak, bytes, std::memory_order_relaxed)) {
+        }
+    }
+
+    MemoryCounter* m_parent;
+    std::atomic<int64_t> m_bytes;
+    std::atomic<int64_t> m_blocks;
+    std::atomic<int64_t> m_peakBytes;
+    std::atomic<uint64_t> m_allocations;
+};
+
+/**
+ * 计数分配器：按请求的字节数记入计数（计数为空时等同std::allocator）
+ * 计数须比经它分配的内存活得更久
+ */
+template<typename T>
+class TrackedAllocator
+{
+public:
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef TrackedAllocator<U> other;
+    };
+
+    TrackedAllocator(MemoryCounter* counter = nullptr) : m_counter(counter) {}
+
+    template<typename U>
+    TrackedAllocator(const TrackedAllocator<U>& other) : m_counter(other.counter()) {}
+
+    T* allocate(size_t count)
+    {
+        T* ptr = static_cast<T*>(::operator new(count * sizeof(T)));
+        if (m_counter) {
+            m_counter->add(count * sizeof(T));
+        }
+        return ptr;
+    }
+
+    void deallocate(T* ptr, size_t count)
+    {
+        ::operator delete(ptr);
+        if (m_counter) {
+            m_counter->remove(count * sizeof(T));
+        }
+    }
+
+    MemoryCounter* counter() const { return m_counter; }
+
+    template<typename U>
+    bool operator==(const TrackedAllocator<U>& other) const { return m_counter == other.counter(); }
+
+    template<typename U>
+    bool operator!=(const TrackedAllocator<U>& other) const { return m_counter != other.counter(); }
+
+private:
+    MemoryCounter* m_counter;
+};
+
+/**
+ * 组件实例的内存账本：按类别计数，总量由各类别累加得到
+ */
+class MemoryAccount
+{
+public:
+    enum Category
+    {
+        CONTACT_SPECTRA = 0,    // 目标传播频谱（本实例持有的副本）
+        CONTACT_RECORDS,        // 各声纳的目标记录表
+        NOISE_SPECTRA,          // 平台自噪声与环境噪声频谱副本
+        RESULTS,                // 方程结果与被动声呐结果结构
+        MESSAGES,               // 待发送消息队列
+        CATEGORY_COUNT
+    };
+
+    /**
+     * 某一类别（或总量）的快照
+     */
+    struct Usage
+    {
+        uint64_t bytes;
+        uint64_t blocks;
+        uint64_t peakBytes;
+        uint64_t allocations;   // 累计分配次数（按容量刷新的类别为0）
+
+        Usage() : bytes(0), blocks(0), peakBytes(0), allocations(0) {}
+    };
+
+    struct Snapshot
+    {
+        Usage categories[CATEGORY_COUNT];
+        Usage total;
+    };
+
+    MemoryAccount()
+    {
+        for (int i = 0; i < CATEGORY_COUNT; i++) {
+            m_categories[i].attachTo(&m_total);
+        }
+    }
+
+    MemoryCounter* category(Category category) { return &m_categories[category]; }
+    const MemoryCounter* category(Category category) const { return &m_categories[category]; }
+
+    uint64_t totalBytes() const { return m_total.bytes(); }
+    uint64_t totalAllocations() const { return m_total.allocations(); }
+
+    Snapshot snapshot() const
+    {
+        Snapshot result;
+        for (int i = 0; i < CATEGORY_COUNT; i++) {
+            result.categories[i] = usageOf(*category(static_cast<Category>(i)));
+        }
+        result.total = usageOf(m_total);
+        return result;
+    }
+
+    static const char* categoryName(Category category)
+    {
+        static const char* const names[CATEGORY_COUNT] = {
+            "contactSpectra", "contactRecords", "noiseSpectra", "results", "messages"
+        };
+        return (category >= 0 && category < CATEGORY_COUNT) ? names[category] : "unknown";
+    }
+
+private:
+    // 禁止拷贝和赋值
+    MemoryAccount(const MemoryAccount&) = delete;
+    MemoryAccount& operator=(const MemoryAccount&) = delete;
+
+    static Usage usageOf(const MemoryCounter& counter)
+    {
+        Usage usage;
+        usage.bytes = counter.bytes();
+        usage.blocks = counter.blocks();
+        usage.peakBytes = counter.peakBytes();
+        usage.allocations = counter.allocations();
+        return usage;
+    }
+
+    MemoryCounter m_total;
+    MemoryCounter m_categories[CATEGORY_COUNT];
+};
+
+#endif // MEMORYACCOUNT_H
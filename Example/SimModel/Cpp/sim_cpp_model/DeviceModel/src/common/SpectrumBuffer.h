@@ -0,0 +1,121 @@
+#ifndef SPECTRUMBUFFER_H
+#define SPECTRUMBUFFER_H
+
+#include <memory>
+#include <cstring>
+
+#include "MemoryAccount.h"
+#include "SpectrumSlabPool.h"
+
+/**
+ * 只读频谱句柄（引用计数）
+ * 拷贝模式：持有一份独立的频谱副本；
+ * 借用模式：持有宿主载荷的引用（CSimModelAgentExtension::retainPayload），载荷在句柄释放前保持有效且不被修改。
+ * 句柄之间复制只增加引用计数，不复制频谱数据
+ */
+class SpectrumBuffer
+{
+public:
+    SpectrumBuffer() : m_size(0), m_borrowed(false) {}
+
+    /**
+     * 拷贝一份频谱
+     * @param counter 非空时副本占用的内存计入该计数
+     */
+    static SpectrumBuffer copyOf(const float* data, int size, MemoryCounter* counter = nullptr)
+    {
+        float* writable = nullptr;
+        SpectrumBuffer buffer = allocate(data ? size : 0, writable, counter);
+        if (writable) {
+            memcpy(writable, data, size * sizeof(float));
+        }
+        return buffer;
+    }
+
+    /**
+     * 分配一块未初始化的频谱，由调用方通过writable填充
+     * 标准点数的频谱取自定长块池，其余大小或池已满时从堆分配
+     * @param counter 非空时按实际占用（池块大小，或堆上数组与控制块）计入该计数，内存释放时扣除
+     */
+    static SpectrumBuffer allocate(int size, float*& writable, MemoryCounter* counter = nullptr)
+    {
+        SpectrumBuffer buffer;
+        writable = nullptr;
+        if (size > 0) {
+            std::shared_ptr<float> storage;
+            if (size == SpectrumSlabPool::SLAB_FLOATS) {
+                storage = SpectrumSlabPool::instance().acquire(counter);
+            }
+            if (!storage && counter) {
+                // 先记入数组：控制块分配失败时删除器会立即扣除
+                float* data = new float[size];
+                counter->add(size * sizeof(float));
+                storage = std::shared_ptr<float>(data, TrackedArrayDeleter(counter, size),
+                                                 TrackedAllocator<float>(counter));
+            } else if (!storage) {
+                storage.reset(new float[size], std::default_delete<float[]>());
+            }
+            writable = storage.get();
+            buffer.m_data = storage;
+            buffer.m_size = size;
+        }
+        return buffer;
+    }
+
+    /**
+     * 借用宿主载荷中的频谱（与owner共享生命周期）
+     * @param owner 宿主返回的载荷句柄
+     * @param data 频谱在载荷中的地址
+     */
+    static SpectrumBuffer borrow(const std::shared_ptr<const void>& owner, const float* data, int size)
+    {
+        SpectrumBuffer buffer;
+        if (owner && data && size > 0) {
+            buffer.m_data = std::shared_ptr<const float>(owner, data);
+            buffer.m_size = size;
+            buffer.m_borrowed = true;
+        }
+        return buffer;
+    }
+
+    const float* data() const { return m_data.get(); }
+    int size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    bool isBorrowed() const { return m_borrowed; }
+
+    float operator[](int index) const { return m_data.get()[index]; }
+    const float* begin() const { return m_data.get(); }
+    const float* end() const { return m_data.get() + m_size; }
+
+    /**
+     * 释放句柄（借用模式下归还宿主载荷的引用）
+     */
+    void reset()
+    {
+        m_data.reset();
+        m_size = 0;
+        m_borrowed = false;
+    }
+
+private:
+    // 堆上频谱数组的删除器，释放时同时扣除计数
+    struct TrackedArrayDeleter
+    {
+        MemoryCounter* counter;
+        int size;
+
+        TrackedArrayDeleter(MemoryCounter* counter, int size) : counter(counter), size(size) {}
+
+        void operator()(float* data) const
+        {
+            delete[] data;
+            counter->remove(size * sizeof(float));
+        }
+    };
+
+    std::shared_ptr<const float> m_data;
+    int m_size;
+    bool m_borrowed;
+};
+
+#endif // SPECTRUMBUFFER_H
@@ -0,0 +1,215 @@
+#include "SpectrumSlabPool.h"
+#include "MemoryAccount.h"
+
+#include <stdlib.h>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#else
+#include <sys/mman.h>
+#endif
+
+const int SpectrumSlabPool::SLAB_FLOATS;
+const size_t SpectrumSlabPool::SLAB_HEADER_BYTES;
+const size_t SpectrumSlabPool::SLAB_BYTES;
+const size_t SpectrumSlabPool::CHUNK_BYTES;
+
+/**
+ * 在块头中构造shared_ptr控制块的分配器
+ * 控制块析构后才归还整块，避免块被他人取走时旧控制块仍在析构；
+ * 控制块超出块头时（不同标准库实现）退回堆分配
+ */
+template<typename T>
+class SlabHeaderAllocator
+{
+public:
+    typedef T value_type;
+
+    template<typename U>
+    struct rebind
+    {
+        typedef SlabHeaderAllocator<U> other;
+    };
+
+    SlabHeaderAllocator(SpectrumSlabPool* pool, unsigned char* slab, MemoryCounter* counter)
+        : m_pool(pool), m_slab(slab), m_counter(counter) {}
+
+    template<typename U>
+    SlabHeaderAllocator(const SlabHeaderAllocator<U>& other)
+        : m_pool(other.m_pool), m_slab(other.m_slab), m_counter(other.m_counter) {}
+
+    T* allocate(size_t count)
+    {
+        if (count * sizeof(T) <= SpectrumSlabPool::SLAB_HEADER_BYTES) {
+            return reinterpret_cast<T*>(m_slab);
+        }
+        return static_cast<T*>(::operator new(count * sizeof(T)));
+    }
+
+    void deallocate(T* ptr, size_t)
+    {
+        if (reinterpret_cast<unsigned char*>(ptr) != m_slab) {
+            ::operator delete(ptr);
+        }
+        if (m_counter) {
+            m_counter->remove(SpectrumSlabPool::SLAB_BYTES);
+        }
+        m_pool->releaseSlab(m_slab);
+    }
+
+    template<typename U>
+    bool operator==(const SlabHeaderAllocator<U>& other) const { return m_slab == other.m_slab; }
+
+    template<typename U>
+    bool operator!=(const SlabHeaderAllocator<U>& other) const { return m_slab != other.m_slab; }
+
+private:
+    template<typename U> friend class SlabHeaderAllocator;
+
+    SpectrumSlabPool* m_pool;
+    unsigned char* m_slab;
+    MemoryCounter* m_counter;
+};
+
+namespace {
+
+// 频谱由块头之后的内存承载，控制块释放时整块归还，删除器无需动作
+struct SlabNoopDeleter
+{
+    void operator()(float*) const {}
+};
+
+unsigned char* allocateChunk(bool hugePages, bool& usedHugePages)
+{
+    usedHugePages = false;
+
+#ifdef _WIN32
+    (void)hugePages;
+    return static_cast<unsigned char*>(_aligned_malloc(SpectrumSlabPool::CHUNK_BYTES, 64));
+#else
+#ifdef __linux__
+    if (hugePages) {
+        // 预留大页可用时直接映射；否则映射普通页并请求透明大页
+        void* mapped = mmap(nullptr, SpectrumSlabPool::CHUNK_BYTES, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapped != MAP_FAILED) {
+            usedHugePages = true;
+            return static_cast<unsigned char*>(mapped);
+        }
+    }
+#endif
+
+    // 按大块大小对齐，便于内核以透明大页承载
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, SpectrumSlabPool::CHUNK_BYTES, SpectrumSlabPool::CHUNK_BYTES) != 0) {
+        return nullptr;
+    }
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    if (hugePages) {
+        usedHugePages = (madvise(ptr, SpectrumSlabPool::CHUNK_BYTES, MADV_HUGEPAGE) == 0);
+    }
+#endif
+    return static_cast<unsigned char*>(ptr);
+#endif
+}
+
+}
+
+SpectrumSlabPool& SpectrumSlabPool::instance()
+{
+    // 不析构：静态对象析构期间仍可能有频谱句柄归还
+    static SpectrumSlabPool* pool = new SpectrumSlabPool();
+    return *pool;
+}
+
+void SpectrumSlabPool::configure(const Config& config)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_config = config;
+}
+
+std::shared_ptr<float> SpectrumSlabPool::acquire(MemoryCounter* counter)
+{
+    unsigned char* slab = takeSlab();
+    if (!slab) {
+        return std::shared_ptr<float>();
+    }
+
+    float* data = reinterpret_cast<float*>(slab + SLAB_HEADER_BYTES);
+    try {
+        std::shared_ptr<float> storage(data, SlabNoopDeleter(), SlabHeaderAllocator<float>(this, slab, counter));
+        if (counter) {
+            counter->add(SLAB_BYTES);
+        }
+        return storage;
+    } catch (...) {
+        // 控制块未建立，块直接归还
+        releaseSlab(slab);
+        throw;
+    }
+}
+
+SpectrumSlabPool::Stats SpectrumSlabPool::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+unsigned char* SpectrumSlabPool::takeSlab()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_stats.acquired++;
+    if (m_freeList) {
+        m_stats.recycled++;
+    } else if (!growLocked()) {
+        m_stats.fallbacks++;
+        return nullptr;
+    }
+
+    FreeSlab* slab = m_freeList;
+    m_freeList = slab->next;
+
+    m_stats.slabsInUse++;
+    if (m_stats.slabsInUse > m_stats.slabsPeak) {
+        m_stats.slabsPeak = m_stats.slabsInUse;
+    }
+    return reinterpret_cast<unsigned char*>(slab);
+}
+
+void SpectrumSlabPool::releaseSlab(void* slab)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    FreeSlab* node = static_cast<FreeSlab*>(slab);
+    node->next = m_freeList;
+    m_freeList = node;
+    m_stats.slabsInUse--;
+}
+
+bool SpectrumSlabPool::growLocked()
+{
+    if (m_config.maxBytes > 0 && m_stats.bytesReserved + CHUNK_BYTES > m_config.maxBytes) {
+        return false;
+    }
+
+    bool usedHugePages = false;
+    unsigned char* chunk = allocateChunk(m_config.hugePages, usedHugePages);
+    if (!chunk) {
+        return false;
+    }
+
+    // 按地址顺序挂入空闲链表，先取出的块位于大块开头
+    const size_t slabCount = CHUNK_BYTES / SLAB_BYTES;
+    for (size_t i = slabCount; i > 0; i--) {
+        FreeSlab* node = reinterpret_cast<FreeSlab*>(chunk + (i - 1) * SLAB_BYTES);
+        node->next = m_freeList;
+        m_freeList = node;
+    }
+
+    m_stats.chunks++;
+    m_stats.hugePageChunks += usedHugePages ? 1 : 0;
+    m_stats.bytesReserved += CHUNK_BYTES;
+    m_stats.slabsTotal += slabCount;
+    return true;
+}
@@ -0,0 +1,99 @@
+#ifndef SPECTRUMSLABPOOL_H
+#define SPECTRUMSLABPOOL_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+class MemoryCounter;
+
+/**
+ * 频谱定长块池（进程内单例，线程安全）
+ * 每块 = 64字节头 + 5296点频谱，频谱按64字节对齐；块从约2MB的大块中切分，
+ * 释放后进入空闲链表循环使用，大块在进程生命期内不归还系统，
+ * 目标频谱随接触目标出现/消失反复申请释放时不再经过malloc，长时间运行也不产生碎片。
+ * 块头存放shared_ptr的引用计数控制块，一次取块即得到完整的频谱句柄存储。
+ */
+class SpectrumSlabPool
+{
+public:
+    static const int SLAB_FLOATS = 5296;            // 每块频谱点数
+    static const size_t SLAB_HEADER_BYTES = 64;     // 块头（控制块）字节数
+    static const size_t SLAB_BYTES = SLAB_HEADER_BYTES + SLAB_FLOATS * sizeof(float);
+    static const size_t CHUNK_BYTES = 2 * 1024 * 1024;  // 大块字节数（一个2MB大页）
+
+    /**
+     * 池配置
+     */
+    struct Config
+    {
+        bool hugePages;         // 大块使用大页（Linux：先试MAP_HUGETLB，失败时退回透明大页）
+        size_t maxBytes;        // 大块总字节上限，0为不限；达到上限后由堆分配兜底
+
+        Config() : hugePages(false), maxBytes(0) {}
+    };
+
+    /**
+     * 池统计
+     */
+    struct Stats
+    {
+        uint64_t chunks;            // 已申请大块数
+        uint64_t hugePageChunks;    // 其中使用大页的大块数
+        uint64_t bytesReserved;     // 大块总字节数
+        uint64_t slabsTotal;        // 已切分的块数
+        uint64_t slabsInUse;        // 使用中的块数
+        uint64_t slabsPeak;         // 使用中块数的峰值
+        uint64_t acquired;          // 累计取块次数
+        uint64_t recycled;          // 其中由空闲链表满足的次数
+        uint64_t fallbacks;         // 达到上限或申请失败、由调用方堆分配的次数
+
+        Stats() : chunks(0), hugePageChunks(0), bytesReserved(0), slabsTotal(0), slabsInUse(0)
+            , slabsPeak(0), acquired(0), recycled(0), fallbacks(0) {}
+    };
+
+    static SpectrumSlabPool& instance();
+
+    /**
+     * 修改配置，只影响之后申请的大块
+     */
+    void configure(const Config& config);
+
+    /**
+     * 取一块频谱存储（内容未初始化），最后一个引用释放时块自动归还
+     * @param counter 非空时整块（SLAB_BYTES）计入该计数，归还时扣除
+     * @return 达到上限或申请失败时返回空指针，由调用方自行分配
+     */
+    std::shared_ptr<float> acquire(MemoryCounter* counter = nullptr);
+
+    Stats stats() const;
+
+private:
+    template<typename T> friend class SlabHeaderAllocator;
+
+    SpectrumSlabPool() = default;
+    ~SpectrumSlabPool() = default;
+
+    // 禁止拷贝和赋值
+    SpectrumSlabPool(const SpectrumSlabPool&) = delete;
+    SpectrumSlabPool& operator=(const SpectrumSlabPool&) = delete;
+
+    // 空闲块链表节点（占用块头）
+    struct FreeSlab
+    {
+        FreeSlab* next;
+    };
+
+    unsigned char* takeSlab();
+    void releaseSlab(void* slab);
+    bool growLocked();
+
+    mutable std::mutex m_mutex;
+    Config m_config;
+    Stats m_stats;
+    FreeSlab* m_freeList = nullptr;
+};
+
+#endif // SPECTRUMSLABPOOL_H
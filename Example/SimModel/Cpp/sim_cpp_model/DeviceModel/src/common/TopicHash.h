@@ -0,0 +1,45 @@
+#ifndef TOPICHASH_H
+#define TOPICHASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <type_traits>
+
+/**
+ * 主题名哈希（FNV-1a 32位）
+ * topicHash() 为编译期版本，用于DeviceTestInOut.h中的主题宏；
+ * topicHashRuntime() 为运行期版本，用于消息/数据中的char[64]主题，二者结果一致
+ */
+namespace TopicHash {
+
+static const uint32_t FNV_OFFSET_BASIS = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+
+// C++11 的 constexpr 函数只允许一条 return 语句，采用递归实现
+constexpr uint32_t hashStep(const char* str, uint32_t hash)
+{
+    return (*str == '\0') ? hash
+                          : hashStep(str + 1, (hash ^ static_cast<uint8_t>(*str)) * FNV_PRIME);
+}
+
+constexpr uint32_t topicHash(const char* str)
+{
+    return hashStep(str, FNV_OFFSET_BASIS);
+}
+
+// 运行期版本，最多处理maxLen个字符（主题数组可能不以'\0'结尾）
+inline uint32_t topicHashRuntime(const char* str, size_t maxLen)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (size_t i = 0; i < maxLen && str[i] != '\0'; ++i) {
+        hash = (hash ^ static_cast<uint8_t>(str[i])) * FNV_PRIME;
+    }
+    return hash;
+}
+
+} // namespace TopicHash
+
+// 主题ID宏：强制在编译期求值
+#define TOPIC_ID(topic) (std::integral_constant<uint32_t, TopicHash::topicHash(topic)>::value)
+
+#endif // TOPICHASH_H
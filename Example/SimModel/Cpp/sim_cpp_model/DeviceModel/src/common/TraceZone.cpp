@@ -0,0 +1,183 @@
+#include "TraceZone.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+const size_t TraceRecorder::DEFAULT_THREAD_CAPACITY;
+
+namespace {
+
+// 当前线程的缓冲（缓冲由记录器持有，线程退出后仍保留）
+thread_local void* t_threadBuffer = nullptr;
+
+int64_t steadyNowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * 写JSON字符串（区段名多为主题宏，仍转义引号、反斜杠与控制字符）
+ */
+void writeJsonString(std::ostream& out, const char* text)
+{
+    out << '"';
+    for (const char* p = text ? text : ""; *p; ++p) {
+        unsigned char c = static_cast<unsigned char>(*p);
+        if (c == '"' || c == '\\') {
+            out << '\\' << *p;
+        } else if (c < 0x20) {
+            out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c)
+                << std::dec << std::setfill(' ');
+        } else {
+            out << *p;
+        }
+    }
+    out << '"';
+}
+
+}
+
+TraceRecorder& TraceRecorder::instance()
+{
+    static TraceRecorder recorder;
+    return recorder;
+}
+
+TraceRecorder::TraceRecorder()
+    : m_enabled(true)
+    , m_threadCapacity(DEFAULT_THREAD_CAPACITY)
+    , m_epochNs(steadyNowNs())
+{
+}
+
+bool TraceRecorder::isCompiledIn()
+{
+#ifdef DEVICEMODEL_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+
+void TraceRecorder::setThreadCapacity(size_t events)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_threadCapacity = events > 0 ? events : 1;
+}
+
+void TraceRecorder::setThreadName(const char* name)
+{
+    ThreadBuffer* buffer = threadBuffer();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    buffer->name = name ? name : "";
+}
+
+uint64_t TraceRecorder::nowNs() const
+{
+    return static_cast<uint64_t>(steadyNowNs() - m_epochNs);
+}
+
+TraceRecorder::ThreadBuffer* TraceRecorder::threadBuffer()
+{
+    ThreadBuffer* buffer = static_cast<ThreadBuffer*>(t_threadBuffer);
+    if (buffer) {
+        return buffer;
+    }
+
+    std::unique_ptr<ThreadBuffer> created(new ThreadBuffer());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    created->tid = static_cast<int>(m_threads.size()) + 1;
+    created->events.reset(new Event[m_threadCapacity]);
+    created->capacity = m_threadCapacity;
+    created->size.store(0, std::memory_order_relaxed);
+    created->dropped.store(0, std::memory_order_relaxed);
+    buffer = created.get();
+    m_threads.push_back(std::move(created));
+    t_threadBuffer = buffer;
+    return buffer;
+}
+
+void TraceRecorder::record(const char* name, uint64_t beginNs, uint64_t endNs, int64_t id)
+{
+    ThreadBuffer* buffer = threadBuffer();
+    size_t index = buffer->size.load(std::memory_order_relaxed);
+    if (index >= buffer->capacity) {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    Event& event = buffer->events[index];
+    event.name = name;
+    event.beginNs = beginNs;
+    event.durationNs = endNs > beginNs ? endNs - beginNs : 0;
+    event.id = id;
+    buffer->size.store(index + 1, std::memory_order_release);
+}
+
+void TraceRecorder::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (size_t i = 0; i < m_threads.size(); i++) {
+        m_threads[i]->size.store(0, std::memory_order_relaxed);
+        m_threads[i]->dropped.store(0, std::memory_order_relaxed);
+    }
+}
+
+TraceRecorder::Stats TraceRecorder::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats result;
+    result.threads = m_threads.size();
+    for (size_t i = 0; i < m_threads.size(); i++) {
+        result.events += m_threads[i]->size.load(std::memory_order_acquire);
+        result.dropped += m_threads[i]->dropped.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+bool TraceRecorder::exportChromeJson(const std::string& path) const
+{
+    std::ofstream out(path.c_str(), std::ios::out | std::ios::trunc);
+    if (!out.is_open()) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"DeviceModel\"}}";
+
+    out << std::fixed << std::setprecision(3);
+    for (size_t t = 0; t < m_threads.size(); t++) {
+        const ThreadBuffer& buffer = *m_threads[t];
+
+        // 线程名（未命名的线程按登记顺序编号）
+        out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.tid << ",\"args\":{\"name\":";
+        if (buffer.name.empty()) {
+            std::string name = "thread-" + std::to_string(buffer.tid);
+            writeJsonString(out, name.c_str());
+        } else {
+            writeJsonString(out, buffer.name.c_str());
+        }
+        out << "}}";
+
+        // 时间戳单位为微秒
+        size_t count = buffer.size.load(std::memory_order_acquire);
+        for (size_t i = 0; i < count; i++) {
+            const Event& event = buffer.events[i];
+            out << ",\n{\"name\":";
+            writeJsonString(out, event.name);
+            out << ",\"cat\":\"DeviceModel\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.tid
+                << ",\"ts\":" << event.beginNs / 1000.0 << ",\"dur\":" << event.durationNs / 1000.0;
+            if (event.id >= 0) {
+                out << ",\"args\":{\"platform\":" << event.id << "}";
+            }
+            out << "}";
+        }
+    }
+
+    out << "\n]}\n";
+    out.flush();
+    return out.good();
+}
@@ -0,0 +1,181 @@
+#ifndef TRACEZONE_H
+#define TRACEZONE_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * 跟踪事件记录器（进程内单例，线程安全）
+ * 每个线程首次记录时登记一块定长事件缓冲，之后只由本线程写入、不加锁不分配；
+ * 缓冲写满后丢弃新事件并计数。导出为Chrome/Perfetto的JSON格式
+ * （chrome://tracing或ui.perfetto.dev直接打开），可在记录进行中导出已完成的事件。
+ * 区段名须为字面量或生命期覆盖导出的字符串（只保存指针）。
+ *
+ * 区段宏默认编出（空语句），qmake CONFIG+=devicemodel_trace（定义DEVICEMODEL_TRACE）时生效；
+ * 生效时每个区段为两次时钟读取加一次本线程缓冲写入
+ */
+class TraceRecorder
+{
+public:
+    static const size_t DEFAULT_THREAD_CAPACITY = 65536;   // 每线程默认事件数（每事件32字节）
+
+    /**
+     * 记录器统计
+     */
+    struct Stats
+    {
+        uint64_t threads;       // 已登记线程数
+        uint64_t events;        // 缓冲中的事件数
+        uint64_t dropped;       // 缓冲写满丢弃的事件数
+
+        Stats() : threads(0), events(0), dropped(0) {}
+    };
+
+    static TraceRecorder& instance();
+
+    /**
+     * 区段宏是否编入（未定义DEVICEMODEL_TRACE时导出的文件只有线程名）
+     */
+    static bool isCompiledIn();
+
+    /**
+     * 运行期开关（默认开启），关闭后区段不读时钟也不写缓冲
+     */
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * 每线程缓冲容量，只影响之后登记的线程
+     */
+    void setThreadCapacity(size_t events);
+
+    /**
+     * 设置当前线程在导出文件中的名称（会登记当前线程）
+     */
+    void setThreadName(const char* name);
+
+    /**
+     * 记录一个完整区段（由ScopedTraceZone调用）
+     * @param name 区段名
+     * @param beginNs 开始时刻（nowNs）
+     * @param endNs 结束时刻（nowNs）
+     * @param id 实例标识（平台ID），负数为不标注
+     */
+    void record(const char* name, uint64_t beginNs, uint64_t endNs, int64_t id);
+
+    /**
+     * 相对记录器创建时刻的单调时钟（纳秒）
+     */
+    uint64_t nowNs() const;
+
+    /**
+     * 清空各线程缓冲（须在没有线程记录时调用）
+     */
+    void clear();
+
+    Stats stats() const;
+
+    /**
+     * 导出Chrome跟踪事件JSON
+     * @param path 输出文件
+     * @return 写入成功返回true
+     */
+    bool exportChromeJson(const std::string& path) const;
+
+private:
+    /**
+     * 单个线程的事件缓冲（只由所属线程追加，size以release发布供导出读取）
+     */
+    struct Event
+    {
+        const char* name;
+        uint64_t beginNs;
+        uint64_t durationNs;
+        int64_t id;
+    };
+
+    struct ThreadBuffer
+    {
+        int tid;
+        std::string name;
+        std::unique_ptr<Event[]> events;
+        size_t capacity;
+        std::atomic<size_t> size;
+        std::atomic<uint64_t> dropped;
+    };
+
+    TraceRecorder();
+    ~TraceRecorder() = default;
+
+    // 禁止拷贝和赋值
+    TraceRecorder(const TraceRecorder&) = delete;
+    TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+    /**
+     * 当前线程的缓冲，首次调用时登记
+     */
+    ThreadBuffer* threadBuffer();
+
+    std::atomic<bool> m_enabled;
+    size_t m_threadCapacity;
+    int64_t m_epochNs;
+
+    mutable std::mutex m_mutex;                             // 保护线程登记与导出
+    std::vector<std::unique_ptr<ThreadBuffer>> m_threads;   // 线程退出后缓冲保留到进程结束
+};
+
+/**
+ * 作用域跟踪区段：构造时取开始时刻，析构时记入当前线程缓冲；记录器关闭时不读时钟
+ */
+class ScopedTraceZone
+{
+public:
+    ScopedTraceZone(const char* name, int64_t id)
+        : m_name(nullptr), m_id(id), m_beginNs(0)
+    {
+        TraceRecorder& recorder = TraceRecorder::instance();
+        if (recorder.isEnabled()) {
+            m_name = name;
+            m_beginNs = recorder.nowNs();
+        }
+    }
+
+    ~ScopedTraceZone()
+    {
+        if (m_name) {
+            TraceRecorder& recorder = TraceRecorder::instance();
+            recorder.record(m_name, m_beginNs, recorder.nowNs(), m_id);
+        }
+    }
+
+private:
+    ScopedTraceZone(const ScopedTraceZone&) = delete;
+    ScopedTraceZone& operator=(const ScopedTraceZone&) = delete;
+
+    const char* m_name;
+    int64_t m_id;
+    uint64_t m_beginNs;
+};
+
+#define TRACE_ZONE_CONCAT_INNER(a, b) a##b
+#define TRACE_ZONE_CONCAT(a, b) TRACE_ZONE_CONCAT_INNER(a, b)
+
+#ifdef DEVICEMODEL_TRACE
+// 跟踪当前作用域（name须为字面量或长期有效的字符串）
+#define TRACE_ZONE(name) ScopedTraceZone TRACE_ZONE_CONCAT(traceZone_, __LINE__)(name, -1)
+// 跟踪当前作用域并标注实例（平台ID）
+#define TRACE_ZONE_ID(name, id) ScopedTraceZone TRACE_ZONE_CONCAT(traceZone_, __LINE__)(name, static_cast<int64_t>(id))
+// 命名当前线程
+#define TRACE_THREAD_NAME(name) TraceRecorder::instance().setThreadName(name)
+#else
+#define TRACE_ZONE(name) do {} while (0)
+#define TRACE_ZONE_ID(name, id) do {} while (0)
+#define TRACE_THREAD_NAME(name) do {} while (0)
+#endif
+
+#endif // TRACEZONE_H
@@ -9,15 +9,20 @@
 #include <iomanip>
 #include <cstring>
 #include <random>
+#include <limits>
+#include <chrono>
+#include <ctime>
 #include "common/define.h"
-#include <QString>
-#include <QDateTime>
-#include <QMap>
+#include "FlatSoundList.h"
+#include "common/TraceZone.h"
+#include "common/CounterRng.h"
 
 constexpr const double DeviceModel::MAX_FREQUENCY_KHZ;
+constexpr const double DeviceModel::BOUND_PRUNING_MARGIN_DB;
 
 
 
+#ifdef _WIN32
 #include <windows.h>
 #include <dbghelp.h>
 // 异常过滤器函数
@@ -48,15 +53,85 @@ LONG WINAPI CustomExceptionFilter(EXCEPTION_POINTERS* ExceptionInfo)
 
     return EXCEPTION_EXECUTE_HANDLER;
 }
+#endif
+
+// 按strftime格式输出当前本地时间（日志文件名与配置文件头使用）
+static std::string currentLocalTimeString(const char* format)
+{
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    std::tm localTime;
+#ifdef _WIN32
+    localtime_s(&localTime, &now);
+#else
+    localtime_r(&now, &localTime);
+#endif
+    char buffer[64];
+    size_t length = std::strftime(buffer, sizeof(buffer), format, &localTime);
+    return std::string(buffer, length);
+}
+
+// 按键同步映射内的列表：已有列表按值赋值（沿用原容量），只在键新增时分配
+// （流水线快照每步复制目标列表，整体赋值会重建各列表）
+template<typename Key, typename Item>
+static void assignListMap(std::map<Key, std::vector<Item>>& target, const std::map<Key, std::vector<Item>>& source)
+{
+    typename std::map<Key, std::vector<Item>>::iterator it = target.begin();
+    while (it != target.end()) {
+        if (source.find(it->first) == source.end()) {
+            it = target.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    for (typename std::map<Key, std::vector<Item>>::const_iterator src = source.begin(); src != source.end(); ++src) {
+        target[src->first] = src->second;
+    }
+}
 
 DeviceModel::DeviceModel()
 {
+#ifdef _WIN32
     // 设置全局异常处理器
     SetUnhandledExceptionFilter(CustomExceptionFilter);
+#endif
 
     m_agent = nullptr; // CSimModelAgentBase 代理对象
+    m_agentExtension = nullptr;
+    m_propagatedSoundSubscribed = false;
+    m_platformId = 0;  // 本平台ID（init时从代理获取）
+    m_stepPrepared = false; // 两阶段步进：尚无待提交的结果
+    for (int i = 0; i < 4; i++) {
+        m_passiveSonarResultReady[i] = false;
+    }
 
     m_initialized = false; // 声纳状态信息 初始化标志
+    m_borrowedPayloadEnabled = false; // 默认拷贝载荷
+
+    // 流水线步进：默认严格同步模式
+    m_pipelineEnabled = false;
+    m_nextStepFrame = 0;
+    m_queuedStepFrame = -1;
+    m_readyStepFrame = -1;
+    m_publishStepFrame = -1;
+    m_pipelineStop = false;
+
+    // 声纳方程上界剪枝：默认启用
+    m_boundPruningEnabled = true;
+    m_boundEvaluatedCount = 0;
+    m_boundPrunedCount = 0;
+
+    // 性能统计：默认计时、不发布
+    m_perfStatsEnabled = true;
+    m_stepCount = 0;
+    m_messageCount = 0;
+    m_contactsIngested = 0;
+    m_activeContacts = 0;
+    m_evaluatedBase = 0;
+    m_prunedBase = 0;
+    m_allocationBase = 0;
+    m_perfStatsInterval = 0;
+    m_lastPerfStatsTime = -1;
+    m_phaseProbe = nullptr;
 
     // 初始化多目标缓存
     m_multiTargetCache = MultiTargetSonarEquationCache();
@@ -69,9 +144,8 @@ DeviceModel::DeviceModel()
     // 生成带时间戳的日志文件名     // 配置 DMLogger 同时输出到控制台和文件
     // 只在 Logger 未初始化时才初始化
      if (!Logger::getInstance().isInitialized()) {  // 需要添加这个方法
-         QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss");
-         QString logFileName = QString("device_model_%1.log").arg(timestamp);
-         Logger::getInstance().initialize(logFileName.toStdString(), true);
+         std::string logFileName = "device_model_" + currentLocalTimeString("%Y%m%d_%H%M%S") + ".log";
+         Logger::getInstance().initialize(logFileName, true);
      }
 
     LOG_INFO("Sonar model created with multi-target equation calculation capability");
@@ -118,12 +192,19 @@ bool DeviceModel::init(CSimModelAgentBase* simModelAgent, CSimComponentAttribute
         return false;
     }
     m_agent = simModelAgent;
+    m_agentExtension = querySimModelAgentExtension(simModelAgent);
+    if (m_agentExtension) {
+        LOG_INFOF("Agent extension available: version=%d", m_agentExtension->extensionVersion());
+    } else {
+        LOG_INFO("Agent extension not available, using per-item agent calls");
+    }
 
 
-
-    // 获取实体ID并设置到Logger中
-    if (m_agent->getPlatformEntity()) {
-        int64_t entityId = m_agent->getPlatformEntity()->id;
+    // 获取实体ID并设置到Logger中（本平台ID在组件生命周期内不变，缓存以减少代理调用）
+    CSimPlatformEntity* platformEntity = m_agent->getPlatformEntity();
+    if (platformEntity) {
+        int64_t entityId = platformEntity->id;
+        m_platformId = entityId;
         Logger::getInstance().setEntityId(entityId);
         LOG_INFOF("DeviceModel initialized for entity ID: %lld", entityId);
     } else {
@@ -142,10 +223,12 @@ void DeviceModel::start()
 {
     LOG_INFO("Multi-target sonar model started");
 
+    // 注册消息主题处理函数
+    registerMessageHandlers();
+
     if (m_agent) {
         // 订阅声纳需要处理的消息主题
         m_agent->subscribeMessage(MSG_SonarCommandControlOrder);
-        m_agent->subscribeMessage(MSG_PropagatedContinuousSound);
         m_agent->subscribeMessage(MSG_PropagatedActivePulseSound);
         m_agent->subscribeMessage(MSG_PropagatedCommPulseSound);
         m_agent->subscribeMessage(MSG_EnvironmentNoiseToSonar);
@@ -156,16 +239,16 @@ void DeviceModel::start()
         memset(&motion, 0, sizeof(motion));
         // 订阅平台机动信息
         memcpy(motion.topic, Data_Motion, strlen(Data_Motion) + 1);
-        motion.platformId = m_agent->getPlatformEntity()->id;//本平台id
-        motion.targetId = m_agent->getPlatformEntity()->id;
+        motion.platformId = m_platformId;//本平台id
+        motion.targetId = m_platformId;
         m_agent->subscribeSimData(&motion);
 
         CSubscribeSimData selfSound;
         memset(&selfSound, 0, sizeof(selfSound));
         // 订阅平台自噪声
         memcpy(selfSound.topic, Data_PlatformSelfSound, strlen(Data_PlatformSelfSound) + 1);
-        selfSound.platformId = m_agent->getPlatformEntity()->id;//本平台id
-        selfSound.targetId = m_agent->getPlatformEntity()->id;
+        selfSound.platformId = m_platformId;//本平台id
+        selfSound.targetId = m_platformId;
         m_agent->subscribeSimData(&selfSound);
     }
 
@@ -195,8 +278,64 @@ void DeviceModel::start()
         m_detectionData[i] = emptyData;
     }
 
+    // 按声纳状态订阅传播声（带过滤条件）
+    updatePropagatedSoundFilter();
+
     // 发布更新后的声纳状态
     updateSonarState();
+
+    if (m_pipelineEnabled) {
+        startStepPipeline();
+    }
+}
+
+void DeviceModel::updatePropagatedSoundFilter()
+{
+    if (!m_agent) {
+        return;
+    }
+
+    // 与isTargetInSonarRange一致：距离上限 + 已启用声纳的相对扇区并集（无声纳启用时只按距离过滤）
+    CSubscribeFilter filter;
+    filter.maxRange = static_cast<float>(MAX_DETECTION_RANGE);
+    filter.sectorRelativeToHeading = true;
+    filter.sectorMargin = PROPAGATED_FILTER_SECTOR_MARGIN;
+
+    for (int sonarID = 0; sonarID < 4; sonarID++) {
+        auto stateIt = m_sonarStates.find(sonarID);
+        if (stateIt == m_sonarStates.end() ||
+            !stateIt->second.arrayWorkingState || !stateIt->second.passiveWorkingState) {
+            continue;
+        }
+
+        if (sonarID == 1) {
+            // 舷侧声纳覆盖左右两侧
+            filter.sectorStart[filter.sectorCount] = 45.0f;
+            filter.sectorEnd[filter.sectorCount++] = 135.0f;
+            filter.sectorStart[filter.sectorCount] = -135.0f;
+            filter.sectorEnd[filter.sectorCount++] = -45.0f;
+        } else {
+            std::pair<float, float> range = getRelativeSonarAngleRange(sonarID);
+            filter.sectorStart[filter.sectorCount] = range.first;
+            filter.sectorEnd[filter.sectorCount++] = range.second;
+        }
+    }
+
+    if (!m_agentExtension) {
+        // 宿主不支持过滤订阅：普通订阅一次，目标由isTargetInSonarRange在组件内过滤
+        if (!m_propagatedSoundSubscribed) {
+            m_agent->subscribeMessage(MSG_PropagatedContinuousSound);
+            m_agent->subscribeMessage(MSG_PropagatedContinuousSound_Flat);
+            m_propagatedSoundSubscribed = true;
+        }
+        return;
+    }
+
+    m_agentExtension->subscribeMessageFiltered(MSG_PropagatedContinuousSound, &filter);
+    m_agentExtension->subscribeMessageFiltered(MSG_PropagatedContinuousSound_Flat, &filter);
+
+    LOG_INFOF("Propagated sound filter updated: maxRange=%.0fm, sectors=%d",
+              filter.maxRange, filter.sectorCount);
 }
 
 void DeviceModel::onMessage(CSimMessage* simMessage)
@@ -206,141 +345,284 @@ void DeviceModel::onMessage(CSimMessage* simMessage)
        return;
    }
 
-   // 根据消息主题进行相应处理
-   std::string topic = simMessage->topic;
-
-   // 对特定消息主题进行5秒间隔日志控制
-   if (topic == MSG_PropagatedContinuousSound ||
-       topic == MSG_EnvironmentNoiseToSonar ||
-       topic == Data_PlatformSelfSound) {
-
-       int64 currentTime = QDateTime::currentMSecsSinceEpoch();
-       bool shouldLog = false;
-
-       if (topic == MSG_PropagatedContinuousSound) {
-           if (currentTime - m_lastPropagatedSoundLogTime >= PROPAGATED_SOUND_LOG_INTERVAL) {
-               m_lastPropagatedSoundLogTime = currentTime;
-               shouldLog = true;
-           }
-       } else if (topic == MSG_EnvironmentNoiseToSonar) {
-           if (currentTime - m_lastEnvironmentNoiseLogTime >= PROPAGATED_SOUND_LOG_INTERVAL) {
-               m_lastEnvironmentNoiseLogTime = currentTime;
-               shouldLog = true;
-           }
-       } else if (topic == Data_PlatformSelfSound) {
-           if (currentTime - m_lastPlatformSelfSoundLogTime >= PROPAGATED_SOUND_LOG_INTERVAL) {
-               m_lastPlatformSelfSoundLogTime = currentTime;
-               shouldLog = true;
-           }
-       }
+   // 根据消息主题查分发表（一次哈希 + 一次查表）
+   TopicHandlerEntry* entry = findTopicHandler(simMessage->topic);
+   if (!entry) {
+       std::cout << __FUNCTION__ << ":" << __LINE__ << " Unknown message topic: ";
+       std::cout.write(simMessage->topic, strnlen(simMessage->topic, EventTypeLen)) << std::endl;
+       return;
+   }
 
+   // 高频主题按仿真时间间隔控制日志，其他消息正常打印
+   bool shouldLog = true;
+   if (entry->throttleLog) {
+       shouldLog = (simMessage->time - entry->lastLogTime >= PROPAGATED_SOUND_LOG_INTERVAL) ||
+                   (simMessage->time < entry->lastLogTime);
        if (shouldLog) {
-           LOG_EMPTY("");
-           LOG_INFOF("==========onMessage!!! Topic: %s", topic.c_str());
-           LOG_INFOF("Received message with topic: %s", topic.c_str());
+           entry->lastLogTime = simMessage->time;
        }
-   } else {
-       // 其他消息正常打印
-       LOG_EMPTY("");
-       LOG_INFOF("==========onMessage!!! Topic: %s", topic.c_str());
-       LOG_INFOF("Received message with topic: %s", topic.c_str());
    }
 
+   if (shouldLog) {
+       LOG_EMPTY("");
+       LOG_INFOF("==========onMessage!!! Topic: %s", entry->topic);
+       LOG_INFOF("Received message with topic: %s", entry->topic);
+   }
 
+   m_messageCount.fetch_add(1, std::memory_order_relaxed);
+   PhaseScope ingestPhase(this, PHASE_INGEST);
+   TRACE_ZONE_ID(entry->topic, m_platformId);
+   (this->*(entry->handler))(simMessage);
+}
 
+void DeviceModel::registerMessageHandlers()
+{
+    m_messageHandlers.clear();
+
+    // 声纳指控指令 / 被动声纳初始化信息
+    registerMessageHandler(MSG_SonarCommandControlOrder, TOPIC_ID(MSG_SonarCommandControlOrder), &DeviceModel::handleSonarControlOrder, false);
+    registerMessageHandler(ATTR_PassiveSonarComponent, TOPIC_ID(ATTR_PassiveSonarComponent), &DeviceModel::handleSonarInitialization, false);
+
+    // 信道输出的传播声、环境噪声、混响
+    registerMessageHandler(MSG_PropagatedContinuousSound, TOPIC_ID(MSG_PropagatedContinuousSound), &DeviceModel::onPropagatedContinuousSound, true);
+    registerMessageHandler(MSG_PropagatedActivePulseSound, TOPIC_ID(MSG_PropagatedActivePulseSound), &DeviceModel::onPropagatedActivePulseSound, true);
+    registerMessageHandler(MSG_PropagatedCommPulseSound, TOPIC_ID(MSG_PropagatedCommPulseSound), &DeviceModel::onPropagatedCommPulseSound, true);
+    registerMessageHandler(MSG_PropagatedInstantSound, TOPIC_ID(MSG_PropagatedInstantSound), &DeviceModel::onPropagatedInstantSound, true);
+    registerMessageHandler(MSG_EnvironmentNoiseToSonar, TOPIC_ID(MSG_EnvironmentNoiseToSonar), &DeviceModel::updateEnvironmentNoiseCache, true);
+    registerMessageHandler(MSG_ReverberationSound, TOPIC_ID(MSG_ReverberationSound), &DeviceModel::onReverberationSound, true);
+
+    // 扁平格式的传播声
+    registerMessageHandler(MSG_PropagatedContinuousSound_Flat, TOPIC_ID(MSG_PropagatedContinuousSound_Flat), &DeviceModel::updateMultiTargetPropagatedSoundCacheFlat, true);
+    registerMessageHandler(MSG_PropagatedActivePulseSound_Flat, TOPIC_ID(MSG_PropagatedActivePulseSound_Flat), &DeviceModel::onPropagatedPulseSoundFlat, true);
+    registerMessageHandler(MSG_PropagatedCommPulseSound_Flat, TOPIC_ID(MSG_PropagatedCommPulseSound_Flat), &DeviceModel::onPropagatedPulseSoundFlat, true);
+    registerMessageHandler(MSG_PropagatedInstantSound_Flat, TOPIC_ID(MSG_PropagatedInstantSound_Flat), &DeviceModel::onPropagatedPulseSoundFlat, true);
+
+    // 数据类主题以消息形式送达时（部分引擎对数据主题也走onMessage）
+    registerMessageHandler(Data_PlatformSelfSound, TOPIC_ID(Data_PlatformSelfSound), &DeviceModel::onPlatformSelfSoundMessage, true);
+    registerMessageHandler(Data_PlatformSelfSound_X1, TOPIC_ID(Data_PlatformSelfSound_X1), &DeviceModel::onPlatformSelfSoundMessage, true);
+    registerMessageHandler(Data_Motion, TOPIC_ID(Data_Motion), &DeviceModel::onMotionMessage, true);
+
+    // 导调功能配置
+    registerMessageHandler(MSG_PassiveSonarControlPara, TOPIC_ID(MSG_PassiveSonarControlPara), &DeviceModel::onControlParaMessage, false);
+    registerMessageHandler(MSG_ActiveSonarControlPara, TOPIC_ID(MSG_ActiveSonarControlPara), &DeviceModel::onControlParaMessage, false);
+    registerMessageHandler(MSG_ActiveTransmitControlPara, TOPIC_ID(MSG_ActiveTransmitControlPara), &DeviceModel::onControlParaMessage, false);
+    registerMessageHandler(MSG_DetectiveSonarControlPara, TOPIC_ID(MSG_DetectiveSonarControlPara), &DeviceModel::onControlParaMessage, false);
+    registerMessageHandler(MSG_DataCombineControlPara, TOPIC_ID(MSG_DataCombineControlPara), &DeviceModel::onControlParaMessage, false);
+
+    if (!buildTopicDispatchTable()) {
+        LOG_ERRORF("Failed to build topic dispatch table for %zu topics", m_messageHandlers.size());
+        return;
+    }
 
+    LOG_INFOF("Topic dispatch table built: %zu topics, %zu slots, seed=0x%08X",
+              m_messageHandlers.size(), m_topicSlots.size(), m_topicHashSeed);
+}
 
+void DeviceModel::registerMessageHandler(const char* topic, uint32_t topicHash, MessageHandler handler, bool throttleLog)
+{
+    // 编译期哈希与运行期哈希必须一致，否则消息将无法命中
+    if (topicHash != TopicHash::topicHashRuntime(topic, EventTypeLen)) {
+        LOG_ERRORF("Topic hash mismatch for %s", topic);
+        return;
+    }
 
-    // 声纳指控指令
-    if (topic == MSG_SonarCommandControlOrder) {
-        // 处理声纳控制命令
-        handleSonarControlOrder(simMessage);
+    for (const auto& existing : m_messageHandlers) {
+        if (existing.topicHash == topicHash) {
+            LOG_ERRORF("Topic hash collision: %s vs %s (0x%08X)", topic, existing.topic, topicHash);
+            return;
+        }
     }
-    else if (topic == ATTR_PassiveSonarComponent) {
-        // 处理被动声纳初始化信息
-        handleSonarInitialization(simMessage);
+
+    TopicHandlerEntry entry;
+    entry.topicHash = topicHash;
+    entry.topic = topic;
+    entry.handler = handler;
+    entry.throttleLog = throttleLog;
+    entry.lastLogTime = 0;
+    m_messageHandlers.push_back(entry);
+}
+
+bool DeviceModel::buildTopicDispatchTable()
+{
+    // 从最小的槽位数开始，寻找使所有已注册主题落在不同槽位的种子（完美哈希）
+    int minBits = 1;
+    while ((static_cast<size_t>(1) << minBits) < m_messageHandlers.size()) {
+        minBits++;
     }
-    else if (topic == MSG_PropagatedContinuousSound ||
-             topic == MSG_PropagatedActivePulseSound ||
-             topic == MSG_PropagatedCommPulseSound ||
-             topic == MSG_PropagatedInstantSound) {
-        // 处理传播声音数据
-//        handlePropagatedSound(simMessage);
-        std::string topic = simMessage->topic;
 
-        // 使用新的多目标处理方法
-        if (topic == MSG_PropagatedContinuousSound) {
-            m_debugStats.totalMessagesReceived++;
+    for (int bits = minBits; bits <= TOPIC_TABLE_MAX_BITS; bits++) {
+        const size_t slotCount = static_cast<size_t>(1) << bits;
+        const uint32_t shift = 32 - bits;
 
-            LOG_INFOF("=== MSG_PropagatedContinuousSound RECEIVED (#%d) ===",
-                     m_debugStats.totalMessagesReceived);
-            LOG_INFOF("Message details:");
-            LOG_INFOF("  - Time: %lld", simMessage->time);
-            LOG_INFOF("  - Sender: %d", simMessage->sender);
-            LOG_INFOF("  - Length: %d", simMessage->length);
-            LOG_INFOF("  - DataFormat: %d", simMessage->dataFormat);
-            LOG_INFOF("  - Data ptr: %p", simMessage->data);
+        for (uint32_t seed = 0; seed < 256; seed++) {
+            std::vector<int> slots(slotCount, -1);
+            bool collision = false;
 
-            // 验证数据长度是否合理
-            if (simMessage->length < sizeof(CMsg_PropagatedContinuousSoundListStruct)) {
-                LOG_ERRORF("CRITICAL: Message length too small! Expected >= %zu, got %d",
-                          sizeof(CMsg_PropagatedContinuousSoundListStruct), simMessage->length);
-                m_debugStats.failedProcessings++;
-                m_debugStats.lastFailedTime = simMessage->time;
-                m_debugStats.lastErrorMsg = "Message length too small";
-                return;
+            for (size_t i = 0; i < m_messageHandlers.size(); i++) {
+                uint32_t slot = ((m_messageHandlers[i].topicHash ^ seed) * 0x9E3779B1u) >> shift;
+                if (slots[slot] != -1) {
+                    collision = true;
+                    break;
+                }
+                slots[slot] = static_cast<int>(i);
             }
 
-            // 内存地址对齐检查
-            if (reinterpret_cast<uintptr_t>(simMessage->data) % alignof(CMsg_PropagatedContinuousSoundListStruct) != 0) {
-                LOG_WARNF("WARNING: Data pointer not properly aligned for struct access: %p", simMessage->data);
+            if (!collision) {
+                m_topicSlots.swap(slots);
+                m_topicHashSeed = seed;
+                m_topicHashShift = shift;
+                return true;
             }
+        }
+    }
 
-            try {
-                updateMultiTargetPropagatedSoundCache(simMessage); //
+    m_topicSlots.clear();
+    return false;
+}
 
+DeviceModel::TopicHandlerEntry* DeviceModel::findTopicHandler(const char* topic)
+{
+    if (m_topicSlots.empty()) {
+        return nullptr;
+    }
 
-                m_debugStats.successfulProcessings++;
-                m_debugStats.lastSuccessfulTime = simMessage->time;
-                LOG_INFOF("✓ MSG_PropagatedContinuousSound processed successfully");
-            } catch (const std::exception& e) {
-                m_debugStats.failedProcessings++;
-                m_debugStats.lastFailedTime = simMessage->time;
-                m_debugStats.lastErrorMsg = e.what();
-                LOG_ERRORF("CRASH: Exception in updateMultiTargetPropagatedSoundCache: %s", e.what());
-            } catch (...) {
-                m_debugStats.failedProcessings++;
-                m_debugStats.lastFailedTime = simMessage->time;
-                m_debugStats.lastErrorMsg = "Unknown exception";
-                LOG_ERRORF("CRASH: Unknown exception in updateMultiTargetPropagatedSoundCache");
-            }
+    uint32_t hash = TopicHash::topicHashRuntime(topic, EventTypeLen);
+    uint32_t slot = ((hash ^ m_topicHashSeed) * 0x9E3779B1u) >> m_topicHashShift;
+    int index = m_topicSlots[slot];
+    if (index < 0) {
+        return nullptr;
+    }
 
-            // 打印调试统计信息
-            LOG_INFOF("Debug Stats: Total=%d, Success=%d, Failed=%d, Success Rate=%.1f%%",
-                     m_debugStats.totalMessagesReceived, m_debugStats.successfulProcessings,
-                     m_debugStats.failedProcessings,
-                     (m_debugStats.totalMessagesReceived > 0 ?
-                      100.0 * m_debugStats.successfulProcessings / m_debugStats.totalMessagesReceived : 0.0));
+    // 槽位只保证已注册主题互不冲突，未注册主题仍需校验
+    TopicHandlerEntry& entry = m_messageHandlers[index];
+    if (entry.topicHash != hash || strncmp(entry.topic, topic, EventTypeLen) != 0) {
+        return nullptr;
+    }
+    return &entry;
+}
 
-            return; // 重要：在这里直接返回，避免继续执行原来的处理逻辑
-        }
+void DeviceModel::onPropagatedContinuousSound(CSimMessage* simMessage)
+{
+    m_debugStats.totalMessagesReceived++;
+
+    LOG_INFOF("=== MSG_PropagatedContinuousSound RECEIVED (#%d) ===",
+             m_debugStats.totalMessagesReceived);
+    LOG_INFOF("Message details:");
+    LOG_INFOF("  - Time: %lld", simMessage->time);
+    LOG_INFOF("  - Sender: %d", simMessage->sender);
+    LOG_INFOF("  - Length: %d", simMessage->length);
+    LOG_INFOF("  - DataFormat: %d", simMessage->dataFormat);
+    LOG_INFOF("  - Data ptr: %p", simMessage->data);
+
+    // 验证数据长度是否合理
+    if (simMessage->length < sizeof(CMsg_PropagatedContinuousSoundListStruct)) {
+        LOG_ERRORF("CRITICAL: Message length too small! Expected >= %zu, got %d",
+                  sizeof(CMsg_PropagatedContinuousSoundListStruct), simMessage->length);
+        m_debugStats.failedProcessings++;
+        m_debugStats.lastFailedTime = simMessage->time;
+        m_debugStats.lastErrorMsg = "Message length too small";
+        return;
+    }
 
-        else if (topic == MSG_PropagatedActivePulseSound) {
-            const CMsg_PropagatedActivePulseSoundListStruct* sounds = reinterpret_cast<const CMsg_PropagatedActivePulseSoundListStruct*>(simMessage->data);
-            std::cout << __FUNCTION__ << ":" << __LINE__ << " Received active pulse sound data, count: " << sounds->propagateActivePulseList.size() << std::endl;
-        }
-        else if (topic == MSG_PropagatedCommPulseSound) {
-            const CMsg_PropagatedCommPulseSoundListStruct* sounds = reinterpret_cast<const CMsg_PropagatedCommPulseSoundListStruct*>(simMessage->data);
-            std::cout << __FUNCTION__ << ":" << __LINE__ << " Received comm pulse sound data, count: " << sounds->propagatedCommList.size() << std::endl;
-        }
+    // 内存地址对齐检查
+    if (reinterpret_cast<uintptr_t>(simMessage->data) % alignof(CMsg_PropagatedContinuousSoundListStruct) != 0) {
+        LOG_WARNF("WARNING: Data pointer not properly aligned for struct access: %p", simMessage->data);
     }
-    else if (topic == MSG_EnvironmentNoiseToSonar) {
-        // 处理环境噪声数据
-        updateEnvironmentNoiseCache(simMessage);
+
+    try {
+        updateMultiTargetPropagatedSoundCache(simMessage);
+
+        m_debugStats.successfulProcessings++;
+        m_debugStats.lastSuccessfulTime = simMessage->time;
+        LOG_INFOF("✓ MSG_PropagatedContinuousSound processed successfully");
+    } catch (const std::exception& e) {
+        m_debugStats.failedProcessings++;
+        m_debugStats.lastFailedTime = simMessage->time;
+        m_debugStats.lastErrorMsg = e.what();
+        LOG_ERRORF("CRASH: Exception in updateMultiTargetPropagatedSoundCache: %s", e.what());
+    } catch (...) {
+        m_debugStats.failedProcessings++;
+        m_debugStats.lastFailedTime = simMessage->time;
+        m_debugStats.lastErrorMsg = "Unknown exception";
+        LOG_ERRORF("CRASH: Unknown exception in updateMultiTargetPropagatedSoundCache");
     }
-    else {
-        std::cout << __FUNCTION__ << ":" << __LINE__ << " Unknown message topic: " << topic << std::endl;
+
+    // 打印调试统计信息
+    LOG_INFOF("Debug Stats: Total=%d, Success=%d, Failed=%d, Success Rate=%.1f%%",
+             m_debugStats.totalMessagesReceived, m_debugStats.successfulProcessings,
+             m_debugStats.failedProcessings,
+             (m_debugStats.totalMessagesReceived > 0 ?
+              100.0 * m_debugStats.successfulProcessings / m_debugStats.totalMessagesReceived : 0.0));
+}
+
+void DeviceModel::onPropagatedActivePulseSound(CSimMessage* simMessage)
+{
+    if (!simMessage->data) {
+        LOG_WARN("Invalid propagated active pulse sound message");
+        return;
     }
+    const CMsg_PropagatedActivePulseSoundListStruct* sounds = reinterpret_cast<const CMsg_PropagatedActivePulseSoundListStruct*>(simMessage->data);
+    LOG_INFOF("Received active pulse sound data, count: %zu", sounds->propagateActivePulseList.size());
+}
+
+void DeviceModel::onPropagatedCommPulseSound(CSimMessage* simMessage)
+{
+    if (!simMessage->data) {
+        LOG_WARN("Invalid propagated comm pulse sound message");
+        return;
+    }
+    const CMsg_PropagatedCommPulseSoundListStruct* sounds = reinterpret_cast<const CMsg_PropagatedCommPulseSoundListStruct*>(simMessage->data);
+    LOG_INFOF("Received comm pulse sound data, count: %zu", sounds->propagatedCommList.size());
+}
+
+void DeviceModel::onPropagatedInstantSound(CSimMessage* simMessage)
+{
+    if (!simMessage->data) {
+        LOG_WARN("Invalid propagated instant sound message");
+        return;
+    }
+    const CMsg_PropagatedInstantSoundListStruct* sounds = reinterpret_cast<const CMsg_PropagatedInstantSoundListStruct*>(simMessage->data);
+    LOG_INFOF("Received instant sound data, count: %zu", sounds->propagatedInstantSoundList.size());
+}
+
+void DeviceModel::onReverberationSound(CSimMessage* simMessage)
+{
+    // 被动处理暂不使用混响数据，仅记录到达
+    LOG_DEBUGF("Received reverberation sound data, time: %lld, length: %u", simMessage->time, simMessage->length);
+}
+
+void DeviceModel::onPlatformSelfSoundMessage(CSimMessage* simMessage)
+{
+    // 平台自噪声（含X1平台区自噪声模型）以消息形式送达，转为数据接口统一处理
+    CSimData simData;
+    simData.time = simMessage->time;
+    simData.sender = simMessage->sender;
+    simData.receiver = simMessage->receiver;
+    simData.componentId = simMessage->senderComponentId;
+    simData.dataFormat = simMessage->dataFormat;
+    memcpy(simData.topic, simMessage->topic, EventTypeLen);
+    simData.data = simMessage->data;
+    simData.length = simMessage->length;
+
+    updatePlatformSelfSoundCache(&simData);
+}
+
+void DeviceModel::onMotionMessage(CSimMessage* simMessage)
+{
+    CSimData simData;
+    simData.time = simMessage->time;
+    simData.sender = simMessage->sender;
+    memcpy(simData.topic, simMessage->topic, EventTypeLen);
+    simData.data = simMessage->data;
+    simData.length = simMessage->length;
+
+    handleMotionData(&simData);
+}
+
+void DeviceModel::onControlParaMessage(CSimMessage* simMessage)
+{
+    // 导调功能配置目前没有可用字段，仅记录到达
+    LOG_INFOF("Received control para message: %s, time: %lld", simMessage->topic, simMessage->time);
 }
 
 // 全面的异常捕获、参数验证和crash定位
@@ -577,16 +859,9 @@ void DeviceModel::updateMultiTargetPropagatedSoundCache_yuan(CSimMessage* simMes
                         // ========== 第八层检查：频谱数据复制 ==========
                         LOG_INFOF("--- Copying spectrum data for target %d sonar %d ---", targetId, sonarID);
                         try {
-                            targetData.propagatedSpectrum.reserve(SPECTRUM_DATA_SIZE);
-                            LOG_INFOF("Reserved spectrum vector for %d elements", SPECTRUM_DATA_SIZE);
-
-                            for (int i = 0; i < SPECTRUM_DATA_SIZE; i++) {
-                                // 在关键位置进行额外检查
-                                if (i == 0 || i == SPECTRUM_DATA_SIZE/2 || i == SPECTRUM_DATA_SIZE-1) {
-                                    LOG_INFOF("Copying spectrum[%d] = %.6f", i, soundData.spectrumData[i]);
-                                }
-                                targetData.propagatedSpectrum.push_back(soundData.spectrumData[i]);
-                            }
+                            targetData.propagatedSpectrum = SpectrumBuffer::copyOf(
+                                soundData.spectrumData, SPECTRUM_DATA_SIZE,
+                                m_memoryAccount.category(MemoryAccount::CONTACT_SPECTRA));
                             LOG_INFOF("✓ Successfully copied %d spectrum elements", SPECTRUM_DATA_SIZE);
 
                         } catch (const std::exception& e) {
@@ -866,13 +1141,15 @@ void DeviceModel::updateMultiTargetPropagatedSoundCache_Enhanced(CSimMessage* si
                 targetData.isValid = true;
 
                 // 安全复制频谱数据
-                targetData.propagatedSpectrum.reserve(5296);
+                float* spectrumCopy = nullptr;
+                targetData.propagatedSpectrum = SpectrumBuffer::allocate(
+                    5296, spectrumCopy, m_memoryAccount.category(MemoryAccount::CONTACT_SPECTRA));
                 bool copySuccess = true;
 
                 for (int i = 0; i < 5296; i++) {
                     float value;
                     if (safeAccessSpectrumData(soundData, i, value)) {
-                        targetData.propagatedSpectrum.push_back(value);
+                        spectrumCopy[i] = value;
                     } else {
                         LOG_ERRORF("FATAL: Failed to copy spectrum[%d] for target %d sonar %d",
                                   i, targetId, sonarID);
@@ -918,6 +1195,8 @@ void DeviceModel::updateMultiTargetPropagatedSoundCache_Enhanced(CSimMessage* si
 
 void DeviceModel::updateMultiTargetPropagatedSoundCache(CSimMessage* simMessage)
 {
+    TRACE_ZONE_ID("updateMultiTargetPropagatedSoundCache", m_platformId);
+
     // 崩溃保护计数检查
     if (m_crashProtectionCount >= m_maxCrashProtections) {
         LOG_CRASH("Maximum crash protections reached (%d), function disabled to prevent infinite loops",
@@ -1015,238 +1294,37 @@ void DeviceModel::updateMultiTargetPropagatedSoundCache(CSimMessage* simMessage)
         }
 
         // ========== 第五级保护：清理过期数据 ==========
-        LOG_SAFE_INFO("Performing safe cleanup of expired data");
-
-        try {
-            for (int sonarID = 0; sonarID < 4; sonarID++) {
-                try {
-                    auto& targetsData = m_multiTargetCache.sonarTargetsData[sonarID];
-                    size_t beforeSize = targetsData.size();
-
-                    // 安全的过期数据移除
-                    auto removeIt = std::remove_if(targetsData.begin(), targetsData.end(),
-                        [currentTime](const TargetData& target) -> bool {
-                            try {
-                                return (currentTime - target.lastUpdateTime) > DATA_UPDATE_INTERVAL_MS;
-                            } catch (...) {
-                                return true; // 如果比较出错，就移除这个目标
-                            }
-                        });
-
-                    targetsData.erase(removeIt, targetsData.end());
-
-                    size_t afterSize = targetsData.size();
-                    LOG_SAFE_INFO("Sonar %d: cleaned %zu expired targets (before=%zu, after=%zu)",
-                                 sonarID, beforeSize - afterSize, beforeSize, afterSize);
-
-                } catch (const std::exception& e) {
-                    LOG_CRASH("Exception cleaning sonar %d expired data: %s", sonarID, e.what());
-                    safeResetTargetCache(sonarID, __FILENAME__, __FUNCTION__, __LINE__);
-                } catch (...) {
-                    LOG_CRASH("Unknown exception cleaning sonar %d expired data", sonarID);
-                    safeResetTargetCache(sonarID, __FILENAME__, __FUNCTION__, __LINE__);
-                }
-            }
-
-            LOG_SAFE_INFO("✓ Expired data cleanup completed");
-
-        } catch (const std::exception& e) {
-            LOG_CRASH("Exception during expired data cleanup: %s", e.what());
-            emergencyCleanup("Exception during expired data cleanup", __FILENAME__, __FUNCTION__, __LINE__);
-            return;
-        } catch (...) {
-            LOG_CRASH("Unknown exception during expired data cleanup");
-            emergencyCleanup("Unknown exception during expired data cleanup", __FILENAME__, __FUNCTION__, __LINE__);
+        if (!expirePropagatedTargets(currentTime)) {
             return;
         }
 
         // ========== 第六级保护：安全迭代目标数据 ==========
         LOG_SAFE_INFO("Starting safe iteration of %zu targets", listSize);
 
+        // 借用模式下持有载荷引用，目标频谱直接指向载荷
+        std::shared_ptr<const void> payloadOwner = retainPayload(simMessage->data);
+
         // 使用安全的迭代器处理
         bool iterationSuccess = safeIterateSTLContainer(
             soundListStruct->propagatedContinuousList,
-            [this, currentTime](const C_PropagatedContinuousSoundStruct& soundData, int targetIndex) -> bool {
+            [this, currentTime, &payloadOwner](const C_PropagatedContinuousSoundStruct& soundData, int targetIndex) -> bool {
 
                 try {
                     LOG_SAFE_INFO("=== Processing target %d ===", targetIndex);
                     LOG_SAFE_INFO("Target %d spectrumData size: %zu elements", targetIndex, sizeof(soundData.spectrumData)/sizeof(float));
 
-                    // ========== 第七级保护：验证目标数据 ==========
-                    // 验证基本数据字段
-                    if (std::isnan(soundData.arrivalSideAngle) || std::isinf(soundData.arrivalSideAngle) ||
-                        soundData.arrivalSideAngle < -360.0f || soundData.arrivalSideAngle > 360.0f) {
-                        LOG_SAFE_WARN("Invalid arrivalSideAngle for target %d: %f", targetIndex, soundData.arrivalSideAngle);
-                        return true; // 跳过这个目标，继续处理下一个
-                    }
-
-                    if (std::isnan(soundData.targetDistance) || std::isinf(soundData.targetDistance) ||
-                        soundData.targetDistance < 0.0f || soundData.targetDistance > 1000000.0f) {
-                        LOG_SAFE_WARN("Invalid targetDistance for target %d: %f", targetIndex, soundData.targetDistance);
+                    // ========== 第七、八级保护：验证目标数据与频谱数据 ==========
+                    if (!validatePropagatedTarget(targetIndex, soundData.arrivalSideAngle,
+                                                  soundData.targetDistance, soundData.spectrumData)) {
                         return true; // 跳过这个目标，继续处理下一个
                     }
 
                     LOG_SAFE_INFO("Target %d data: angle=%.3f°, distance=%.3fm, platType=%d",
                                  targetIndex, soundData.arrivalSideAngle, soundData.targetDistance, soundData.platType);
 
-                    // ========== 第八级保护：验证频谱数据 ==========
-                    LOG_SAFE_INFO("Validating spectrum data for target %d", targetIndex);
-                    LOG_SAFE_INFO("Target %d spectrumData array size: %zu elements", targetIndex, sizeof(soundData.spectrumData)/sizeof(float));
-
-                    // 检查关键位置的频谱数据
-                    std::vector<int> testIndices = {0, 1, 100, 1000, 2648, 5000, 5294, 5295};
-                    bool spectrumValid = true;
-
-                    for (int idx : testIndices) {
-                        float value;
-                        if (!SAFE_ACCESS_SPECTRUM(soundData.spectrumData, idx, value)) {
-                            LOG_SAFE_ERROR("Failed to access spectrum[%d] for target %d", idx, targetIndex);
-                            spectrumValid = false;
-                            break;
-                        }
-
-                        if (idx < 50) { // 只打印前几个避免日志过多
-                            LOG_SAFE_INFO("spectrum[%d] = %.6f", idx, value);
-                        }
-                    }
-
-                    if (!spectrumValid) {
-                        LOG_SAFE_WARN("Spectrum validation failed for target %d, skipping", targetIndex);
-                        return true; // 跳过这个目标
-                    }
-
                     // ========== 第九级保护：为每个声纳处理目标 ==========
-                    int targetId = targetIndex + 1000;
-                    float targetBearing = soundData.arrivalSideAngle;
-                    float targetDistance = soundData.targetDistance;
-
-                    for (int sonarID = 0; sonarID < 4; sonarID++) {
-                        try {
-                            LOG_SAFE_INFO("Processing target %d for sonar %d", targetId, sonarID);
-
-                            // 声纳状态检查
-                            auto stateIt = m_sonarStates.find(sonarID);
-                            if (stateIt == m_sonarStates.end()) {
-                                LOG_SAFE_INFO("Sonar %d state not found, skipping", sonarID);
-                                continue;
-                            }
-
-                            if (!stateIt->second.arrayWorkingState || !stateIt->second.passiveWorkingState) {
-                                LOG_SAFE_INFO("Sonar %d not enabled, skipping", sonarID);
-                                continue;
-                            }
-
-                            // 范围检查
-                            if (!isTargetInSonarRange(sonarID, targetBearing, targetDistance)) {
-                                LOG_SAFE_INFO("Target %d not in sonar %d range, skipping", targetId, sonarID);
-                                continue;
-                            }
-
-                            // ========== 第十级保护：安全的目标数据管理 ==========
-                            auto& targetsData = m_multiTargetCache.sonarTargetsData[sonarID];
-
-                            // 检查目标数限制
-                            if (targetsData.size() >= MAX_TARGETS_PER_SONAR) {
-                                LOG_SAFE_INFO("Sonar %d at max capacity (%d), checking replacement",
-                                             sonarID, MAX_TARGETS_PER_SONAR);
-
-                                try {
-                                    auto farthestIt = std::max_element(targetsData.begin(), targetsData.end(),
-                                        [](const TargetData& a, const TargetData& b) -> bool {
-                                            try {
-                                                return a.targetDistance < b.targetDistance;
-                                            } catch (...) {
-                                                return false; // 如果比较出错，保持原顺序
-                                            }
-                                        });
-
-                                    if (farthestIt != targetsData.end() && targetDistance < farthestIt->targetDistance) {
-                                        LOG_SAFE_INFO("Replacing farthest target (%.1fm) with closer target (%.1fm)",
-                                                      farthestIt->targetDistance, targetDistance);
-                                        targetsData.erase(farthestIt);
-                                    } else {
-                                        LOG_SAFE_INFO("New target not closer than existing, skipping");
-                                        continue;
-                                    }
-
-                                } catch (const std::exception& e) {
-                                    LOG_CRASH("Exception during target replacement for sonar %d: %s", sonarID, e.what());
-                                    continue;
-                                } catch (...) {
-                                    LOG_CRASH("Unknown exception during target replacement for sonar %d", sonarID);
-                                    continue;
-                                }
-                            }
-
-                            // ========== 第十一级保护：创建和复制目标数据 ==========
-                            try {
-                                TargetData targetData;
-                                targetData.targetId = targetId;
-                                targetData.targetDistance = targetDistance;
-                                targetData.targetBearing = targetBearing;
-                                targetData.lastUpdateTime = currentTime;
-                                targetData.isValid = true;
-
-                                // 安全复制频谱数据
-                                LOG_SAFE_INFO("Copying spectrum data for target %d sonar %d", targetId, sonarID);
-
-                                targetData.propagatedSpectrum.clear();
-                                targetData.propagatedSpectrum.reserve(5296);
-
-                                bool copySuccess = true;
-                                for (int i = 0; i < 5296; i++) {
-                                    float value;
-                                    if (SAFE_ACCESS_SPECTRUM(soundData.spectrumData, i, value)) {
-                                        targetData.propagatedSpectrum.push_back(value);
-                                    } else {
-                                        LOG_SAFE_ERROR("Failed to copy spectrum[%d], using 0.0", i);
-                                        targetData.propagatedSpectrum.push_back(0.0f);
-                                        copySuccess = false;
-                                    }
-                                }
-
-                                if (!copySuccess) {
-                                    LOG_SAFE_WARN("Spectrum copy had errors for target %d sonar %d, but continuing",
-                                                  targetId, sonarID);
-                                }
-
-                                // 安全更新目标数据
-                                auto existingIt = std::find_if(targetsData.begin(), targetsData.end(),
-                                    [targetId](const TargetData& target) -> bool {
-                                        try {
-                                            return target.targetId == targetId;
-                                        } catch (...) {
-                                            return false;
-                                        }
-                                    });
-
-                                if (existingIt != targetsData.end()) {
-                                    *existingIt = std::move(targetData);
-                                    LOG_SAFE_INFO("✓ Updated existing target %d for sonar %d", targetId, sonarID);
-                                } else {
-                                    targetsData.push_back(std::move(targetData));
-                                    LOG_SAFE_INFO("✓ Added new target %d for sonar %d", targetId, sonarID);
-                                }
-
-                            } catch (const std::bad_alloc& e) {
-                                LOG_CRASH("Memory allocation failed for target %d sonar %d: %s", targetId, sonarID, e.what());
-                                continue;
-                            } catch (const std::exception& e) {
-                                LOG_CRASH("Exception creating target data for target %d sonar %d: %s", targetId, sonarID, e.what());
-                                continue;
-                            } catch (...) {
-                                LOG_CRASH("Unknown exception creating target data for target %d sonar %d", targetId, sonarID);
-                                continue;
-                            }
-
-                        } catch (const std::exception& e) {
-                            LOG_CRASH("Exception in sonar %d processing for target %d: %s", sonarID, targetId, e.what());
-                            continue;
-                        } catch (...) {
-                            LOG_CRASH("Unknown exception in sonar %d processing for target %d", sonarID, targetId);
-                            continue;
-                        }
-                    }
+                    ingestPropagatedTarget(targetIndex, soundData.arrivalSideAngle, soundData.targetDistance,
+                                           soundData.spectrumData, currentTime, payloadOwner);
 
                     LOG_SAFE_INFO("✓ Completed processing target %d", targetIndex);
                     return true; // 继续处理下一个目标
@@ -1284,16 +1362,323 @@ void DeviceModel::updateMultiTargetPropagatedSoundCache(CSimMessage* simMessage)
     }
 }
 
+bool DeviceModel::expirePropagatedTargets(int64 currentTime)
+{
+    PhaseScope expiryPhase(this, PHASE_EXPIRY);
+    TRACE_ZONE_ID("expirePropagatedTargets", m_platformId);
+    LOG_SAFE_INFO("Performing safe cleanup of expired data");
+
+    try {
+        for (int sonarID = 0; sonarID < 4; sonarID++) {
+            try {
+                auto& targetsData = m_multiTargetCache.sonarTargetsData[sonarID];
+                size_t beforeSize = targetsData.size();
+
+                // 安全的过期数据移除
+                auto removeIt = std::remove_if(targetsData.begin(), targetsData.end(),
+                    [currentTime](const TargetData& target) -> bool {
+                        try {
+                            return (currentTime - target.lastUpdateTime) > DATA_UPDATE_INTERVAL_MS;
+                        } catch (...) {
+                            return true; // 如果比较出错，就移除这个目标
+                        }
+                    });
+
+                targetsData.erase(removeIt, targetsData.end());
+
+                size_t afterSize = targetsData.size();
+                LOG_SAFE_INFO("Sonar %d: cleaned %zu expired targets (before=%zu, after=%zu)",
+                             sonarID, beforeSize - afterSize, beforeSize, afterSize);
+
+            } catch (const std::exception& e) {
+                LOG_CRASH("Exception cleaning sonar %d expired data: %s", sonarID, e.what());
+                safeResetTargetCache(sonarID, __FILENAME__, __FUNCTION__, __LINE__);
+            } catch (...) {
+                LOG_CRASH("Unknown exception cleaning sonar %d expired data", sonarID);
+                safeResetTargetCache(sonarID, __FILENAME__, __FUNCTION__, __LINE__);
+            }
+        }
+
+        LOG_SAFE_INFO("✓ Expired data cleanup completed");
+        return true;
+
+    } catch (const std::exception& e) {
+        LOG_CRASH("Exception during expired data cleanup: %s", e.what());
+        emergencyCleanup("Exception during expired data cleanup", __FILENAME__, __FUNCTION__, __LINE__);
+        return false;
+    } catch (...) {
+        LOG_CRASH("Unknown exception during expired data cleanup");
+        emergencyCleanup("Unknown exception during expired data cleanup", __FILENAME__, __FUNCTION__, __LINE__);
+        return false;
+    }
+}
+
+bool DeviceModel::validatePropagatedTarget(int targetIndex, float arrivalSideAngle, float targetDistance,
+                                           const float* spectrumData)
+{
+    // 验证基本数据字段
+    if (std::isnan(arrivalSideAngle) || std::isinf(arrivalSideAngle) ||
+        arrivalSideAngle < -360.0f || arrivalSideAngle > 360.0f) {
+        LOG_SAFE_WARN("Invalid arrivalSideAngle for target %d: %f", targetIndex, arrivalSideAngle);
+        return false;
+    }
+
+    if (std::isnan(targetDistance) || std::isinf(targetDistance) ||
+        targetDistance < 0.0f || targetDistance > 1000000.0f) {
+        LOG_SAFE_WARN("Invalid targetDistance for target %d: %f", targetIndex, targetDistance);
+        return false;
+    }
+
+    // 检查关键位置的频谱数据
+    LOG_SAFE_INFO("Validating spectrum data for target %d", targetIndex);
+    static const int testIndices[] = {0, 1, 100, 1000, 2648, 5000, 5294, 5295};
+
+    for (int idx : testIndices) {
+        float value;
+        if (!SAFE_ACCESS_SPECTRUM(spectrumData, idx, value)) {
+            LOG_SAFE_ERROR("Failed to access spectrum[%d] for target %d", idx, targetIndex);
+            LOG_SAFE_WARN("Spectrum validation failed for target %d, skipping", targetIndex);
+            return false;
+        }
+
+        if (idx < 50) { // 只打印前几个避免日志过多
+            LOG_SAFE_INFO("spectrum[%d] = %.6f", idx, value);
+        }
+    }
+
+    return true;
+}
+
+SpectrumBuffer DeviceModel::acquireSpectrum(const float* spectrumData, const std::shared_ptr<const void>& payloadOwner)
+{
+    // 借用模式：载荷全部为有限值时直接引用，避免拷贝
+    if (payloadOwner) {
+        bool allFinite = true;
+        for (int i = 0; i < SPECTRUM_DATA_SIZE; i++) {
+            if (!std::isfinite(spectrumData[i])) {
+                allFinite = false;
+                break;
+            }
+        }
+        if (allFinite) {
+            return SpectrumBuffer::borrow(payloadOwner, spectrumData, SPECTRUM_DATA_SIZE);
+        }
+        LOG_SAFE_WARN("Spectrum contains NaN/Inf, falling back to copy");
+    }
+
+    // 拷贝模式：逐点安全读取，异常值置0
+    float* spectrumCopy = nullptr;
+    SpectrumBuffer spectrum = SpectrumBuffer::allocate(
+        SPECTRUM_DATA_SIZE, spectrumCopy, m_memoryAccount.category(MemoryAccount::CONTACT_SPECTRA));
+
+    bool copySuccess = true;
+    for (int i = 0; i < SPECTRUM_DATA_SIZE; i++) {
+        float value;
+        if (SAFE_ACCESS_SPECTRUM(spectrumData, i, value)) {
+            spectrumCopy[i] = value;
+        } else {
+            LOG_SAFE_ERROR("Failed to copy spectrum[%d], using 0.0", i);
+            spectrumCopy[i] = 0.0f;
+            copySuccess = false;
+        }
+    }
+
+    if (!copySuccess) {
+        LOG_SAFE_WARN("Spectrum copy had errors, but continuing");
+    }
+    return spectrum;
+}
+
+std::shared_ptr<const void> DeviceModel::retainPayload(const void* data)
+{
+    if (!m_borrowedPayloadEnabled || !m_agentExtension || !data) {
+        return std::shared_ptr<const void>();
+    }
+    return m_agentExtension->retainPayload(data);
+}
+
+void DeviceModel::ingestPropagatedTarget(int targetIndex, float targetBearing, float targetDistance,
+                                         const float* spectrumData, int64 currentTime,
+                                         const std::shared_ptr<const void>& payloadOwner)
+{
+    int targetId = targetIndex + 1000;
+
+    // 扇区筛选：先确定目标落在哪些已启用声纳的范围内
+    bool inSector[4];
+    {
+        PhaseScope sectorPhase(this, PHASE_SECTOR);
+        for (int sonarID = 0; sonarID < 4; sonarID++) {
+            auto stateIt = m_sonarStates.find(sonarID);
+            inSector[sonarID] = stateIt != m_sonarStates.end() &&
+                                stateIt->second.arrayWorkingState && stateIt->second.passiveWorkingState &&
+                                isTargetInSonarRange(sonarID, targetBearing, targetDistance);
+        }
+    }
+
+    // 同一目标的频谱在各声纳间共享，只提取一次（首次被某个声纳接收时）
+    SpectrumBuffer spectrum;
+
+    for (int sonarID = 0; sonarID < 4; sonarID++) {
+        try {
+            LOG_SAFE_INFO("Processing target %d for sonar %d", targetId, sonarID);
+
+            // 声纳未启用或不在范围内
+            if (!inSector[sonarID]) {
+                LOG_SAFE_INFO("Target %d not in enabled sonar %d range, skipping", targetId, sonarID);
+                continue;
+            }
+
+            // ========== 第十级保护：安全的目标数据管理 ==========
+            auto& targetsData = m_multiTargetCache.sonarTargetsData[sonarID];
+
+            // 检查目标数限制
+            if (targetsData.size() >= MAX_TARGETS_PER_SONAR) {
+                LOG_SAFE_INFO("Sonar %d at max capacity (%d), checking replacement",
+                             sonarID, MAX_TARGETS_PER_SONAR);
+
+                auto farthestIt = std::max_element(targetsData.begin(), targetsData.end(),
+                    [](const TargetData& a, const TargetData& b) -> bool {
+                        return a.targetDistance < b.targetDistance;
+                    });
+
+                if (farthestIt != targetsData.end() && targetDistance < farthestIt->targetDistance) {
+                    LOG_SAFE_INFO("Replacing farthest target (%.1fm) with closer target (%.1fm)",
+                                  farthestIt->targetDistance, targetDistance);
+                    targetsData.erase(farthestIt);
+                } else {
+                    LOG_SAFE_INFO("New target not closer than existing, skipping");
+                    continue;
+                }
+            }
+
+            // ========== 第十一级保护：创建和复制目标数据 ==========
+            TargetData targetData;
+            targetData.targetId = targetId;
+            targetData.targetDistance = targetDistance;
+            targetData.targetBearing = targetBearing;
+            targetData.lastUpdateTime = currentTime;
+            targetData.isValid = true;
+
+            // 安全获取频谱数据（借用或拷贝）
+            if (spectrum.empty()) {
+                LOG_SAFE_INFO("Acquiring spectrum data for target %d sonar %d", targetId, sonarID);
+                spectrum = acquireSpectrum(spectrumData, payloadOwner);
+            }
+            targetData.propagatedSpectrum = spectrum;
+
+            // 记录本声纳频带内的峰值，供计算时求X的上界
+            if (m_boundPruningEnabled) {
+                targetData.bandPeakLevel = calculateBandPeakLevel(spectrum, sonarID);
+            }
+
+            // 安全更新目标数据
+            auto existingIt = std::find_if(targetsData.begin(), targetsData.end(),
+                [targetId](const TargetData& target) -> bool {
+                    return target.targetId == targetId;
+                });
+
+            if (existingIt != targetsData.end()) {
+                *existingIt = std::move(targetData);
+                LOG_SAFE_INFO("✓ Updated existing target %d for sonar %d", targetId, sonarID);
+            } else {
+                targetsData.push_back(std::move(targetData));
+                LOG_SAFE_INFO("✓ Added new target %d for sonar %d", targetId, sonarID);
+            }
+            m_contactsIngested.fetch_add(1, std::memory_order_relaxed);
+
+        } catch (const std::bad_alloc& e) {
+            LOG_CRASH("Memory allocation failed for target %d sonar %d: %s", targetId, sonarID, e.what());
+            continue;
+        } catch (const std::exception& e) {
+            LOG_CRASH("Exception in sonar %d processing for target %d: %s", sonarID, targetId, e.what());
+            continue;
+        } catch (...) {
+            LOG_CRASH("Unknown exception in sonar %d processing for target %d", sonarID, targetId);
+            continue;
+        }
+    }
+}
+
+void DeviceModel::updateMultiTargetPropagatedSoundCacheFlat(CSimMessage* simMessage)
+{
+    TRACE_ZONE_ID("updateMultiTargetPropagatedSoundCacheFlat", m_platformId);
+    m_debugStats.totalMessagesReceived++;
+
+    try {
+        // 扁平格式：校验头后直接在载荷上线性扫描，不经过std::list
+        FlatSoundListView view;
+        if (!view.attach(simMessage->data, simMessage->length) || view.kind() != FLAT_SOUND_CONTINUOUS) {
+            LOG_SAFE_ERROR("Invalid flat propagated sound payload: data=%p, length=%u",
+                           simMessage->data, simMessage->length);
+            m_debugStats.failedProcessings++;
+            m_debugStats.lastFailedTime = simMessage->time;
+            m_debugStats.lastErrorMsg = "Invalid flat payload";
+            return;
+        }
+
+        int64 currentTime = simMessage->time;
+        uint32 count = view.count();
+        std::shared_ptr<const void> payloadOwner = retainPayload(simMessage->data);
+        LOG_SAFE_INFO("Flat propagated sound received: time=%lld, count=%u", currentTime, count);
+
+        if (count == 0) {
+            for (int sonarID = 0; sonarID < 4; sonarID++) {
+                safeResetTargetCache(sonarID, __FILENAME__, __FUNCTION__, __LINE__);
+            }
+        } else if (expirePropagatedTargets(currentTime)) {
+            for (uint32 i = 0; i < count; i++) {
+                const CFlatSoundRecord& record = view.record(i);
+                if (!validatePropagatedTarget(static_cast<int>(i), record.arrivalSideAngle,
+                                              record.targetDistance, record.spectrumData)) {
+                    continue;
+                }
+                int contactIndex = record.contactId > 0 ? static_cast<int>(record.contactId) - 1 : static_cast<int>(i);
+                ingestPropagatedTarget(contactIndex, record.arrivalSideAngle, record.targetDistance,
+                                       record.spectrumData, currentTime, payloadOwner);
+            }
+        }
+
+        m_debugStats.successfulProcessings++;
+        m_debugStats.lastSuccessfulTime = simMessage->time;
+
+    } catch (const std::exception& e) {
+        m_debugStats.failedProcessings++;
+        m_debugStats.lastFailedTime = simMessage->time;
+        m_debugStats.lastErrorMsg = e.what();
+        LOG_CRASH("Exception in updateMultiTargetPropagatedSoundCacheFlat: %s", e.what());
+        emergencyCleanup("Exception in flat ingestion", __FILENAME__, __FUNCTION__, __LINE__);
+    } catch (...) {
+        m_debugStats.failedProcessings++;
+        m_debugStats.lastFailedTime = simMessage->time;
+        m_debugStats.lastErrorMsg = "Unknown exception";
+        LOG_CRASH("Unknown exception in updateMultiTargetPropagatedSoundCacheFlat");
+        emergencyCleanup("Unknown exception in flat ingestion", __FILENAME__, __FUNCTION__, __LINE__);
+    }
+}
+
+void DeviceModel::onPropagatedPulseSoundFlat(CSimMessage* simMessage)
+{
+    FlatSoundListView view;
+    if (!view.attach(simMessage->data, simMessage->length)) {
+        LOG_WARNF("Invalid flat pulse sound payload: %s", simMessage->topic);
+        return;
+    }
+    LOG_INFOF("Received flat sound data (kind=%u), count: %u", view.kind(), view.count());
+}
+
 bool DeviceModel::isTargetInSonarRange(int sonarID, float targetBearing, float targetDistance)
+{
+    // 按本艇当前航向判断
+    return isTargetInSonarRange(sonarID, targetBearing, targetDistance, static_cast<float>(m_platformMotion.rotation));
+}
+
+bool DeviceModel::isTargetInSonarRange(int sonarID, float targetBearing, float targetDistance, float ownShipHeading)
 {
     // 检查距离范围
     if (targetDistance <= 0 || targetDistance > MAX_DETECTION_RANGE) {
         return false;
     }
 
-    // 获取本艇当前航向
-    float ownShipHeading = static_cast<float>(m_platformMotion.rotation);
-
     LOG_INFOF("=== Sonar Range Check Debug ===");
     LOG_INFOF("SonarID: %d, Target bearing: %.1f°, Target distance: %.1fm",
               sonarID, targetBearing, targetDistance);
@@ -1356,98 +1741,443 @@ bool DeviceModel::isTargetInSonarRange(int sonarID, float targetBearing, float t
     LOG_INFOF("=== End Debug ===");
     return inRange;
 }
-std::pair<float, float> DeviceModel::getRelativeSonarAngleRange(int sonarID)
+std::pair<float, float> DeviceModel::getRelativeSonarAngleRange(int sonarID)
+{
+    switch (sonarID) {
+        case 0: // 艏端声纳 - 前向扇形区域（相对艏向 -45° to +45°）
+            return std::make_pair(-45.0f, 45.0f);
+
+        case 2: // 粗拖声纳 - 后向扇形区域（相对艏向后方90度扇形）
+            return std::make_pair(135.0f, 225.0f);
+
+        case 3: // 细拖声纳 - 后向扇形区域（相对艏向后方120度扇形）
+            return std::make_pair(120.0f, 240.0f);
+
+        default:
+            LOG_WARNF("Unknown sonar ID %d, using default range", sonarID);
+            return std::make_pair(0.0f, 360.0f);
+    }
+}
+
+void DeviceModel::updateEnvironmentNoiseCache(CSimMessage* simMessage)
+{
+    if (!simMessage || !simMessage->data) {
+        LOG_WARN("Invalid environment noise message");
+        return;
+    }
+
+    const CMsg_EnvironmentNoiseToSonarStruct* noiseData =
+        reinterpret_cast<const CMsg_EnvironmentNoiseToSonarStruct*>(simMessage->data);
+
+    LOG_INFO("Updating environment noise cache");
+
+    // 提取环境噪声频谱数据（借用模式下引用载荷）
+    std::shared_ptr<const void> payloadOwner = retainPayload(simMessage->data);
+    SpectrumBuffer spectrum = payloadOwner
+        ? SpectrumBuffer::borrow(payloadOwner, noiseData->spectrumData, SPECTRUM_DATA_SIZE)
+        : SpectrumBuffer::copyOf(noiseData->spectrumData, SPECTRUM_DATA_SIZE,
+                                 m_memoryAccount.category(MemoryAccount::NOISE_SPECTRA));
+
+    // 环境噪声对所有声纳位置都是相同的，各声纳共享同一份频谱
+    for (int sonarID = 0; sonarID < 4; sonarID++) {
+        m_multiTargetCache.environmentNoiseSpectrumMap[sonarID] = spectrum;
+    }
+
+    LOG_INFOF("Updated environment noise cache for all sonars, spectrum size: %d, borrowed: %d",
+              spectrum.size(), spectrum.isBorrowed());
+
+    m_multiTargetCache.lastEnvironmentNoiseTime = simMessage->time;
+    LOG_INFOF("Environment noise time updated to: %lld", simMessage->time);
+}
+
+void DeviceModel::step(int64 curTime, int32 step)
+{
+    LOG_INFO("Multi-target sonar model step");
+
+    if (!m_agent || !m_initialized)
+    {
+        return;
+    }
+
+    // 串行宿主：准备与提交连续执行
+    prepareStep(curTime, step);
+    commitStep();
+}
+
+void DeviceModel::prepareStep(int64 curTime, int32 step)
+{
+    (void)step;
+    TRACE_ZONE_ID("prepareStep", m_platformId);
+
+    m_stepPrepared = false;
+    if (!m_agent || !m_initialized)
+    {
+        return;
+    }
+    this->curTime = curTime;
+
+    // 批量获取本平台的订阅数据（平台机动信息、平台自噪声）
+    int64 platformId = m_platformId;
+    const char* inputTopics[2] = { Data_Motion, Data_PlatformSelfSound };
+    int64 inputPlatformIds[2] = { platformId, platformId };
+    CSimData* inputs[2] = { nullptr, nullptr };
+    if (m_agentExtension) {
+        m_agentExtension->getSubscribeSimDataBatch(inputTopics, inputPlatformIds, inputs, 2);
+    } else {
+        for (int i = 0; i < 2; i++) {
+            inputs[i] = m_agent->getSubscribeSimData(inputTopics[i], inputPlatformIds[i]);
+        }
+    }
+
+    CSimData* motionData = inputs[0];
+    if (motionData) {
+        handleMotionData(motionData);
+    }
+
+    CSimData* selfSoundData = inputs[1];
+    if (selfSoundData) {
+        LOG_INFOF("Retrieved platform self sound data with timestamp: %lld", selfSoundData->time);
+        updatePlatformSelfSoundCache(selfSoundData);
+    } else {
+        LOG_WARN("Failed to retrieve platform self sound data in prepareStep()");
+        LOG_WARNF("Topic: %s, PlatformId: %lld", Data_PlatformSelfSound, platformId);
+    }
+
+    uint64 activeContacts = 0;
+    for (const auto& entry : m_multiTargetCache.sonarTargetsData) {
+        activeContacts += entry.second.size();
+    }
+    m_activeContacts.store(activeContacts, std::memory_order_relaxed);
+
+    if (m_pipelineThread.joinable()) {
+        // 流水线：取走上一帧的结果留待本步发布，再把本步输入的快照交给工作线程
+        waitForStepPipeline();
+        {
+            std::lock_guard<std::mutex> lock(m_pipelineMutex);
+            m_publishStepFrame = m_readyStepFrame;
+            m_readyStepFrame = -1;
+        }
+
+        // 工作线程空闲，两帧的容器都可读取
+        refreshContainerMemory();
+        updateMemoryEstimate();
+
+        StepFrame& frame = m_stepFrames[m_nextStepFrame];
+        frame.time = curTime;
+        frame.platformHeading = static_cast<float>(m_platformMotion.rotation);
+        assignListMap(frame.cache.sonarTargetsData, m_multiTargetCache.sonarTargetsData);
+        frame.cache.platformSelfSoundSpectrumMap = m_multiTargetCache.platformSelfSoundSpectrumMap;
+        frame.cache.environmentNoiseSpectrumMap = m_multiTargetCache.environmentNoiseSpectrumMap;
+
+        {
+            std::lock_guard<std::mutex> lock(m_pipelineMutex);
+            m_queuedStepFrame = m_nextStepFrame;
+        }
+        m_pipelineCond.notify_all();
+        m_nextStepFrame = 1 - m_nextStepFrame;
+
+        m_stepPrepared = true;
+        return;
+    }
+
+    // 执行多目标声纳方程计算
+    performMultiTargetSonarEquationCalculation(m_multiTargetCache);
+
+    // 组装各声纳的被动探测结果，留待提交阶段发送
+    float platformHeading = static_cast<float>(m_platformMotion.rotation);
+    {
+        PhaseScope assemblePhase(this, PHASE_ASSEMBLE);
+        TRACE_ZONE_ID("assemblePassiveSonarResult", m_platformId);
+        for (int sonarID = 0; sonarID < 4; sonarID++) {
+            m_passiveSonarResultReady[sonarID] = assemblePassiveSonarResult(
+                sonarID, getEffectiveThreshold(sonarID), curTime, m_multiTargetCache.multiTargetEquationResults,
+                platformHeading, m_passiveSonarResults[sonarID]);
+        }
+    }
+
+    refreshContainerMemory();
+    updateMemoryEstimate();
+
+    m_stepPrepared = true;
+}
+
+void DeviceModel::commitStep()
+{
+    if (!m_stepPrepared) {
+        return;
+    }
+    m_stepPrepared = false;
+    m_stepCount.fetch_add(1, std::memory_order_relaxed);
+    PhaseScope publishPhase(this, PHASE_PUBLISH);
+    TRACE_ZONE_ID("commitStep", m_platformId);
+
+    // 声纳工作状态随本步结果一起批量发送
+    m_workState.platformId = m_platformId;
+    m_workState.maxDetectRange = MAX_DETECTION_RANGE;
+    m_workState.sonarOnOff = true;
+    CSimMessage cSimMessage;
+    cSimMessage.sender = m_platformId;
+    memset(cSimMessage.topic,0,EventTypeLen);
+    memcpy(cSimMessage.topic,Msg_SonarWorkState,sizeof(Msg_SonarWorkState));
+    cSimMessage.data=&m_workState;
+    queueMessage(cSimMessage);
+
+    for (int sonarID = 0; sonarID < 4; sonarID++) {
+        if (m_passiveSonarResultReady[sonarID]) {
+            queuePassiveSonarResult(m_passiveSonarResults[sonarID], curTime);
+            m_passiveSonarResultReady[sonarID] = false;
+        }
+    }
+
+    // 流水线：发布上一步计算完成的帧，方程结果同时供界面查询
+    if (m_publishStepFrame >= 0) {
+        StepFrame& frame = m_stepFrames[m_publishStepFrame];
+        for (int sonarID = 0; sonarID < 4; sonarID++) {
+            if (frame.resultReady[sonarID]) {
+                queuePassiveSonarResult(frame.results[sonarID], frame.time);
+                frame.resultReady[sonarID] = false;
+            }
+        }
+        m_multiTargetCache.multiTargetEquationResults.swap(frame.cache.multiTargetEquationResults);
+        m_publishStepFrame = -1;
+    }
+
+    flushPendingMessages();
+    publishPerformanceStats(curTime);
+}
+
+void DeviceModel::setBoundPruningEnabled(bool enabled)
+{
+    waitForStepPipeline();
+    m_boundPruningEnabled = enabled;
+    LOG_INFOF("Equation upper-bound pruning %s", enabled ? "enabled" : "disabled");
+}
+
+DeviceModel::BoundPruningStats DeviceModel::getBoundPruningStats() const
+{
+    BoundPruningStats stats;
+    stats.evaluated = m_boundEvaluatedCount.load(std::memory_order_relaxed);
+    stats.pruned = m_boundPrunedCount.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void DeviceModel::setMemoryBudget(size_t bytes)
+{
+    m_globalProtection.memoryBudget = bytes;
+    LOG_INFOF("Memory budget set to %zu bytes", bytes);
+}
+
+MemoryAccount::Snapshot DeviceModel::getMemoryStats() const
+{
+    return m_memoryAccount.snapshot();
+}
+
+const char* DeviceModel::perfPhaseName(int phase)
+{
+    static const char* const names[PHASE_COUNT] = {
+        "ingest", "expiry", "sector", "equation", "assemble", "publish"
+    };
+    return (phase >= 0 && phase < PHASE_COUNT) ? names[phase] : "unknown";
+}
+
+void DeviceModel::setPerformanceStatsEnabled(bool enabled)
+{
+    waitForStepPipeline();
+    m_perfStatsEnabled = enabled;
+    LOG_INFOF("Phase latency recording %s", enabled ? "enabled" : "disabled");
+}
+
+DeviceModel::PerformanceStats DeviceModel::getPerformanceStats() const
+{
+    PerformanceStats stats;
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        stats.phases[phase] = m_phaseLatency[phase].summary();
+    }
+    stats.steps = m_stepCount.load(std::memory_order_relaxed);
+    stats.messages = m_messageCount.load(std::memory_order_relaxed);
+    stats.contactsIngested = m_contactsIngested.load(std::memory_order_relaxed);
+    stats.activeContacts = m_activeContacts.load(std::memory_order_relaxed);
+    stats.contactsEvaluated = m_boundEvaluatedCount.load(std::memory_order_relaxed) -
+                              m_evaluatedBase.load(std::memory_order_relaxed);
+    stats.contactsPruned = m_boundPrunedCount.load(std::memory_order_relaxed) -
+                           m_prunedBase.load(std::memory_order_relaxed);
+    stats.allocations = m_memoryAccount.totalAllocations() - m_allocationBase.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void DeviceModel::resetPerformanceStats()
 {
-    switch (sonarID) {
-        case 0: // 艏端声纳 - 前向扇形区域（相对艏向 -45° to +45°）
-            return std::make_pair(-45.0f, 45.0f);
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        m_phaseLatency[phase].reset();
+    }
+    m_stepCount = 0;
+    m_messageCount = 0;
+    m_contactsIngested = 0;
+    m_evaluatedBase = m_boundEvaluatedCount.load(std::memory_order_relaxed);
+    m_prunedBase = m_boundPrunedCount.load(std::memory_order_relaxed);
+    m_allocationBase = m_memoryAccount.totalAllocations();
+}
 
-        case 2: // 粗拖声纳 - 后向扇形区域（相对艏向后方90度扇形）
-            return std::make_pair(135.0f, 225.0f);
+void DeviceModel::setPerformanceStatsInterval(int64 intervalMs)
+{
+    m_perfStatsInterval = intervalMs > 0 ? intervalMs : 0;
+    m_lastPerfStatsTime = -1;
+    LOG_INFOF("Performance stats publish interval: %lld ms", m_perfStatsInterval);
+}
 
-        case 3: // 细拖声纳 - 后向扇形区域（相对艏向后方120度扇形）
-            return std::make_pair(120.0f, 240.0f);
+void DeviceModel::setPhaseProbe(PhaseProbe* probe)
+{
+    m_phaseProbe = probe;
+}
 
-        default:
-            LOG_WARNF("Unknown sonar ID %d, using default range", sonarID);
-            return std::make_pair(0.0f, 360.0f);
+void DeviceModel::publishPerformanceStats(int64 currentTime)
+{
+    if (m_perfStatsInterval <= 0 || !m_agent) {
+        return;
+    }
+    // 仿真时间回退（重新开始）时立即发布
+    if (m_lastPerfStatsTime >= 0 && currentTime >= m_lastPerfStatsTime &&
+        currentTime - m_lastPerfStatsTime < m_perfStatsInterval) {
+        return;
+    }
+    m_lastPerfStatsTime = currentTime;
+
+    static_assert(DEVICE_PERF_PHASE_COUNT == PHASE_COUNT, "Data_DevicePerfStats_Topic phase count mismatch");
+    PerformanceStats stats = getPerformanceStats();
+    m_perfStatsData.platformId = m_platformId;
+    m_perfStatsData.time = currentTime;
+    for (int phase = 0; phase < PHASE_COUNT; phase++) {
+        const LatencyHistogram::Summary& summary = stats.phases[phase];
+        CData_DevicePhaseLatency& latency = m_perfStatsData.phases[phase];
+        latency.count = summary.count;
+        latency.minNs = summary.minNs;
+        latency.meanNs = summary.meanNs;
+        latency.p50Ns = summary.p50Ns;
+        latency.p90Ns = summary.p90Ns;
+        latency.p99Ns = summary.p99Ns;
+        latency.p999Ns = summary.p999Ns;
+        latency.maxNs = summary.maxNs;
     }
+    m_perfStatsData.steps = stats.steps;
+    m_perfStatsData.messages = stats.messages;
+    m_perfStatsData.contactsIngested = stats.contactsIngested;
+    m_perfStatsData.activeContacts = stats.activeContacts;
+    m_perfStatsData.contactsEvaluated = stats.contactsEvaluated;
+    m_perfStatsData.contactsPruned = stats.contactsPruned;
+    m_perfStatsData.allocations = stats.allocations;
+    m_perfStatsData.memoryBytes = m_memoryAccount.totalBytes();
+
+    CSimData simData;
+    simData.time = currentTime;
+    simData.sender = m_platformId;
+    simData.dataFormat = STRUCT;
+    memcpy(simData.topic, Data_DevicePerfStats_Topic, strlen(Data_DevicePerfStats_Topic) + 1);
+    simData.data = &m_perfStatsData;
+    simData.length = sizeof(CData_DevicePerfStats);
+    m_agent->publishSimData(&simData);
 }
 
-void DeviceModel::updateEnvironmentNoiseCache(CSimMessage* simMessage)
+void DeviceModel::setStepPipelineEnabled(bool enabled)
 {
-    if (!simMessage || !simMessage->data) {
-        LOG_WARN("Invalid environment noise message");
+    if (m_pipelineThread.joinable()) {
+        LOG_WARN("Step pipeline mode must be set before start(), ignored");
         return;
     }
 
-    const CMsg_EnvironmentNoiseToSonarStruct* noiseData =
-        reinterpret_cast<const CMsg_EnvironmentNoiseToSonarStruct*>(simMessage->data);
+    m_pipelineEnabled = enabled;
+    LOG_INFOF("Step pipeline %s", enabled ? "enabled" : "disabled (strict synchronous mode)");
+}
 
-    LOG_INFO("Updating environment noise cache");
+void DeviceModel::startStepPipeline()
+{
+    if (m_pipelineThread.joinable()) {
+        return;
+    }
 
-    // 提取环境噪声频谱数据
-    std::vector<float> spectrum;
-    spectrum.reserve(SPECTRUM_DATA_SIZE);
-    for (int i = 0; i < SPECTRUM_DATA_SIZE; i++) {
-        spectrum.push_back(noiseData->spectrumData[i]);
+    m_nextStepFrame = 0;
+    m_queuedStepFrame = -1;
+    m_readyStepFrame = -1;
+    m_publishStepFrame = -1;
+    m_pipelineStop = false;
+    m_pipelineThread = std::thread(&DeviceModel::stepPipelineLoop, this);
+    LOG_INFO("Step pipeline worker started");
+}
+
+void DeviceModel::stopStepPipeline()
+{
+    if (!m_pipelineThread.joinable()) {
+        return;
     }
 
-    // 环境噪声对所有声纳位置都是相同的，为每个声纳ID都存储一份
-    for (int sonarID = 0; sonarID < 4; sonarID++) {
-        m_multiTargetCache.environmentNoiseSpectrumMap[sonarID] = spectrum;
+    {
+        std::lock_guard<std::mutex> lock(m_pipelineMutex);
+        m_pipelineStop = true;
     }
+    m_pipelineCond.notify_all();
+    m_pipelineThread.join();
+
+    // 未发布的帧随模型停止丢弃
+    m_queuedStepFrame = -1;
+    m_readyStepFrame = -1;
+    m_publishStepFrame = -1;
+    LOG_INFO("Step pipeline worker stopped");
+}
 
-    LOG_INFOF("Updated environment noise cache for all sonars, spectrum size: %zu",
-              spectrum.size());
+void DeviceModel::stepPipelineLoop()
+{
+    TRACE_THREAD_NAME(("step-pipeline-" + std::to_string(m_platformId)).c_str());
+
+    while (true) {
+        int frameIndex = -1;
+        {
+            std::unique_lock<std::mutex> lock(m_pipelineMutex);
+            m_pipelineCond.wait(lock, [this]() { return m_pipelineStop || m_queuedStepFrame >= 0; });
+            if (m_pipelineStop) {
+                return;
+            }
+            frameIndex = m_queuedStepFrame;
+        }
 
-    m_multiTargetCache.lastEnvironmentNoiseTime = simMessage->time;
-    LOG_INFOF("Environment noise time updated to: %lld", simMessage->time);
+        StepFrame& frame = m_stepFrames[frameIndex];
+        try {
+            evaluateStepFrame(frame);
+        } catch (const std::exception& e) {
+            LOG_ERRORF("Step pipeline evaluation failed: %s", e.what());
+            for (int sonarID = 0; sonarID < 4; sonarID++) {
+                frame.resultReady[sonarID] = false;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_pipelineMutex);
+            m_readyStepFrame = frameIndex;
+            m_queuedStepFrame = -1;
+        }
+        m_pipelineCond.notify_all();
+    }
 }
 
-void DeviceModel::step(int64 curTime, int32 step)
+void DeviceModel::waitForStepPipeline()
 {
-    LOG_INFO("Multi-target sonar model step");
-    (void)step;
-
-    if (!m_agent || !m_initialized)
-    {
+    if (!m_pipelineThread.joinable()) {
         return;
     }
-    this->curTime = curTime;
 
-    CMsg_SonarWorkState sta;
-    sta.platformId = m_agent->getPlatformEntity()->id;
-    sta.maxDetectRange = MAX_DETECTION_RANGE;
-    sta.sonarOnOff = true;
-    CSimMessage cSimMessage;
-    cSimMessage.sender = m_agent->getPlatformEntity()->id;
-    memset(cSimMessage.topic,0,EventTypeLen);
-    memcpy(cSimMessage.topic,Msg_SonarWorkState,sizeof(Msg_SonarWorkState));
-    cSimMessage.data=&sta;
-    m_agent->sendMessage(&cSimMessage);
-
-    // 获取平台机动信息
-    CSimData* motionData = m_agent->getSubscribeSimData(Data_Motion, m_agent->getPlatformEntity()->id);
-    if (motionData) {
-        handleMotionData(motionData);
-    }
+    std::unique_lock<std::mutex> lock(m_pipelineMutex);
+    m_pipelineCond.wait(lock, [this]() { return m_queuedStepFrame < 0; });
+}
 
-    // 获取平台自噪声数据
-    int64 platformId = m_agent->getPlatformEntity()->id;
-    LOG_INFOF("Attempting to get platform self sound data for platformId: %lld", platformId);
+void DeviceModel::evaluateStepFrame(StepFrame& frame)
+{
+    performMultiTargetSonarEquationCalculation(frame.cache);
 
-    CSimData* selfSoundData = m_agent->getSubscribeSimData(Data_PlatformSelfSound, platformId);
-    if (selfSoundData) {
-        LOG_INFOF("Retrieved platform self sound data with timestamp: %lld", selfSoundData->time);
-        updatePlatformSelfSoundCache(selfSoundData);
-    } else {
-        LOG_WARN("Failed to retrieve platform self sound data in step()");
-        LOG_WARNF("Topic: %s, PlatformId: %lld", Data_PlatformSelfSound, platformId);
+    PhaseScope assemblePhase(this, PHASE_ASSEMBLE);
+    TRACE_ZONE_ID("assemblePassiveSonarResult", m_platformId);
+    for (int sonarID = 0; sonarID < 4; sonarID++) {
+        frame.resultReady[sonarID] = assemblePassiveSonarResult(
+            sonarID, getEffectiveThreshold(sonarID), frame.time, frame.cache.multiTargetEquationResults,
+            frame.platformHeading, frame.results[sonarID]);
     }
-
-    // 执行多目标声纳方程计算
-    performMultiTargetSonarEquationCalculation();
 }
 
 // 平台自噪声数据
@@ -1458,14 +2188,26 @@ void DeviceModel::updatePlatformSelfSoundCache(CSimData* simData)
         return;
     }
 
+    // 订阅数据在宿主更新前地址与时间不变，每步重复获取时无需再次提取
+    if (simData->data == m_multiTargetCache.lastPlatformSoundPayload &&
+        simData->time == m_multiTargetCache.lastPlatformSoundTime &&
+        !m_multiTargetCache.platformSelfSoundSpectrumMap.empty()) {
+        return;
+    }
+
     const CData_PlatformSelfSound* selfSound =
         reinterpret_cast<const CData_PlatformSelfSound*>(simData->data);
 
     LOG_INFOF("Updating platform self sound cache, spectrum count: %zu",
               selfSound->selfSoundSpectrumList.size());
 
-    // 清空旧的平台噪声数据
-    m_multiTargetCache.platformSelfSoundSpectrumMap.clear();
+    // 释放旧的平台噪声数据（借用模式下归还旧载荷的引用）
+    // 只重置句柄、保留映射节点，新数据中缺失的声纳在末尾移除
+    for (auto& spectrumPair : m_multiTargetCache.platformSelfSoundSpectrumMap) {
+        spectrumPair.second.reset();
+    }
+
+    std::shared_ptr<const void> payloadOwner = retainPayload(simData->data);
 
     // 处理平台自噪声数据列表
     for (const auto& spectrumStruct : selfSound->selfSoundSpectrumList) {
@@ -1477,12 +2219,11 @@ void DeviceModel::updatePlatformSelfSoundCache(CSimData* simData)
             continue;
         }
 
-        // 提取频谱数据
-        std::vector<float> spectrum;
-        spectrum.reserve(SPECTRUM_DATA_SIZE);
-        for (int i = 0; i < SPECTRUM_DATA_SIZE; i++) {
-            spectrum.push_back(spectrumStruct.spectumData[i]);
-        }
+        // 提取频谱数据（借用模式下引用载荷）
+        SpectrumBuffer spectrum = payloadOwner
+            ? SpectrumBuffer::borrow(payloadOwner, spectrumStruct.spectumData, SPECTRUM_DATA_SIZE)
+            : SpectrumBuffer::copyOf(spectrumStruct.spectumData, SPECTRUM_DATA_SIZE,
+                                     m_memoryAccount.category(MemoryAccount::NOISE_SPECTRA));
 
         // 存储到对应声纳的缓存中
         m_multiTargetCache.platformSelfSoundSpectrumMap[sonarID] = spectrum;
@@ -1490,45 +2231,100 @@ void DeviceModel::updatePlatformSelfSoundCache(CSimData* simData)
         LOG_INFOF("Updated platform self sound cache for sonar %d", sonarID);
     }
 
+    for (auto it = m_multiTargetCache.platformSelfSoundSpectrumMap.begin();
+         it != m_multiTargetCache.platformSelfSoundSpectrumMap.end();) {
+        if (it->second.empty()) {
+            it = m_multiTargetCache.platformSelfSoundSpectrumMap.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    m_multiTargetCache.lastPlatformSoundPayload = simData->data;
     m_multiTargetCache.lastPlatformSoundTime = simData->time;
     LOG_INFOF("Platform self sound time updated to: %lld", simData->time);
 }
 
-void DeviceModel::performMultiTargetSonarEquationCalculation()
+void DeviceModel::performMultiTargetSonarEquationCalculation(MultiTargetSonarEquationCache& cache)
 {
     LOG_DEBUG("Performing multi-target sonar equation calculation for all sonars");
-
-    // 清空之前的计算结果
-    m_multiTargetCache.multiTargetEquationResults.clear();
+    PhaseScope equationPhase(this, PHASE_EQUATION);
+    TRACE_ZONE_ID("performMultiTargetSonarEquationCalculation", m_platformId);
 
     // 为每个声纳位置计算所有目标的声纳方程
+    // 结果列表按声纳复用（只清空不释放），稳态步进不再为结果分配内存
     for (int sonarID = 0; sonarID < 4; sonarID++) {
         // 检查该声纳是否启用
         auto stateIt = m_sonarStates.find(sonarID);
         if (stateIt == m_sonarStates.end() ||
             !stateIt->second.arrayWorkingState ||
             !stateIt->second.passiveWorkingState) {
+            // 关闭的声纳不保留上一步的结果
+            cache.multiTargetEquationResults.erase(sonarID);
             LOG_INFOF("Sonar %d is disabled, skipping calculation", sonarID);
             continue;
         }
 
         LOG_INFOF("Sonar %d is enabled, calculating equations for all targets", sonarID);
 
-        const auto& targetsData = m_multiTargetCache.sonarTargetsData[sonarID];
-        std::vector<TargetEquationResult> sonarResults;
+        const auto& targetsData = cache.sonarTargetsData[sonarID];
+        std::vector<TargetEquationResult>& sonarResults = cache.multiTargetEquationResults[sonarID];
+        sonarResults.clear();
+        sonarResults.reserve(targetsData.size());
+
+        // 上界剪枝：噪声频带求和与最大DI每个声纳只算一次；噪声缺失时不剪枝，由精确计算处理
+        double pruningLimit = getEffectiveThreshold(sonarID) - BOUND_PRUNING_MARGIN_DB;
+        double noiseDenominator = 0.0;
+        double maxDI = 0.0;
+        bool pruningReady = false;
+        if (m_boundPruningEnabled && pruningLimit > 0.0 && !targetsData.empty()) {
+            auto platformIt = cache.platformSelfSoundSpectrumMap.find(sonarID);
+            auto environmentIt = cache.environmentNoiseSpectrumMap.find(sonarID);
+            if (platformIt != cache.platformSelfSoundSpectrumMap.end() &&
+                environmentIt != cache.environmentNoiseSpectrumMap.end()) {
+                double platformSum = calculateSpectrumSumByFreqRange(platformIt->second, sonarID);
+                double environmentSum = calculateSpectrumSumByFreqRange(environmentIt->second, sonarID);
+                noiseDenominator = platformSum * platformSum + environmentSum * environmentSum;
+
+                // DI随频率（kHz）单调增，calculateDynamicDI内部再限制到该声纳的最大频率；
+                // 中位数频率为0时DI只取偏移量
+                maxDI = std::max(calculateDynamicDI(sonarID, MAX_FREQUENCY_KHZ),
+                                 calculateDynamicDI(sonarID, 0.0));
+                pruningReady = noiseDenominator > 0.0;
+            }
+        }
 
+        int prunedCount = 0;
         for (const auto& targetData : targetsData) {
-            // 计算该目标的声纳方程
-            double result = calculateTargetSonarEquation(sonarID, targetData);
-
             // 获取当前声纳的有效阈值
             double threshold = getEffectiveThreshold(sonarID);
 
             TargetEquationResult targetResult;
             targetResult.targetId = targetData.targetId;
-            targetResult.equationResult = result;
             targetResult.targetDistance = targetData.targetDistance;
             targetResult.targetBearing = targetData.targetBearing;
+
+            // 上界（与精确计算失败时的0取大）低于阈值的目标必然不可探测，跳过精确计算
+            double upperBound = 0.0;
+            if (pruningReady && targetData.isValid && targetData.bandPeakLevel >= 0.0f) {
+                upperBound = std::max(0.0, calculateEquationUpperBound(sonarID, targetData, noiseDenominator, maxDI));
+                targetResult.pruned = (upperBound < pruningLimit);
+            }
+
+            if (targetResult.pruned) {
+                // X未计算：与精确计算失败相同记0，上界单独保存，界面与探测判断不会把上界当作X
+                targetResult.equationResult = 0.0;
+                targetResult.upperBound = upperBound;
+                targetResult.isValid = false;
+                prunedCount++;
+                sonarResults.push_back(targetResult);
+                continue;
+            }
+
+            // 计算该目标的声纳方程
+            double result = calculateTargetSonarEquation(sonarID, targetData, cache);
+
+            targetResult.equationResult = result;
             // 使用配置的阈值进行判断
             targetResult.isValid = (result > threshold);
 
@@ -1545,41 +2341,41 @@ void DeviceModel::performMultiTargetSonarEquationCalculation()
             }
         }
 
-        // 存储该声纳的所有目标结果
-        m_multiTargetCache.multiTargetEquationResults[sonarID] = sonarResults;
-
-        LOG_INFOF("Sonar %d completed calculation for %zu targets", sonarID, sonarResults.size());
+        m_boundEvaluatedCount.fetch_add(sonarResults.size(), std::memory_order_relaxed);
+        m_boundPrunedCount.fetch_add(prunedCount, std::memory_order_relaxed);
 
-        // 发送被动声呐探测结果
-        sendPassiveSonarResultsInStep();
+        LOG_INFOF("Sonar %d completed calculation for %zu targets (%d pruned by upper bound)",
+                  sonarID, sonarResults.size(), prunedCount);
     }
 }
-double DeviceModel::calculateTargetSonarEquation(int sonarID, const TargetData& targetCachePropagatedSpectrum)
+
+double DeviceModel::calculateTargetSonarEquation(int sonarID, const TargetData& targetCachePropagatedSpectrum,
+                                                 const MultiTargetSonarEquationCache& cache)
 {
     LOG_INFOF("=== Calculating equation for sonar %d, target %d ===", sonarID, targetCachePropagatedSpectrum.targetId);
 
     // 检查目标数据有效性
     if (!targetCachePropagatedSpectrum.isValid || targetCachePropagatedSpectrum.propagatedSpectrum.empty()) {
-        LOG_WARNF("Invalid target data for sonar %d, target %d - isValid:%d, spectrumSize:%zu",
+        LOG_WARNF("Invalid target data for sonar %d, target %d - isValid:%d, spectrumSize:%d",
                   sonarID, targetCachePropagatedSpectrum.targetId, targetCachePropagatedSpectrum.isValid, targetCachePropagatedSpectrum.propagatedSpectrum.size());
         return 0.0;
     }
 
     // 检查平台自噪声和环境噪声数据
-    auto targetCachePlatformSpectrumVector = m_multiTargetCache.platformSelfSoundSpectrumMap.find(sonarID);
-    auto targetCacheEnvironmentSpectrumVector = m_multiTargetCache.environmentNoiseSpectrumMap.find(sonarID);
+    auto targetCachePlatformSpectrumVector = cache.platformSelfSoundSpectrumMap.find(sonarID);
+    auto targetCacheEnvironmentSpectrumVector = cache.environmentNoiseSpectrumMap.find(sonarID);
 
-    if (targetCachePlatformSpectrumVector == m_multiTargetCache.platformSelfSoundSpectrumMap.end()) {
+    if (targetCachePlatformSpectrumVector == cache.platformSelfSoundSpectrumMap.end()) {
         LOG_WARNF("Missing platform noise data for sonar %d", sonarID);
         return 0.0;
     }
 
-    if (targetCacheEnvironmentSpectrumVector == m_multiTargetCache.environmentNoiseSpectrumMap.end()) {
+    if (targetCacheEnvironmentSpectrumVector == cache.environmentNoiseSpectrumMap.end()) {
         LOG_WARNF("Missing environment noise data for sonar %d", sonarID);
         return 0.0;
     }
 
-    LOG_INFOF("Sonar %d data check passed - platform spectrum size:%zu, environment spectrum size:%zu, target spectrum size:%zu",
+    LOG_INFOF("Sonar %d data check passed - platform spectrum size:%d, environment spectrum size:%d, target spectrum size:%d",
               sonarID, targetCachePlatformSpectrumVector->second.size(),
               targetCacheEnvironmentSpectrumVector->second.size(), targetCachePropagatedSpectrum.propagatedSpectrum.size());
 
@@ -1626,7 +2422,25 @@ double DeviceModel::calculateTargetSonarEquation(int sonarID, const TargetData&
 
     return result;
 }
-double DeviceModel::calculateSpectrumSum(const std::vector<float>& spectrum)
+double DeviceModel::calculateEquationUpperBound(int sonarID, const TargetData& targetData,
+                                                double noiseDenominator, double maxDI)
+{
+    int startIndex = 0;
+    int endIndex = 0;
+    if (!getSonarBandIndexRange(sonarID, startIndex, endIndex) || noiseDenominator <= 0.0) {
+        return std::numeric_limits<double>::infinity();
+    }
+
+    // |频带求和| <= 频点数 x 频带内绝对值峰值
+    double propagatedBound = static_cast<double>(endIndex - startIndex + 1) * targetData.bandPeakLevel;
+    if (propagatedBound <= 0.0) {
+        return 0.0;     // 频带内全为0，精确计算返回0
+    }
+
+    return 10.0 * log10(propagatedBound * propagatedBound / noiseDenominator) + maxDI;
+}
+
+double DeviceModel::calculateSpectrumSum(const SpectrumBuffer& spectrum)
 {
     if (spectrum.empty()) {
         return 0.0;
@@ -1692,19 +2506,33 @@ void DeviceModel::updateSonarState()
         return;
     }
 
-    // 为每个声纳阵列发布状态（ID：0-3）
+    // 为每个声纳阵列发布状态（ID：0-3），一次批量发布
+    std::vector<CData_SonarState> states;
+    std::vector<CSimData> simDatas(m_sonarStates.size());
+    std::vector<CSimData*> simDataPtrs;
+    states.reserve(m_sonarStates.size());
+    simDataPtrs.reserve(m_sonarStates.size());
+
     for (const auto& entry : m_sonarStates) {
-        CData_SonarState state = entry.second;
+        states.push_back(entry.second);
 
-        // 发布声纳状态
-        CSimData simData;
+        CSimData& simData = simDatas[simDataPtrs.size()];
         simData.dataFormat = STRUCT;
-        simData.sender = m_agent->getPlatformEntity()->id;
+        simData.sender = m_platformId;
         memcpy(simData.topic, Data_SonarState_Topic, strlen(Data_SonarState_Topic) + 1);
-        simData.data = &state;
-        simData.length = sizeof(state);
+        simData.data = &states.back();
+        simData.length = sizeof(CData_SonarState);
+        simDataPtrs.push_back(&simData);
+    }
 
-        m_agent->publishSimData(&simData);
+    if (m_agentExtension) {
+        if (!simDataPtrs.empty()) {
+            m_agentExtension->publishSimDataBatch(simDataPtrs.data(), static_cast<int32>(simDataPtrs.size()));
+        }
+    } else {
+        for (CSimData* simData : simDataPtrs) {
+            m_agent->publishSimData(simData);
+        }
     }
 }
 
@@ -1740,8 +2568,9 @@ void DeviceModel::handleSonarControlOrder(CSimMessage* simMessage)
         return;
     }
 
-    // 找到对应的声纳ID并更新状态
+    // 找到对应的声纳ID并更新状态（流水线工作线程读取声纳状态，先等待在途计算完成）
     if (m_sonarStates.find(order->sonarID) != m_sonarStates.end()) {
+        waitForStepPipeline();
         CData_SonarState& state = m_sonarStates[order->sonarID];
 
         // 更新工作状态
@@ -1757,6 +2586,9 @@ void DeviceModel::handleSonarControlOrder(CSimMessage* simMessage)
                   order->sonarID, state.arrayWorkingState, state.activeWorkingState,
                   state.passiveWorkingState, state.scoutingWorkingState);
 
+        // 声纳启停后更新传播声过滤条件
+        updatePropagatedSoundFilter();
+
         // 发布更新后的声纳状态
         updateSonarState();
     }
@@ -1773,24 +2605,20 @@ void DeviceModel::handleMotionData(CSimData* simData)
     // 更新平台机动信息
     m_platformMotion = *motionData;
 
-    std::cout << __FUNCTION__ << ":" << __LINE__
-              << std::fixed << std::setprecision(6)
-              << " Platform motion updated: "
-              << " lon=" << m_platformMotion.x
-              << " lat=" << m_platformMotion.y
-              << " alt=" << m_platformMotion.z
-              << " heading=" << m_platformMotion.rotation
-              << " speed=" << m_platformMotion.curSpeed
-              << std::endl;
+    LOG_INFOF("Platform motion updated: lon=%.6f lat=%.6f alt=%.6f heading=%.6f speed=%.6f",
+              m_platformMotion.x, m_platformMotion.y, m_platformMotion.z,
+              m_platformMotion.rotation, m_platformMotion.curSpeed);
 }
 
 void DeviceModel::stop()
 {
+    stopStepPipeline();
     LOG_INFO("Multi-target sonar model stopped");
 }
 
 void DeviceModel::destroy()
 {
+    stopStepPipeline();
     LOG_INFO("Multi-target sonar model destroyed");
 }
 
@@ -1808,6 +2636,12 @@ void DeviceModel::setFileLogEnabled(bool enabled) {
     Logger::getInstance().enableFileOutput(enabled);
 }
 
+void DeviceModel::setBorrowedPayloadEnabled(bool enabled)
+{
+    m_borrowedPayloadEnabled = enabled;
+    LOG_INFOF("Borrowed payload mode %s", enabled ? "enabled" : "disabled");
+}
+
 
 
 
@@ -1826,6 +2660,7 @@ void DeviceModel::setSonarDetectionThreshold(int sonarID, double threshold)
         return;
     }
 
+    waitForStepPipeline();
     m_detectionThresholds[sonarID] = threshold;
     LOG_INFOF("设置声纳%d探测阈值: %.2f", sonarID, threshold);
 }
@@ -1861,7 +2696,7 @@ void DeviceModel::saveThresholdConfig(const std::string& filename) const
 
         // 写入配置文件头
         configFile << "# 声纳探测阈值配置文件\n";
-        configFile << "# 生成时间: " << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss").toStdString() << "\n\n";
+        configFile << "# 生成时间: " << currentLocalTimeString("%Y-%m-%d %H:%M:%S") << "\n\n";
 
         // 写入各声纳的阈值
         configFile << "[SonarThresholds]\n";
@@ -1889,6 +2724,7 @@ void DeviceModel::loadThresholdConfig(const std::string& filename)
             LOG_WARNF("无法打开配置文件: %s，使用默认阈值", filename.c_str());
             return;
         }
+        waitForStepPipeline();
 
         std::string line;
         std::string currentSection;
@@ -1953,6 +2789,7 @@ void DeviceModel::loadThresholdConfig(const std::string& filename)
 
 DeviceModel::~DeviceModel()
 {
+    stopStepPipeline();
     LOG_INFO("Sonar model destroyed");
 }
 
@@ -1970,7 +2807,7 @@ void DeviceModel::saveExtendedConfig(const std::string& filename, const std::map
 
         // 写入配置文件头
         configFile << "# 声纳探测阈值和角度范围配置文件\n";
-        configFile << "# 生成时间: " << QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss").toStdString() << "\n\n";
+        configFile << "# 生成时间: " << currentLocalTimeString("%Y-%m-%d %H:%M:%S") << "\n\n";
 
         // 写入各声纳的阈值
         configFile << "[SonarThresholds]\n";
@@ -2035,6 +2872,7 @@ void DeviceModel::loadExtendedConfig(const std::string& filename)
             LOG_WARNF("无法打开配置文件: %s，使用默认配置", filename.c_str());
             return;
         }
+        waitForStepPipeline();
 
         std::string line;
         std::string currentSection;
@@ -2224,10 +3062,60 @@ int DeviceModel::getSpectrumIndexFromFrequency(int frequency_hz)
     }
 }
 
-double DeviceModel::calculateSpectrumSumByFreqRange(const std::vector<float>& spectrum, int sonarID)
+bool DeviceModel::getSonarBandIndexRange(int sonarID, int& startIndex, int& endIndex)
+{
+    int start_freq_hz, end_freq_hz;
+
+    switch (sonarID) {
+        case 0:  // 艏端声纳：500Hz-7500Hz
+            start_freq_hz = 500;
+            end_freq_hz = 7500;
+            break;
+        case 1:  // 舷侧声纳：400Hz-3200Hz
+            start_freq_hz = 400;
+            end_freq_hz = 3200;
+            break;
+        case 2:  // 粗拖声纳：48Hz-750Hz
+            start_freq_hz = 48;
+            end_freq_hz = 750;
+            break;
+        case 3:  // 细拖声纳：10Hz-500Hz
+            start_freq_hz = 10;
+            end_freq_hz = 500;
+            break;
+        default:
+            return false;
+    }
+
+    startIndex = std::max(0, getSpectrumIndexFromFrequency(start_freq_hz));
+    endIndex = std::min(SPECTRUM_DATA_SIZE - 1, getSpectrumIndexFromFrequency(end_freq_hz));
+    return startIndex <= endIndex;
+}
+
+float DeviceModel::calculateBandPeakLevel(const SpectrumBuffer& spectrum, int sonarID)
+{
+    int startIndex = 0;
+    int endIndex = 0;
+    if (spectrum.size() != SPECTRUM_DATA_SIZE || !getSonarBandIndexRange(sonarID, startIndex, endIndex)) {
+        return -1.0f;
+    }
+
+    const float* data = spectrum.data();
+    float peak = 0.0f;
+    for (int i = startIndex; i <= endIndex; i++) {
+        float level = std::fabs(data[i]);
+        if (std::isnan(level)) {
+            return -1.0f;       // 含NaN时不剪枝，由精确计算处理
+        }
+        peak = std::max(peak, level);
+    }
+    return peak;
+}
+
+double DeviceModel::calculateSpectrumSumByFreqRange(const SpectrumBuffer& spectrum, int sonarID)
 {
     if (spectrum.empty() || spectrum.size() != SPECTRUM_DATA_SIZE) {
-        LOG_WARNF("Invalid spectrum data size: %zu, expected: %d", spectrum.size(), SPECTRUM_DATA_SIZE);
+        LOG_WARNF("Invalid spectrum data size: %d, expected: %d", spectrum.size(), SPECTRUM_DATA_SIZE);
         return 0.0;
     }
 
@@ -2299,10 +3187,10 @@ double DeviceModel::calculateSpectrumSumByFreqRange(const std::vector<float>& sp
 
 
 
-double DeviceModel::calculateMedianFrequencyFromSpectrum(const std::vector<float>& spectrum, int sonarID)
+double DeviceModel::calculateMedianFrequencyFromSpectrum(const SpectrumBuffer& spectrum, int sonarID)
 {
     if (spectrum.empty() || spectrum.size() != SPECTRUM_DATA_SIZE) {
-        LOG_WARNF("Invalid spectrum data size: %zu, expected: %d", spectrum.size(), SPECTRUM_DATA_SIZE);
+        LOG_WARNF("Invalid spectrum data size: %d, expected: %d", spectrum.size(), SPECTRUM_DATA_SIZE);
         return 0.0;
     }
 
@@ -2458,22 +3346,23 @@ double DeviceModel::calculateDynamicDI(int sonarID, double dynamicFrequency)
 
 
 /**
- * @brief 组装并发送被动声呐探测结果
+ * @brief 组装被动声呐探测结果
  * @param sonarID 声呐编号 (0:艏端, 1:舷侧, 2:粗拖, 3:细拖)
  * @param detectionThreshold 探测阈值 X
  * @param currentTime 当前时间戳
+ * @param equationResults 各声呐的声纳方程计算结果
+ * @param platformHeading 本艇航向（度），用于扇区判断与大地方位换算
+ * @param passiveSonarResult 输出结果（原有内容被清空）
+ * @return 声呐启用且结果已组装返回true
  */
-void DeviceModel::assembleAndSendPassiveSonarResult(int sonarID, double detectionThreshold, int64 currentTime)
+bool DeviceModel::assemblePassiveSonarResult(int sonarID, double detectionThreshold, int64 currentTime,
+                                             const std::map<int, std::vector<TargetEquationResult>>& equationResults,
+                                             float platformHeading, CMsg_PassiveSonarResultStruct& passiveSonarResult)
 {
-    if (!m_agent) {
-        LOG_WARN("Agent is null, cannot send passive sonar result");
-        return;
-    }
-
     // 验证声呐ID有效性
     if (sonarID < 0 || sonarID >= 4) {
         LOG_WARNF("Invalid sonar ID: %d", sonarID);
-        return;
+        return false;
     }
 
     // 检查声呐是否启用
@@ -2482,85 +3371,76 @@ void DeviceModel::assembleAndSendPassiveSonarResult(int sonarID, double detectio
         !stateIt->second.arrayWorkingState ||
         !stateIt->second.passiveWorkingState) {
         LOG_INFOF("Sonar %d is disabled, not sending result", sonarID);
-        return;
+        return false;
     }
 
-    // 创建被动声呐结果结构体
-    CMsg_PassiveSonarResultStruct passiveSonarResult;
+    // 复用被动声呐结果结构体（保留容器容量）
+    passiveSonarResult.detectionNumber = 0;
+    passiveSonarResult.PassiveSonarDetectionResult.clear();
+    passiveSonarResult.PassiveSonarTrackingResult.clear();
 
     // 设置声呐ID (转换为1-7的编号，项目中使用1开始编号)
     passiveSonarResult.sonarID = sonarID + 1;  // 0->1, 1->2, 2->3, 3->4
 
     // 获取该声呐的计算结果
-    auto resultIt = m_multiTargetCache.multiTargetEquationResults.find(sonarID);
-    if (resultIt == m_multiTargetCache.multiTargetEquationResults.end()) {
+    auto resultIt = equationResults.find(sonarID);
+    if (resultIt == equationResults.end()) {
         LOG_INFOF("No calculation results for sonar %d", sonarID);
         passiveSonarResult.detectionNumber = 0;
     } else {
         const auto& targetResults = resultIt->second;
 
-        // 统计可探测的目标
-        std::vector<TargetEquationResult> detectedTargets;
-        std::vector<TargetEquationResult> validTargets;  // 用于跟踪的目标
-
+        // 单遍筛选：检测结果与跟踪结果直接写入输出结构（容量跨步保留），不再经过临时目标列表
+        int detectionCount = 0;
         for (const auto& result : targetResults) {
             // 检查目标是否在声呐有效角度范围内
-            if (!isTargetInSonarRange(sonarID, result.targetBearing, result.targetDistance)) {
+            if (!isTargetInSonarRange(sonarID, result.targetBearing, result.targetDistance, platformHeading)) {
                 continue;
             }
 
             // 根据阈值判断是否可探测
-            if (result.equationResult > detectionThreshold) {
-                detectedTargets.push_back(result);
-
-                // SNR较高的目标可以进行跟踪（这里用简单规则：X值高于阈值5dB以上）
-                if (result.equationResult > (detectionThreshold + 5.0)) {
-                    validTargets.push_back(result);
-                }
+            if (!(result.equationResult > detectionThreshold)) {
+                continue;
             }
-        }
+            detectionCount++;
 
-        // 设置检测目标数量
-        passiveSonarResult.detectionNumber = static_cast<int>(detectedTargets.size());
+            // 方位角估计值（大地坐标系），转换为0-360度范围
+            float groundBearing = result.targetBearing + platformHeading;
+            while (groundBearing < 0) groundBearing += 360.0f;
+            while (groundBearing >= 360) groundBearing -= 360.0f;
 
-        // 组装检测结果
-        for (size_t i = 0; i < detectedTargets.size() && i < 100; i++) {  // 最多100个目标
-            C_PassiveSonarDetectionResult detection;
+            // 组装检测结果
+            if (passiveSonarResult.PassiveSonarDetectionResult.size() < 100) {  // 最多100个目标
+                C_PassiveSonarDetectionResult detection;
 
-            // 方位角估计值（阵坐标系）
-            detection.detectionDirArray = detectedTargets[i].targetBearing;
+                // 方位角估计值（阵坐标系）
+                detection.detectionDirArray = result.targetBearing;
+                detection.detectionDirGroud = groundBearing;
 
-            // 方位角估计值（大地坐标系）
-            // 转换为0-360度范围
-            float groundBearing = detectedTargets[i].targetBearing + m_platformMotion.rotation;
-            while (groundBearing < 0) groundBearing += 360.0f;
-            while (groundBearing >= 360) groundBearing -= 360.0f;
-            detection.detectionDirGroud = groundBearing;
+                passiveSonarResult.PassiveSonarDetectionResult.push_back(detection);
+            }
 
-            passiveSonarResult.PassiveSonarDetectionResult.push_back(detection);
-        }
+            // SNR较高的目标可以进行跟踪（这里用简单规则：X值高于阈值5dB以上）
+            if (!(result.equationResult > (detectionThreshold + 5.0)) ||
+                passiveSonarResult.PassiveSonarTrackingResult.size() >= 50) {  // 最多50个跟踪目标
+                continue;
+            }
 
-        // 组装跟踪结果
-        for (size_t i = 0; i < validTargets.size() && i < 50; i++) {  // 最多50个跟踪目标
+            // 组装跟踪结果
             C_PassiveSonarTrackingResult tracking;
 
             // 跟踪批次号
-            tracking.trackingID = static_cast<int>(i + 1);
+            tracking.trackingID = static_cast<int>(passiveSonarResult.PassiveSonarTrackingResult.size() + 1);
 
             // 信噪比（基于声呐方程结果估算）
             tracking.SNR = std::min(50.0f, std::max(-50.0f,
-                static_cast<float>(validTargets[i].equationResult - detectionThreshold)));
+                static_cast<float>(result.equationResult - detectionThreshold)));
 
             // 跟踪时长（模拟数据，实际应该是累积时间）
             tracking.trackingStep = std::min(1000, static_cast<int>(currentTime / 1000) % 1000);
 
             // 方位角估计值（阵坐标系）
-            tracking.trackingDirArray = validTargets[i].targetBearing;
-
-            // 方位角估计值（大地坐标系）
-            float groundBearing = validTargets[i].targetBearing + m_platformMotion.rotation;
-            while (groundBearing < 0) groundBearing += 360.0f;
-            while (groundBearing >= 360) groundBearing -= 360.0f;
+            tracking.trackingDirArray = result.targetBearing;
             tracking.trackingDirGroud = groundBearing;
 
             // 目标识别结果（基于SNR和距离的简单规则）
@@ -2576,43 +3456,112 @@ void DeviceModel::assembleAndSendPassiveSonarResult(int sonarID, double detectio
             }
 
             // 频谱数据填充（这里使用模拟数据，实际应该从目标频谱获取）
-            fillMockSpectrumData(tracking.spectumData, validTargets[i].targetId);
+            fillMockSpectrumData(tracking.spectumData, result.targetId);
 
             passiveSonarResult.PassiveSonarTrackingResult.push_back(tracking);
         }
+
+        // 设置检测目标数量（含超出100条上限未列出的目标）
+        passiveSonarResult.detectionNumber = detectionCount;
     }
 
+    return true;
+}
+
+/**
+ * @brief 将被动声呐结果加入待发送队列
+ * @param passiveSonarResult 结果（须在队列发送前保持有效）
+ */
+void DeviceModel::queuePassiveSonarResult(const CMsg_PassiveSonarResultStruct& passiveSonarResult, int64 currentTime)
+{
     // 创建仿真消息
     CSimMessage simMessage;
     simMessage.dataFormat = STRUCT;
     simMessage.time = currentTime;
-    simMessage.sender = m_agent->getPlatformEntity()->id;
+    simMessage.sender = m_platformId;
     simMessage.senderComponentId = 1;
     simMessage.receiver = 0;  // 广播
-    simMessage.data = &passiveSonarResult;
+    simMessage.data = const_cast<CMsg_PassiveSonarResultStruct*>(&passiveSonarResult);
     simMessage.length = sizeof(passiveSonarResult);
 
     // 设置消息主题
     memset(simMessage.topic, 0, sizeof(simMessage.topic));
     strncpy(simMessage.topic, MSG_PassiveSonarResult_Topic, strlen(MSG_PassiveSonarResult_Topic));
 
-    // 发送消息
-    m_agent->sendMessage(&simMessage);
+    queueMessage(simMessage);
 
-    LOG_INFOF("Sent passive sonar result for sonar %d: %d detections, %d trackings",
-              sonarID, passiveSonarResult.detectionNumber,
+    LOG_INFOF("Queued passive sonar result for sonar %d: %d detections, %d trackings",
+              passiveSonarResult.sonarID - 1, passiveSonarResult.detectionNumber,
               static_cast<int>(passiveSonarResult.PassiveSonarTrackingResult.size()));
 }
 
+/**
+ * @brief 组装并发送被动声呐探测结果
+ * @param sonarID 声呐编号 (0:艏端, 1:舷侧, 2:粗拖, 3:细拖)
+ * @param detectionThreshold 探测阈值 X
+ * @param currentTime 当前时间戳
+ */
+void DeviceModel::assembleAndSendPassiveSonarResult(int sonarID, double detectionThreshold, int64 currentTime)
+{
+    TRACE_ZONE_ID("assembleAndSendPassiveSonarResult", m_platformId);
+
+    if (!m_agent) {
+        LOG_WARN("Agent is null, cannot send passive sonar result");
+        return;
+    }
+
+    if (sonarID < 0 || sonarID >= 4 ||
+        !assemblePassiveSonarResult(sonarID, detectionThreshold, currentTime, m_multiTargetCache.multiTargetEquationResults,
+                                    static_cast<float>(m_platformMotion.rotation), m_passiveSonarResults[sonarID])) {
+        return;
+    }
+
+    queuePassiveSonarResult(m_passiveSonarResults[sonarID], currentTime);
+    flushPendingMessages();
+}
+
+void DeviceModel::queueMessage(const CSimMessage& simMessage)
+{
+    m_pendingMessages.push_back(simMessage);
+}
+
+void DeviceModel::flushPendingMessages()
+{
+    TRACE_ZONE_ID("flushPendingMessages", m_platformId);
+    if (!m_agent || m_pendingMessages.empty()) {
+        m_pendingMessages.clear();
+        return;
+    }
+
+    // 队列发送前不再增长，元素地址稳定
+    m_pendingMessagePtrs.clear();
+    for (auto& message : m_pendingMessages) {
+        m_pendingMessagePtrs.push_back(&message);
+    }
+
+    if (m_agentExtension) {
+        m_agentExtension->sendMessages(m_pendingMessagePtrs.data(), static_cast<int32>(m_pendingMessagePtrs.size()));
+    } else {
+        for (CSimMessage* message : m_pendingMessagePtrs) {
+            m_agent->sendMessage(message);
+        }
+    }
+
+    m_pendingMessages.clear();
+    m_pendingMessagePtrs.clear();
+}
+
 /**
  * @brief 填充模拟频谱数据
  * @param spectrumData 频谱数据数组
  * @param targetId 目标ID
+ * 背景噪声由本平台ID与目标ID确定的计数器随机数生成，同一目标每次得到相同频谱，可在任意线程调用
  */
 void DeviceModel::fillMockSpectrumData(float spectrumData[5296], int targetId)
 {
-    // 清零频谱数据
-    memset(spectrumData, 0, sizeof(float) * 5296);
+    // 背景噪声（±1）
+    CounterRng rng(static_cast<uint64_t>(m_platformId), CounterRng::streamOf(targetId, 0));
+    rng.fillUniform(spectrumData, 5296, -1.0f, 1.0f);
 
     // 基于目标ID生成特征频谱
     int baseFreq = (targetId % 10) * 100 + 500;  // 500-1400Hz基频
@@ -2624,7 +3573,7 @@ void DeviceModel::fillMockSpectrumData(float spectrumData[5296], int targetId)
         // 在基频附近生成峰值
         if (freq >= baseFreq - 50 && freq <= baseFreq + 50) {
             float diff = std::abs(freq - baseFreq);
-            spectrumData[i] = amplitude * exp(-diff * diff / (2 * 25 * 25));  // 高斯分布
+            spectrumData[i] += amplitude * exp(-diff * diff / (2 * 25 * 25));  // 高斯分布
         }
 
         // 添加一些谐波
@@ -2633,9 +3582,6 @@ void DeviceModel::fillMockSpectrumData(float spectrumData[5296], int targetId)
             float diff = std::abs(freq - harmonic2);
             spectrumData[i] += amplitude * 0.3f * exp(-diff * diff / (2 * 15 * 15));
         }
-
-        // 添加背景噪声
-        spectrumData[i] += (rand() % 20 - 10) * 0.1f;
     }
 }
 
@@ -2646,6 +3592,11 @@ void DeviceModel::fillMockSpectrumData(float spectrumData[5296], int targetId)
  */
 void DeviceModel::sendAllPassiveSonarResults(const std::map<int, double>& detectionThresholds, int64 currentTime)
 {
+    if (!m_agent) {
+        LOG_WARN("Agent is null, cannot send passive sonar result");
+        return;
+    }
+
     for (int sonarID = 0; sonarID < 4; sonarID++) {
         double threshold = 33.0;  // 默认阈值
 
@@ -2657,8 +3608,14 @@ void DeviceModel::sendAllPassiveSonarResults(const std::map<int, double>& detect
             threshold = getEffectiveThreshold(sonarID);
         }
 
-        assembleAndSendPassiveSonarResult(sonarID, threshold, currentTime);
+        if (assemblePassiveSonarResult(sonarID, threshold, currentTime, m_multiTargetCache.multiTargetEquationResults,
+                                       static_cast<float>(m_platformMotion.rotation), m_passiveSonarResults[sonarID])) {
+            queuePassiveSonarResult(m_passiveSonarResults[sonarID], currentTime);
+        }
     }
+
+    // 一次批量发送（含本步已排队的工作状态消息）
+    flushPendingMessages();
 }
 
 /**
@@ -3030,36 +3987,19 @@ void DeviceModel::startExecutionTimer()
 bool DeviceModel::checkMemoryUsage(const char* funcName, const char* fileName, int line)
 {
     try {
-        // 简单的内存使用估算
-        size_t estimatedUsage = 0;
-
-        // 估算目标缓存使用的内存
-        for (const auto& sonarPair : m_multiTargetCache.sonarTargetsData) {
-            for (const auto& target : sonarPair.second) {
-                estimatedUsage += sizeof(TargetData) + target.propagatedSpectrum.size() * sizeof(float);
-            }
-        }
+        // 计数在分配/释放与每步容量刷新时实时维护，这里只读取总量（借用的载荷由宿主持有，不计入）
+        size_t usage = static_cast<size_t>(m_memoryAccount.totalBytes());
 
-        // 估算其他缓存
-        for (const auto& spectrumPair : m_multiTargetCache.platformSelfSoundSpectrumMap) {
-            estimatedUsage += spectrumPair.second.size() * sizeof(float);
-        }
-
-        for (const auto& spectrumPair : m_multiTargetCache.environmentNoiseSpectrumMap) {
-            estimatedUsage += spectrumPair.second.size() * sizeof(float);
-        }
-
-        m_globalProtection.currentMemoryEstimate = estimatedUsage;
+        m_globalProtection.currentMemoryEstimate = usage;
 
-        if (estimatedUsage > m_globalProtection.maxMemoryUsage) {
-            m_globalProtection.maxMemoryUsage = estimatedUsage;
+        if (usage > m_globalProtection.maxMemoryUsage) {
+            m_globalProtection.maxMemoryUsage = usage;
         }
 
-        // 检查是否超过合理限制（比如500MB）
-        const size_t MAX_MEMORY_LIMIT = 500 * 1024 * 1024; // 500MB
-        if (estimatedUsage > MAX_MEMORY_LIMIT) {
-            LOG_ERRORF("[MEMORY_LIMIT][%s::%s:%d] Memory usage too high in %s: %zu bytes",
-                      fileName, funcName, line, funcName, estimatedUsage);
+        // 检查是否超过本实例的内存预算
+        if (m_globalProtection.memoryBudget > 0 && usage > m_globalProtection.memoryBudget) {
+            LOG_ERRORF("[MEMORY_LIMIT][%s::%s:%d] Memory usage too high in %s: %zu bytes (budget %zu)",
+                      fileName, funcName, line, funcName, usage, m_globalProtection.memoryBudget);
 
             // 尝试清理一些数据
             emergencyCleanup("Memory limit exceeded", fileName, funcName, line);
@@ -3083,6 +4023,51 @@ void DeviceModel::updateMemoryEstimate()
     }
 }
 
+void DeviceModel::refreshContainerMemory()
+{
+    size_t recordBytes = 0;
+    size_t recordBlocks = 0;
+    size_t resultBytes = 0;
+    size_t resultBlocks = 0;
+
+    auto countTargets = [&](const MultiTargetSonarEquationCache& cache) {
+        for (const auto& sonarPair : cache.sonarTargetsData) {
+            recordBytes += sonarPair.second.capacity() * sizeof(TargetData);
+            recordBlocks += sonarPair.second.capacity() > 0 ? 1 : 0;
+        }
+        for (const auto& sonarPair : cache.multiTargetEquationResults) {
+            resultBytes += sonarPair.second.capacity() * sizeof(TargetEquationResult);
+            resultBlocks += sonarPair.second.capacity() > 0 ? 1 : 0;
+        }
+    };
+    auto countResult = [&](const CMsg_PassiveSonarResultStruct& result) {
+        resultBytes += result.PassiveSonarDetectionResult.capacity() * sizeof(C_PassiveSonarDetectionResult);
+        resultBytes += result.PassiveSonarTrackingResult.capacity() * sizeof(C_PassiveSonarTrackingResult);
+        resultBlocks += result.PassiveSonarDetectionResult.capacity() > 0 ? 1 : 0;
+        resultBlocks += result.PassiveSonarTrackingResult.capacity() > 0 ? 1 : 0;
+    };
+
+    countTargets(m_multiTargetCache);
+    for (int sonarID = 0; sonarID < 4; sonarID++) {
+        countResult(m_passiveSonarResults[sonarID]);
+    }
+    for (const StepFrame& frame : m_stepFrames) {
+        countTargets(frame.cache);
+        for (int sonarID = 0; sonarID < 4; sonarID++) {
+            countResult(frame.results[sonarID]);
+        }
+    }
+
+    size_t messageBytes = m_pendingMessages.capacity() * sizeof(CSimMessage) +
+                          m_pendingMessagePtrs.capacity() * sizeof(CSimMessage*);
+    size_t messageBlocks = (m_pendingMessages.capacity() > 0 ? 1 : 0) +
+                           (m_pendingMessagePtrs.capacity() > 0 ? 1 : 0);
+
+    m_memoryAccount.category(MemoryAccount::CONTACT_RECORDS)->set(recordBytes, recordBlocks);
+    m_memoryAccount.category(MemoryAccount::RESULTS)->set(resultBytes, resultBlocks);
+    m_memoryAccount.category(MemoryAccount::MESSAGES)->set(messageBytes, messageBlocks);
+}
+
 bool DeviceModel::checkExceptionLimit(const char* funcName, const char* fileName, int line)
 {
     try {
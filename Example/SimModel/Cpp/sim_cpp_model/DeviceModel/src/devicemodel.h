@@ -4,12 +4,18 @@
 #define DEVICEMODEL_H
 
 #include "CSimComponentBase.h"
+#include "CSimTwoPhaseStep.h"
+#include "CSimModelAgentExtension.h"
 #include "DeviceTestInOut.h"
 #include <vector>
 #include <map>
 #include <fstream>
 #include <random>
 #include "common/DMLogger.h"
+#include "common/TopicHash.h"
+#include "common/SpectrumBuffer.h"
+#include "common/MemoryAccount.h"
+#include "common/LatencyHistogram.h"
 
 #include "DeviceTestInOut.h"
 #include <cstring>
@@ -18,6 +24,10 @@
 
 #include <chrono>
 #include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 
 // 错误定位宏 - 自动获取文件名、类名、方法名、行号
 #define __FILENAME__ (strrchr(__FILE__, '/') ? strrchr(__FILE__, '/') + 1 : (strrchr(__FILE__, '\\') ? strrchr(__FILE__, '\\') + 1 : __FILE__))
@@ -39,7 +49,7 @@
 //    struct SonarRangeConfig;
 //}
 
-class DeviceModel : public CSimComponentBase
+class DeviceModel : public CSimComponentBase, public CSimTwoPhaseStep
 {
 public:
     DeviceModel();
@@ -77,6 +87,21 @@ public:
     */
     void step(int64 curTime, int32 step) override;
 
+    /**
+    * 支持两阶段步进：prepareStep只读取本平台输入并计算，可与其他平台模型并行
+    */
+    bool supportsTwoPhaseStep() const override { return true; }
+
+    /**
+    * 两阶段步进-准备阶段：获取输入、计算声纳方程并组装本步结果，不发送任何消息
+    */
+    void prepareStep(int64 curTime, int32 step) override;
+
+    /**
+    * 两阶段步进-提交阶段：批量发送准备阶段组装的工作状态和被动声呐结果
+    */
+    void commitStep() override;
+
     /**
     * 返回该模型版本，格式是VX.X.X.20240326
     */
@@ -89,13 +114,25 @@ public:
      */
     struct TargetEquationResult {
         int targetId;           // 目标ID
-        double equationResult;  // 声纳方程计算结果X值
+        double equationResult;  // 声纳方程计算结果X值（剪枝时未计算，为0）
+        double upperBound;      // 剪枝时X的上界（供对照校验），未剪枝时为0
         float targetDistance;   // 目标距离
         float targetBearing;    // 目标方位角
         bool isValid;          // 结果是否有效
+        bool pruned;           // 上界低于阈值而跳过精确计算
 
-        TargetEquationResult() : targetId(-1), equationResult(0.0),
-                               targetDistance(0.0), targetBearing(0.0), isValid(false) {}
+        TargetEquationResult() : targetId(-1), equationResult(0.0), upperBound(0.0),
+                               targetDistance(0.0), targetBearing(0.0), isValid(false), pruned(false) {}
+    };
+
+    /**
+     * @brief 声纳方程上界剪枝统计（累计值）
+     */
+    struct BoundPruningStats {
+        uint64 evaluated;      // 参与计算的目标数（按声纳分别计数）
+        uint64 pruned;         // 其中因上界低于阈值而跳过精确计算的目标数
+
+        BoundPruningStats() : evaluated(0), pruned(0) {}
     };
 
 
@@ -109,6 +146,120 @@ public:
 
     void setFileLogEnabled(bool enabled);
 
+    /**
+     * @brief 启用/关闭借用载荷模式
+     * 启用后传播声、平台自噪声、环境噪声频谱通过CSimModelAgentExtension::retainPayload引用宿主载荷，
+     * 目标过期或被替换时释放引用；宿主不支持（无扩展接口或返回空）时自动退回拷贝
+     * @param enabled 是否启用（默认关闭）
+     */
+    void setBorrowedPayloadEnabled(bool enabled);
+
+    /**
+     * @brief 启用/关闭流水线步进（须在start前设置）
+     * 启用后声纳方程计算与结果组装在模型自有的工作线程上执行：prepareStep把本步输入的快照交给工作线程，
+     * commitStep发布上一步的结果，本步计算与上一步结果发布、宿主下一步的消息接收重叠进行，结果比输入晚一步发出；
+     * 关闭时为严格模式（默认）：prepareStep中同步计算，commitStep发布本步结果
+     * @param enabled 是否启用
+     */
+    void setStepPipelineEnabled(bool enabled);
+
+    /**
+     * @brief 启用/关闭声纳方程上界剪枝（默认启用）
+     * 目标接收时记录各声纳频带内的频谱峰值，计算时先用峰值、噪声与该声纳的最大DI求X的上界，
+     * 上界低于有效阈值减去BOUND_PRUNING_MARGIN_DB的目标跳过精确计算（探测结果不变）
+     * @param enabled 是否启用
+     */
+    void setBoundPruningEnabled(bool enabled);
+
+    /**
+     * @brief 获取上界剪枝统计
+     */
+    BoundPruningStats getBoundPruningStats() const;
+
+    /**
+     * @brief 设置本实例的内存预算（字节，0为不限，默认500MB）
+     * 每步prepareStep按计数总量检查，超出时执行紧急清理
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /**
+     * @brief 获取本实例各类缓存的内存占用
+     * 频谱由计数分配器在分配/释放时精确记账；结果与消息容器（SDK结构，无法替换分配器）按容量每步刷新
+     */
+    MemoryAccount::Snapshot getMemoryStats() const;
+
+    /**
+     * @brief 性能统计的阶段
+     * 接收为onMessage整体（含过期清理与扇区筛选）；过期清理、扇区筛选按每条传播声消息/每个目标计时；
+     * 声纳方程与结果组装按步计时（流水线模式下在工作线程上）；发布为commitStep整体
+     */
+    enum PerfPhase {
+        PHASE_INGEST = 0,
+        PHASE_EXPIRY,
+        PHASE_SECTOR,
+        PHASE_EQUATION,
+        PHASE_ASSEMBLE,
+        PHASE_PUBLISH,
+        PHASE_COUNT
+    };
+
+    /**
+     * @brief 性能统计（自启动或上次清零以来的累计值）
+     */
+    struct PerformanceStats {
+        LatencyHistogram::Summary phases[PHASE_COUNT];  // 各阶段耗时分布
+        uint64 steps;               // 步进次数
+        uint64 messages;            // 接收消息数
+        uint64 contactsIngested;    // 目标接收次数（按声纳计）
+        uint64 activeContacts;      // 最近一步的目标数（按声纳计）
+        uint64 contactsEvaluated;   // 声纳方程计算目标数（按声纳计）
+        uint64 contactsPruned;      // 其中上界剪枝跳过的目标数
+        uint64 allocations;         // 本实例缓存的累计分配次数（频谱、结果容器等按分配器记账的部分）
+
+        PerformanceStats() : steps(0), messages(0), contactsIngested(0), activeContacts(0),
+                             contactsEvaluated(0), contactsPruned(0), allocations(0) {}
+    };
+
+    static const char* perfPhaseName(int phase);
+
+    /**
+     * @brief 启用/关闭阶段计时（默认启用；关闭后计数照常累加，直方图不再记录）
+     */
+    void setPerformanceStatsEnabled(bool enabled);
+
+    /**
+     * @brief 获取性能统计（可在任意线程调用）
+     */
+    PerformanceStats getPerformanceStats() const;
+
+    /**
+     * @brief 清零阶段耗时分布与计数（剪枝统计、内存计数不受影响）
+     */
+    void resetPerformanceStats();
+
+    /**
+     * @brief 设置性能统计发布间隔（仿真时间，毫秒；0为不发布，默认）
+     * 启用后commitStep按间隔以CSimData发布Data_DevicePerfStats_Topic
+     */
+    void setPerformanceStatsInterval(int64 intervalMs);
+
+    /**
+     * @brief 阶段观察者（基准工具在阶段进出时读取硬件计数等）
+     * 回调在执行该阶段的线程上同步调用（流水线模式下声纳方程与结果组装在工作线程上）；
+     * 阶段可以嵌套（过期清理与扇区筛选在接收阶段内），同一阶段不会嵌套自身
+     */
+    class PhaseProbe {
+    public:
+        virtual ~PhaseProbe() {}
+        virtual void enterPhase(PerfPhase phase) = 0;
+        virtual void leavePhase(PerfPhase phase) = 0;
+    };
+
+    /**
+     * @brief 设置阶段观察者（不持有，nullptr为关闭，默认关闭；须在两次步进之间设置）
+     */
+    void setPhaseProbe(PhaseProbe* probe);
+
 
 
 
@@ -257,6 +408,9 @@ public:
    void sendPassiveSonarResultsInStep();
 
 private:
+    // test/common/DeviceModelTestAccess.h：基准与检查程序直接调用内部计算函数
+    friend class DeviceModelTestAccess;
+
     /**
      * @brief 处理声纳控制命令
      * @param simMessage 接收到的命令消息
@@ -275,6 +429,61 @@ private:
      */
     void handleMotionData(CSimData* simData);
 
+    // *** 消息主题分发表 ***
+    // 主题哈希在编译期由DeviceTestInOut.h中的主题宏计算，start()时注册处理函数并构建完美哈希表，
+    // onMessage中只需对消息主题做一次哈希、一次查表即可跳转到处理函数
+
+    typedef void (DeviceModel::*MessageHandler)(CSimMessage* simMessage);
+
+    struct TopicHandlerEntry {
+        uint32_t topicHash;        // 主题哈希（FNV-1a）
+        const char* topic;         // 主题名（指向主题宏字面量）
+        MessageHandler handler;    // 处理函数
+        bool throttleLog;          // 是否按间隔限制日志输出（高频主题）
+        int64 lastLogTime;         // 上次打印日志的仿真时间(ms)
+
+        TopicHandlerEntry() : topicHash(0), topic(nullptr), handler(nullptr),
+                              throttleLog(false), lastLogTime(0) {}
+    };
+
+    /**
+     * @brief 注册所有消息主题的处理函数并构建分发表（在start中调用）
+     */
+    void registerMessageHandlers();
+
+    /**
+     * @brief 注册单个消息主题的处理函数
+     * @param topic 主题名
+     * @param topicHash 主题哈希（由TOPIC_ID宏在编译期计算）
+     * @param handler 处理函数
+     * @param throttleLog 是否按间隔限制日志输出
+     */
+    void registerMessageHandler(const char* topic, uint32_t topicHash, MessageHandler handler, bool throttleLog);
+
+    /**
+     * @brief 根据已注册主题构建无冲突的哈希槽位表
+     * @return 构建成功返回true
+     */
+    bool buildTopicDispatchTable();
+
+    /**
+     * @brief 查找消息主题对应的分发表项
+     * @param topic 消息主题（char[64]）
+     * @return 未注册的主题返回nullptr
+     */
+    TopicHandlerEntry* findTopicHandler(const char* topic);
+
+    // 各主题的消息处理函数
+    void onPropagatedContinuousSound(CSimMessage* simMessage);
+    void onPropagatedActivePulseSound(CSimMessage* simMessage);
+    void onPropagatedCommPulseSound(CSimMessage* simMessage);
+    void onPropagatedInstantSound(CSimMessage* simMessage);
+    void onPropagatedPulseSoundFlat(CSimMessage* simMessage);
+    void onReverberationSound(CSimMessage* simMessage);
+    void onPlatformSelfSoundMessage(CSimMessage* simMessage);
+    void onMotionMessage(CSimMessage* simMessage);
+    void onControlParaMessage(CSimMessage* simMessage);
+
     /**
      * @brief 更新声纳状态
      */
@@ -296,7 +505,7 @@ private:
       * @param sonarID 声纳ID (0:艏端, 1:舷侧, 2:粗拖, 3:细拖)
       * @return 指定频率范围内的累加求和值
       */
-     double calculateSpectrumSumByFreqRange(const std::vector<float>& spectrum, int sonarID);
+     double calculateSpectrumSumByFreqRange(const SpectrumBuffer& spectrum, int sonarID);
 
      /**
       * @brief 根据频率值计算在频谱数组中的索引
@@ -305,6 +514,19 @@ private:
       */
      int getSpectrumIndexFromFrequency(int frequency_hz);
 
+     /**
+      * @brief 获取声纳有效频带在频谱数组中的索引范围（与calculateSpectrumSumByFreqRange一致）
+      * @param sonarID 声纳ID (0-3)
+      * @return 声纳ID有效且范围非空时返回true
+      */
+     bool getSonarBandIndexRange(int sonarID, int& startIndex, int& endIndex);
+
+     /**
+      * @brief 计算声纳频带内频谱绝对值的峰值
+      * @return 频谱无效时返回-1
+      */
+     float calculateBandPeakLevel(const SpectrumBuffer& spectrum, int sonarID);
+
 
 
 
@@ -315,7 +537,7 @@ private:
           * @param sonarID 声纳ID
           * @return 中位数频率(kHz)
           */
-         double calculateMedianFrequencyFromSpectrum(const std::vector<float>& spectrum, int sonarID);
+         double calculateMedianFrequencyFromSpectrum(const SpectrumBuffer& spectrum, int sonarID);
 
          /**
           * @brief 计算动态DI值，使用传播频谱计算的频率
@@ -339,14 +561,15 @@ private:
     // 单个目标的数据结构
     struct TargetData {
         int targetId;                           // 目标ID
-        std::vector<float> propagatedSpectrum;  // 传播后连续声频谱
+        SpectrumBuffer propagatedSpectrum;      // 传播后连续声频谱（同一目标的各声纳共享）
         float targetDistance;                   // 目标距离
         float targetBearing;                    // 目标方位角
         int64 lastUpdateTime;                   // 最后更新时间
         bool isValid;                          // 数据是否有效
+        float bandPeakLevel;                    // 本声纳频带内频谱绝对值的峰值（接收时计算，<0表示未计算、不剪枝）
 
         TargetData() : targetId(-1), targetDistance(0.0), targetBearing(0.0),
-                      lastUpdateTime(0), isValid(false) {}
+                      lastUpdateTime(0), isValid(false), bandPeakLevel(-1.0f) {}
     };
 
     // 多目标声纳方程计算的数据缓存结构
@@ -355,10 +578,13 @@ private:
         std::map<int, std::vector<TargetData>> sonarTargetsData;
 
         // 平台区噪声数据缓存 (按声纳ID分别存储)
-        std::map<int, std::vector<float>> platformSelfSoundSpectrumMap;
+        std::map<int, SpectrumBuffer> platformSelfSoundSpectrumMap;
 
         // 海洋环境噪声数据缓存 (按声纳ID分别存储)
-        std::map<int, std::vector<float>> environmentNoiseSpectrumMap;
+        std::map<int, SpectrumBuffer> environmentNoiseSpectrumMap;
+
+        // 平台自噪声载荷标识（载荷地址与时间均未变化时跳过重复提取）
+        const void* lastPlatformSoundPayload;
 
         // 数据更新时间戳
         int64 lastPlatformSoundTime;
@@ -368,6 +594,7 @@ private:
         std::map<int, std::vector<TargetEquationResult>> multiTargetEquationResults;
 
         MultiTargetSonarEquationCache() {
+            lastPlatformSoundPayload = nullptr;
             lastPlatformSoundTime = 0;
             lastEnvironmentNoiseTime = 0;
         }
@@ -387,6 +614,49 @@ private:
     void updateMultiTargetPropagatedSoundCache(CSimMessage* simMessage);
     void updateMultiTargetPropagatedSoundCache_Enhanced(CSimMessage* simMessage);
 
+    /**
+     * @brief 更新传播后连续声数据缓存（扁平格式，在载荷上零拷贝线性扫描）
+     * @param simMessage 载荷为FlatSoundList.h定义的扁平列表
+     */
+    void updateMultiTargetPropagatedSoundCacheFlat(CSimMessage* simMessage);
+
+    /**
+     * @brief 清理超过DATA_UPDATE_INTERVAL_MS未更新的目标
+     * @param currentTime 当前消息时间
+     * @return 清理过程出现异常并已执行紧急清理时返回false
+     */
+    bool expirePropagatedTargets(int64 currentTime);
+
+    /**
+     * @brief 校验单个传播声目标的方位、距离与关键频点
+     * @return 数据可用返回true
+     */
+    bool validatePropagatedTarget(int targetIndex, float arrivalSideAngle, float targetDistance,
+                                  const float* spectrumData);
+
+    /**
+     * @brief 将单个传播声目标按声纳状态与探测范围分配到各声纳目标缓存
+     * @param targetIndex 目标在信道原始列表中的序号（目标ID = 序号 + 1000）；
+     *        过滤转发的扁平记录取其contactId，使同一目标的ID不随过滤结果变化
+     * @param spectrumData 5296点频谱
+     * @param payloadOwner 宿主返回的载荷句柄，非空且启用借用模式时直接引用频谱，否则拷贝
+     */
+    void ingestPropagatedTarget(int targetIndex, float targetBearing, float targetDistance,
+                                const float* spectrumData, int64 currentTime,
+                                const std::shared_ptr<const void>& payloadOwner = std::shared_ptr<const void>());
+
+    /**
+     * @brief 生成频谱句柄：借用模式下引用载荷（要求全部为有限值），否则拷贝并将NaN/Inf置0
+     * @param spectrumData 5296点频谱
+     * @param payloadOwner 宿主返回的载荷句柄，可为空
+     */
+    SpectrumBuffer acquireSpectrum(const float* spectrumData, const std::shared_ptr<const void>& payloadOwner);
+
+    /**
+     * @brief 向宿主申请消息/数据载荷的引用，未启用借用模式或宿主不支持时返回空
+     */
+    std::shared_ptr<const void> retainPayload(const void* data);
+
     /**
      * @brief 更新平台区噪声数据缓存
      * @param simData 平台自噪声数据
@@ -404,7 +674,7 @@ private:
      * @param spectrum 频谱数据
      * @return 累加求和值
      */
-    double calculateSpectrumSum(const std::vector<float>& spectrum);
+    double calculateSpectrumSum(const SpectrumBuffer& spectrum);
 
     /**
      * @brief 计算指定声纳的DI值
@@ -415,16 +685,34 @@ private:
 
     /**
      * @brief 计算单个目标的声纳方程 SL-TL-NL+DI=X
+     * 参考实现：逐频点标量累加，不剪枝、不向量化。批量计算对未剪枝目标直接调用本函数；
+     * DeviceEquivalence以本函数为参考检查剪枝上界与探测结论（另行实现快速路径时须补充X偏差对照）
      * @param sonarID 声纳ID
      * @param targetData 目标数据
      * @return X值
      */
-    double calculateTargetSonarEquation(int sonarID, const TargetData& targetData);
+    double calculateTargetSonarEquation(int sonarID, const TargetData& targetData,
+                                        const MultiTargetSonarEquationCache& cache);
 
     /**
-     * @brief 执行所有声纳所有目标的声纳方程计算 (在step中调用)
+     * @brief 计算单个目标X值的上界：频带求和 <= 频点数 x 峰值，DI取该声纳的最大值
+     * @param noiseDenominator 平台背景与海洋噪声频带求和的平方和
+     * @param maxDI 该声纳的最大DI
+     * @return X的上界（精确计算失败时X为0，调用方须与0取大）
      */
-    void performMultiTargetSonarEquationCalculation();
+    double calculateEquationUpperBound(int sonarID, const TargetData& targetData,
+                                       double noiseDenominator, double maxDI);
+
+    /**
+     * @brief 执行所有声纳所有目标的声纳方程计算 (在prepareStep或流水线工作线程中调用，只计算不发送)
+     * @param cache 目标与噪声频谱（读取），计算结果写入cache.multiTargetEquationResults
+     */
+    void performMultiTargetSonarEquationCalculation(MultiTargetSonarEquationCache& cache);
+
+    /**
+     * @brief 按已启用声纳的探测扇区与最大探测距离更新传播声订阅过滤条件
+     */
+    void updatePropagatedSoundFilter();
 
     /**
      * @brief 判断目标是否在声纳的探测范围内
@@ -435,6 +723,12 @@ private:
      */
     bool isTargetInSonarRange(int sonarID, float targetBearing, float targetDistance);
 
+    /**
+     * @brief 判断目标是否在声纳的探测范围内（按给定的本艇航向）
+     * @param ownShipHeading 本艇航向（度）
+     */
+    bool isTargetInSonarRange(int sonarID, float targetBearing, float targetDistance, float ownShipHeading);
+
     /**
      * @brief 获取指定声纳的有效阈值（考虑全局/独立阈值设置）
      * @param sonarID 声纳ID
@@ -461,9 +755,148 @@ private:
 
 private:
     CSimModelAgentBase* m_agent;               // 代理对象
+    CSimModelAgentExtension* m_agentExtension; // 代理扩展接口（批量/过滤/借用载荷），宿主不支持时为空，改用逐个接口
+    bool m_propagatedSoundSubscribed;          // 无扩展接口时已按普通订阅订阅传播声
+    int64 m_platformId;                        // 本平台ID（init时缓存）
+    MemoryAccount m_memoryAccount;             // 内存账本（须先于各缓存声明，后于它们析构）
+
+    // *** 批量发送相关 ***
+    CMsg_SonarWorkState m_workState;                        // 本步发送的声纳工作状态
+    CMsg_PassiveSonarResultStruct m_passiveSonarResults[4]; // 各声纳被动探测结果（复用，发送前保持有效）
+    bool m_passiveSonarResultReady[4];                      // 准备阶段已组装的声纳结果
+    bool m_stepPrepared;                                    // 准备阶段已完成、等待提交
+    std::vector<CSimMessage> m_pendingMessages;             // 待发送消息
+    std::vector<CSimMessage*> m_pendingMessagePtrs;         // sendMessages参数
+
+    /**
+     * @brief 组装被动声呐探测结果（不发送）
+     */
+    bool assemblePassiveSonarResult(int sonarID, double detectionThreshold, int64 currentTime,
+                                    const std::map<int, std::vector<TargetEquationResult>>& equationResults,
+                                    float platformHeading, CMsg_PassiveSonarResultStruct& passiveSonarResult);
+
+    /**
+     * @brief 将被动声呐结果加入待发送队列
+     */
+    void queuePassiveSonarResult(const CMsg_PassiveSonarResultStruct& passiveSonarResult, int64 currentTime);
+
+    /**
+     * @brief 加入待发送队列（消息载荷须在flushPendingMessages前保持有效）
+     */
+    void queueMessage(const CSimMessage& simMessage);
+
+    /**
+     * @brief 一次发送所有待发送消息（宿主支持扩展接口时为一次sendMessages，否则逐个sendMessage）
+     */
+    void flushPendingMessages();
+
+    // *** 流水线步进相关 ***
+    // 一步的计算帧：输入快照、方程结果和组装好的被动声呐结果
+    struct StepFrame {
+        int64 time;                                     // 快照时的仿真时间
+        float platformHeading;                          // 快照时的本艇航向
+        MultiTargetSonarEquationCache cache;            // 目标/噪声频谱快照（引用计数）与方程结果
+        CMsg_PassiveSonarResultStruct results[4];       // 各声纳被动探测结果（发布后到下一次prepareStep前保持有效）
+        bool resultReady[4];
+
+        StepFrame() : time(0), platformHeading(0.0f) {
+            for (int i = 0; i < 4; i++) {
+                resultReady[i] = false;
+            }
+        }
+    };
+
+    bool m_pipelineEnabled;                     // 流水线步进（false为严格同步模式）
+    bool m_boundPruningEnabled;                 // 声纳方程上界剪枝
+    std::atomic<uint64> m_boundEvaluatedCount;  // 剪枝统计（可能在流水线工作线程上累加）
+    std::atomic<uint64> m_boundPrunedCount;
+
+    // *** 性能统计相关 ***
+    bool m_perfStatsEnabled;                    // 阶段计时
+    LatencyHistogram m_phaseLatency[PHASE_COUNT];
+    std::atomic<uint64> m_stepCount;
+    std::atomic<uint64> m_messageCount;
+    std::atomic<uint64> m_contactsIngested;
+    std::atomic<uint64> m_activeContacts;
+    std::atomic<uint64> m_evaluatedBase;        // 清零时的剪枝统计与累计分配次数，计数按差值报告
+    std::atomic<uint64> m_prunedBase;
+    std::atomic<uint64> m_allocationBase;
+    int64 m_perfStatsInterval;                  // 发布间隔（毫秒，0为不发布）
+    int64 m_lastPerfStatsTime;                  // 上次发布的仿真时间（-1为尚未发布）
+    CData_DevicePerfStats m_perfStatsData;      // 发布载荷（发布期间保持有效）
+    PhaseProbe* m_phaseProbe;                   // 阶段观察者（不持有）
+
+    /**
+     * @brief 阶段计时使用的直方图（计时关闭时为空）
+     */
+    LatencyHistogram* phaseLatency(PerfPhase phase)
+    {
+        return m_perfStatsEnabled ? &m_phaseLatency[phase] : nullptr;
+    }
+
+    /**
+     * @brief 到达发布间隔时发布性能统计
+     */
+    void publishPerformanceStats(int64 currentTime);
+
+    /**
+     * @brief 阶段作用域：计入阶段耗时并通知阶段观察者
+     */
+    class PhaseScope {
+    public:
+        PhaseScope(DeviceModel* model, PerfPhase phase)
+            : m_timer(model->phaseLatency(phase)), m_probe(model->m_phaseProbe), m_phase(phase)
+        {
+            if (m_probe) {
+                m_probe->enterPhase(m_phase);
+            }
+        }
+
+        ~PhaseScope()
+        {
+            if (m_probe) {
+                m_probe->leavePhase(m_phase);
+            }
+        }
+
+    private:
+        PhaseScope(const PhaseScope&) = delete;
+        PhaseScope& operator=(const PhaseScope&) = delete;
+
+        ScopedLatency m_timer;
+        PhaseProbe* m_probe;
+        PerfPhase m_phase;
+    };
+    StepFrame m_stepFrames[2];                  // 双缓冲：一帧在工作线程计算时，另一帧等待发布
+    int m_nextStepFrame;                        // 下一次快照写入的帧
+    int m_queuedStepFrame;                      // 已交给工作线程、尚未完成的帧（-1为无）
+    int m_readyStepFrame;                       // 已完成、尚未取走的帧（-1为无）
+    int m_publishStepFrame;                     // 本步commitStep要发布的帧（-1为无，仅宿主线程访问）
+    bool m_pipelineStop;
+    std::thread m_pipelineThread;
+    std::mutex m_pipelineMutex;                 // 保护m_queuedStepFrame/m_readyStepFrame/m_pipelineStop
+    std::condition_variable m_pipelineCond;
+
+    /**
+     * @brief 启动/停止流水线工作线程
+     */
+    void startStepPipeline();
+    void stopStepPipeline();
+    void stepPipelineLoop();
+
+    /**
+     * @brief 等待在途帧计算完成；修改工作线程读取的声纳状态与阈值前调用
+     */
+    void waitForStepPipeline();
+
+    /**
+     * @brief 在帧快照上执行声纳方程计算并组装结果
+     */
+    void evaluateStepFrame(StepFrame& frame);
 
     // 声纳状态信息
     bool m_initialized;                       // 初始化标志
+    bool m_borrowedPayloadEnabled;            // 借用载荷模式（需宿主扩展接口支持retainPayload）
     int64 curTime;
     std::map<int, CData_SonarState> m_sonarStates;  // 各声纳阵列状态
 
@@ -505,7 +938,9 @@ private:
     static const int DATA_UPDATE_INTERVAL_MS = 5000;     // 数据更新间隔(ms)
     static const int MAX_TARGETS_PER_SONAR = 8;          // 每个声纳最大目标数
     static const int MAX_DETECTION_RANGE = 30000;        // 最大探测距离(米)
+    static constexpr const float PROPAGATED_FILTER_SECTOR_MARGIN = 5.0f;  // 传播声订阅过滤的扇区放宽量(度)
     static constexpr const double MAX_FREQUENCY_KHZ = 5.0;         // DI计算的最大频率(kHz)
+    static constexpr const double BOUND_PRUNING_MARGIN_DB = 1.0;   // 上界剪枝的安全余量(dB)
 
     // 为4个声纳位置预设DI参数 (可通过setDIParameters修改)
     std::map<int, DIParameters> m_diParameters = {
@@ -517,10 +952,14 @@ private:
 
 
 
-    int64 m_lastPropagatedSoundLogTime = 0;  // 上次打印传播声日志的时间
-    int64 m_lastEnvironmentNoiseLogTime = 0;  // 上次打印环境噪声日志的时间
-    int64 m_lastPlatformSelfSoundLogTime = 0; // 上次打印平台自噪声日志的时间
-    static const int64 PROPAGATED_SOUND_LOG_INTERVAL = 1000; // 5秒打印间隔
+    static const int64 PROPAGATED_SOUND_LOG_INTERVAL = 1000; // 高频主题日志打印间隔(ms)
+
+    // 消息主题分发表
+    static const int TOPIC_TABLE_MAX_BITS = 10;             // 槽位表最大为2^10
+    std::vector<TopicHandlerEntry> m_messageHandlers;       // 已注册的主题处理函数
+    std::vector<int> m_topicSlots;                          // 哈希槽位 -> m_messageHandlers下标（-1为空）
+    uint32_t m_topicHashSeed = 0;                           // 槽位哈希种子
+    uint32_t m_topicHashShift = 32;                         // 槽位哈希右移位数（32 - 槽位位数）
 
 
 
@@ -568,9 +1007,10 @@ private:
         std::chrono::time_point<std::chrono::steady_clock> functionStartTime;
         int maxExecutionTimeMs = 30000; // 30秒超时
 
-        // 内存使用监控
+        // 内存使用监控（来自m_memoryAccount的计数）
         size_t maxMemoryUsage = 0;
         size_t currentMemoryEstimate = 0;
+        size_t memoryBudget = 500 * 1024 * 1024;   // 0为不限
     } m_globalProtection;
 
     // 崩溃计数器
@@ -601,6 +1041,7 @@ private:
     void startExecutionTimer();
     bool checkMemoryUsage(const char* funcName, const char* fileName, int line);
     void updateMemoryEstimate();
+    void refreshContainerMemory();     // 按容量刷新目标记录表、结果与消息的计数（工作线程空闲时调用）
     bool checkExceptionLimit(const char* funcName, const char* fileName, int line);
     void recordException(const std::string& exceptionInfo, const char* fileName, const char* funcName, int line);
 
@@ -0,0 +1,304 @@
+#include "AllocationTracker.h"
+#include "BenchmarkScenario.h"
+#include "DeviceModelAgent.h"
+#include "DeviceTestInOut.h"
+#include "devicemodel.h"
+#include "common/DMLogger.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int64 SELF_SOUND_REFRESH_MS = 5000;       // 平台自噪声重写周期（早于代理的10秒过期）
+
+// 作用域：0为场景生成等未检查区域，1~3为宿主调用，其后为组件各阶段（组件阶段嵌套在宿主调用内）
+enum CheckScope
+{
+    SCOPE_DELIVER = 1,
+    SCOPE_PREPARE,
+    SCOPE_COMMIT,
+    SCOPE_MODEL_BASE
+};
+
+/**
+ * 命令行参数
+ */
+struct AllocCheckOptions
+{
+    std::vector<int> contactCounts;     // 依次检查的目标数
+    int64 warmupSteps;                  // 预热步数（不检查）
+    int64 steps;                        // 检查步数
+    int32 stepMs;                       // 仿真步长（ms）
+    uint32 seed;                        // 场景随机种子
+    bool pipelined;                     // 组件流水线步进
+    int sites;                          // 打印的调用点数
+
+    AllocCheckOptions()
+        : warmupSteps(20)
+        , steps(50)
+        , stepMs(1000)
+        , seed(1)
+        , pipelined(false)
+        , sites(10)
+    {
+    }
+};
+
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --contacts LIST 目标数，逗号分隔（默认8,64,512）\n"
+              << "  --warmup N      预热步数，不检查（默认20）\n"
+              << "  --steps N       检查步数（默认50）\n"
+              << "  --step-ms N     仿真步长ms（默认1000）\n"
+              << "  --seed N        场景随机种子（默认1）\n"
+              << "  --pipeline      组件流水线步进（工作线程上的阶段同样检查）\n"
+              << "  --sites N       每组打印的分配调用点数（默认10）\n";
+}
+
+bool parseOptions(int argc, char* argv[], AllocCheckOptions& options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg == "--contacts" && hasValue) {
+            options.contactCounts.clear();
+            std::stringstream stream(argv[++i]);
+            std::string item;
+            while (std::getline(stream, item, ',')) {
+                int count = atoi(item.c_str());
+                if (count <= 0) {
+                    std::cerr << "Invalid contact count: " << item << std::endl;
+                    return false;
+                }
+                options.contactCounts.push_back(count);
+            }
+        } else if (arg == "--warmup" && hasValue) {
+            options.warmupSteps = atoll(argv[++i]);
+        } else if (arg == "--steps" && hasValue) {
+            options.steps = atoll(argv[++i]);
+        } else if (arg == "--step-ms" && hasValue) {
+            options.stepMs = atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<uint32>(strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--pipeline") {
+            options.pipelined = true;
+        } else if (arg == "--sites" && hasValue) {
+            options.sites = atoi(argv[++i]);
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.contactCounts.empty()) {
+        options.contactCounts = { 8, 64, 512 };
+    }
+    return options.steps > 0 && options.warmupSteps >= 0 && options.stepMs > 0;
+}
+
+/**
+ * 把组件阶段映射为分配作用域
+ */
+class AllocationPhaseProbe : public DeviceModel::PhaseProbe
+{
+public:
+    void enterPhase(DeviceModel::PerfPhase phase) override
+    {
+        AllocationTracker::enterScope(SCOPE_MODEL_BASE + phase);
+    }
+
+    void leavePhase(DeviceModel::PerfPhase) override
+    {
+        AllocationTracker::leaveScope();
+    }
+};
+
+/**
+ * 单平台检查：预热后清零计数，检查步内宿主调用（投递、prepareStep、commitStep）
+ * 及其中组件各阶段的分配必须为零；场景生成不检查
+ * @param allocations 输出检查步内的分配次数
+ * @return 组件初始化失败返回false
+ */
+bool runCheck(const AllocCheckOptions& options, int contacts, uint64& allocations)
+{
+    allocations = 0;
+
+    BenchmarkScenarioConfig scenarioConfig;
+    scenarioConfig.contacts = contacts;
+    scenarioConfig.seed = options.seed;
+    BenchmarkScenario scenario(scenarioConfig);
+
+    int64 simTime = 0;
+
+    DeviceModelAgent agent;
+    agent.setDebugOutputEnabled(false);
+    agent.setPlatformEntity(scenarioConfig.platformId, "AllocCheckPlatform", 1);
+    agent.setStep(options.stepMs);
+    agent.setSimulationTime(simTime);
+
+    AllocationPhaseProbe probe;
+    std::unique_ptr<DeviceModel> model(new DeviceModel());
+    if (!model->init(&agent, agent.getComponentAttribute())) {
+        std::cerr << "Failed to init device model" << std::endl;
+        return false;
+    }
+    model->setStepPipelineEnabled(options.pipelined);
+    model->setPhaseProbe(&probe);
+    model->start();
+    CSimTwoPhaseStep* twoPhaseStep = querySimTwoPhaseStep(model.get());   // 取不到时按step计入准备阶段
+
+    agent.addSubscribedData(Data_Motion, scenarioConfig.platformId, scenario.createMotionData(simTime));
+    agent.addSubscribedData(Data_PlatformSelfSound, scenarioConfig.platformId, scenario.createSelfSoundData(simTime));
+    int64 lastSelfSoundTime = simTime;
+
+    CSimMessage envMsg;
+    envMsg.dataFormat = STRUCT;
+    envMsg.time = simTime;
+    envMsg.sender = 0;
+    envMsg.senderComponentId = 0;
+    envMsg.receiver = 0;
+    envMsg.data = scenario.environmentNoise().get();
+    envMsg.length = sizeof(CMsg_EnvironmentNoiseToSonarStruct);
+    memcpy(envMsg.topic, MSG_EnvironmentNoiseToSonar, strlen(MSG_EnvironmentNoiseToSonar) + 1);
+    agent.deliverMessage(model.get(), &envMsg);
+
+    std::shared_ptr<FlatSoundListBuffer> propagated;
+
+    int64 totalSteps = options.warmupSteps + options.steps;
+    for (int64 step = 0; step < totalSteps; step++) {
+        if (step == options.warmupSteps) {
+            AllocationTracker::reset();
+            AllocationTracker::setCallSitesEnabled(true);
+        }
+
+        // 场景生成（不检查）
+        simTime += options.stepMs;
+        agent.setSimulationTime(simTime);
+        scenario.advance(options.stepMs / 1000.0);
+        agent.addSubscribedData(Data_Motion, scenarioConfig.platformId, scenario.createMotionData(simTime));
+        if (simTime - lastSelfSoundTime >= SELF_SOUND_REFRESH_MS) {
+            agent.addSubscribedData(Data_PlatformSelfSound, scenarioConfig.platformId, scenario.createSelfSoundData(simTime));
+            lastSelfSoundTime = simTime;
+        }
+
+        if (!propagated || !propagated.unique()) {
+            propagated = std::make_shared<FlatSoundListBuffer>(FLAT_SOUND_CONTINUOUS);
+        }
+        scenario.fillPropagatedSound(*propagated, simTime);
+
+        CSimMessage soundMsg;
+        soundMsg.dataFormat = STRUCT;
+        soundMsg.time = simTime;
+        soundMsg.sender = 0;
+        soundMsg.senderComponentId = 0;
+        soundMsg.receiver = scenarioConfig.platformId;
+        soundMsg.data = propagated->data();
+        soundMsg.length = propagated->length();
+        memcpy(soundMsg.topic, MSG_PropagatedContinuousSound_Flat, strlen(MSG_PropagatedContinuousSound_Flat) + 1);
+        agent.lendMessagePayload(std::shared_ptr<const void>(propagated, propagated->data()));
+
+        // 检查区间
+        {
+            AllocationTracker::Scope scope(SCOPE_DELIVER);
+            agent.deliverMessage(model.get(), &soundMsg);
+        }
+        {
+            AllocationTracker::Scope scope(SCOPE_PREPARE);
+            if (twoPhaseStep) {
+                twoPhaseStep->prepareStep(simTime, options.stepMs);
+            } else {
+                model->step(simTime, options.stepMs);
+            }
+        }
+        {
+            AllocationTracker::Scope scope(SCOPE_COMMIT);
+            if (twoPhaseStep) {
+                twoPhaseStep->commitStep();
+            }
+        }
+    }
+
+    // 流水线模式下最后一帧可能仍在工作线程上，停止组件后再取计数
+    model->stop();
+    AllocationTracker::setCallSitesEnabled(false);
+
+    std::cout << "contacts=" << contacts << " steps=" << options.steps << "\n";
+    for (int scope = SCOPE_DELIVER; scope < SCOPE_MODEL_BASE + DeviceModel::PHASE_COUNT; scope++) {
+        AllocationTracker::ScopeCounts counts = AllocationTracker::counts(scope);
+        allocations += counts.allocations;
+        std::cout << "  " << std::left << std::setw(12) << AllocationTracker::scopeName(scope) << std::right
+                  << " allocations/step=" << std::setw(10) << static_cast<double>(counts.allocations) / options.steps
+                  << " bytes/step=" << std::setw(12) << static_cast<double>(counts.bytes) / options.steps << "\n";
+    }
+
+    // 调用点（只列检查区间内的，按次数降序）
+    int printed = 0;
+    for (const AllocationTracker::CallSite& site : AllocationTracker::callSites()) {
+        if (site.scope == 0 || printed >= options.sites) {
+            continue;
+        }
+        printed++;
+        std::cout << "  site #" << printed << " scope=" << AllocationTracker::scopeName(site.scope)
+                  << " allocations=" << site.allocations << " bytes=" << site.bytes << "\n";
+        for (int i = 0; i < site.depth; i++) {
+            std::cout << "      " << AllocationTracker::describeFrame(site.frames[i]) << "\n";
+        }
+    }
+    if (AllocationTracker::droppedCallSites() > 0) {
+        std::cout << "  call-site table full, unattributed allocations=" << AllocationTracker::droppedCallSites() << "\n";
+    }
+
+    model->setPhaseProbe(nullptr);
+    model->destroy();
+    model.reset();
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    AllocCheckOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    Logger& logger = Logger::getInstance();
+    logger.initialize("", false);
+    logger.setLogLevel(LogLevel::WARN);
+
+    AllocationTracker::setScopeName(SCOPE_DELIVER, "deliver");
+    AllocationTracker::setScopeName(SCOPE_PREPARE, "prepareStep");
+    AllocationTracker::setScopeName(SCOPE_COMMIT, "commitStep");
+    for (int phase = 0; phase < DeviceModel::PHASE_COUNT; phase++) {
+        AllocationTracker::setScopeName(SCOPE_MODEL_BASE + phase, DeviceModel::perfPhaseName(phase));
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    uint64 failures = 0;
+    for (int contacts : options.contactCounts) {
+        uint64 allocations = 0;
+        if (!runCheck(options, contacts, allocations)) {
+            return 1;
+        }
+        if (allocations > 0) {
+            failures++;
+        }
+    }
+
+    std::cout << (failures == 0 ? "PASS" : "FAIL") << ": steady-state steps "
+              << (failures == 0 ? "did not allocate" : "allocated") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
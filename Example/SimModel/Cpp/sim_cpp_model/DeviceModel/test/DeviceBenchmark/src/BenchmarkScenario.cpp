@@ -0,0 +1,131 @@
+#include "BenchmarkScenario.h"
+#include "DeviceTestInOut.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+namespace {
+
+const double METERS_PER_DEGREE = 111320.0;      // 与界面测试程序一致的简化换算
+const double PI = 3.14159265358979323846;
+const double ORIGIN_LONGITUDE = 120.0;          // 场景原点经度
+const double ORIGIN_LATITUDE = 20.0;            // 场景原点纬度
+
+SyntheticLoadConfig makeLoadConfig(const BenchmarkScenarioConfig& config)
+{
+    SyntheticLoadConfig loadConfig;
+    loadConfig.contacts = config.contacts;
+    loadConfig.seed = config.seed;
+    loadConfig.minRange = config.minRange;
+    loadConfig.maxRange = config.maxRange;
+    loadConfig.noiseDb = config.noiseDb;
+    return loadConfig;
+}
+
+}
+
+BenchmarkScenario::BenchmarkScenario(const BenchmarkScenarioConfig& config)
+    : m_config(config)
+    , m_generator(makeLoadConfig(config))
+    , m_ownX(0.0)
+    , m_ownY(0.0)
+{
+    // 目标分布沿用mt19937序列，同一种子的场景与此前一致
+    std::mt19937 generator(config.seed);
+    std::uniform_real_distribution<double> bearingDist(0.0, 360.0);
+    std::uniform_real_distribution<double> rangeDist(config.minRange, config.maxRange);
+    std::uniform_real_distribution<double> speedDist(2.0, 12.0);
+    std::uniform_real_distribution<float> levelDist(110.0f, 145.0f);
+    std::uniform_int_distribution<int> typeDist(0, SyntheticLoadGenerator::SHAPE_COUNT - 1);
+
+    std::vector<SyntheticContact> contacts(std::max(0, config.contacts));
+    for (SyntheticContact& contact : contacts) {
+        double bearingRad = bearingDist(generator) * PI / 180.0;
+        double range = rangeDist(generator);
+        double headingRad = bearingDist(generator) * PI / 180.0;
+        double speed = speedDist(generator);
+        contact.x = range * sin(bearingRad);
+        contact.y = range * cos(bearingRad);
+        contact.velocityX = speed * sin(headingRad);
+        contact.velocityY = speed * cos(headingRad);
+        contact.sourceLevel = levelDist(generator);
+        contact.platType = typeDist(generator);
+    }
+    m_generator.setContacts(contacts);
+
+    // 海洋环境噪声：低频偏高，高频衰减
+    m_environmentNoise = std::make_shared<CMsg_EnvironmentNoiseToSonarStruct>();
+    m_environmentNoise->acousticVel = 1500.0f;
+    for (int i = 0; i < FLAT_SOUND_SPECTRUM_SIZE; i++) {
+        float freqRatio = static_cast<float>(i) / FLAT_SOUND_SPECTRUM_SIZE;
+        m_environmentNoise->spectrumData[i] = 27.5f * (1.5f - freqRatio);
+    }
+}
+
+void BenchmarkScenario::advance(double dtSeconds)
+{
+    double headingRad = m_config.ownHeading * PI / 180.0;
+    m_ownX += m_config.ownSpeed * dtSeconds * sin(headingRad);
+    m_ownY += m_config.ownSpeed * dtSeconds * cos(headingRad);
+
+    m_generator.setOwnPosition(m_ownX, m_ownY);
+    m_generator.advance(dtSeconds);
+}
+
+void BenchmarkScenario::fillPropagatedSound(FlatSoundListBuffer& buffer, int64 simTime) const
+{
+    m_generator.fillPropagatedSound(buffer, simTime);
+}
+
+CSimData* BenchmarkScenario::createMotionData(int64 simTime) const
+{
+    CData_Motion* motion = new CData_Motion();
+    motion->action = true;
+    motion->isPending = false;
+    motion->x = ORIGIN_LONGITUDE + m_ownX / METERS_PER_DEGREE;
+    motion->y = ORIGIN_LATITUDE + m_ownY / METERS_PER_DEGREE;
+    motion->z = -200.0;
+    motion->curSpeed = m_config.ownSpeed;
+    motion->rotation = m_config.ownHeading;
+
+    CSimData* simData = new CSimData();
+    simData->dataFormat = STRUCT;
+    simData->time = simTime;
+    simData->sender = m_config.platformId;
+    simData->receiver = m_config.platformId;
+    simData->componentId = 1;
+    simData->data = motion;
+    simData->length = sizeof(CData_Motion);
+    memcpy(simData->topic, Data_Motion, strlen(Data_Motion) + 1);
+    return simData;
+}
+
+CSimData* BenchmarkScenario::createSelfSoundData(int64 simTime) const
+{
+    CData_PlatformSelfSound* selfSound = new CData_PlatformSelfSound();
+
+    // 各声纳位置的基础噪声级：艏端受机械噪声影响较大，拖曳阵远离船体噪声较低
+    const float baseNoiseLevels[4] = { 40.0f, 35.0f, 30.0f, 28.0f };
+    for (int sonarID = 0; sonarID < 4; sonarID++) {
+        C_SelfSoundSpectrumStruct spectrumStruct;
+        spectrumStruct.sonarID = sonarID;
+        for (int i = 0; i < FLAT_SOUND_SPECTRUM_SIZE; i++) {
+            float freqFactor = 1.0f - 0.3f * (i / static_cast<float>(FLAT_SOUND_SPECTRUM_SIZE));
+            spectrumStruct.spectumData[i] = baseNoiseLevels[sonarID] * freqFactor;
+        }
+        selfSound->selfSoundSpectrumList.push_back(spectrumStruct);
+    }
+
+    CSimData* simData = new CSimData();
+    simData->dataFormat = STRUCT;
+    simData->time = simTime;
+    simData->sender = m_config.platformId;
+    simData->receiver = m_config.platformId;
+    simData->componentId = 1;
+    simData->data = selfSound;
+    simData->length = sizeof(CData_PlatformSelfSound);
+    memcpy(simData->topic, Data_PlatformSelfSound, strlen(Data_PlatformSelfSound) + 1);
+    return simData;
+}
@@ -0,0 +1,86 @@
+#ifndef BENCHMARKSCENARIO_H
+#define BENCHMARKSCENARIO_H
+
+#include <memory>
+#include <vector>
+#include "SimBasicTypes.h"
+#include "CSimData.h"
+#include "CSimMessage.h"
+#include "FlatSoundList.h"
+#include "SyntheticLoadGenerator.h"
+
+struct CMsg_EnvironmentNoiseToSonarStruct;
+
+/**
+ * 基准场景配置
+ */
+struct BenchmarkScenarioConfig
+{
+    int contacts;                   // 目标数
+    uint32 seed;                    // 随机种子（相同种子生成相同场景）
+    int64 platformId;               // 本平台ID
+    double ownSpeed;                // 本平台航速（m/s）
+    double ownHeading;              // 本平台航向（度，正北顺时针）
+    double minRange;                // 目标初始距离下限（米）
+    double maxRange;                // 目标初始距离上限（米），超出声纳作用距离的目标由模型过滤
+    float noiseDb;                  // 传播声逐频点噪声幅度（±dB），0为无噪声
+
+    BenchmarkScenarioConfig()
+        : contacts(64)
+        , seed(1)
+        , platformId(1)
+        , ownSpeed(6.0)
+        , ownHeading(45.0)
+        , minRange(1000.0)
+        , maxRange(40000.0)
+        , noiseDb(0.0f)
+    {
+    }
+};
+
+/**
+ * 单平台合成场景：本平台匀速直航，周围目标各自匀速直航
+ * 每步的扁平传播声列表由SyntheticLoadGenerator生成（球面扩散损失，频谱形状按目标类型取表），
+ * 本类另提供本平台机动、平台自噪声与海洋环境噪声数据
+ */
+class BenchmarkScenario
+{
+public:
+    explicit BenchmarkScenario(const BenchmarkScenarioConfig& config);
+
+    /**
+     * 推进dtSeconds秒（本平台与各目标航位推算）
+     */
+    void advance(double dtSeconds);
+
+    /**
+     * 按当前几何关系生成全部目标的传播声记录（缓冲先清空）
+     */
+    void fillPropagatedSound(FlatSoundListBuffer& buffer, int64 simTime) const;
+
+    /**
+     * 本平台机动数据（调用方取得所有权，交给代理addSubscribedData）
+     */
+    CSimData* createMotionData(int64 simTime) const;
+
+    /**
+     * 平台自噪声数据（调用方取得所有权，交给代理addSubscribedData）
+     */
+    CSimData* createSelfSoundData(int64 simTime) const;
+
+    /**
+     * 海洋环境噪声消息载荷（场景内共用一份）
+     */
+    const std::shared_ptr<CMsg_EnvironmentNoiseToSonarStruct>& environmentNoise() const { return m_environmentNoise; }
+
+    int contactCount() const { return m_generator.contactCount(); }
+
+private:
+    BenchmarkScenarioConfig m_config;
+    SyntheticLoadGenerator m_generator;
+    std::shared_ptr<CMsg_EnvironmentNoiseToSonarStruct> m_environmentNoise;
+    double m_ownX;
+    double m_ownY;
+};
+
+#endif // BENCHMARKSCENARIO_H
@@ -0,0 +1,722 @@
+#include "BenchmarkScenario.h"
+#include "DeviceModelAgent.h"
+#include "ModelCapture.h"
+#include "PerfCounters.h"
+#include "DeviceTestInOut.h"
+#include "devicemodel.h"
+#include "common/DMLogger.h"
+#include "common/SpectrumSlabPool.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+const int MIN_CONTACTS = 1;
+const int MAX_CONTACTS = 4096;
+const int64 SELF_SOUND_REFRESH_MS = 5000;       // 平台自噪声重写周期（早于代理的10秒过期）
+
+/**
+ * 命令行参数
+ */
+struct BenchmarkOptions
+{
+    std::vector<int> contactCounts;     // 依次测量的目标数
+    int64 steps;                        // 每组计时步数
+    int64 warmupSteps;                  // 每组预热步数（不计时）
+    int32 stepMs;                       // 仿真步长（ms）
+    uint32 seed;                        // 场景随机种子
+    float noiseDb;                      // 传播声逐频点噪声幅度（±dB）
+    bool pipelined;                     // 组件流水线步进
+    bool boundPruning;                  // 组件声纳方程上界剪枝
+    bool hugePages;                     // 频谱块池使用大页
+    bool hardwareCounters;              // 按阶段读取硬件性能计数
+    std::string outputFile;             // 为空时JSON写到标准输出
+    std::string logFile;                // 为空时不写日志文件
+    std::string capturePrefix;          // 捕获文件前缀，为空时不捕获
+
+    BenchmarkOptions()
+        : steps(200)
+        , warmupSteps(20)
+        , stepMs(1000)
+        , seed(1)
+        , noiseDb(0.0f)
+        , pipelined(false)
+        , boundPruning(true)
+        , hugePages(false)
+        , hardwareCounters(false)
+    {
+    }
+};
+
+/**
+ * 各阶段的硬件计数（计时步累计）
+ */
+struct PhaseCounterTotals
+{
+    uint64 calls[DeviceModel::PHASE_COUNT];
+    uint64 values[DeviceModel::PHASE_COUNT][PerfCounters::EVENT_COUNT];
+
+    PhaseCounterTotals()
+    {
+        memset(calls, 0, sizeof(calls));
+        memset(values, 0, sizeof(values));
+    }
+};
+
+/**
+ * 按阶段累计硬件计数的阶段观察者
+ * 计数只统计所在线程，因此每个进入阶段的线程各开一组（流水线模式下工作线程另有一组）；
+ * 嵌套阶段的计数同时计入外层阶段。每次进出阶段各读一次计数（系统调用），会拉长计时，
+ * 耗时结果应以不读计数的运行为准
+ */
+class PhaseCounterProbe : public DeviceModel::PhaseProbe
+{
+public:
+    PhaseCounterProbe()
+    {
+        threadCounters();
+    }
+
+    void enterPhase(DeviceModel::PerfPhase phase) override
+    {
+        PerfCounters::Sample sample = threadCounters().read();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_begin[phase] = sample;
+    }
+
+    void leavePhase(DeviceModel::PerfPhase phase) override
+    {
+        PerfCounters::Sample sample = threadCounters().read();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_totals.calls[phase]++;
+        for (int i = 0; i < PerfCounters::EVENT_COUNT; i++) {
+            m_totals.values[phase][i] += sample.values[i] - m_begin[phase].values[i];
+        }
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_totals = PhaseCounterTotals();
+    }
+
+    PhaseCounterTotals totals() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_totals;
+    }
+
+    /**
+     * 计数是否可用（以创建观察者的线程为准）
+     */
+    bool available(PerfCounters::Event event) const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_counters.front().second->available(event);
+    }
+
+    bool multiplexed() const
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : m_counters) {
+            if (entry.second->multiplexed()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    /**
+     * 当前线程的计数，首次进入阶段时打开
+     */
+    PerfCounters& threadCounters()
+    {
+        std::thread::id self = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (const auto& entry : m_counters) {
+            if (entry.first == self) {
+                return *entry.second;
+            }
+        }
+        m_counters.push_back(std::make_pair(self, std::unique_ptr<PerfCounters>(new PerfCounters())));
+        return *m_counters.back().second;
+    }
+
+    mutable std::mutex m_mutex;
+    std::vector<std::pair<std::thread::id, std::unique_ptr<PerfCounters>>> m_counters;
+    PerfCounters::Sample m_begin[DeviceModel::PHASE_COUNT];
+    PhaseCounterTotals m_totals;
+};
+
+/**
+ * 一组目标数的测量结果（耗时单位为微秒）
+ */
+struct BenchmarkResult
+{
+    int contacts;
+    int64 steps;
+    double deliverMeanUs;               // 传播声消息投递（onMessage）平均耗时
+    double prepareMeanUs;               // prepareStep平均耗时
+    double commitMeanUs;                // commitStep平均耗时
+    double generateMeanUs;              // 场景生成平均耗时（不计入步进耗时）
+    std::vector<double> stepUs;         // 每步耗时：投递 + prepareStep + commitStep
+    uint64 messagesSent;                // 组件发送的消息数（计时步）
+    DeviceModel::BoundPruningStats pruning;
+    DeviceModel::PerformanceStats perf; // 组件自报的阶段耗时分布与计数（计时步）
+    bool hasCounters;                   // 读取了硬件计数
+    bool countersAvailable[PerfCounters::EVENT_COUNT];
+    bool countersMultiplexed;
+    PhaseCounterTotals counters;        // 各阶段硬件计数（计时步）
+    MemoryAccount::Snapshot memory;
+    long peakRssKiB;                    // 进程峰值常驻内存（进程级，多组运行时单调不减）
+
+    BenchmarkResult()
+        : contacts(0), steps(0), deliverMeanUs(0.0), prepareMeanUs(0.0), commitMeanUs(0.0)
+        , generateMeanUs(0.0), messagesSent(0), hasCounters(false), countersMultiplexed(false), peakRssKiB(0)
+    {
+        memset(countersAvailable, 0, sizeof(countersAvailable));
+    }
+};
+
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --contacts LIST 目标数，逗号分隔，范围" << MIN_CONTACTS << "~" << MAX_CONTACTS
+              << "（默认8,64,512,4096）\n"
+              << "  --steps N       每组计时步数（默认200）\n"
+              << "  --warmup N      每组预热步数（默认20）\n"
+              << "  --step-ms N     仿真步长ms（默认1000）\n"
+              << "  --seed N        场景随机种子（默认1）\n"
+              << "  --noise-db X    传播声逐频点叠加±X dB噪声（默认0，不加噪声）\n"
+              << "  --pipeline      组件流水线步进：计算在组件自有线程上与发布重叠，结果晚一步发出\n"
+              << "  --no-prune      关闭组件的声纳方程上界剪枝\n"
+              << "  --huge-pages    频谱块池以大页承载（Linux）\n"
+              << "  --counters      按组件阶段读取硬件性能计数（周期、指令、L1/末级缓存缺失、分支预测失败），\n"
+              << "                  报告IPC及每目标、每频点的缺失数；读数会拉长计时，耗时以不加此项的运行为准\n"
+              << "  --output FILE   JSON结果写到文件（默认标准输出）\n"
+              << "  --log FILE      写模型日志到文件（INFO级别，会显著拉长耗时）\n"
+              << "  --capture PFX   组件输入写入捕获文件 PFX_<目标数>.dmcap（DeviceReplay回放，计时含捕获开销）\n";
+}
+
+bool parseContactList(const std::string& text, std::vector<int>& counts)
+{
+    counts.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        int count = atoi(item.c_str());
+        if (count < MIN_CONTACTS || count > MAX_CONTACTS) {
+            std::cerr << "Contact count out of range: " << item << std::endl;
+            return false;
+        }
+        counts.push_back(count);
+    }
+    return !counts.empty();
+}
+
+bool parseOptions(int argc, char* argv[], BenchmarkOptions& options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg == "--contacts" && hasValue) {
+            if (!parseContactList(argv[++i], options.contactCounts)) {
+                return false;
+            }
+        } else if (arg == "--steps" && hasValue) {
+            options.steps = atoll(argv[++i]);
+        } else if (arg == "--warmup" && hasValue) {
+            options.warmupSteps = atoll(argv[++i]);
+        } else if (arg == "--step-ms" && hasValue) {
+            options.stepMs = atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<uint32>(strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--noise-db" && hasValue) {
+            options.noiseDb = static_cast<float>(atof(argv[++i]));
+        } else if (arg == "--pipeline") {
+            options.pipelined = true;
+        } else if (arg == "--no-prune") {
+            options.boundPruning = false;
+        } else if (arg == "--huge-pages") {
+            options.hugePages = true;
+        } else if (arg == "--counters") {
+            options.hardwareCounters = true;
+        } else if (arg == "--output" && hasValue) {
+            options.outputFile = argv[++i];
+        } else if (arg == "--log" && hasValue) {
+            options.logFile = argv[++i];
+        } else if (arg == "--capture" && hasValue) {
+            options.capturePrefix = argv[++i];
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.contactCounts.empty()) {
+        options.contactCounts = { 8, 64, 512, 4096 };
+    }
+    return options.steps > 0 && options.warmupSteps >= 0 && options.stepMs > 0 && options.noiseDb >= 0.0f;
+}
+
+/**
+ * 进程峰值常驻内存（KiB）
+ */
+long peakRssKiB()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+    }
+    return 0;
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#ifdef __APPLE__
+    return static_cast<long>(usage.ru_maxrss / 1024);   // macOS以字节为单位
+#else
+    return static_cast<long>(usage.ru_maxrss);
+#endif
+#endif
+}
+
+double elapsedMicroseconds(const std::chrono::steady_clock::time_point& begin,
+                           const std::chrono::steady_clock::time_point& end)
+{
+    return std::chrono::duration<double, std::micro>(end - begin).count();
+}
+
+/**
+ * 已排序样本的分位数（最近秩）
+ */
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(fraction * sorted.size() + 0.999999);
+    rank = std::max<size_t>(1, std::min(rank, sorted.size()));
+    return sorted[rank - 1];
+}
+
+/**
+ * 单平台测量：一个代理、一个组件，场景生成不计时，
+ * 每步计时区间为传播声消息投递、prepareStep与commitStep
+ */
+bool runBenchmark(const BenchmarkOptions& options, int contacts, BenchmarkResult& result)
+{
+    BenchmarkScenarioConfig scenarioConfig;
+    scenarioConfig.contacts = contacts;
+    scenarioConfig.seed = options.seed;
+    scenarioConfig.noiseDb = options.noiseDb;
+    BenchmarkScenario scenario(scenarioConfig);
+
+    int64 simTime = 0;
+    uint64 messagesSent = 0;
+
+    DeviceModelAgent agent;
+    agent.setDebugOutputEnabled(false);
+    agent.setPlatformEntity(scenarioConfig.platformId, "BenchmarkPlatform", 1);
+    agent.setStep(options.stepMs);
+    agent.setSimulationTime(simTime);
+    agent.setMessageSink([&messagesSent](CSimMessage*) {
+        messagesSent++;
+    });
+
+    // 捕获文件在组件初始化前打开，记录从第一次取数据开始
+    ModelCapture::CaptureWriter capture;
+    if (!options.capturePrefix.empty()) {
+        std::string path = options.capturePrefix + "_" + std::to_string(contacts) + ".dmcap";
+        if (!capture.open(path, scenarioConfig.platformId, 1, options.stepMs)) {
+            std::cerr << "Failed to open capture file: " << path << std::endl;
+            return false;
+        }
+        agent.setCaptureWriter(&capture);
+    }
+
+    std::unique_ptr<DeviceModel> model(new DeviceModel());
+    if (!model->init(&agent, agent.getComponentAttribute())) {
+        std::cerr << "Failed to init device model" << std::endl;
+        return false;
+    }
+    model->setStepPipelineEnabled(options.pipelined);
+    model->setBoundPruningEnabled(options.boundPruning);
+    CSimTwoPhaseStep* twoPhaseStep = querySimTwoPhaseStep(model.get());   // 取不到时按step计入准备阶段
+    std::unique_ptr<PhaseCounterProbe> probe;
+    if (options.hardwareCounters) {
+        probe.reset(new PhaseCounterProbe());
+        model->setPhaseProbe(probe.get());
+
+        bool anyAvailable = false;
+        for (int i = 0; i < PerfCounters::EVENT_COUNT; i++) {
+            anyAvailable = anyAvailable || probe->available(static_cast<PerfCounters::Event>(i));
+        }
+        if (!anyAvailable) {
+            std::cerr << "Hardware counters unavailable (perf_event_open refused, see perf_event_paranoid"
+                      << " or container seccomp); counters reported as null" << std::endl;
+        }
+    }
+    model->start();
+
+    // 初始状态：机动、自噪声、环境噪声
+    agent.addSubscribedData(Data_Motion, scenarioConfig.platformId, scenario.createMotionData(simTime));
+    agent.addSubscribedData(Data_PlatformSelfSound, scenarioConfig.platformId, scenario.createSelfSoundData(simTime));
+    int64 lastSelfSoundTime = simTime;
+
+    CSimMessage envMsg;
+    envMsg.dataFormat = STRUCT;
+    envMsg.time = simTime;
+    envMsg.sender = 0;
+    envMsg.senderComponentId = 0;
+    envMsg.receiver = 0;
+    envMsg.data = scenario.environmentNoise().get();
+    envMsg.length = sizeof(CMsg_EnvironmentNoiseToSonarStruct);
+    memcpy(envMsg.topic, MSG_EnvironmentNoiseToSonar, strlen(MSG_EnvironmentNoiseToSonar) + 1);
+    agent.deliverMessage(model.get(), &envMsg);
+
+    // 传播声缓冲：组件仍借用上一步的缓冲时换一块新缓冲
+    std::shared_ptr<FlatSoundListBuffer> propagated;
+
+    double deliverUs = 0.0;
+    double prepareUs = 0.0;
+    double commitUs = 0.0;
+    double generateUs = 0.0;
+    result = BenchmarkResult();
+    result.contacts = contacts;
+    result.stepUs.reserve(static_cast<size_t>(options.steps));
+
+    int64 totalSteps = options.warmupSteps + options.steps;
+    for (int64 step = 0; step < totalSteps; step++) {
+        bool measured = (step >= options.warmupSteps);
+        if (step == options.warmupSteps) {
+            messagesSent = 0;
+            model->resetPerformanceStats();
+            if (probe) {
+                probe->reset();
+            }
+        }
+
+        // 场景生成（不计时）
+        auto generateBegin = std::chrono::steady_clock::now();
+        simTime += options.stepMs;
+        agent.setSimulationTime(simTime);
+        scenario.advance(options.stepMs / 1000.0);
+        agent.addSubscribedData(Data_Motion, scenarioConfig.platformId, scenario.createMotionData(simTime));
+        if (simTime - lastSelfSoundTime >= SELF_SOUND_REFRESH_MS) {
+            agent.addSubscribedData(Data_PlatformSelfSound, scenarioConfig.platformId, scenario.createSelfSoundData(simTime));
+            lastSelfSoundTime = simTime;
+        }
+
+        if (!propagated || !propagated.unique()) {
+            propagated = std::make_shared<FlatSoundListBuffer>(FLAT_SOUND_CONTINUOUS);
+        }
+        scenario.fillPropagatedSound(*propagated, simTime);
+
+        CSimMessage soundMsg;
+        soundMsg.dataFormat = STRUCT;
+        soundMsg.time = simTime;
+        soundMsg.sender = 0;
+        soundMsg.senderComponentId = 0;
+        soundMsg.receiver = scenarioConfig.platformId;
+        soundMsg.data = propagated->data();
+        soundMsg.length = propagated->length();
+        memcpy(soundMsg.topic, MSG_PropagatedContinuousSound_Flat, strlen(MSG_PropagatedContinuousSound_Flat) + 1);
+        agent.lendMessagePayload(std::shared_ptr<const void>(propagated, propagated->data()));
+        auto generateEnd = std::chrono::steady_clock::now();
+
+        // 计时步：投递、准备、提交
+        agent.deliverMessage(model.get(), &soundMsg);
+        auto deliverEnd = std::chrono::steady_clock::now();
+        if (twoPhaseStep) {
+            twoPhaseStep->prepareStep(simTime, options.stepMs);
+        } else {
+            model->step(simTime, options.stepMs);
+        }
+        auto prepareEnd = std::chrono::steady_clock::now();
+        if (twoPhaseStep) {
+            twoPhaseStep->commitStep();
+        }
+        if (capture.isOpen()) {
+            capture.appendStep(simTime, options.stepMs);
+        }
+        auto commitEnd = std::chrono::steady_clock::now();
+
+        if (measured) {
+            generateUs += elapsedMicroseconds(generateBegin, generateEnd);
+            deliverUs += elapsedMicroseconds(generateEnd, deliverEnd);
+            prepareUs += elapsedMicroseconds(deliverEnd, prepareEnd);
+            commitUs += elapsedMicroseconds(prepareEnd, commitEnd);
+            result.stepUs.push_back(elapsedMicroseconds(generateEnd, commitEnd));
+        }
+    }
+
+    result.steps = options.steps;
+    result.deliverMeanUs = deliverUs / options.steps;
+    result.prepareMeanUs = prepareUs / options.steps;
+    result.commitMeanUs = commitUs / options.steps;
+    result.generateMeanUs = generateUs / options.steps;
+    result.messagesSent = messagesSent;
+    result.pruning = model->getBoundPruningStats();
+    result.perf = model->getPerformanceStats();
+    result.memory = model->getMemoryStats();
+
+    // 流水线模式下最后一帧可能仍在工作线程上，停止组件后再取硬件计数
+    model->stop();
+    if (probe) {
+        result.hasCounters = true;
+        result.counters = probe->totals();
+        result.countersMultiplexed = probe->multiplexed();
+        for (int i = 0; i < PerfCounters::EVENT_COUNT; i++) {
+            result.countersAvailable[i] = probe->available(static_cast<PerfCounters::Event>(i));
+        }
+    }
+    model->destroy();
+    model.reset();
+    agent.setCaptureWriter(nullptr);
+    capture.close();
+
+    result.peakRssKiB = peakRssKiB();
+    return true;
+}
+
+void writeUsage(std::ostream& out, const MemoryAccount::Usage& usage)
+{
+    out << "{\"bytes\": " << usage.bytes
+        << ", \"blocks\": " << usage.blocks
+        << ", \"peakBytes\": " << usage.peakBytes << "}";
+}
+
+void writeLatency(std::ostream& out, const LatencyHistogram::Summary& summary)
+{
+    out << "{\"count\": " << summary.count
+        << ", \"mean\": " << summary.meanNs
+        << ", \"p50\": " << summary.p50Ns
+        << ", \"p99\": " << summary.p99Ns
+        << ", \"p999\": " << summary.p999Ns
+        << ", \"max\": " << summary.maxNs << "}";
+}
+
+/**
+ * 各阶段的硬件计数：总数、IPC，以及每目标与每频点的均值
+ * 目标数取计时步内声纳方程计算的目标数（按声纳计），每目标5296个频点；不可用的计数输出null
+ */
+void writeCounters(std::ostream& out, const BenchmarkResult& result)
+{
+    uint64 contacts = result.perf.contactsEvaluated > 0 ? result.perf.contactsEvaluated : result.perf.contactsIngested;
+    double bins = static_cast<double>(contacts) * SpectrumSlabPool::SLAB_FLOATS;
+
+    auto writeValue = [&out, &result](int event, double value) {
+        if (result.countersAvailable[event]) {
+            out << value;
+        } else {
+            out << "null";
+        }
+    };
+
+    out << "{\"multiplexed\": " << (result.countersMultiplexed ? "true" : "false")
+        << ", \"contacts\": " << contacts;
+    for (int phase = 0; phase < DeviceModel::PHASE_COUNT; phase++) {
+        const uint64* values = result.counters.values[phase];
+        out << ", \"" << DeviceModel::perfPhaseName(phase) << "\": {\"calls\": " << result.counters.calls[phase];
+        for (int i = 0; i < PerfCounters::EVENT_COUNT; i++) {
+            out << ", \"" << PerfCounters::eventName(static_cast<PerfCounters::Event>(i)) << "\": ";
+            writeValue(i, static_cast<double>(values[i]));
+        }
+
+        out << ", \"ipc\": ";
+        if (result.countersAvailable[PerfCounters::CYCLES] && result.countersAvailable[PerfCounters::INSTRUCTIONS] &&
+            values[PerfCounters::CYCLES] > 0) {
+            out << static_cast<double>(values[PerfCounters::INSTRUCTIONS]) / values[PerfCounters::CYCLES];
+        } else {
+            out << "null";
+        }
+
+        // 每目标、每频点（计数均摊到计时步内全部目标）
+        const char* const scopes[2] = { "perContact", "perBin" };
+        double divisors[2] = { static_cast<double>(contacts), bins };
+        for (int scope = 0; scope < 2; scope++) {
+            out << ", \"" << scopes[scope] << "\": {";
+            for (int i = 0; i < PerfCounters::EVENT_COUNT; i++) {
+                out << (i > 0 ? ", " : "") << "\"" << PerfCounters::eventName(static_cast<PerfCounters::Event>(i)) << "\": ";
+                if (divisors[scope] > 0.0) {
+                    writeValue(i, values[i] / divisors[scope]);
+                } else {
+                    out << "null";
+                }
+            }
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "}";
+}
+
+void writeResult(std::ostream& out, const BenchmarkResult& result)
+{
+    std::vector<double> sorted = result.stepUs;
+    std::sort(sorted.begin(), sorted.end());
+    double totalUs = 0.0;
+    for (double us : sorted) {
+        totalUs += us;
+    }
+    double meanUs = sorted.empty() ? 0.0 : totalUs / sorted.size();
+    double stepsPerSecond = totalUs > 0.0 ? sorted.size() * 1e6 / totalUs : 0.0;
+
+    out << "    {\n"
+        << "      \"contacts\": " << result.contacts << ",\n"
+        << "      \"steps\": " << result.steps << ",\n"
+        << "      \"latencyUs\": {"
+        << "\"mean\": " << meanUs
+        << ", \"p50\": " << percentile(sorted, 0.50)
+        << ", \"p90\": " << percentile(sorted, 0.90)
+        << ", \"p99\": " << percentile(sorted, 0.99)
+        << ", \"p999\": " << percentile(sorted, 0.999)
+        << ", \"min\": " << (sorted.empty() ? 0.0 : sorted.front())
+        << ", \"max\": " << (sorted.empty() ? 0.0 : sorted.back()) << "},\n"
+        << "      \"phaseMeanUs\": {"
+        << "\"deliver\": " << result.deliverMeanUs
+        << ", \"prepare\": " << result.prepareMeanUs
+        << ", \"commit\": " << result.commitMeanUs
+        << ", \"generate\": " << result.generateMeanUs << "},\n"
+        << "      \"throughput\": {"
+        << "\"stepsPerSecond\": " << stepsPerSecond
+        << ", \"contactsPerSecond\": " << stepsPerSecond * result.contacts << "},\n"
+        << "      \"messagesSent\": " << result.messagesSent << ",\n"
+        << "      \"equations\": {"
+        << "\"evaluated\": " << result.pruning.evaluated
+        << ", \"pruned\": " << result.pruning.pruned << "},\n"
+        << "      \"modelPhasesNs\": {";
+    for (int i = 0; i < DeviceModel::PHASE_COUNT; i++) {
+        out << (i > 0 ? ", " : "") << "\"" << DeviceModel::perfPhaseName(i) << "\": ";
+        writeLatency(out, result.perf.phases[i]);
+    }
+    out << "},\n"
+        << "      \"modelCounters\": {"
+        << "\"steps\": " << result.perf.steps
+        << ", \"messages\": " << result.perf.messages
+        << ", \"contactsIngested\": " << result.perf.contactsIngested
+        << ", \"activeContacts\": " << result.perf.activeContacts
+        << ", \"contactsEvaluated\": " << result.perf.contactsEvaluated
+        << ", \"contactsPruned\": " << result.perf.contactsPruned
+        << ", \"allocations\": " << result.perf.allocations << "},\n";
+    if (result.hasCounters) {
+        out << "      \"hardwareCounters\": ";
+        writeCounters(out, result);
+        out << ",\n";
+    }
+    out << "      \"memory\": {";
+    for (int i = 0; i < MemoryAccount::CATEGORY_COUNT; i++) {
+        out << "\"" << MemoryAccount::categoryName(static_cast<MemoryAccount::Category>(i)) << "\": ";
+        writeUsage(out, result.memory.categories[i]);
+        out << ", ";
+    }
+    out << "\"total\": ";
+    writeUsage(out, result.memory.total);
+    out << "},\n"
+        << "      \"peakRssKiB\": " << result.peakRssKiB << "\n"
+        << "    }";
+}
+
+void writeReport(std::ostream& out, const BenchmarkOptions& options, const std::vector<BenchmarkResult>& results)
+{
+    SpectrumSlabPool::Stats poolStats = SpectrumSlabPool::instance().stats();
+
+    out << std::fixed << std::setprecision(3)
+        << "{\n"
+        << "  \"config\": {"
+        << "\"steps\": " << options.steps
+        << ", \"warmupSteps\": " << options.warmupSteps
+        << ", \"stepMs\": " << options.stepMs
+        << ", \"seed\": " << options.seed
+        << ", \"noiseDb\": " << options.noiseDb
+        << ", \"pipelined\": " << (options.pipelined ? "true" : "false")
+        << ", \"boundPruning\": " << (options.boundPruning ? "true" : "false")
+        << ", \"hugePages\": " << (options.hugePages ? "true" : "false")
+        << ", \"hardwareCounters\": " << (options.hardwareCounters ? "true" : "false") << "},\n"
+        << "  \"runs\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        writeResult(out, results[i]);
+        out << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ],\n"
+        << "  \"spectrumPool\": {"
+        << "\"chunks\": " << poolStats.chunks
+        << ", \"hugePageChunks\": " << poolStats.hugePageChunks
+        << ", \"bytesReserved\": " << poolStats.bytesReserved
+        << ", \"slabsPeak\": " << poolStats.slabsPeak
+        << ", \"acquired\": " << poolStats.acquired
+        << ", \"recycled\": " << poolStats.recycled
+        << ", \"fallbacks\": " << poolStats.fallbacks << "},\n"
+        << "  \"peakRssKiB\": " << peakRssKiB() << "\n"
+        << "}\n";
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    BenchmarkOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // 模型构造时若日志未初始化会自动创建日志文件，这里先按参数初始化
+    Logger& logger = Logger::getInstance();
+    logger.initialize(options.logFile, false);
+    logger.setLogLevel(options.logFile.empty() ? LogLevel::WARN : LogLevel::INFO);
+
+    // 频谱块池为进程级单例，须在首个频谱分配前配置
+    SpectrumSlabPool::Config poolConfig;
+    poolConfig.hugePages = options.hugePages;
+    SpectrumSlabPool::instance().configure(poolConfig);
+
+    std::vector<BenchmarkResult> results;
+    for (int contacts : options.contactCounts) {
+        BenchmarkResult result;
+        if (!runBenchmark(options, contacts, result)) {
+            return 2;
+        }
+        std::cerr << "contacts=" << contacts << " done" << std::endl;
+        results.push_back(result);
+    }
+
+    if (options.outputFile.empty()) {
+        writeReport(std::cout, options, results);
+        std::cout.flush();
+    } else {
+        std::ofstream file(options.outputFile.c_str());
+        if (!file) {
+            std::cerr << "Failed to open output file: " << options.outputFile << std::endl;
+            return 3;
+        }
+        writeReport(file, options, results);
+    }
+    return 0;
+}
@@ -0,0 +1,61 @@
+# testcase：make check 运行随机对照（非零退出表示不一致）
+CONFIG += c++11 console testcase
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += \
+    $$PWD/../../../../../../../SDK/SimModel/Cpp/include/ \
+    $$PWD/../../src/ \
+    $$PWD/../common/ \
+    $$PWD/../DeviceUiTestUnit/src/ \
+    $$PWD/../DeviceReplay/src/ \
+    $$PWD/src/
+
+win32 {
+    CONFIG(debug,debug|release){
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/winDebug -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/winDebug/
+    }
+    else {
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/winRelease -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/winRelease/
+    }
+}
+else {
+    CONFIG(debug,debug|release){
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/linuxDebug -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/linuxDebug/
+    }
+    else {
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/linuxRelease -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/linuxRelease/
+    }
+    LIBS += -lpthread
+}
+
+SOURCES += \
+        src/mainEquivalence.cpp \
+        ../DeviceReplay/src/ReplayAgent.cpp \
+        ../DeviceUiTestUnit/src/DeviceModelAgent.cpp \
+        ../DeviceUiTestUnit/src/ModelCapture.cpp \
+        ../DeviceUiTestUnit/src/SubscribedDataStore.cpp \
+        ../../src/common/DMLogger.cpp \
+        ../../src/common/SpectrumSlabPool.cpp \
+        ../../src/common/TraceZone.cpp \
+        ../../src/devicemodel.cpp \
+        ../../src/FlatSoundList.cpp
+
+HEADERS += \
+    ../common/DeviceModelTestAccess.h \
+    ../DeviceReplay/src/ReplayAgent.h \
+    ../DeviceUiTestUnit/src/DeviceModelAgent.h \
+    ../DeviceUiTestUnit/src/ModelCapture.h \
+    ../DeviceUiTestUnit/src/SubscribedDataStore.h \
+    ../../src/common/DMLogger.h \
+    ../../src/devicemodel.h \
+    ../../src/FlatSoundList.h \
+    ../../src/common/SpectrumBuffer.h \
+    ../../src/common/SpectrumSlabPool.h \
+    ../../src/common/MemoryAccount.h \
+    ../../src/common/LatencyHistogram.h \
+    ../../src/common/CounterRng.h \
+    ../../src/common/TraceZone.h
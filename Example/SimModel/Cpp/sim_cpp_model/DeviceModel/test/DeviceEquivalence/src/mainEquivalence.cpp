@@ -0,0 +1,405 @@
+#include "DeviceModelTestAccess.h"
+#include "ReplayAgent.h"
+#include "ModelCapture.h"
+#include "common/DMLogger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int SONAR_COUNT = 4;
+const int SPECTRUM_SIZE = DeviceModelTestAccess::SPECTRUM_SIZE;
+const double BOUND_SLACK_DB = 1e-9;     // 上界与参考值比较时允许的舍入误差
+
+typedef DeviceModelTestAccess::TargetData TargetData;
+typedef DeviceModelTestAccess::EquationCache EquationCache;
+
+/**
+ * 命令行参数
+ */
+struct EquivalenceOptions
+{
+    int trials;                         // 随机试验次数
+    uint32_t seed;                      // 随机种子
+    std::vector<std::string> captures;  // 非空时改为回放捕获文件对照
+    bool verbose;                       // 逐条打印不一致的目标
+
+    EquivalenceOptions()
+        : trials(2000)
+        , seed(1)
+        , verbose(false)
+    {
+    }
+};
+
+/**
+ * 对照统计：组件实际使用的批量计算（上界剪枝）与参考路径（逐目标标量计算）
+ * 批量计算对未剪枝目标调用的就是参考函数，X值不作逐值比较；对照的是剪枝上界与探测结论
+ */
+struct EquivalenceStats
+{
+    uint64 evaluations;                 // 参与对照的批量计算次数（试验或回放步）
+    uint64 targets;                     // 对照的目标数（按声纳分别计数）
+    uint64 pruned;                      // 批量计算剪枝的目标数
+    uint64 flips;                       // 探测结论不一致的目标数
+    uint64 boundViolations;             // 剪枝上界低于参考X的目标数
+    uint64 mismatches;                  // 结果条数或目标ID对不上的声纳数
+
+    EquivalenceStats()
+        : evaluations(0), targets(0), pruned(0), flips(0)
+        , boundViolations(0), mismatches(0)
+    {
+    }
+};
+
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --trials N          随机试验次数（默认2000）\n"
+              << "  --seed N            随机种子（默认1）\n"
+              << "  --capture FILE...   回放捕获文件，逐步对照组件实际输入\n"
+              << "  --verbose           逐条打印不一致的目标\n";
+}
+
+bool parseOptions(int argc, char* argv[], EquivalenceOptions& options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg == "--trials" && hasValue) {
+            options.trials = atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--capture") {
+            while (i + 1 < argc && argv[i + 1][0] != '-') {
+                options.captures.push_back(argv[++i]);
+            }
+            if (options.captures.empty()) {
+                return false;
+            }
+        } else if (arg == "--verbose") {
+            options.verbose = true;
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+    return options.trials >= 0;
+}
+
+/**
+ * 对照一次批量计算的结果：对每个启用声纳的每个目标重算参考X
+ * - 剪枝：上界须不低于参考X
+ * - 剪枝与未剪枝的目标，探测结论都须与参考X对阈值的判断一致
+ */
+void compareCache(DeviceModel& model, const EquationCache& cache, const std::string& label,
+                  const EquivalenceOptions& options, EquivalenceStats& stats)
+{
+    stats.evaluations++;
+    for (int sonarID = 0; sonarID < SONAR_COUNT; sonarID++) {
+        auto resultsIt = cache.multiTargetEquationResults.find(sonarID);
+        if (resultsIt == cache.multiTargetEquationResults.end()) {
+            continue;                   // 声纳关闭
+        }
+        auto targetsIt = cache.sonarTargetsData.find(sonarID);
+        size_t targetCount = (targetsIt != cache.sonarTargetsData.end()) ? targetsIt->second.size() : 0;
+        const auto& results = resultsIt->second;
+        if (results.size() != targetCount) {
+            stats.mismatches++;
+            if (options.verbose) {
+                std::cout << label << " sonar " << sonarID << ": " << results.size()
+                          << " results for " << targetCount << " targets\n";
+            }
+            continue;
+        }
+
+        double threshold = DeviceModelTestAccess::effectiveThreshold(model, sonarID);
+        for (size_t i = 0; i < targetCount; i++) {
+            const TargetData& target = targetsIt->second[i];
+            const DeviceModel::TargetEquationResult& result = results[i];
+            if (result.targetId != target.targetId) {
+                stats.mismatches++;
+                continue;
+            }
+
+            double reference = DeviceModelTestAccess::referenceEquation(model, sonarID, target, cache);
+            bool referenceDetected = reference > threshold;
+            stats.targets++;
+
+            bool violation = false;
+            if (result.pruned) {
+                stats.pruned++;
+                violation = result.upperBound + BOUND_SLACK_DB < reference;
+                if (violation) {
+                    stats.boundViolations++;
+                }
+            }
+
+            bool flip = result.isValid != referenceDetected;
+            if (flip) {
+                stats.flips++;
+            }
+            if (options.verbose && (flip || violation)) {
+                std::cout << std::setprecision(12) << label << " sonar " << sonarID
+                          << " target " << target.targetId
+                          << (result.pruned ? " bound=" : " X=")
+                          << (result.pruned ? result.upperBound : result.equationResult)
+                          << " reference=" << reference << " threshold=" << threshold
+                          << (flip ? " FLIP" : "") << "\n";
+            }
+        }
+    }
+}
+
+/**
+ * 随机频谱：按形状覆盖剪枝边界附近与各类退化输入
+ */
+enum SpectrumShape {
+    SHAPE_BROADBAND,                    // 宽带起伏
+    SHAPE_FLAT,                         // 常数
+    SHAPE_PEAKY,                        // 低底噪上的强线谱（上界最松）
+    SHAPE_ZERO,                         // 全零（参考X为0）
+    SHAPE_NEGATIVE,                     // 含负值（求和可正可负）
+    SHAPE_LARGE,                        // 大幅度
+    SHAPE_MOCK,                         // 组件的模拟频谱
+    SHAPE_COUNT
+};
+
+SpectrumBuffer randomSpectrum(DeviceModel& model, std::mt19937& generator, int shape, int targetId)
+{
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_real_distribution<float> levelDist(-3.0f, 3.0f);  // 幅度的数量级
+    std::uniform_int_distribution<int> binDist(0, SPECTRUM_SIZE - 1);
+
+    float* data = nullptr;
+    SpectrumBuffer spectrum = SpectrumBuffer::allocate(SPECTRUM_SIZE, data);
+    float scale = std::pow(10.0f, levelDist(generator));
+
+    switch (shape) {
+    case SHAPE_FLAT:
+        std::fill(data, data + SPECTRUM_SIZE, scale);
+        break;
+    case SHAPE_PEAKY: {
+        std::fill(data, data + SPECTRUM_SIZE, scale * 1e-3f);
+        int lines = 1 + binDist(generator) % 4;
+        for (int l = 0; l < lines; l++) {
+            data[binDist(generator)] = scale * (1.0f + 100.0f * unit(generator));
+        }
+        break;
+    }
+    case SHAPE_ZERO:
+        std::fill(data, data + SPECTRUM_SIZE, 0.0f);
+        break;
+    case SHAPE_NEGATIVE:
+        for (int i = 0; i < SPECTRUM_SIZE; i++) {
+            data[i] = scale * (unit(generator) - 0.5f);
+        }
+        break;
+    case SHAPE_LARGE:
+        for (int i = 0; i < SPECTRUM_SIZE; i++) {
+            data[i] = scale * 1e6f * (0.5f + unit(generator));
+        }
+        break;
+    case SHAPE_MOCK:
+        DeviceModelTestAccess::fillMockSpectrumData(model, data, targetId);
+        break;
+    default:
+        for (int i = 0; i < SPECTRUM_SIZE; i++) {
+            float slope = 1.0f - 0.5f * static_cast<float>(i) / SPECTRUM_SIZE;
+            data[i] = scale * slope * (0.5f + unit(generator));
+        }
+        break;
+    }
+    return spectrum;
+}
+
+/**
+ * 随机试验：每次生成各声纳的噪声与目标，阈值一部分取在某个目标的参考X附近（剪枝边界），
+ * 一部分随机，然后按组件的批量计算求结果并逐目标对照
+ */
+void runRandomTrials(const EquivalenceOptions& options, EquivalenceStats& stats)
+{
+    std::mt19937 generator(options.seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    std::uniform_int_distribution<int> shapeDist(0, SHAPE_COUNT - 1);
+    std::uniform_int_distribution<int> countDist(0, DeviceModelTestAccess::MAX_TARGETS_PER_SONAR);
+    std::uniform_real_distribution<double> thresholdDist(10.0, 60.0);
+    std::uniform_real_distribution<double> nearDist(-1.5, 1.5);
+
+    DeviceModel model;
+    model.setBoundPruningEnabled(true);
+    for (int sonarID = 0; sonarID < SONAR_COUNT; sonarID++) {
+        DeviceModelTestAccess::setSonarPassiveEnabled(model, sonarID, true);
+    }
+
+    for (int trial = 0; trial < options.trials; trial++) {
+        EquationCache cache;
+        int targetId = 0;
+        for (int sonarID = 0; sonarID < SONAR_COUNT; sonarID++) {
+            // 噪声缺失时组件不剪枝、参考X为0，同样须一致
+            if (unit(generator) > 0.02f) {
+                cache.platformSelfSoundSpectrumMap[sonarID] =
+                    randomSpectrum(model, generator, SHAPE_BROADBAND, -1);
+                cache.environmentNoiseSpectrumMap[sonarID] =
+                    randomSpectrum(model, generator, unit(generator) < 0.05f ? SHAPE_ZERO : SHAPE_BROADBAND, -1);
+            }
+
+            std::vector<TargetData>& targets = cache.sonarTargetsData[sonarID];
+            int count = countDist(generator);
+            for (int t = 0; t < count; t++) {
+                TargetData target;
+                target.targetId = ++targetId;
+                target.propagatedSpectrum = randomSpectrum(model, generator, shapeDist(generator), target.targetId);
+                target.targetDistance = 500.0f + 40000.0f * unit(generator);
+                target.targetBearing = 360.0f * unit(generator);
+                target.lastUpdateTime = trial;
+                target.isValid = unit(generator) > 0.03f;
+                target.bandPeakLevel = (unit(generator) > 0.03f)
+                    ? DeviceModelTestAccess::bandPeakLevel(model, target.propagatedSpectrum, sonarID)
+                    : -1.0f;
+                targets.push_back(target);
+            }
+
+            double threshold = thresholdDist(generator);
+            if (!targets.empty() && unit(generator) < 0.6f) {
+                const TargetData& pivot = targets[generator() % targets.size()];
+                double reference = DeviceModelTestAccess::referenceEquation(model, sonarID, pivot, cache);
+                if (reference > 0.0) {
+                    threshold = reference + DeviceModelTestAccess::boundPruningMarginDb() * nearDist(generator);
+                }
+            }
+            model.setSonarDetectionThreshold(sonarID, threshold);
+        }
+
+        DeviceModelTestAccess::evaluateEquations(model, cache);
+        compareCache(model, cache, "trial " + std::to_string(trial), options, stats);
+    }
+}
+
+/**
+ * 回放捕获文件（严格步进），每步prepareStep之后对照组件本步的实际输入与结果
+ */
+bool runCapture(const std::string& file, const EquivalenceOptions& options, EquivalenceStats& stats)
+{
+    ModelCapture::CaptureReader reader;
+    if (!reader.open(file)) {
+        std::cerr << "Failed to open capture " << file << std::endl;
+        return false;
+    }
+    const ModelCapture::FileHeader& fileHeader = reader.header();
+
+    ReplayAgent agent;
+    std::string name = "ReplayPlatform_" + std::to_string(fileHeader.platformId);
+    agent.setPlatformEntity(fileHeader.platformId, name.c_str(), fileHeader.campId);
+    agent.setStep(fileHeader.stepMs);
+    agent.setMessageSink([](CSimMessage*) {});
+
+    std::unique_ptr<DeviceModel> model(new DeviceModel());
+    if (!model->init(&agent, agent.getComponentAttribute())) {
+        std::cerr << "Failed to init device model" << std::endl;
+        return false;
+    }
+    model->setStepPipelineEnabled(false);
+    model->setBoundPruningEnabled(true);
+    model->start();
+    CSimTwoPhaseStep* twoPhaseStep = querySimTwoPhaseStep(model.get());   // 取不到时在step之后对照
+
+    ModelCapture::CaptureReader::Record record;
+    while (reader.next(record)) {
+        const ModelCapture::RecordHeader& header = *record.header;
+        if (header.kind == ModelCapture::RECORD_MESSAGE) {
+            if (header.codec == ModelCapture::CODEC_UNSUPPORTED) {
+                continue;
+            }
+            std::shared_ptr<const void> payload = reader.decodePayload(record);
+            if (header.codec != ModelCapture::CODEC_NONE && !payload) {
+                continue;
+            }
+
+            CSimMessage simMessage;
+            simMessage.time = header.time;
+            simMessage.sender = header.sender;
+            simMessage.senderComponentId = header.componentId;
+            simMessage.receiver = header.receiver;
+            simMessage.dataFormat = static_cast<CDataFormat>(header.dataFormat);
+            memcpy(simMessage.topic, header.topic, EventTypeLen);
+            simMessage.data = payload.get();
+            simMessage.length = header.length;
+            if (payload) {
+                agent.lendMessagePayload(payload);
+            }
+            model->onMessage(&simMessage);
+        } else if (header.kind == ModelCapture::RECORD_SUBSCRIBED_DATA) {
+            agent.applySubscribedData(record, reader.decodePayload(record));
+        } else if (header.kind == ModelCapture::RECORD_STEP) {
+            agent.setSimulationTime(header.time);
+            if (twoPhaseStep) {
+                twoPhaseStep->prepareStep(header.time, static_cast<int32>(header.length));
+            } else {
+                model->step(header.time, static_cast<int32>(header.length));
+            }
+            compareCache(*model, DeviceModelTestAccess::equationCache(*model),
+                         file + " t=" + std::to_string(header.time), options, stats);
+            if (twoPhaseStep) {
+                twoPhaseStep->commitStep();
+            }
+        }
+    }
+
+    model->stop();
+    model->destroy();
+    model.reset();
+    agent.clearReplayData();
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    EquivalenceOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // 关闭日志：对照只关心计算结果
+    Logger& logger = Logger::getInstance();
+    logger.initialize("", false);
+    logger.setLogLevel(LogLevel::OFF);
+
+    EquivalenceStats stats;
+    if (options.captures.empty()) {
+        runRandomTrials(options, stats);
+        std::cout << "Random trials: " << options.trials << " (seed " << options.seed << ")\n";
+    } else {
+        for (const std::string& file : options.captures) {
+            if (!runCapture(file, options, stats)) {
+                return 1;
+            }
+        }
+        std::cout << "Captured steps: " << stats.evaluations << " from " << options.captures.size() << " file(s)\n";
+    }
+
+    std::cout << "targets=" << stats.targets
+              << " pruned=" << stats.pruned << "\n"
+              << "detection flips=" << stats.flips
+              << " bound violations=" << stats.boundViolations
+              << " mismatches=" << stats.mismatches << std::endl;
+
+    bool passed = stats.flips == 0 && stats.boundViolations == 0 && stats.mismatches == 0;
+    std::cout << (passed ? "PASS" : "FAIL") << std::endl;
+    return passed ? 0 : 1;
+}
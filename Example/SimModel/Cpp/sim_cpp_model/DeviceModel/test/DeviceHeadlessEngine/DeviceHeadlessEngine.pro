@@ -0,0 +1,67 @@
+CONFIG += c++11 console
+CONFIG -= app_bundle qt
+
+# 跟踪区段默认编出，qmake CONFIG+=devicemodel_trace 时编入（导出Chrome/Perfetto跟踪事件）
+devicemodel_trace {
+    DEFINES += DEVICEMODEL_TRACE
+}
+
+INCLUDEPATH += \
+    $$PWD/../../../../../../../SDK/SimModel/Cpp/include/ \
+    $$PWD/../../src/ \
+    $$PWD/../DeviceUiTestUnit/src/ \
+    $$PWD/src/
+
+win32 {
+    CONFIG(debug,debug|release){
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/winDebug -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/winDebug/
+    }
+    else {
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/winRelease -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/winRelease/
+    }
+}
+else {
+    CONFIG(debug,debug|release){
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/linuxDebug -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/linuxDebug/
+    }
+    else {
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/linuxRelease -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/linuxRelease/
+    }
+    LIBS += -lpthread
+}
+
+SOURCES += \
+        src/mainHeadless.cpp \
+        src/HeadlessEngine.cpp \
+        src/StepThreadPool.cpp \
+        src/TopicBus.cpp \
+        ../DeviceUiTestUnit/src/DeviceModelAgent.cpp \
+        ../DeviceUiTestUnit/src/ModelCapture.cpp \
+        ../DeviceUiTestUnit/src/SubscribedDataStore.cpp \
+        ../../src/common/DMLogger.cpp \
+        ../../src/common/SpectrumSlabPool.cpp \
+        ../../src/common/TraceZone.cpp \
+        ../../src/devicemodel.cpp \
+        ../../src/FlatSoundList.cpp
+
+HEADERS += \
+    src/HeadlessEngine.h \
+    src/StepThreadPool.h \
+    src/SpscQueue.h \
+    src/TopicBus.h \
+    ../DeviceUiTestUnit/src/DeviceModelAgent.h \
+    ../DeviceUiTestUnit/src/ModelCapture.h \
+    ../DeviceUiTestUnit/src/SubscribedDataStore.h \
+    ../../src/common/DMLogger.h \
+    ../../src/devicemodel.h \
+    ../../src/FlatSoundList.h \
+    ../../src/common/SpectrumBuffer.h \
+    ../../src/common/SpectrumSlabPool.h \
+    ../../src/common/MemoryAccount.h \
+    ../../src/common/LatencyHistogram.h \
+    ../../src/common/CounterRng.h \
+    ../../src/common/TraceZone.h
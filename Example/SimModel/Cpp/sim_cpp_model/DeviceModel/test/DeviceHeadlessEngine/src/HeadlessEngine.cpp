@@ -0,0 +1,603 @@
+#include "HeadlessEngine.h"
+#include "DeviceModelAgent.h"
+#include "devicemodel.h"
+#include "DeviceTestInOut.h"
+#include "ModelCapture.h"
+#include "common/TraceZone.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+const double METERS_PER_DEGREE = 111320.0;      // 与界面测试程序一致的简化换算
+const double PI = 3.14159265358979323846;
+const int64 SELF_SOUND_REFRESH_MS = 5000;       // 平台自噪声重写周期（早于代理的10秒过期）
+
+double elapsedSeconds(const std::chrono::steady_clock::time_point& begin)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+}
+
+}
+
+HeadlessEngine::HeadlessEngine(const HeadlessEngineConfig& config)
+    : m_config(config)
+    , m_pool(config.workerThreads > 0 ? config.workerThreads : 0)
+    , m_bus(static_cast<size_t>(config.busQueueCapacity > 0 ? config.busQueueCapacity : 1))
+    , m_messagesSent(0)
+    , m_simTime(config.startTime)
+    , m_started(false)
+{
+    // 传播声频谱形状：模拟频率响应，各平台按接收级缩放
+    m_spectrumShape.resize(FLAT_SOUND_SPECTRUM_SIZE);
+    for (int i = 0; i < FLAT_SOUND_SPECTRUM_SIZE; i++) {
+        m_spectrumShape[i] = 1.0f + 0.1f * sinf(i * 0.01f);
+    }
+
+    // 海洋环境噪声：低频偏高，高频衰减（所有平台共用一份载荷）
+    m_environmentNoise = std::make_shared<CMsg_EnvironmentNoiseToSonarStruct>();
+    m_environmentNoise->acousticVel = 1500.0f;
+    for (int i = 0; i < FLAT_SOUND_SPECTRUM_SIZE; i++) {
+        float freqRatio = static_cast<float>(i) / FLAT_SOUND_SPECTRUM_SIZE;
+        m_environmentNoise->spectrumData[i] = 27.5f * (1.5f - freqRatio);
+    }
+}
+
+HeadlessEngine::~HeadlessEngine()
+{
+    stop();
+}
+
+int HeadlessEngine::addPlatform(const HeadlessPlatformConfig& platformConfig)
+{
+    if (m_started) {
+        LOG_WARN("addPlatform called after start, ignored");
+        return -1;
+    }
+
+    std::unique_ptr<Platform> platform(new Platform());
+    platform->config = platformConfig;
+    platform->x = platformConfig.x;
+    platform->y = platformConfig.y;
+    platform->lastSelfSoundTime = -1;
+    platform->lastContactCount = 0;
+    platform->lastDeliveredCount = 0;
+    platform->hasPerfStats = false;
+    platform->twoPhaseStep = nullptr;
+    platform->subscriberId = m_bus.addSubscriber(platformConfig.platformId);
+
+    platform->agent.reset(new DeviceModelAgent());
+    platform->agent->setDebugOutputEnabled(false);
+    std::string name = "HeadlessPlatform_" + std::to_string(platformConfig.platformId);
+    platform->agent->setPlatformEntity(platformConfig.platformId, name.c_str(), platformConfig.campId);
+    platform->agent->setStep(m_config.stepMs);
+    platform->agent->setSimulationTime(m_simTime);
+
+    int index = static_cast<int>(m_platforms.size());
+    platform->agent->setMessageSink([this, index](CSimMessage* simMessage) {
+        routeMessage(index, simMessage);
+    });
+
+    // 组件发布的性能统计按平台保存最近一次（commitStep串行执行，无需加锁）
+    Platform* platformState = platform.get();
+    platform->agent->setDataSink([platformState](CSimData* simData) {
+        if (strncmp(simData->topic, Data_DevicePerfStats_Topic, EventTypeLen) == 0 && simData->data &&
+            simData->length >= sizeof(CData_DevicePerfStats)) {
+            memcpy(&platformState->perfStats, simData->data, sizeof(CData_DevicePerfStats));
+            platformState->hasPerfStats = true;
+        }
+    });
+
+    // 组件的事件类订阅登记到总线
+    int subscriberId = platform->subscriberId;
+    platform->agent->setSubscriptionSink([this, subscriberId](const char* topic, bool subscribed) {
+        if (subscribed) {
+            m_bus.subscribe(subscriberId, topic);
+        } else {
+            m_bus.unsubscribe(subscriberId, topic);
+        }
+    });
+
+    m_platforms.push_back(std::move(platform));
+    return index;
+}
+
+bool HeadlessEngine::start()
+{
+    if (m_started) {
+        return true;
+    }
+
+    // 分区：平台按序号连续分组，组数与线程数相同
+    m_partitions.clear();
+    m_stats.groups.clear();
+    if (m_config.partitioned) {
+        int groups = threadCount();
+        int count = platformCount();
+        m_partitions.resize(groups);
+        m_stats.groups.resize(groups);
+        for (int group = 0; group < groups; group++) {
+            m_partitions[group].begin = static_cast<int>(static_cast<int64>(count) * group / groups);
+            m_partitions[group].end = static_cast<int>(static_cast<int64>(count) * (group + 1) / groups);
+            m_partitions[group].stepSeconds = 0.0;
+            m_stats.groups[group].platforms = m_partitions[group].end - m_partitions[group].begin;
+        }
+    }
+
+    if (m_config.pinThreads) {
+        pinThreads();
+    }
+
+    // 捕获文件在组件初始化前打开，记录从第一次取数据开始
+    if (!m_config.capturePrefix.empty()) {
+        for (auto& platform : m_platforms) {
+            if (!openCapture(*platform)) {
+                return false;
+            }
+        }
+    }
+
+    // 分区模式下组件在所属线程上创建和初始化，其缓存首次写入发生在该线程
+    std::atomic<bool> created(true);
+    auto createBody = [this, &created](int index) {
+        if (!createModel(*m_platforms[index])) {
+            created.store(false);
+        }
+    };
+    if (m_config.partitioned) {
+        forEachPlatform(createBody);
+    } else {
+        for (int i = 0; i < platformCount(); i++) {
+            createBody(i);
+        }
+    }
+    if (!created.load()) {
+        return false;
+    }
+
+    // 初始状态：机动、自噪声
+    forEachPlatform([this](int index) {
+        advanceMotion(index, 0.0);
+        storeSelfSound(*m_platforms[index]);
+    });
+    for (auto& partition : m_partitions) {
+        partition.stepSeconds = 0.0;
+    }
+
+    // 环境噪声广播给所有订阅者（一份载荷，第一步投递）
+    CSimMessage envMsg;
+    envMsg.dataFormat = STRUCT;
+    envMsg.time = m_simTime;
+    envMsg.sender = 0;
+    envMsg.senderComponentId = 0;
+    envMsg.receiver = 0;
+    envMsg.data = m_environmentNoise.get();
+    envMsg.length = sizeof(CMsg_EnvironmentNoiseToSonarStruct);
+    memcpy(envMsg.topic, MSG_EnvironmentNoiseToSonar, strlen(MSG_EnvironmentNoiseToSonar) + 1);
+    m_bus.publish(envMsg, m_environmentNoise);
+
+    m_started = true;
+    LOG_INFOF("Headless engine started: %d platforms, %d threads, step %d ms, %s",
+              platformCount(), threadCount(), m_config.stepMs,
+              m_config.partitioned ? "partitioned" : "shared");
+    return true;
+}
+
+void HeadlessEngine::stepOnce()
+{
+    if (!m_started) {
+        return;
+    }
+
+    m_simTime += m_config.stepMs;
+    TRACE_ZONE("engine.step");
+
+    // 步与步之间没有进行中的发布，释放订阅变化（上一步投递阶段）替换下来的路由表
+    m_bus.reclaimRoutingTables();
+
+    // 1. 机动
+    auto phaseBegin = std::chrono::steady_clock::now();
+    double dtSeconds = m_config.stepMs / 1000.0;
+    forEachPlatform([this, dtSeconds](int index) {
+        m_platforms[index]->agent->setSimulationTime(m_simTime);
+        advanceMotion(index, dtSeconds);
+    });
+    m_stats.motionSeconds += elapsedSeconds(phaseBegin);
+
+    // 2. 信道：各平台只读取其他平台的位置，只写自己的传播声缓冲，并只向自己的队列定向发布（每个队列一个生产者）
+    phaseBegin = std::chrono::steady_clock::now();
+    forEachPlatform([this](int index) {
+        buildPropagatedSound(index);
+    });
+    m_stats.environmentSeconds += elapsedSeconds(phaseBegin);
+
+    // 3. 投递：各平台只消费自己的总线队列
+    phaseBegin = std::chrono::steady_clock::now();
+    forEachPlatform([this](int index) {
+        deliverInbox(index);
+    });
+    for (const auto& platform : m_platforms) {
+        m_stats.contactsDelivered += platform->lastContactCount;
+        m_stats.messagesDelivered += platform->lastDeliveredCount;
+    }
+    m_stats.deliverSeconds += elapsedSeconds(phaseBegin);
+
+    // 4. 准备：支持两阶段步进的组件并行，其余组件在此串行推进（其输出同样进入路由）
+    phaseBegin = std::chrono::steady_clock::now();
+    int32 step = m_config.stepMs;
+    forEachPlatform([this, step](int index) {
+        CSimTwoPhaseStep* twoPhaseStep = m_platforms[index]->twoPhaseStep;
+        if (twoPhaseStep && twoPhaseStep->supportsTwoPhaseStep()) {
+            twoPhaseStep->prepareStep(m_simTime, step);
+        }
+    });
+    for (auto& platform : m_platforms) {
+        if (!platform->twoPhaseStep) {
+            platform->model->step(m_simTime, step);
+        } else if (!platform->twoPhaseStep->supportsTwoPhaseStep()) {
+            platform->twoPhaseStep->prepareStep(m_simTime, step);
+        }
+    }
+    m_stats.prepareSeconds += elapsedSeconds(phaseBegin);
+
+    // 5. 提交：固定平台顺序，保证路由结果可复现；组件在此发送的消息由本线程串行发布
+    phaseBegin = std::chrono::steady_clock::now();
+    for (auto& platform : m_platforms) {
+        if (platform->twoPhaseStep) {
+            platform->twoPhaseStep->commitStep();
+        }
+        if (platform->capture) {
+            platform->capture->appendStep(m_simTime, step);
+        }
+    }
+    m_stats.commitSeconds += elapsedSeconds(phaseBegin);
+
+    // 分组步进耗时
+    for (size_t group = 0; group < m_partitions.size(); group++) {
+        Partition& partition = m_partitions[group];
+        HeadlessGroupStats& groupStats = m_stats.groups[group];
+        groupStats.totalStepSeconds += partition.stepSeconds;
+        groupStats.maxStepSeconds = std::max(groupStats.maxStepSeconds, partition.stepSeconds);
+        partition.stepSeconds = 0.0;
+    }
+
+    m_stats.messagesSent = m_messagesSent.load();
+    m_stats.steps++;
+}
+
+HeadlessRunStats HeadlessEngine::run(int64 stepCount)
+{
+    auto begin = std::chrono::steady_clock::now();
+    int64 firstStep = m_stats.steps;
+
+    for (int64 i = 0; i < stepCount; i++) {
+        stepOnce();
+    }
+
+    double seconds = elapsedSeconds(begin);
+    int64 steps = m_stats.steps - firstStep;
+
+    // 剪枝统计为组件累计值，内存为组件当前值
+    m_stats.equationsEvaluated = 0;
+    m_stats.equationsPruned = 0;
+    m_stats.memory = MemoryAccount::Snapshot();
+    for (const auto& platform : m_platforms) {
+        if (platform->model) {
+            DeviceModel::BoundPruningStats pruningStats = platform->model->getBoundPruningStats();
+            m_stats.equationsEvaluated += pruningStats.evaluated;
+            m_stats.equationsPruned += pruningStats.pruned;
+
+            MemoryAccount::Snapshot memory = platform->model->getMemoryStats();
+            for (int i = 0; i <= MemoryAccount::CATEGORY_COUNT; i++) {
+                const MemoryAccount::Usage& usage = (i < MemoryAccount::CATEGORY_COUNT) ? memory.categories[i] : memory.total;
+                MemoryAccount::Usage& sum = (i < MemoryAccount::CATEGORY_COUNT) ? m_stats.memory.categories[i] : m_stats.memory.total;
+                sum.bytes += usage.bytes;
+                sum.blocks += usage.blocks;
+                sum.peakBytes += usage.peakBytes;
+            }
+        }
+    }
+
+    // 组件经数据主题自报的性能统计
+    m_stats.perfStatsPlatforms = 0;
+    m_stats.modelAllocations = 0;
+    for (int phase = 0; phase < DEVICE_PERF_PHASE_COUNT; phase++) {
+        m_stats.modelPhases[phase] = HeadlessPhaseLatency();
+    }
+    for (const auto& platform : m_platforms) {
+        if (!platform->hasPerfStats) {
+            continue;
+        }
+        const CData_DevicePerfStats& perfStats = platform->perfStats;
+        m_stats.perfStatsPlatforms++;
+        m_stats.modelAllocations += perfStats.allocations;
+        for (int phase = 0; phase < DEVICE_PERF_PHASE_COUNT; phase++) {
+            const CData_DevicePhaseLatency& latency = perfStats.phases[phase];
+            HeadlessPhaseLatency& sum = m_stats.modelPhases[phase];
+            uint64 count = sum.count + latency.count;
+            if (count > 0) {
+                sum.meanNs = (sum.meanNs * sum.count + static_cast<double>(latency.meanNs) * latency.count) / count;
+            }
+            sum.count = count;
+            sum.worstP99Ns = std::max<uint64>(sum.worstP99Ns, latency.p99Ns);
+            sum.maxNs = std::max<uint64>(sum.maxNs, latency.maxNs);
+        }
+    }
+
+    m_stats.wallSeconds += seconds;
+    if (m_stats.wallSeconds > 0.0) {
+        m_stats.stepsPerSecond = m_stats.steps / m_stats.wallSeconds;
+        m_stats.platformStepsPerSecond = m_stats.stepsPerSecond * platformCount();
+    }
+
+    LOG_INFOF("Ran %lld steps in %.3f s", steps, seconds);
+    return m_stats;
+}
+
+void HeadlessEngine::stop()
+{
+    if (!m_started) {
+        return;
+    }
+
+    for (auto& platform : m_platforms) {
+        if (platform->model) {
+            platform->model->stop();
+            platform->model->destroy();
+        }
+    }
+
+    // 组件可能仍持有代理载荷的引用，先释放组件再释放代理
+    for (auto& platform : m_platforms) {
+        platform->twoPhaseStep = nullptr;
+        platform->model.reset();
+        if (platform->capture) {
+            platform->agent->setCaptureWriter(nullptr);
+            platform->capture.reset();
+        }
+    }
+
+    // 丢弃未投递的消息，释放载荷引用
+    BusMessage pending;
+    for (auto& platform : m_platforms) {
+        while (m_bus.poll(platform->subscriberId, pending)) {
+        }
+    }
+    m_started = false;
+}
+
+void HeadlessEngine::forEachPlatform(const std::function<void(int)>& body)
+{
+    if (m_partitions.empty()) {
+        m_pool.parallelFor(platformCount(), body);
+        return;
+    }
+
+    // 各线程只处理自己的分区，并记录本组耗时
+    m_pool.runOnEachThread([this, &body](int threadIndex) {
+        Partition& partition = m_partitions[threadIndex];
+        auto begin = std::chrono::steady_clock::now();
+        for (int index = partition.begin; index < partition.end; index++) {
+            body(index);
+        }
+        partition.stepSeconds += elapsedSeconds(begin);
+    });
+}
+
+void HeadlessEngine::pinThreads()
+{
+    std::vector<int> cpus = StepThreadPool::availableCpus();
+    if (cpus.empty()) {
+        LOG_WARN("No CPU available for thread pinning");
+        return;
+    }
+    if (threadCount() > static_cast<int>(cpus.size())) {
+        LOG_WARNF("%d threads share %d CPUs", threadCount(), static_cast<int>(cpus.size()));
+    }
+
+    std::vector<int> pinned(threadCount(), -1);
+    m_pool.runOnEachThread([&cpus, &pinned](int threadIndex) {
+        int cpu = cpus[threadIndex % cpus.size()];
+        if (StepThreadPool::pinCurrentThread(cpu)) {
+            pinned[threadIndex] = cpu;
+        }
+    });
+
+    for (int threadIndex = 0; threadIndex < threadCount(); threadIndex++) {
+        if (pinned[threadIndex] < 0) {
+            LOG_WARNF("Failed to pin thread %d", threadIndex);
+        }
+        if (threadIndex < static_cast<int>(m_stats.groups.size())) {
+            m_stats.groups[threadIndex].cpu = pinned[threadIndex];
+        }
+    }
+}
+
+bool HeadlessEngine::openCapture(Platform& platform)
+{
+    std::string path = m_config.capturePrefix + "_" + std::to_string(platform.config.platformId) + ".dmcap";
+    platform.capture.reset(new ModelCapture::CaptureWriter());
+    if (!platform.capture->open(path, platform.config.platformId, platform.config.campId, m_config.stepMs)) {
+        LOG_ERRORF("Failed to open capture for platform %lld", platform.config.platformId);
+        platform.capture.reset();
+        return false;
+    }
+    platform.agent->setCaptureWriter(platform.capture.get());
+    return true;
+}
+
+bool HeadlessEngine::createModel(Platform& platform)
+{
+    platform.model.reset(new DeviceModel());
+    if (!platform.model->init(platform.agent.get(), platform.agent->getComponentAttribute())) {
+        LOG_ERRORF("Failed to init device model for platform %lld", platform.config.platformId);
+        return false;
+    }
+    platform.model->setStepPipelineEnabled(m_config.pipelinedModels);
+    platform.model->setBoundPruningEnabled(m_config.boundPruning);
+    platform.model->setPerformanceStatsInterval(m_config.perfStatsIntervalMs);
+    platform.model->start();
+    platform.twoPhaseStep = querySimTwoPhaseStep(platform.model.get());
+    return true;
+}
+
+void HeadlessEngine::advanceMotion(int index, double dt)
+{
+    Platform& platform = *m_platforms[index];
+
+    // 航位推算
+    double headingRad = platform.config.heading * PI / 180.0;
+    platform.x += platform.config.speed * dt * sin(headingRad) / METERS_PER_DEGREE;
+    platform.y += platform.config.speed * dt * cos(headingRad) / METERS_PER_DEGREE;
+
+    CData_Motion* motion = new CData_Motion();
+    motion->action = true;
+    motion->isPending = false;
+    motion->x = platform.x;
+    motion->y = platform.y;
+    motion->z = -200.0;
+    motion->curSpeed = platform.config.speed;
+    motion->rotation = platform.config.heading;
+
+    CSimData* simData = new CSimData();
+    simData->dataFormat = STRUCT;
+    simData->time = m_simTime;
+    simData->sender = platform.config.platformId;
+    simData->receiver = platform.config.platformId;
+    simData->componentId = 1;
+    simData->data = motion;
+    simData->length = sizeof(CData_Motion);
+    memcpy(simData->topic, Data_Motion, strlen(Data_Motion) + 1);
+    platform.agent->addSubscribedData(Data_Motion, platform.config.platformId, simData);
+
+    // 平台自噪声在代理过期前重写
+    if (platform.lastSelfSoundTime >= 0 && m_simTime - platform.lastSelfSoundTime >= SELF_SOUND_REFRESH_MS) {
+        storeSelfSound(platform);
+    }
+}
+
+void HeadlessEngine::buildPropagatedSound(int index)
+{
+    Platform& receiver = *m_platforms[index];
+
+    // 发布后的载荷只读：上一步的缓冲仍被借用（或仍在队列中）时换一块新缓冲
+    if (!receiver.propagated || !receiver.propagated.unique()) {
+        receiver.propagated = std::make_shared<FlatSoundListBuffer>(FLAT_SOUND_CONTINUOUS);
+        receiver.propagated->reserve(static_cast<uint32>(std::max(0, m_config.maxContactsPerPlatform)));
+    }
+    FlatSoundListBuffer& buffer = *receiver.propagated;
+    buffer.clear();
+    buffer.setTime(m_simTime);
+
+    // 按平台序号取作用距离内的前maxContactsPerPlatform个目标，保证各步目标序号稳定
+    int count = platformCount();
+    for (int i = 0; i < count && static_cast<int>(buffer.count()) < m_config.maxContactsPerPlatform; i++) {
+        if (i == index) {
+            continue;
+        }
+
+        const Platform& source = *m_platforms[i];
+        double deltaXMeters = (source.x - receiver.x) * METERS_PER_DEGREE;
+        double deltaYMeters = (source.y - receiver.y) * METERS_PER_DEGREE;
+        double distance = sqrt(deltaXMeters * deltaXMeters + deltaYMeters * deltaYMeters);
+        if (distance > m_config.maxContactRange || distance < 1.0) {
+            continue;
+        }
+
+        double bearing = atan2(deltaXMeters, deltaYMeters) * 180.0 / PI;
+        if (bearing < 0) bearing += 360.0;
+
+        // 球面扩散损失：TL = 20 * log10(R)
+        float propagationLoss = 20.0f * log10f(static_cast<float>(distance));
+        float level = std::max(10.0f, std::min(120.0f, source.config.sourceLevel - propagationLoss));
+
+        CFlatSoundRecord& record = buffer.append();
+        record.targetDistance = static_cast<float>(distance);
+        record.arrivalSideAngle = static_cast<float>(bearing);
+        record.arrivalPitchAngle = 0.0f;
+        record.platType = 1;
+        record.arrivalTime = m_simTime;
+        for (int k = 0; k < FLAT_SOUND_SPECTRUM_SIZE; k++) {
+            record.spectrumData[k] = level * m_spectrumShape[k];
+        }
+    }
+
+    CSimMessage soundMsg;
+    soundMsg.dataFormat = STRUCT;
+    soundMsg.time = m_simTime;
+    soundMsg.sender = 0;
+    soundMsg.senderComponentId = 0;
+    soundMsg.receiver = receiver.config.platformId;
+    soundMsg.data = buffer.data();
+    soundMsg.length = buffer.length();
+    memcpy(soundMsg.topic, MSG_PropagatedContinuousSound_Flat, strlen(MSG_PropagatedContinuousSound_Flat) + 1);
+    m_bus.publish(soundMsg, std::shared_ptr<const void>(receiver.propagated, buffer.data()));
+    receiver.lastContactCount = static_cast<int>(buffer.count());
+}
+
+void HeadlessEngine::deliverInbox(int index)
+{
+    Platform& platform = *m_platforms[index];
+    int delivered = 0;
+
+    BusMessage message;
+    while (m_bus.poll(platform.subscriberId, message)) {
+        if (message.lendable) {
+            platform.agent->lendMessagePayload(message.payload);
+        }
+        platform.agent->deliverMessage(platform.model.get(), &message.header);
+        delivered++;
+    }
+
+    platform.lastDeliveredCount = delivered;
+}
+
+void HeadlessEngine::storeSelfSound(Platform& platform)
+{
+    CData_PlatformSelfSound* selfSound = new CData_PlatformSelfSound();
+
+    // 各声纳位置的基础噪声级：艏端受机械噪声影响较大，拖曳阵远离船体噪声较低
+    const float baseNoiseLevels[4] = { 40.0f, 35.0f, 30.0f, 28.0f };
+    for (int sonarID = 0; sonarID < 4; sonarID++) {
+        C_SelfSoundSpectrumStruct spectrumStruct;
+        spectrumStruct.sonarID = sonarID;
+        for (int i = 0; i < FLAT_SOUND_SPECTRUM_SIZE; i++) {
+            float freqFactor = 1.0f - 0.3f * (i / static_cast<float>(FLAT_SOUND_SPECTRUM_SIZE));
+            spectrumStruct.spectumData[i] = baseNoiseLevels[sonarID] * freqFactor;
+        }
+        selfSound->selfSoundSpectrumList.push_back(spectrumStruct);
+    }
+
+    CSimData* simData = new CSimData();
+    simData->dataFormat = STRUCT;
+    simData->time = m_simTime;
+    simData->sender = platform.config.platformId;
+    simData->receiver = platform.config.platformId;
+    simData->componentId = 1;
+    simData->data = selfSound;
+    simData->length = sizeof(CData_PlatformSelfSound);
+    memcpy(simData->topic, Data_PlatformSelfSound, strlen(Data_PlatformSelfSound) + 1);
+    platform.agent->addSubscribedData(Data_PlatformSelfSound, platform.config.platformId, simData);
+
+    platform.lastSelfSoundTime = m_simTime;
+}
+
+void HeadlessEngine::routeMessage(int senderIndex, CSimMessage* simMessage)
+{
+    if (!simMessage) {
+        return;
+    }
+
+    // 发送方登记过的载荷按引用计数扇出；组件自有的载荷不归代理管理，以不释放的句柄发布
+    std::shared_ptr<const void> payload = m_platforms[senderIndex]->agent->retainPayload(simMessage->data);
+    bool lendable = static_cast<bool>(payload);
+    if (!payload) {
+        payload = std::shared_ptr<const void>(simMessage->data, [](const void*) {});
+    }
+
+    m_bus.publish(*simMessage, payload, lendable);
+    m_messagesSent.fetch_add(1, std::memory_order_relaxed);
+}
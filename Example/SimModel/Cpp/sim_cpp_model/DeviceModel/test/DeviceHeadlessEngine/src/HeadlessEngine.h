@@ -0,0 +1,264 @@
+#ifndef HEADLESSENGINE_H
+#define HEADLESSENGINE_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "SimBasicTypes.h"
+#include "CSimMessage.h"
+#include "FlatSoundList.h"
+#include "common/MemoryAccount.h"
+#include "StepThreadPool.h"
+#include "TopicBus.h"
+
+class DeviceModel;
+class DeviceModelAgent;
+class CSimTwoPhaseStep;
+namespace ModelCapture { class CaptureWriter; }
+struct CMsg_EnvironmentNoiseToSonarStruct;
+
+/**
+ * 无界面宿主配置
+ */
+struct HeadlessEngineConfig
+{
+    int32 stepMs;                   // 仿真步长（ms）
+    int workerThreads;              // 额外工作线程数，0表示单线程
+    int maxContactsPerPlatform;     // 每个平台每步最多接收的传播声目标数
+    float maxContactRange;          // 传播声最大作用距离（米）
+    int64 startTime;                // 仿真起始时间（ms）
+    int busQueueCapacity;           // 每个平台的总线接收队列容量
+    bool partitioned;               // 平台按线程固定分组，组内平台的创建、初始化与各并行阶段始终在同一线程执行
+    bool pinThreads;                // 各线程绑定到固定CPU（调用线程同样被绑定）
+    bool pipelinedModels;           // 组件启用流水线步进（DeviceModel::setStepPipelineEnabled，每个组件一个计算线程）
+    bool boundPruning;              // 组件启用声纳方程上界剪枝（DeviceModel::setBoundPruningEnabled）
+    std::string capturePrefix;      // 非空时各平台组件的输入写入捕获文件 <前缀>_<平台ID>.dmcap（供DeviceReplay回放）
+    int64 perfStatsIntervalMs;      // 非0时组件按该仿真时间间隔发布Data_DevicePerfStats_Topic（DeviceModel::setPerformanceStatsInterval）
+
+    HeadlessEngineConfig()
+        : stepMs(1000)
+        , workerThreads(0)
+        , maxContactsPerPlatform(8)
+        , maxContactRange(30000.0f)
+        , startTime(0)
+        , busQueueCapacity(64)
+        , partitioned(false)
+        , pinThreads(false)
+        , pipelinedModels(false)
+        , boundPruning(true)
+        , perfStatsIntervalMs(0)
+    {
+    }
+};
+
+/**
+ * 平台初始状态
+ */
+struct HeadlessPlatformConfig
+{
+    int64 platformId;               // 平台ID
+    int32 campId;                   // 阵营ID
+    double x;                       // 经度
+    double y;                       // 纬度
+    double heading;                 // 航向（度，正北顺时针）
+    double speed;                   // 速度（m/s）
+    float sourceLevel;              // 辐射噪声源级（dB）
+
+    HeadlessPlatformConfig()
+        : platformId(0)
+        , campId(1)
+        , x(0.0)
+        , y(0.0)
+        , heading(0.0)
+        , speed(0.0)
+        , sourceLevel(120.0f)
+    {
+    }
+};
+
+/**
+ * 分组统计（分区模式）
+ * 步进耗时为该组在各并行阶段（机动、信道、投递、准备）的耗时之和
+ */
+struct HeadlessGroupStats
+{
+    int platforms;                  // 组内平台数
+    int cpu;                        // 绑定的CPU，-1表示未绑定
+    double totalStepSeconds;        // 累计步进耗时（秒）
+    double maxStepSeconds;          // 单步最大耗时（秒）
+
+    HeadlessGroupStats()
+        : platforms(0), cpu(-1), totalStepSeconds(0.0), maxStepSeconds(0.0)
+    {
+    }
+};
+
+/**
+ * 各平台组件自报的某一阶段耗时（汇总各平台最近一次发布的Data_DevicePerfStats_Topic）
+ * 分位数无法跨平台合并，只给出最差平台的p99
+ */
+struct HeadlessPhaseLatency
+{
+    uint64 count;                   // 各平台记录次数之和
+    double meanNs;                  // 按记录次数加权的平均耗时
+    uint64 worstP99Ns;              // 各平台p99的最大值
+    uint64 maxNs;                   // 各平台最大耗时的最大值
+
+    HeadlessPhaseLatency() : count(0), meanNs(0.0), worstP99Ns(0), maxNs(0) {}
+};
+
+/**
+ * 运行统计
+ */
+struct HeadlessRunStats
+{
+    int64 steps;                    // 推进步数
+    double wallSeconds;             // 总耗时（秒）
+    double stepsPerSecond;          // 每秒推进步数
+    double platformStepsPerSecond;  // 每秒推进的平台步数（步数 x 平台数）
+    uint64 messagesSent;            // 组件发送的消息数
+    uint64 messagesDelivered;       // 从总线投递给组件的消息数（含信道消息）
+    uint64 contactsDelivered;       // 投递的传播声目标数
+    uint64 equationsEvaluated;      // 各组件参与声纳方程计算的目标数（按声纳计）
+    uint64 equationsPruned;         // 其中因上界低于阈值跳过精确计算的目标数
+    MemoryAccount::Snapshot memory; // 各组件内存占用之和（峰值为各组件峰值之和）
+
+    // 组件经数据主题发布的性能统计（perfStatsIntervalMs非0时）
+    int perfStatsPlatforms;                                     // 已发布过统计的平台数
+    HeadlessPhaseLatency modelPhases[DEVICE_PERF_PHASE_COUNT];  // 各阶段耗时
+    uint64 modelAllocations;                                    // 各组件累计分配次数之和
+
+    // 各阶段累计耗时（秒）
+    double motionSeconds;
+    double environmentSeconds;
+    double deliverSeconds;
+    double prepareSeconds;
+    double commitSeconds;
+
+    std::vector<HeadlessGroupStats> groups;     // 分区模式下各组统计（按线程序号）
+
+    HeadlessRunStats()
+        : steps(0), wallSeconds(0.0), stepsPerSecond(0.0), platformStepsPerSecond(0.0)
+        , messagesSent(0), messagesDelivered(0), contactsDelivered(0)
+        , equationsEvaluated(0), equationsPruned(0)
+        , perfStatsPlatforms(0), modelAllocations(0)
+        , motionSeconds(0.0), environmentSeconds(0.0), deliverSeconds(0.0)
+        , prepareSeconds(0.0), commitSeconds(0.0)
+    {
+    }
+};
+
+/**
+ * 多平台无界面宿主（引擎替身）
+ * 每个平台一个DeviceModelAgent和一个DeviceModel，按固定步长推进：
+ *   1. 机动：航位推算并写入各平台的Data_Motion（并行）
+ *   2. 信道：按平台间距离为每个平台生成扁平传播声列表（并行）
+ *   3. 投递：各平台取出总线队列中的消息（上一步组件发送的消息、本步传播声）投递给组件（按接收平台并行）
+ *   4. 准备：prepareStep（经querySimTwoPhaseStep取到且支持两阶段步进的组件并行，其余串行；未实现该接口的组件串行step）
+ *   5. 提交：按平台顺序串行commitStep，发送的消息经TopicBus按主题订阅扇出，下一步投递
+ * 总线队列为单生产者单消费者，由阶段划分保证：信道阶段各平台只向自己的队列发布，组件发送的消息
+ * 只在串行阶段（串行prepareStep与commitStep）发布，出队只在投递阶段由接收平台所在线程进行。
+ * 总线只复制消息头、增加载荷引用计数；组件以自有成员发送的载荷（未登记为可借用）不可借用，
+ * 发送方在下一次prepareStep前不修改该载荷
+ * 分区模式下平台按序号连续分成与线程数相同的组，组内平台在start时由所属线程创建并初始化
+ * （缓存首次写入发生在该线程，NUMA系统上落在其所在节点），此后并行阶段始终由该线程执行
+ */
+class HeadlessEngine
+{
+public:
+    explicit HeadlessEngine(const HeadlessEngineConfig& config);
+    ~HeadlessEngine();
+
+    /**
+     * 添加平台（须在start前调用）
+     * @return 平台序号
+     */
+    int addPlatform(const HeadlessPlatformConfig& platformConfig);
+
+    /**
+     * 初始化并启动所有平台组件，写入平台自噪声、投递环境噪声
+     */
+    bool start();
+
+    /**
+     * 推进一步
+     */
+    void stepOnce();
+
+    /**
+     * 连续推进stepCount步并返回统计
+     */
+    HeadlessRunStats run(int64 stepCount);
+
+    /**
+     * 停止并销毁所有平台组件
+     */
+    void stop();
+
+    int platformCount() const { return static_cast<int>(m_platforms.size()); }
+    int threadCount() const { return m_pool.threadCount(); }
+    int64 simTime() const { return m_simTime; }
+    const HeadlessRunStats& stats() const { return m_stats; }
+    const TopicBus& bus() const { return m_bus; }
+
+private:
+    // 禁止拷贝和赋值
+    HeadlessEngine(const HeadlessEngine&) = delete;
+    HeadlessEngine& operator=(const HeadlessEngine&) = delete;
+
+    /**
+     * 单个平台的运行状态
+     */
+    struct Platform {
+        HeadlessPlatformConfig config;
+        std::unique_ptr<DeviceModelAgent> agent;
+        std::unique_ptr<DeviceModel> model;
+        CSimTwoPhaseStep* twoPhaseStep;         // 组件的两阶段步进接口，组件未实现时为空（串行step）
+        std::unique_ptr<ModelCapture::CaptureWriter> capture;  // 输入捕获，未开启时为空
+        double x;                               // 当前经度
+        double y;                               // 当前纬度
+        int subscriberId;                       // 总线订阅者ID
+        std::shared_ptr<FlatSoundListBuffer> propagated;   // 传播声缓冲（无其他引用时复用）
+        int64 lastSelfSoundTime;                // 最近一次写入平台自噪声的时间
+        int lastContactCount;                   // 本步传播声目标数
+        int lastDeliveredCount;                 // 本步投递的消息数
+        bool hasPerfStats;                      // 组件已发布过性能统计
+        CData_DevicePerfStats perfStats;        // 组件最近一次发布的性能统计
+    };
+
+    /**
+     * 分区：线程序号对应的平台区间
+     */
+    struct Partition {
+        int begin;                              // 首个平台序号
+        int end;                                // 末个平台序号+1
+        double stepSeconds;                     // 本步已累计的耗时
+    };
+
+    void forEachPlatform(const std::function<void(int)>& body);
+    void pinThreads();
+    bool openCapture(Platform& platform);
+    bool createModel(Platform& platform);
+    void advanceMotion(int index, double dt);
+    void buildPropagatedSound(int index);
+    void deliverInbox(int index);
+    void storeSelfSound(Platform& platform);
+    void routeMessage(int senderIndex, CSimMessage* simMessage);
+
+    HeadlessEngineConfig m_config;
+    StepThreadPool m_pool;
+    TopicBus m_bus;
+    std::vector<std::unique_ptr<Platform>> m_platforms;
+    std::vector<Partition> m_partitions;        // 分区模式下按线程序号，否则为空
+    std::vector<float> m_spectrumShape;         // 传播声频谱形状（各平台共用）
+    std::shared_ptr<CMsg_EnvironmentNoiseToSonarStruct> m_environmentNoise;
+    std::atomic<uint64> m_messagesSent;         // 组件发送的消息数（可能在并行阶段发送）
+
+    int64 m_simTime;
+    bool m_started;
+    HeadlessRunStats m_stats;
+};
+
+#endif // HEADLESSENGINE_H
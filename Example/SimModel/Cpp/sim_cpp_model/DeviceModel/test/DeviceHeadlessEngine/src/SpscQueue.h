@@ -0,0 +1,93 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <stddef.h>
+#include <utility>
+
+/**
+ * 有界单生产者单消费者无锁队列
+ * 容量向上取整为2的幂；任一时刻只能有一个线程入队、一个线程出队，
+ * 入队与出队可以在不同线程上并发进行
+ */
+template<typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(size_t capacity)
+        : m_capacity(roundUpPowerOfTwo(capacity))
+        , m_mask(m_capacity - 1)
+        , m_slots(new T[m_capacity])
+        , m_head(0)
+        , m_tail(0)
+    {
+    }
+
+    /**
+     * 入队（生产者线程），队列满时返回false且不修改value
+     */
+    bool tryPush(T&& value)
+    {
+        size_t tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) >= m_capacity) {
+            return false;
+        }
+        m_slots[tail & m_mask] = std::move(value);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * 出队（消费者线程），队列空时返回false
+     * 出队后槽位被重置，元素持有的资源随out一起释放
+     */
+    bool tryPop(T& out)
+    {
+        size_t head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire)) {
+            return false;
+        }
+        T& slot = m_slots[head & m_mask];
+        out = std::move(slot);
+        slot = T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * 当前元素数（并发时为近似值）
+     */
+    size_t size() const
+    {
+        return m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return m_capacity; }
+
+private:
+    // 禁止拷贝和赋值
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    static size_t roundUpPowerOfTwo(size_t value)
+    {
+        size_t result = 1;
+        while (result < value) {
+            result <<= 1;
+        }
+        return result;
+    }
+
+    const size_t m_capacity;
+    const size_t m_mask;
+    std::unique_ptr<T[]> m_slots;
+
+    // 生产者与消费者下标用填充隔开，分处不同缓存行，避免伪共享
+    // （不用alignas：C++11的new不保证超过默认对齐的分配）
+    std::atomic<size_t> m_head;                 // 消费者下标
+    char m_padding[64];
+    std::atomic<size_t> m_tail;                 // 生产者下标
+};
+
+#endif // SPSCQUEUE_H
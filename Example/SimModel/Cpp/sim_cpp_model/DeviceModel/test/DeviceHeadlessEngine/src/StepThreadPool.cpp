@@ -0,0 +1,209 @@
+#include "StepThreadPool.h"
+#include "common/TraceZone.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+StepThreadPool::StepThreadPool(int workerCount)
+    : m_body(nullptr)
+    , m_count(0)
+    , m_perThread(false)
+    , m_next(0)
+    , m_busyWorkers(0)
+    , m_generation(0)
+    , m_stop(false)
+{
+    for (int i = 0; i < workerCount; i++) {
+        m_workers.push_back(std::thread(&StepThreadPool::workerLoop, this, i + 1));
+    }
+}
+
+StepThreadPool::~StepThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_startCond.notify_all();
+
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+}
+
+void StepThreadPool::parallelFor(int count, const std::function<void(int)>& body)
+{
+    if (count <= 0) {
+        return;
+    }
+
+    // 无工作线程或只有一个任务时直接在调用线程执行
+    if (m_workers.empty() || count == 1) {
+        for (int i = 0; i < count; i++) {
+            body(i);
+        }
+        return;
+    }
+
+    dispatch(body, count, false);
+}
+
+void StepThreadPool::runOnEachThread(const std::function<void(int)>& body)
+{
+    if (m_workers.empty()) {
+        body(0);
+        return;
+    }
+
+    dispatch(body, threadCount(), true);
+}
+
+bool StepThreadPool::pinCurrentThread(int cpu)
+{
+    if (cpu < 0) {
+        return false;
+    }
+
+#ifdef _WIN32
+    if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+        return false;
+    }
+    return SetThreadAffinityMask(GetCurrentThread(), static_cast<DWORD_PTR>(1) << cpu) != 0;
+#elif defined(__linux__)
+    if (cpu >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    CPU_SET(cpu, &cpuSet);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet) == 0;
+#else
+    return false;
+#endif
+}
+
+std::vector<int> StepThreadPool::availableCpus()
+{
+    std::vector<int> cpus;
+
+#ifdef _WIN32
+    DWORD_PTR processMask = 0;
+    DWORD_PTR systemMask = 0;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        for (int cpu = 0; cpu < static_cast<int>(sizeof(DWORD_PTR) * 8); cpu++) {
+            if (processMask & (static_cast<DWORD_PTR>(1) << cpu)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#elif defined(__linux__)
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+            if (CPU_ISSET(cpu, &cpuSet)) {
+                cpus.push_back(cpu);
+            }
+        }
+    }
+#endif
+
+    // 无法查询时按硬件线程数假定
+    if (cpus.empty()) {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        for (unsigned int cpu = 0; cpu < hardwareThreads; cpu++) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+void StepThreadPool::dispatch(const std::function<void(int)>& body, int count, bool perThread)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_body = &body;
+        m_count = count;
+        m_perThread = perThread;
+        m_next.store(0);
+        m_busyWorkers = static_cast<int>(m_workers.size());
+        m_error = nullptr;
+        m_generation++;
+    }
+    m_startCond.notify_all();
+
+    // 调用线程同样领取任务
+    runTasks(0);
+
+    std::exception_ptr error;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_doneCond.wait(lock, [this]() { return m_busyWorkers == 0; });
+        m_body = nullptr;
+        error = m_error;
+        m_error = nullptr;
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+void StepThreadPool::workerLoop(int threadIndex)
+{
+    TRACE_THREAD_NAME(("step-worker-" + std::to_string(threadIndex)).c_str());
+    unsigned long long seenGeneration = 0;
+
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_startCond.wait(lock, [this, seenGeneration]() {
+                return m_stop || m_generation != seenGeneration;
+            });
+            if (m_stop) {
+                return;
+            }
+            seenGeneration = m_generation;
+        }
+
+        runTasks(threadIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_busyWorkers--;
+        }
+        m_doneCond.notify_one();
+    }
+}
+
+void StepThreadPool::runTasks(int threadIndex)
+{
+    while (true) {
+        int index = 0;
+        if (m_perThread) {
+            index = threadIndex;
+        } else {
+            index = m_next.fetch_add(1);
+            if (index >= m_count) {
+                return;
+            }
+        }
+
+        try {
+            (*m_body)(index);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) {
+                m_error = std::current_exception();
+            }
+        }
+
+        if (m_perThread) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+#ifndef STEPTHREADPOOL_H
+#define STEPTHREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * 步进线程池
+ * 固定数量的工作线程，parallelFor把[0, count)的下标分发给工作线程与调用线程，全部完成后返回；
+ * runOnEachThread让每个线程（调用线程序号为0，工作线程依次为1..n）各执行一次，用于固定分区；
+ * 同一时刻只执行一个任务（由宿主的步进循环串行调用）
+ */
+class StepThreadPool
+{
+public:
+    /**
+     * @param workerCount 额外的工作线程数，0表示只在调用线程执行
+     */
+    explicit StepThreadPool(int workerCount);
+    ~StepThreadPool();
+
+    /**
+     * 参与执行的线程总数（含调用线程）
+     */
+    int threadCount() const { return static_cast<int>(m_workers.size()) + 1; }
+
+    /**
+     * 并行执行body(0) ... body(count-1)，返回前全部完成
+     * body抛出的第一个异常在所有任务结束后重新抛出
+     */
+    void parallelFor(int count, const std::function<void(int)>& body);
+
+    /**
+     * 每个线程执行一次body(threadIndex)，返回前全部完成
+     * 同一threadIndex总在同一线程上执行，调用线程为0
+     */
+    void runOnEachThread(const std::function<void(int)>& body);
+
+    /**
+     * 把当前线程绑定到指定CPU
+     * @return 平台不支持或绑定失败时返回false
+     */
+    static bool pinCurrentThread(int cpu);
+
+    /**
+     * 当前进程允许运行的CPU编号（按编号升序）
+     */
+    static std::vector<int> availableCpus();
+
+private:
+    // 禁止拷贝和赋值
+    StepThreadPool(const StepThreadPool&) = delete;
+    StepThreadPool& operator=(const StepThreadPool&) = delete;
+
+    void dispatch(const std::function<void(int)>& body, int count, bool perThread);
+    void workerLoop(int threadIndex);
+    void runTasks(int threadIndex);
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    std::condition_variable m_startCond;
+    std::condition_variable m_doneCond;
+
+    const std::function<void(int)>* m_body;    // 当前任务（parallelFor期间有效）
+    int m_count;
+    bool m_perThread;                           // 每线程执行一次（runOnEachThread）
+    std::atomic<int> m_next;                    // 下一个待领取的下标
+    int m_busyWorkers;                          // 尚未完成当前任务的工作线程数
+    unsigned long long m_generation;            // 任务代数，工作线程据此识别新任务
+    bool m_stop;
+    std::exception_ptr m_error;
+};
+
+#endif // STEPTHREADPOOL_H
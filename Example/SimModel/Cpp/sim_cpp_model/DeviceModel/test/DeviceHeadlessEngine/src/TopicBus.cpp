@@ -0,0 +1,252 @@
+#include "TopicBus.h"
+#include "common/TopicHash.h"
+#include "common/DMLogger.h"
+
+#include <cstring>
+
+TopicBus::TopicBus(size_t queueCapacity)
+    : m_queueCapacity(queueCapacity > 0 ? queueCapacity : 1)
+    , m_routingTable(new RoutingTable())
+    , m_routing(nullptr)
+{
+    m_routing.store(m_routingTable.get(), std::memory_order_release);
+}
+
+TopicBus::~TopicBus()
+{
+}
+
+int TopicBus::addSubscriber(int64 platformId)
+{
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+
+    int subscriberId = static_cast<int>(m_subscribers.size());
+    m_subscribers.push_back(std::unique_ptr<Subscriber>(new Subscriber(platformId, m_queueCapacity)));
+    m_platformSubscribers[platformId] = subscriberId;
+    rebuildRouting();
+    return subscriberId;
+}
+
+bool TopicBus::subscribe(int subscriberId, const char* topic)
+{
+    if (!topic || subscriberId < 0 || subscriberId >= subscriberCount()) {
+        return false;
+    }
+
+    uint32_t topicHash = TopicHash::topicHashRuntime(topic, EventTypeLen);
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+
+    TopicEntry* entry = findOrCreateTopic(topic, topicHash);
+    if (!entry) {
+        return false;
+    }
+
+    Subscriber& subscriber = *m_subscribers[subscriberId];
+    for (uint32_t subscribedHash : subscriber.topicHashes) {
+        if (subscribedHash == topicHash) {
+            return true;
+        }
+    }
+    subscriber.topicHashes.push_back(topicHash);
+    entry->subscribers.push_back(subscriberId);
+    rebuildRouting();
+    return true;
+}
+
+void TopicBus::unsubscribe(int subscriberId, const char* topic)
+{
+    if (!topic || subscriberId < 0 || subscriberId >= subscriberCount()) {
+        return;
+    }
+
+    uint32_t topicHash = TopicHash::topicHashRuntime(topic, EventTypeLen);
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+
+    TopicEntry* entry = findTopic(topic, topicHash);
+    if (!entry) {
+        return;
+    }
+
+    Subscriber& subscriber = *m_subscribers[subscriberId];
+    for (size_t i = 0; i < subscriber.topicHashes.size(); i++) {
+        if (subscriber.topicHashes[i] == topicHash) {
+            subscriber.topicHashes.erase(subscriber.topicHashes.begin() + i);
+            break;
+        }
+    }
+    for (size_t i = 0; i < entry->subscribers.size(); i++) {
+        if (entry->subscribers[i] == subscriberId) {
+            entry->subscribers.erase(entry->subscribers.begin() + i);
+            break;
+        }
+    }
+    rebuildRouting();
+}
+
+int TopicBus::publish(const CSimMessage& header, const std::shared_ptr<const void>& payload, bool lendable)
+{
+    uint32_t topicHash = TopicHash::topicHashRuntime(header.topic, EventTypeLen);
+
+    // 路由表只读，扇出与入队不持锁；同一订阅者队列的单生产者由宿主的步进阶段保证
+    const RoutingTable* routing = m_routing.load(std::memory_order_acquire);
+    const RoutingTable::Topic* route = findRoute(*routing, header.topic, topicHash);
+    if (!route) {
+        // 首次发布的主题：登记（无人订阅同样登记，以便统计未路由的发布）后重取路由表
+        std::lock_guard<std::mutex> lock(m_registryMutex);
+        if (!findOrCreateTopic(header.topic, topicHash)) {
+            return 0;
+        }
+        routing = m_routing.load(std::memory_order_acquire);
+        route = findRoute(*routing, header.topic, topicHash);
+        if (!route) {
+            rebuildRouting();
+            routing = m_routing.load(std::memory_order_acquire);
+            route = findRoute(*routing, header.topic, topicHash);
+        }
+    }
+
+    TopicEntry& entry = *route->entry;
+    entry.published.fetch_add(1, std::memory_order_relaxed);
+
+    BusMessage message;
+    message.header = header;
+    message.payload = payload;
+    message.lendable = lendable;
+
+    int fanOut = 0;
+    if (header.receiver > 0) {
+        // 定向投递：只查接收平台的订阅者
+        auto it = routing->receivers.find(header.receiver);
+        if (it != routing->receivers.end()) {
+            for (uint32_t subscribedHash : it->second.topicHashes) {
+                if (subscribedHash == topicHash) {
+                    fanOut += enqueue(entry, *it->second.subscriber, message) ? 1 : 0;
+                    break;
+                }
+            }
+        }
+    } else {
+        // 广播：发送方所在平台不接收自己的消息
+        for (Subscriber* subscriber : route->subscribers) {
+            if (subscriber->platformId == header.sender) {
+                continue;
+            }
+            fanOut += enqueue(entry, *subscriber, message) ? 1 : 0;
+        }
+    }
+
+    if (fanOut == 0) {
+        entry.unrouted.fetch_add(1, std::memory_order_relaxed);
+    }
+    return fanOut;
+}
+
+bool TopicBus::poll(int subscriberId, BusMessage& out)
+{
+    if (subscriberId < 0 || subscriberId >= subscriberCount()) {
+        return false;
+    }
+    return m_subscribers[subscriberId]->queue.tryPop(out);
+}
+
+void TopicBus::reclaimRoutingTables()
+{
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+    m_retiredTables.clear();
+}
+
+std::vector<TopicBusStats> TopicBus::topicStats() const
+{
+    std::lock_guard<std::mutex> lock(m_registryMutex);
+
+    std::vector<TopicBusStats> result;
+    for (const auto& item : m_topics) {
+        const TopicEntry& entry = *item.second;
+        TopicBusStats stats;
+        stats.topic = entry.name;
+        stats.published = entry.published.load(std::memory_order_relaxed);
+        stats.delivered = entry.delivered.load(std::memory_order_relaxed);
+        stats.dropped = entry.dropped.load(std::memory_order_relaxed);
+        stats.unrouted = entry.unrouted.load(std::memory_order_relaxed);
+        stats.maxQueueDepth = entry.maxQueueDepth.load(std::memory_order_relaxed);
+        result.push_back(stats);
+    }
+    return result;
+}
+
+TopicBus::TopicEntry* TopicBus::findTopic(const char* topic, uint32_t topicHash) const
+{
+    auto it = m_topics.find(topicHash);
+    if (it == m_topics.end() || strncmp(it->second->name.c_str(), topic, EventTypeLen) != 0) {
+        return nullptr;
+    }
+    return it->second.get();
+}
+
+const TopicBus::RoutingTable::Topic* TopicBus::findRoute(const RoutingTable& routing, const char* topic,
+                                                         uint32_t topicHash) const
+{
+    auto it = routing.topics.find(topicHash);
+    if (it == routing.topics.end() || strncmp(it->second.entry->name.c_str(), topic, EventTypeLen) != 0) {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+TopicBus::TopicEntry* TopicBus::findOrCreateTopic(const char* topic, uint32_t topicHash)
+{
+    auto it = m_topics.find(topicHash);
+    if (it != m_topics.end()) {
+        if (strncmp(it->second->name.c_str(), topic, EventTypeLen) != 0) {
+            LOG_WARNF("Topic hash collision: %s vs %s", topic, it->second->name.c_str());
+            return nullptr;
+        }
+        return it->second.get();
+    }
+
+    std::unique_ptr<TopicEntry> entry(new TopicEntry());
+    entry->name.assign(topic, strnlen(topic, EventTypeLen));
+    TopicEntry* result = entry.get();
+    m_topics[topicHash] = std::move(entry);
+    return result;
+}
+
+bool TopicBus::enqueue(TopicEntry& entry, Subscriber& subscriber, const BusMessage& message)
+{
+    BusMessage copy = message;      // 只复制消息头并增加载荷引用计数
+    if (!subscriber.queue.tryPush(std::move(copy))) {
+        entry.dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    entry.delivered.fetch_add(1, std::memory_order_relaxed);
+
+    uint64 depth = subscriber.queue.size();
+    uint64 maxDepth = entry.maxQueueDepth.load(std::memory_order_relaxed);
+    while (depth > maxDepth &&
+           !entry.maxQueueDepth.compare_exchange_weak(maxDepth, depth, std::memory_order_relaxed)) {
+    }
+    return true;
+}
+
+void TopicBus::rebuildRouting()
+{
+    std::unique_ptr<RoutingTable> routing(new RoutingTable());
+    for (const auto& item : m_topics) {
+        RoutingTable::Topic& route = routing->topics[item.first];
+        route.entry = item.second.get();
+        route.subscribers.reserve(item.second->subscribers.size());
+        for (int subscriberId : item.second->subscribers) {
+            route.subscribers.push_back(m_subscribers[subscriberId].get());
+        }
+    }
+    for (const auto& item : m_platformSubscribers) {
+        RoutingTable::Receiver& receiver = routing->receivers[item.first];
+        receiver.subscriber = m_subscribers[item.second].get();
+        receiver.topicHashes = receiver.subscriber->topicHashes;
+    }
+
+    // 旧表可能仍被进行中的publish读取，暂存到reclaimRoutingTables时释放
+    m_retiredTables.push_back(std::move(m_routingTable));
+    m_routingTable.reset(routing.release());
+    m_routing.store(m_routingTable.get(), std::memory_order_release);
+}
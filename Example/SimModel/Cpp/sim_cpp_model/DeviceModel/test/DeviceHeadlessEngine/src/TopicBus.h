@@ -0,0 +1,158 @@
+#ifndef TOPICBUS_H
+#define TOPICBUS_H
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "SimBasicTypes.h"
+#include "CSimMessage.h"
+#include "SpscQueue.h"
+
+/**
+ * 总线消息：消息头 + 引用计数的只读载荷
+ * 消息头的data指向payload所持有的内存，一条消息扇出给多个订阅者时只增加引用计数
+ */
+struct BusMessage
+{
+    CSimMessage header;
+    std::shared_ptr<const void> payload;
+    bool lendable;                  // 载荷由payload持有，接收方可借用（CSimModelAgentExtension::retainPayload）
+
+    BusMessage() : lendable(false) {}
+};
+
+/**
+ * 主题统计（背压计数）
+ */
+struct TopicBusStats
+{
+    std::string topic;
+    uint64 published;               // 发布次数
+    uint64 delivered;               // 成功入队的订阅者消息数（扇出）
+    uint64 dropped;                 // 订阅者队列满而丢弃的消息数
+    uint64 unrouted;                // 没有匹配订阅者的发布次数
+    uint64 maxQueueDepth;           // 入队后订阅者队列的最大深度
+};
+
+/**
+ * 进程内发布/订阅总线
+ * 每个订阅者一个有界SPSC队列，发布时按主题订阅和接收者（receiver>0时只投给该平台）入队；
+ * 同一订阅者的入队在同一时刻只能来自一个线程，出队只能来自一个线程，由宿主按步进阶段保证，总线不加锁。
+ * 订阅关系以只读路由表发布：订阅/取消订阅在互斥量内修改登记并生成新表（写时复制），
+ * publish只原子读取当前表，扇出与入队不持锁，可与订阅修改并发。
+ * 被替换的旧表暂存，宿主在没有并发publish的时刻（步与步之间）调用reclaimRoutingTables释放
+ */
+class TopicBus
+{
+public:
+    /**
+     * @param queueCapacity 每个订阅者队列的容量
+     */
+    explicit TopicBus(size_t queueCapacity);
+    ~TopicBus();
+
+    /**
+     * 登记订阅者（须在发布前完成）
+     * @param platformId 订阅者所在平台，用于按receiver定向投递
+     * @return 订阅者ID
+     */
+    int addSubscriber(int64 platformId);
+
+    /**
+     * 订阅/取消订阅主题
+     */
+    bool subscribe(int subscriberId, const char* topic);
+    void unsubscribe(int subscriberId, const char* topic);
+
+    /**
+     * 发布消息（不拷贝载荷）
+     * @param header 消息头，data须指向payload持有的内存
+     * @param payload 载荷句柄，发布后不得再修改
+     * @param lendable 载荷由payload持有（非空删除器），接收方可借用
+     * @return 入队的订阅者数
+     */
+    int publish(const CSimMessage& header, const std::shared_ptr<const void>& payload, bool lendable = true);
+
+    /**
+     * 取出订阅者的下一条消息（消费者线程）
+     */
+    bool poll(int subscriberId, BusMessage& out);
+
+    /**
+     * 释放已被替换的路由表（调用时不得有并发的publish）
+     */
+    void reclaimRoutingTables();
+
+    /**
+     * 各主题统计
+     */
+    std::vector<TopicBusStats> topicStats() const;
+
+    int subscriberCount() const { return static_cast<int>(m_subscribers.size()); }
+
+private:
+    // 禁止拷贝和赋值
+    TopicBus(const TopicBus&) = delete;
+    TopicBus& operator=(const TopicBus&) = delete;
+
+    struct TopicEntry {
+        std::string name;
+        std::vector<int> subscribers;           // 订阅者ID（广播投递顺序），只在锁内访问
+        std::atomic<uint64> published;
+        std::atomic<uint64> delivered;
+        std::atomic<uint64> dropped;
+        std::atomic<uint64> unrouted;
+        std::atomic<uint64> maxQueueDepth;
+
+        TopicEntry() : published(0), delivered(0), dropped(0), unrouted(0), maxQueueDepth(0) {}
+    };
+
+    struct Subscriber {
+        int64 platformId;
+        std::vector<uint32_t> topicHashes;      // 已订阅主题（数量很少，线性查找），只在锁内访问
+        SpscQueue<BusMessage> queue;
+
+        Subscriber(int64 id, size_t capacity) : platformId(id), queue(capacity) {}
+    };
+
+    /**
+     * 只读路由表：生成后不再修改，publish无锁读取
+     */
+    struct RoutingTable {
+        struct Topic {
+            TopicEntry* entry;                  // 主题统计（登记后不释放）
+            std::vector<Subscriber*> subscribers;   // 广播投递顺序
+        };
+        struct Receiver {
+            Subscriber* subscriber;
+            std::vector<uint32_t> topicHashes;  // 该订阅者已订阅的主题
+        };
+
+        std::map<uint32_t, Topic> topics;       // 主题哈希 -> 订阅者
+        std::map<int64, Receiver> receivers;    // 平台ID -> 定向投递的订阅者
+    };
+
+    TopicEntry* findTopic(const char* topic, uint32_t topicHash) const;
+    TopicEntry* findOrCreateTopic(const char* topic, uint32_t topicHash);
+    const RoutingTable::Topic* findRoute(const RoutingTable& routing, const char* topic, uint32_t topicHash) const;
+    bool enqueue(TopicEntry& entry, Subscriber& subscriber, const BusMessage& message);
+
+    /**
+     * 按当前登记生成新路由表并替换（调用方持有m_registryMutex）
+     */
+    void rebuildRouting();
+
+    size_t m_queueCapacity;
+    std::vector<std::unique_ptr<Subscriber>> m_subscribers;
+    std::map<int64, int> m_platformSubscribers;            // 平台ID -> 订阅者ID
+    std::map<uint32_t, std::unique_ptr<TopicEntry>> m_topics;   // 主题哈希 -> 主题
+    std::unique_ptr<const RoutingTable> m_routingTable;    // 当前路由表
+    std::atomic<const RoutingTable*> m_routing;            // 当前路由表（publish读取）
+    std::vector<std::unique_ptr<const RoutingTable>> m_retiredTables;  // 已替换、待释放的路由表
+    mutable std::mutex m_registryMutex;                    // 保护订阅登记与路由表替换
+};
+
+#endif // TOPICBUS_H
@@ -0,0 +1,285 @@
+#include "HeadlessEngine.h"
+#include "devicemodel.h"
+#include "common/DMLogger.h"
+#include "common/SpectrumSlabPool.h"
+#include "common/TraceZone.h"
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <thread>
+
+namespace {
+
+/**
+ * 命令行参数
+ */
+struct HeadlessOptions
+{
+    int platforms;
+    int64 steps;
+    int32 stepMs;
+    int threads;
+    int contacts;
+    double spacing;         // 平台间距（米）
+    int queueCapacity;      // 总线接收队列容量
+    bool partitioned;       // 平台按线程固定分组
+    bool pinThreads;        // 线程绑定CPU
+    bool pipelined;         // 组件流水线步进
+    bool boundPruning;      // 组件声纳方程上界剪枝
+    bool hugePages;         // 频谱块池使用大页
+    std::string logFile;    // 为空时不写日志文件
+    std::string capture;    // 捕获文件前缀，为空时不捕获
+    int64 perfStatsMs;      // 组件性能统计发布间隔（仿真毫秒），0为不发布
+    std::string traceFile;  // 跟踪事件输出文件，为空时不导出
+
+    HeadlessOptions()
+        : platforms(16)
+        , steps(100)
+        , stepMs(1000)
+        , threads(-1)
+        , contacts(8)
+        , spacing(5000.0)
+        , queueCapacity(64)
+        , partitioned(false)
+        , pinThreads(false)
+        , pipelined(false)
+        , boundPruning(true)
+        , hugePages(false)
+        , perfStatsMs(0)
+    {
+    }
+};
+
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --platforms N   平台数量（默认16）\n"
+              << "  --steps N       推进步数（默认100）\n"
+              << "  --step-ms N     仿真步长ms（默认1000）\n"
+              << "  --threads N     线程总数，含主线程（默认为硬件线程数）\n"
+              << "  --contacts N    每平台每步最多传播声目标数（默认8）\n"
+              << "  --spacing M     平台初始间距，米（默认5000）\n"
+              << "  --queue N       每平台总线接收队列容量（默认64）\n"
+              << "  --partition     平台按线程固定分组，组内平台始终在同一线程创建和推进\n"
+              << "  --pin           各线程绑定到固定CPU\n"
+              << "  --pipeline      组件流水线步进：计算在组件自有线程上与发布重叠，结果晚一步发出\n"
+              << "  --no-prune      关闭组件的声纳方程上界剪枝\n"
+              << "  --huge-pages    频谱块池以大页承载（Linux）\n"
+              << "  --log FILE      写模型日志到文件（INFO级别，大规模运行时很慢）\n"
+              << "  --capture PFX   各平台组件输入写入捕获文件 PFX_<平台ID>.dmcap（DeviceReplay回放）\n"
+              << "  --perf-stats MS 组件按仿真时间间隔发布性能统计主题，结束时汇总各阶段耗时\n"
+              << "  --trace FILE    结束时导出Chrome/Perfetto跟踪事件JSON（需以CONFIG+=devicemodel_trace构建）\n";
+}
+
+bool parseOptions(int argc, char* argv[], HeadlessOptions& options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg == "--platforms" && hasValue) {
+            options.platforms = atoi(argv[++i]);
+        } else if (arg == "--steps" && hasValue) {
+            options.steps = atoll(argv[++i]);
+        } else if (arg == "--step-ms" && hasValue) {
+            options.stepMs = atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = atoi(argv[++i]);
+        } else if (arg == "--contacts" && hasValue) {
+            options.contacts = atoi(argv[++i]);
+        } else if (arg == "--spacing" && hasValue) {
+            options.spacing = atof(argv[++i]);
+        } else if (arg == "--queue" && hasValue) {
+            options.queueCapacity = atoi(argv[++i]);
+        } else if (arg == "--partition") {
+            options.partitioned = true;
+        } else if (arg == "--pin") {
+            options.pinThreads = true;
+        } else if (arg == "--pipeline") {
+            options.pipelined = true;
+        } else if (arg == "--no-prune") {
+            options.boundPruning = false;
+        } else if (arg == "--huge-pages") {
+            options.hugePages = true;
+        } else if (arg == "--log" && hasValue) {
+            options.logFile = argv[++i];
+        } else if (arg == "--capture" && hasValue) {
+            options.capture = argv[++i];
+        } else if (arg == "--perf-stats" && hasValue) {
+            options.perfStatsMs = atoll(argv[++i]);
+        } else if (arg == "--trace" && hasValue) {
+            options.traceFile = argv[++i];
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.threads < 0) {
+        options.threads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    return options.platforms > 0 && options.steps >= 0 && options.stepMs > 0;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    HeadlessOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // 模型构造时若日志未初始化会自动创建日志文件，这里先按参数初始化
+    Logger& logger = Logger::getInstance();
+    logger.initialize(options.logFile, false);
+    logger.setLogLevel(options.logFile.empty() ? LogLevel::WARN : LogLevel::INFO);
+
+    // 频谱块池为进程级单例，须在首个频谱分配前配置
+    SpectrumSlabPool::Config poolConfig;
+    poolConfig.hugePages = options.hugePages;
+    SpectrumSlabPool::instance().configure(poolConfig);
+
+    // 未指定输出文件时不记录跟踪事件
+    TraceRecorder& tracer = TraceRecorder::instance();
+    tracer.setEnabled(!options.traceFile.empty());
+    TRACE_THREAD_NAME("engine-main");
+
+    HeadlessEngineConfig config;
+    config.stepMs = options.stepMs;
+    config.workerThreads = options.threads > 1 ? options.threads - 1 : 0;
+    config.maxContactsPerPlatform = options.contacts;
+    config.busQueueCapacity = options.queueCapacity;
+    config.partitioned = options.partitioned;
+    config.pinThreads = options.pinThreads;
+    config.pipelinedModels = options.pipelined;
+    config.boundPruning = options.boundPruning;
+    config.capturePrefix = options.capture;
+    config.perfStatsIntervalMs = options.perfStatsMs;
+
+    HeadlessEngine engine(config);
+
+    // 平台按方阵排布，航向与源级各不相同
+    const double metersPerDegree = 111320.0;
+    int columns = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(options.platforms))));
+    for (int i = 0; i < options.platforms; i++) {
+        HeadlessPlatformConfig platform;
+        platform.platformId = 1000 + i;
+        platform.campId = (i % 2) + 1;
+        platform.x = 120.0 + (i % columns) * options.spacing / metersPerDegree;
+        platform.y = 20.0 + (i / columns) * options.spacing / metersPerDegree;
+        platform.heading = (i * 37) % 360;
+        platform.speed = 5.0;
+        platform.sourceLevel = 120.0f + (i % 5) * 3.0f;
+        engine.addPlatform(platform);
+    }
+
+    if (!engine.start()) {
+        std::cerr << "Failed to start headless engine" << std::endl;
+        return 2;
+    }
+
+    HeadlessRunStats stats = engine.run(options.steps);
+    engine.stop();
+
+    double stepCount = stats.steps > 0 ? static_cast<double>(stats.steps) : 1.0;
+    std::cout << std::fixed << std::setprecision(3)
+              << "platforms=" << engine.platformCount()
+              << " threads=" << engine.threadCount()
+              << " steps=" << stats.steps
+              << " stepMs=" << options.stepMs << "\n"
+              << "wall=" << stats.wallSeconds << "s"
+              << " steps/s=" << stats.stepsPerSecond
+              << " platform-steps/s=" << stats.platformStepsPerSecond << "\n"
+              << "messages sent=" << stats.messagesSent
+              << " delivered=" << stats.messagesDelivered
+              << " contacts=" << stats.contactsDelivered << "\n"
+              << "equations evaluated=" << stats.equationsEvaluated
+              << " pruned=" << stats.equationsPruned
+              << " skip-rate=" << (stats.equationsEvaluated > 0
+                                   ? 100.0 * stats.equationsPruned / stats.equationsEvaluated : 0.0) << "%\n"
+              << "per-step ms: motion=" << stats.motionSeconds * 1000.0 / stepCount
+              << " environment=" << stats.environmentSeconds * 1000.0 / stepCount
+              << " deliver=" << stats.deliverSeconds * 1000.0 / stepCount
+              << " prepare=" << stats.prepareSeconds * 1000.0 / stepCount
+              << " commit=" << stats.commitSeconds * 1000.0 / stepCount
+              << std::endl;
+
+    // 组件内存账本（各组件之和）
+    std::cout << std::setprecision(1) << "memory KiB total=" << stats.memory.total.bytes / 1024.0
+              << " peak=" << stats.memory.total.peakBytes / 1024.0;
+    for (int i = 0; i < MemoryAccount::CATEGORY_COUNT; i++) {
+        std::cout << " " << MemoryAccount::categoryName(static_cast<MemoryAccount::Category>(i))
+                  << "=" << stats.memory.categories[i].bytes / 1024.0;
+    }
+    std::cout << std::setprecision(3) << "\n";
+
+    // 组件经Data_DevicePerfStats_Topic自报的阶段耗时
+    if (stats.perfStatsPlatforms > 0) {
+        std::cout << "model perf (" << stats.perfStatsPlatforms << " platforms"
+                  << ", allocations=" << stats.modelAllocations << ")\n";
+        for (int phase = 0; phase < DEVICE_PERF_PHASE_COUNT; phase++) {
+            const HeadlessPhaseLatency& latency = stats.modelPhases[phase];
+            std::cout << "  " << std::left << std::setw(9) << DeviceModel::perfPhaseName(phase) << std::right
+                      << " count=" << latency.count
+                      << " mean us=" << latency.meanNs / 1000.0
+                      << " worst p99 us=" << latency.worstP99Ns / 1000.0
+                      << " max us=" << latency.maxNs / 1000.0 << "\n";
+        }
+    }
+
+    SpectrumSlabPool::Stats poolStats = SpectrumSlabPool::instance().stats();
+    std::cout << "spectrum pool chunks=" << poolStats.chunks
+              << " hugePageChunks=" << poolStats.hugePageChunks
+              << " slabs=" << poolStats.slabsTotal
+              << " inUse=" << poolStats.slabsInUse
+              << " peak=" << poolStats.slabsPeak
+              << " acquired=" << poolStats.acquired
+              << " recycled=" << poolStats.recycled
+              << " fallbacks=" << poolStats.fallbacks << "\n";
+
+    // 分区模式下各组的步进耗时
+    for (size_t group = 0; group < stats.groups.size(); group++) {
+        const HeadlessGroupStats& groupStats = stats.groups[group];
+        std::cout << "group " << group
+                  << " platforms=" << groupStats.platforms
+                  << " cpu=" << groupStats.cpu
+                  << " step ms avg=" << groupStats.totalStepSeconds * 1000.0 / stepCount
+                  << " max=" << groupStats.maxStepSeconds * 1000.0 << "\n";
+    }
+
+    // 总线各主题的扇出与背压
+    for (const TopicBusStats& topicStats : engine.bus().topicStats()) {
+        std::cout << "topic " << topicStats.topic
+                  << " published=" << topicStats.published
+                  << " delivered=" << topicStats.delivered
+                  << " dropped=" << topicStats.dropped
+                  << " unrouted=" << topicStats.unrouted
+                  << " maxDepth=" << topicStats.maxQueueDepth << "\n";
+    }
+    std::cout.flush();
+
+    if (!options.traceFile.empty()) {
+        if (!TraceRecorder::isCompiledIn()) {
+            std::cerr << "Trace zones are compiled out (build with CONFIG+=devicemodel_trace)" << std::endl;
+        }
+        TraceRecorder::Stats traceStats = tracer.stats();
+        if (!tracer.exportChromeJson(options.traceFile)) {
+            std::cerr << "Failed to write trace file " << options.traceFile << std::endl;
+            return 3;
+        }
+        std::cout << "trace " << options.traceFile
+                  << " threads=" << traceStats.threads
+                  << " events=" << traceStats.events
+                  << " dropped=" << traceStats.dropped << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,52 @@
+CONFIG += c++11 console
+CONFIG -= app_bundle qt
+
+INCLUDEPATH += \
+    $$PWD/../../../../../../../SDK/SimModel/Cpp/include/ \
+    $$PWD/../../src/ \
+    $$PWD/../common/ \
+    $$PWD/src/
+
+win32 {
+    CONFIG(debug,debug|release){
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/winDebug -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/winDebug/
+    }
+    else {
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/winRelease -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/winRelease/
+    }
+}
+else {
+    CONFIG(debug,debug|release){
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/linuxDebug -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/linuxDebug/
+    }
+    else {
+        LIBS += -L$$PWD/../../../../../../../SDK/SimModel/Cpp/bin/linuxRelease -lSimSdk
+        DESTDIR = $$PWD/../../../bin2/linuxRelease/
+    }
+    LIBS += -lpthread
+}
+
+SOURCES += \
+        src/mainKernelBench.cpp \
+        ../common/PerfCounters.cpp \
+        ../../src/common/DMLogger.cpp \
+        ../../src/common/SpectrumSlabPool.cpp \
+        ../../src/common/TraceZone.cpp \
+        ../../src/devicemodel.cpp \
+        ../../src/FlatSoundList.cpp
+
+HEADERS += \
+    ../common/DeviceModelTestAccess.h \
+    ../common/PerfCounters.h \
+    ../../src/common/DMLogger.h \
+    ../../src/devicemodel.h \
+    ../../src/FlatSoundList.h \
+    ../../src/common/SpectrumBuffer.h \
+    ../../src/common/SpectrumSlabPool.h \
+    ../../src/common/MemoryAccount.h \
+    ../../src/common/LatencyHistogram.h \
+    ../../src/common/CounterRng.h \
+    ../../src/common/TraceZone.h
@@ -0,0 +1,520 @@
+#include "DeviceModelTestAccess.h"
+#include "PerfCounters.h"
+#include "common/DMLogger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+const int SONAR_COUNT = 4;
+const int NO_SONAR = -1;                // 与声纳无关的函数
+const int SPECTRUM_SIZE = DeviceModelTestAccess::SPECTRUM_SIZE;
+
+/**
+ * 命令行参数
+ */
+struct KernelBenchOptions
+{
+    std::vector<int> contactCounts;     // 每轮处理的目标（频谱）数
+    std::vector<int> sonarIds;          // 声纳阵列ID
+    std::vector<std::string> kernels;   // 为空时测量全部函数
+    double minTrialMs;                  // 每次试验的最短耗时（ms）
+    int trials;                         // 试验次数，取最快一次
+    uint32_t seed;                      // 输入数据随机种子
+    std::string jsonFile;               // 非空时另写JSON结果
+
+    KernelBenchOptions()
+        : minTrialMs(20.0)
+        , trials(5)
+        , seed(1)
+    {
+    }
+};
+
+/**
+ * 各目标的输入数据（按目标数生成一次，各函数共用）
+ */
+struct KernelInputs
+{
+    std::vector<SpectrumBuffer> spectra;        // 传播频谱（与模型一样经块池分配）
+    std::vector<float> bearings;                // 目标方位（度）
+    std::vector<float> distances;               // 目标距离（米）
+    std::vector<double> frequenciesKHz;         // 动态DI使用的频率（kHz）
+    std::vector<int> frequenciesHz;             // 频点索引换算使用的频率（Hz）
+    std::vector<std::vector<float> > outputs;   // 模拟频谱的写出缓冲
+    float ownShipHeading;
+};
+
+/**
+ * 一项测量结果
+ */
+struct KernelResult
+{
+    std::string kernel;
+    int sonarId;
+    int contacts;
+    double nsPerOp;
+    double bytesPerOp;                  // 每次调用读写的频谱字节数，标量函数为0
+    double binsPerOp;                   // 每次调用处理的频点数，标量函数为0
+    double instructionsPerOp;           // 计数不可用时为-1
+    double cyclesPerOp;                 // 计数不可用时为-1
+};
+
+/**
+ * 被测函数：pass对全部目标各调用一次（间接调用每轮一次，不计入单次耗时），
+ * 返回值之和累加到全局汇总防止被优化掉
+ */
+struct KernelCase
+{
+    std::string name;
+    bool perSonar;                      // 按声纳阵列分别测量
+    std::function<double(int sonarId)> pass;
+    std::function<double(int sonarId, int index)> bytes;    // 对第index个目标单次调用的频谱字节数
+};
+
+double g_sink = 0.0;
+
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options]\n"
+              << "  --contacts LIST  目标数，逗号分隔（默认1,8,64,512,4096）\n"
+              << "  --sonars LIST    声纳阵列ID，逗号分隔（默认0,1,2,3）\n"
+              << "  --kernels LIST   只测量列出的函数（默认全部）\n"
+              << "  --min-time-ms N  每次试验最短耗时（默认20）\n"
+              << "  --trials N       试验次数，取最快一次（默认5）\n"
+              << "  --seed N         输入数据随机种子（默认1）\n"
+              << "  --json FILE      另写JSON结果到文件\n";
+}
+
+std::vector<std::string> splitList(const std::string& text)
+{
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+std::vector<int> parseIntList(const std::string& text)
+{
+    std::vector<int> values;
+    for (const std::string& item : splitList(text)) {
+        values.push_back(atoi(item.c_str()));
+    }
+    return values;
+}
+
+bool parseOptions(int argc, char* argv[], KernelBenchOptions& options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg == "--contacts" && hasValue) {
+            options.contactCounts = parseIntList(argv[++i]);
+        } else if (arg == "--sonars" && hasValue) {
+            options.sonarIds = parseIntList(argv[++i]);
+        } else if (arg == "--kernels" && hasValue) {
+            options.kernels = splitList(argv[++i]);
+        } else if (arg == "--min-time-ms" && hasValue) {
+            options.minTrialMs = atof(argv[++i]);
+        } else if (arg == "--trials" && hasValue) {
+            options.trials = atoi(argv[++i]);
+        } else if (arg == "--seed" && hasValue) {
+            options.seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--json" && hasValue) {
+            options.jsonFile = argv[++i];
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+
+    if (options.contactCounts.empty()) {
+        options.contactCounts = { 1, 8, 64, 512, 4096 };
+    }
+    if (options.sonarIds.empty()) {
+        options.sonarIds = { 0, 1, 2, 3 };
+    }
+    for (int contacts : options.contactCounts) {
+        if (contacts <= 0) {
+            return false;
+        }
+    }
+    for (int sonarId : options.sonarIds) {
+        if (sonarId < 0 || sonarId >= SONAR_COUNT) {
+            return false;
+        }
+    }
+    return options.minTrialMs > 0.0 && options.trials > 0;
+}
+
+/**
+ * 生成输入：频谱为宽带斜坡叠加起伏与线谱，幅度按目标随机
+ */
+void buildInputs(int contacts, uint32_t seed, KernelInputs& inputs)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> levelDist(20.0f, 90.0f);
+    std::uniform_real_distribution<float> slopeDist(0.1f, 0.4f);
+    std::uniform_real_distribution<float> bearingDist(0.0f, 360.0f);
+    std::uniform_real_distribution<float> distanceDist(500.0f, 45000.0f);
+    std::uniform_real_distribution<double> khzDist(0.01, 8.0);
+    std::uniform_int_distribution<int> hzDist(1, 45000);
+    std::uniform_int_distribution<int> lineDist(0, SPECTRUM_SIZE - 1);
+
+    inputs.spectra.clear();
+    inputs.spectra.reserve(contacts);
+    inputs.bearings.resize(contacts);
+    inputs.distances.resize(contacts);
+    inputs.frequenciesKHz.resize(contacts);
+    inputs.frequenciesHz.resize(contacts);
+    inputs.outputs.assign(contacts, std::vector<float>(SPECTRUM_SIZE, 0.0f));
+    inputs.ownShipHeading = 30.0f;
+
+    for (int c = 0; c < contacts; c++) {
+        float* data = nullptr;
+        SpectrumBuffer spectrum = SpectrumBuffer::allocate(SPECTRUM_SIZE, data);
+        float level = levelDist(generator);
+        float slope = slopeDist(generator);
+        int lineBin = lineDist(generator);
+        for (int i = 0; i < SPECTRUM_SIZE; i++) {
+            float freqRatio = static_cast<float>(i) / SPECTRUM_SIZE;
+            float line = (std::abs(i - lineBin) < 4) ? 0.1f : 0.0f;
+            data[i] = level * (1.0f - slope * freqRatio + 0.05f * sinf(i * 0.013f) + line);
+        }
+        inputs.spectra.push_back(spectrum);
+
+        inputs.bearings[c] = bearingDist(generator);
+        inputs.distances[c] = distanceDist(generator);
+        inputs.frequenciesKHz[c] = khzDist(generator);
+        inputs.frequenciesHz[c] = hzDist(generator);
+    }
+}
+
+/**
+ * 测量一个函数：每轮对全部目标各调用一次，轮数按最短试验耗时校准，取最快一次试验
+ */
+KernelResult measureKernel(const KernelCase& kernel, int sonarId, int contacts, const KernelBenchOptions& options,
+                           const PerfCounters& counters)
+{
+    KernelResult result;
+    result.kernel = kernel.name;
+    result.sonarId = sonarId;
+    result.contacts = contacts;
+    result.instructionsPerOp = -1.0;
+    result.cyclesPerOp = -1.0;
+
+    auto runPasses = [&kernel, sonarId](int64_t passes) {
+        double sum = 0.0;
+        for (int64_t pass = 0; pass < passes; pass++) {
+            sum += kernel.pass(sonarId);
+        }
+        g_sink += sum;
+    };
+
+    // 校准：轮数翻倍直到单次试验达到最短耗时
+    int64_t passes = 1;
+    double minTrialSeconds = options.minTrialMs / 1000.0;
+    while (true) {
+        auto begin = std::chrono::steady_clock::now();
+        runPasses(passes);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (seconds >= minTrialSeconds || passes >= (int64_t(1) << 40)) {
+            break;
+        }
+        passes *= 2;
+    }
+
+    double ops = static_cast<double>(passes) * contacts;
+    double bestNs = -1.0;
+    PerfCounters::Sample bestCounts;
+    for (int trial = 0; trial < options.trials; trial++) {
+        PerfCounters::Sample before = counters.read();
+        auto begin = std::chrono::steady_clock::now();
+        runPasses(passes);
+        auto end = std::chrono::steady_clock::now();
+        PerfCounters::Sample after = counters.read();
+
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+        if (bestNs < 0.0 || ns < bestNs) {
+            bestNs = ns;
+            for (int i = 0; i < PerfCounters::EVENT_COUNT; i++) {
+                bestCounts.values[i] = after.values[i] - before.values[i];
+            }
+        }
+    }
+    result.nsPerOp = bestNs / ops;
+
+    // 字节数与频点数按各目标的实际访问范围取平均（不计时）
+    double bytes = 0.0;
+    for (int index = 0; index < contacts; index++) {
+        bytes += kernel.bytes(sonarId, index);
+    }
+    result.bytesPerOp = bytes / contacts;
+    result.binsPerOp = result.bytesPerOp / sizeof(float);
+
+    if (counters.available(PerfCounters::INSTRUCTIONS)) {
+        result.instructionsPerOp = bestCounts.values[PerfCounters::INSTRUCTIONS] / ops;
+    }
+    if (counters.available(PerfCounters::CYCLES)) {
+        result.cyclesPerOp = bestCounts.values[PerfCounters::CYCLES] / ops;
+    }
+    return result;
+}
+
+std::vector<KernelCase> buildKernelCases(DeviceModel& model, KernelInputs& inputs)
+{
+    std::vector<KernelCase> cases;
+
+    // 声纳频带的频点数
+    auto bandBytes = [&model](int sonarId) {
+        int startIndex = 0;
+        int endIndex = -1;
+        DeviceModelTestAccess::sonarBandIndexRange(model, sonarId, startIndex, endIndex);
+        return static_cast<double>(endIndex - startIndex + 1) * sizeof(float);
+    };
+
+    KernelCase spectrumSum;
+    spectrumSum.name = "calculateSpectrumSumByFreqRange";
+    spectrumSum.perSonar = true;
+    spectrumSum.pass = [&model, &inputs](int sonarId) {
+        double sum = 0.0;
+        for (const SpectrumBuffer& spectrum : inputs.spectra) {
+            sum += DeviceModelTestAccess::spectrumSumByFreqRange(model, spectrum, sonarId);
+        }
+        return sum;
+    };
+    spectrumSum.bytes = [bandBytes](int sonarId, int) {
+        return bandBytes(sonarId);
+    };
+    cases.push_back(spectrumSum);
+
+    // 中位数频率：总能量一遍，累积能量读到中位数频点为止
+    KernelCase median;
+    median.name = "calculateMedianFrequencyFromSpectrum";
+    median.perSonar = true;
+    median.pass = [&model, &inputs](int sonarId) {
+        double sum = 0.0;
+        for (const SpectrumBuffer& spectrum : inputs.spectra) {
+            sum += DeviceModelTestAccess::medianFrequencyFromSpectrum(model, spectrum, sonarId);
+        }
+        return sum;
+    };
+    median.bytes = [&model, &inputs, bandBytes](int sonarId, int index) {
+        int startIndex = 0;
+        int endIndex = -1;
+        DeviceModelTestAccess::sonarBandIndexRange(model, sonarId, startIndex, endIndex);
+        double medianKHz = DeviceModelTestAccess::medianFrequencyFromSpectrum(model, inputs.spectra[index], sonarId);
+        int medianIndex = DeviceModelTestAccess::spectrumIndexFromFrequency(
+            model, static_cast<int>(std::lround(medianKHz * 1000.0)));
+        return bandBytes(sonarId) + std::max(0, medianIndex - startIndex + 1) * sizeof(float);
+    };
+    cases.push_back(median);
+
+    KernelCase dynamicDI;
+    dynamicDI.name = "calculateDynamicDI";
+    dynamicDI.perSonar = true;
+    dynamicDI.pass = [&model, &inputs](int sonarId) {
+        double sum = 0.0;
+        for (double frequencyKHz : inputs.frequenciesKHz) {
+            sum += DeviceModelTestAccess::dynamicDI(model, sonarId, frequencyKHz);
+        }
+        return sum;
+    };
+    dynamicDI.bytes = [](int, int) { return 0.0; };
+    cases.push_back(dynamicDI);
+
+    KernelCase inRange;
+    inRange.name = "isTargetInSonarRange";
+    inRange.perSonar = true;
+    inRange.pass = [&model, &inputs](int sonarId) {
+        int inside = 0;
+        for (size_t index = 0; index < inputs.bearings.size(); index++) {
+            if (DeviceModelTestAccess::targetInSonarRange(model, sonarId, inputs.bearings[index],
+                                                          inputs.distances[index], inputs.ownShipHeading)) {
+                inside++;
+            }
+        }
+        return static_cast<double>(inside);
+    };
+    inRange.bytes = [](int, int) { return 0.0; };
+    cases.push_back(inRange);
+
+    KernelCase spectrumIndex;
+    spectrumIndex.name = "getSpectrumIndexFromFrequency";
+    spectrumIndex.perSonar = false;
+    spectrumIndex.pass = [&model, &inputs](int) {
+        int64_t sum = 0;
+        for (int frequencyHz : inputs.frequenciesHz) {
+            sum += DeviceModelTestAccess::spectrumIndexFromFrequency(model, frequencyHz);
+        }
+        return static_cast<double>(sum);
+    };
+    spectrumIndex.bytes = [](int, int) { return 0.0; };
+    cases.push_back(spectrumIndex);
+
+    // 模拟频谱：整条频谱写出（含清零）
+    KernelCase mockSpectrum;
+    mockSpectrum.name = "fillMockSpectrumData";
+    mockSpectrum.perSonar = false;
+    mockSpectrum.pass = [&model, &inputs](int) {
+        double sum = 0.0;
+        for (size_t index = 0; index < inputs.outputs.size(); index++) {
+            float* output = inputs.outputs[index].data();
+            DeviceModelTestAccess::fillMockSpectrumData(model, output, static_cast<int>(index));
+            sum += output[index % SPECTRUM_SIZE];
+        }
+        return sum;
+    };
+    mockSpectrum.bytes = [](int, int) { return static_cast<double>(SPECTRUM_SIZE * sizeof(float)); };
+    cases.push_back(mockSpectrum);
+
+    return cases;
+}
+
+void printResult(const KernelResult& result)
+{
+    std::cout << std::left << std::setw(38) << result.kernel << std::right
+              << std::setw(6) << (result.sonarId == NO_SONAR ? std::string("-") : std::to_string(result.sonarId))
+              << std::setw(9) << result.contacts
+              << std::fixed << std::setprecision(2)
+              << std::setw(12) << result.nsPerOp
+              << std::setw(11) << std::setprecision(0) << result.bytesPerOp
+              << std::setw(12) << std::setprecision(2);
+    if (result.instructionsPerOp >= 0.0) {
+        std::cout << result.instructionsPerOp;
+    } else {
+        std::cout << "-";
+    }
+    std::cout << std::setw(11);
+    if (result.instructionsPerOp >= 0.0 && result.binsPerOp > 0.0) {
+        std::cout << result.instructionsPerOp / result.binsPerOp;
+    } else {
+        std::cout << "-";
+    }
+    std::cout << std::setw(9);
+    if (result.instructionsPerOp > 0.0 && result.cyclesPerOp > 0.0) {
+        std::cout << result.instructionsPerOp / result.cyclesPerOp;
+    } else {
+        std::cout << "-";
+    }
+    std::cout << "\n";
+}
+
+void writeJson(std::ostream& out, const std::vector<KernelResult>& results, const PerfCounters& counters)
+{
+    out << std::fixed << std::setprecision(3)
+        << "{\n"
+        << "  \"counters\": {";
+    for (int i = 0; i < PerfCounters::EVENT_COUNT; i++) {
+        PerfCounters::Event event = static_cast<PerfCounters::Event>(i);
+        out << (i > 0 ? ", " : "") << "\"" << PerfCounters::eventName(event) << "\": "
+            << (counters.available(event) ? "true" : "false");
+    }
+    out << "},\n"
+        << "  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const KernelResult& result = results[i];
+        out << "    {\"kernel\": \"" << result.kernel << "\""
+            << ", \"sonarId\": " << result.sonarId
+            << ", \"contacts\": " << result.contacts
+            << ", \"nsPerOp\": " << result.nsPerOp
+            << ", \"bytesPerOp\": " << result.bytesPerOp
+            << ", \"binsPerOp\": " << result.binsPerOp;
+        if (result.instructionsPerOp >= 0.0) {
+            out << ", \"instructionsPerOp\": " << result.instructionsPerOp;
+            if (result.binsPerOp > 0.0) {
+                out << ", \"instructionsPerBin\": " << result.instructionsPerOp / result.binsPerOp;
+            }
+        }
+        if (result.cyclesPerOp >= 0.0) {
+            out << ", \"cyclesPerOp\": " << result.cyclesPerOp;
+        }
+        out << "}" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n"
+        << "}\n";
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    KernelBenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // 测量期间关闭全部日志：被测函数中的日志宏只剩级别判断
+    Logger& logger = Logger::getInstance();
+    logger.initialize("", false);
+    logger.setLogLevel(LogLevel::OFF);
+
+    DeviceModel model;
+    PerfCounters counters;
+    if (!counters.anyAvailable()) {
+        std::cerr << "Hardware counters unavailable, instruction counts omitted" << std::endl;
+    }
+
+    std::cout << std::left << std::setw(38) << "kernel" << std::right
+              << std::setw(6) << "sonar"
+              << std::setw(9) << "contacts"
+              << std::setw(12) << "ns/op"
+              << std::setw(11) << "bytes/op"
+              << std::setw(12) << "instr/op"
+              << std::setw(11) << "instr/bin"
+              << std::setw(9) << "IPC" << "\n";
+
+    std::vector<KernelResult> results;
+    KernelInputs inputs;
+    for (int contacts : options.contactCounts) {
+        buildInputs(contacts, options.seed, inputs);
+        std::vector<KernelCase> cases = buildKernelCases(model, inputs);
+
+        for (const KernelCase& kernel : cases) {
+            if (!options.kernels.empty() &&
+                std::find(options.kernels.begin(), options.kernels.end(), kernel.name) == options.kernels.end()) {
+                continue;
+            }
+
+            std::vector<int> sonarIds = kernel.perSonar ? options.sonarIds : std::vector<int>(1, NO_SONAR);
+            for (int sonarId : sonarIds) {
+                KernelResult result = measureKernel(kernel, sonarId, contacts, options, counters);
+                printResult(result);
+                results.push_back(result);
+            }
+        }
+        std::cout.flush();
+    }
+
+    if (!options.jsonFile.empty()) {
+        std::ofstream file(options.jsonFile.c_str());
+        if (!file) {
+            std::cerr << "Failed to open output file: " << options.jsonFile << std::endl;
+            return 2;
+        }
+        writeJson(file, results, counters);
+    }
+
+    // 防止累加结果被整体优化掉
+    return g_sink == 0.123456789 ? 3 : 0;
+}
@@ -0,0 +1,62 @@
+#include "ReplayAgent.h"
+
+#include <cstring>
+
+ReplayAgent::ReplayAgent()
+{
+    setDebugOutputEnabled(false);
+}
+
+void ReplayAgent::applySubscribedData(const ModelCapture::CaptureReader::Record& record,
+                                      const std::shared_ptr<const void>& payload)
+{
+    const ModelCapture::RecordHeader& header = *record.header;
+    std::string topic(header.topic, strnlen(header.topic, EventTypeLen));
+    ReplayKey key(topic, header.receiver, header.componentId);
+
+    if (header.codec == ModelCapture::CODEC_NONE || !payload) {
+        m_replayData.erase(key);
+        return;
+    }
+
+    ReplayData& entry = m_replayData[key];
+    entry.simData.time = header.time;
+    entry.simData.sender = header.sender;
+    entry.simData.receiver = header.receiver;
+    entry.simData.componentId = header.componentId;
+    entry.simData.dataFormat = static_cast<CDataFormat>(header.dataFormat);
+    memcpy(entry.simData.topic, header.topic, EventTypeLen);
+    entry.simData.data = payload.get();
+    entry.simData.length = header.length;
+    entry.payload = payload;
+
+    // 组件可借用订阅数据载荷（与代理存储条目的行为一致）
+    lendMessagePayload(payload);
+}
+
+CSimData* ReplayAgent::getSubscribeSimData(const char* topic, int64 platformId)
+{
+    return getSubscribeSimData(topic, platformId, -1);
+}
+
+CSimData* ReplayAgent::getSubscribeSimData(const char* topic, int64 platformId, int64 componentId)
+{
+    if (!topic) {
+        return nullptr;
+    }
+
+    auto it = m_replayData.find(ReplayKey(std::string(topic, strnlen(topic, EventTypeLen)), platformId, componentId));
+    return it != m_replayData.end() ? &it->second.simData : nullptr;
+}
+
+void ReplayAgent::getSubscribeSimDataBatch(const char* const* topics, const int64* platformIds,
+                                           CSimData** results, int32 count)
+{
+    if (!topics || !platformIds || !results) {
+        return;
+    }
+
+    for (int32 i = 0; i < count; i++) {
+        results[i] = getSubscribeSimData(topics[i], platformIds[i], -1);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef REPLAYAGENT_H
+#define REPLAYAGENT_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include "DeviceModelAgent.h"
+#include "ModelCapture.h"
+
+/**
+ * 回放代理：订阅数据取自捕获文件，其余行为（消息出口、订阅登记、载荷借用）与DeviceModelAgent相同
+ * 捕获中的订阅数据记录按顺序应用，组件取数据时得到捕获时取到的同一份内容；
+ * 空载荷记录表示捕获时取不到，回放时同样返回空
+ */
+class ReplayAgent : public DeviceModelAgent
+{
+public:
+    ReplayAgent();
+
+    /**
+     * 应用一条订阅数据记录
+     * @param record 记录（kind须为RECORD_SUBSCRIBED_DATA）
+     * @param payload 解码后的载荷（空表示取不到）
+     */
+    void applySubscribedData(const ModelCapture::CaptureReader::Record& record,
+                             const std::shared_ptr<const void>& payload);
+
+    /**
+     * 丢弃全部订阅数据（重新回放前调用）
+     */
+    void clearReplayData() { m_replayData.clear(); }
+
+    CSimData* getSubscribeSimData(const char* topic, int64 platformId) override;
+    CSimData* getSubscribeSimData(const char* topic, int64 platformId, int64 componentId) override;
+    void getSubscribeSimDataBatch(const char* const* topics, const int64* platformIds,
+                                  CSimData** results, int32 count) override;
+
+private:
+    /**
+     * 回放的订阅数据：数据头 + 载荷（载荷同时登记为可借用）
+     */
+    struct ReplayData {
+        CSimData simData;
+        std::shared_ptr<const void> payload;
+    };
+
+    typedef std::tuple<std::string, int64, int64> ReplayKey;   // 主题、平台ID、组件ID
+
+    std::map<ReplayKey, ReplayData> m_replayData;
+};
+
+#endif // REPLAYAGENT_H
@@ -0,0 +1,336 @@
+#include "ReplayAgent.h"
+#include "ModelCapture.h"
+#include "DeviceTestInOut.h"
+#include "devicemodel.h"
+#include "common/DMLogger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/**
+ * 命令行参数
+ */
+struct ReplayOptions
+{
+    std::vector<std::string> files;     // 捕获文件（各自独立回放）
+    double speed;                       // 回放速度倍率，0表示尽快
+    int repeat;                         // 每个文件回放次数（结果摘要须一致）
+    bool pipelined;                     // 组件流水线步进（须与捕获时一致）
+    bool boundPruning;                  // 组件声纳方程上界剪枝（须与捕获时一致）
+    std::string logFile;                // 为空时不写日志文件
+
+    ReplayOptions()
+        : speed(0.0)
+        , repeat(1)
+        , pipelined(false)
+        , boundPruning(true)
+    {
+    }
+};
+
+/**
+ * 一次回放的结果
+ */
+struct ReplayResult
+{
+    uint64 steps;                       // 回放步数
+    uint64 messages;                    // 投递的消息数
+    uint64 skippedMessages;             // 载荷不支持回放而跳过的消息数
+    uint64 subscribedData;              // 应用的订阅数据记录数
+    uint64 messagesSent;                // 组件发送的消息数
+    uint64 digest;                      // 组件输出摘要
+    double wallSeconds;                 // 总耗时（秒）
+    std::vector<double> stepUs;         // 每步耗时：投递 + prepareStep + commitStep
+
+    ReplayResult()
+        : steps(0), messages(0), skippedMessages(0), subscribedData(0), messagesSent(0)
+        , digest(0), wallSeconds(0.0)
+    {
+    }
+};
+
+void printUsage(const char* program)
+{
+    std::cout << "Usage: " << program << " [options] FILE...\n"
+              << "  FILE            捕获文件（DeviceBenchmark/DeviceHeadlessEngine --capture生成）\n"
+              << "  --speed X       按仿真时间的X倍速回放（默认尽快回放）\n"
+              << "  --realtime      按仿真时间实时回放（等同--speed 1）\n"
+              << "  --repeat N      每个文件回放N次并校验输出摘要一致（默认1）\n"
+              << "  --pipeline      组件流水线步进（须与捕获时一致）\n"
+              << "  --no-prune      关闭组件的声纳方程上界剪枝（须与捕获时一致）\n"
+              << "  --log FILE      写模型日志到文件（INFO级别）\n";
+}
+
+bool parseOptions(int argc, char* argv[], ReplayOptions& options)
+{
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg == "--speed" && hasValue) {
+            options.speed = atof(argv[++i]);
+        } else if (arg == "--realtime") {
+            options.speed = 1.0;
+        } else if (arg == "--repeat" && hasValue) {
+            options.repeat = atoi(argv[++i]);
+        } else if (arg == "--pipeline") {
+            options.pipelined = true;
+        } else if (arg == "--no-prune") {
+            options.boundPruning = false;
+        } else if (arg == "--log" && hasValue) {
+            options.logFile = argv[++i];
+        } else if (arg.compare(0, 2, "--") == 0) {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        } else {
+            options.files.push_back(arg);
+        }
+    }
+    return !options.files.empty() && options.repeat > 0 && options.speed >= 0.0;
+}
+
+// FNV-1a（64位）
+const uint64 FNV_OFFSET = 14695981039346656037ULL;
+const uint64 FNV_PRIME = 1099511628211ULL;
+
+void hashBytes(uint64& hash, const void* data, size_t size)
+{
+    const uint8* bytes = static_cast<const uint8*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+}
+
+/**
+ * 把组件发送的消息计入摘要：主题、时间与载荷内容（已知结构逐字段，其余只计长度）
+ */
+void hashMessage(uint64& hash, const CSimMessage& simMessage)
+{
+    hashBytes(hash, simMessage.topic, strnlen(simMessage.topic, EventTypeLen));
+    hashBytes(hash, &simMessage.time, sizeof(simMessage.time));
+    if (!simMessage.data) {
+        return;
+    }
+
+    if (strncmp(simMessage.topic, MSG_PassiveSonarResult_Topic, EventTypeLen) == 0) {
+        const CMsg_PassiveSonarResultStruct* result = static_cast<const CMsg_PassiveSonarResultStruct*>(simMessage.data);
+        hashBytes(hash, &result->sonarID, sizeof(result->sonarID));
+        hashBytes(hash, &result->detectionNumber, sizeof(result->detectionNumber));
+        for (const C_PassiveSonarDetectionResult& detection : result->PassiveSonarDetectionResult) {
+            hashBytes(hash, &detection, sizeof(detection));
+        }
+        for (const C_PassiveSonarTrackingResult& tracking : result->PassiveSonarTrackingResult) {
+            hashBytes(hash, &tracking, sizeof(tracking));
+        }
+    } else if (strncmp(simMessage.topic, Msg_SonarWorkState, EventTypeLen) == 0) {
+        const CMsg_SonarWorkState* state = static_cast<const CMsg_SonarWorkState*>(simMessage.data);
+        hashBytes(hash, &state->platformId, sizeof(state->platformId));
+        hashBytes(hash, &state->maxDetectRange, sizeof(state->maxDetectRange));
+        hashBytes(hash, &state->sonarOnOff, sizeof(state->sonarOnOff));
+    } else {
+        hashBytes(hash, &simMessage.length, sizeof(simMessage.length));
+    }
+}
+
+double elapsedMicroseconds(const std::chrono::steady_clock::time_point& begin,
+                           const std::chrono::steady_clock::time_point& end)
+{
+    return std::chrono::duration<double, std::micro>(end - begin).count();
+}
+
+double percentile(const std::vector<double>& sorted, double fraction)
+{
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(fraction * sorted.size() + 0.999999);
+    rank = std::max<size_t>(1, std::min(rank, sorted.size()));
+    return sorted[rank - 1];
+}
+
+/**
+ * 回放一个捕获文件：消息直接交给组件（捕获中已是过滤后的载荷），
+ * 订阅数据记录交给回放代理，步进记录处调用prepareStep与commitStep
+ */
+bool replayOnce(ModelCapture::CaptureReader& reader, const ReplayOptions& options, ReplayResult& result)
+{
+    const ModelCapture::FileHeader& fileHeader = reader.header();
+    result = ReplayResult();
+    result.digest = FNV_OFFSET;
+
+    ReplayAgent agent;
+    std::string name = "ReplayPlatform_" + std::to_string(fileHeader.platformId);
+    agent.setPlatformEntity(fileHeader.platformId, name.c_str(), fileHeader.campId);
+    agent.setStep(fileHeader.stepMs);
+    agent.setMessageSink([&result](CSimMessage* simMessage) {
+        result.messagesSent++;
+        hashMessage(result.digest, *simMessage);
+    });
+
+    std::unique_ptr<DeviceModel> model(new DeviceModel());
+    if (!model->init(&agent, agent.getComponentAttribute())) {
+        std::cerr << "Failed to init device model" << std::endl;
+        return false;
+    }
+    model->setStepPipelineEnabled(options.pipelined);
+    model->setBoundPruningEnabled(options.boundPruning);
+    model->start();
+    CSimTwoPhaseStep* twoPhaseStep = querySimTwoPhaseStep(model.get());
+
+    reader.rewind();
+    ModelCapture::CaptureReader::Record record;
+    auto runBegin = std::chrono::steady_clock::now();
+    auto stepBegin = runBegin;
+    bool stepOpen = false;
+    int64 firstStepTime = -1;
+
+    while (reader.next(record)) {
+        const ModelCapture::RecordHeader& header = *record.header;
+        if (!stepOpen) {
+            stepBegin = std::chrono::steady_clock::now();
+            stepOpen = true;
+        }
+
+        if (header.kind == ModelCapture::RECORD_MESSAGE) {
+            if (header.codec == ModelCapture::CODEC_UNSUPPORTED) {
+                result.skippedMessages++;
+                continue;
+            }
+            std::shared_ptr<const void> payload = reader.decodePayload(record);
+            if (header.codec != ModelCapture::CODEC_NONE && !payload) {
+                result.skippedMessages++;
+                continue;
+            }
+
+            CSimMessage simMessage;
+            simMessage.time = header.time;
+            simMessage.sender = header.sender;
+            simMessage.senderComponentId = header.componentId;
+            simMessage.receiver = header.receiver;
+            simMessage.dataFormat = static_cast<CDataFormat>(header.dataFormat);
+            memcpy(simMessage.topic, header.topic, EventTypeLen);
+            simMessage.data = payload.get();
+            simMessage.length = header.length;
+            if (payload) {
+                agent.lendMessagePayload(payload);
+            }
+            model->onMessage(&simMessage);
+            result.messages++;
+        } else if (header.kind == ModelCapture::RECORD_SUBSCRIBED_DATA) {
+            agent.applySubscribedData(record, reader.decodePayload(record));
+            result.subscribedData++;
+        } else if (header.kind == ModelCapture::RECORD_STEP) {
+            // 限速回放：按仿真时间推算本步的墙钟时刻
+            if (firstStepTime < 0) {
+                firstStepTime = header.time;
+            }
+            if (options.speed > 0.0) {
+                double offsetSeconds = (header.time - firstStepTime) / 1000.0 / options.speed;
+                auto sleepBegin = std::chrono::steady_clock::now();
+                std::this_thread::sleep_until(runBegin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(offsetSeconds)));
+                stepBegin += std::chrono::steady_clock::now() - sleepBegin;     // 等待时间不计入步进耗时
+            }
+
+            agent.setSimulationTime(header.time);
+            if (twoPhaseStep) {
+                twoPhaseStep->prepareStep(header.time, static_cast<int32>(header.length));
+                twoPhaseStep->commitStep();
+            } else {
+                model->step(header.time, static_cast<int32>(header.length));
+            }
+            auto stepEnd = std::chrono::steady_clock::now();
+            result.stepUs.push_back(elapsedMicroseconds(stepBegin, stepEnd));
+            result.steps++;
+            stepOpen = false;
+        }
+    }
+    result.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - runBegin).count();
+
+    model->stop();
+    model->destroy();
+    model.reset();
+    agent.clearReplayData();
+    return true;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    ReplayOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // 模型构造时若日志未初始化会自动创建日志文件，这里先按参数初始化
+    Logger& logger = Logger::getInstance();
+    logger.initialize(options.logFile, false);
+    logger.setLogLevel(options.logFile.empty() ? LogLevel::WARN : LogLevel::INFO);
+
+    bool consistent = true;
+    for (const std::string& file : options.files) {
+        ModelCapture::CaptureReader reader;
+        if (!reader.open(file)) {
+            std::cerr << "Failed to open capture file: " << file << std::endl;
+            return 2;
+        }
+
+        const ModelCapture::FileHeader& fileHeader = reader.header();
+        std::cout << "file=" << file
+                  << " platform=" << fileHeader.platformId
+                  << " stepMs=" << fileHeader.stepMs
+                  << " records=" << fileHeader.recordCount
+                  << " bytes=" << fileHeader.committedBytes << "\n";
+
+        uint64 firstDigest = 0;
+        for (int run = 0; run < options.repeat; run++) {
+            ReplayResult result;
+            if (!replayOnce(reader, options, result)) {
+                return 2;
+            }
+            if (run == 0) {
+                firstDigest = result.digest;
+            } else if (result.digest != firstDigest) {
+                consistent = false;
+            }
+
+            std::vector<double> sorted = result.stepUs;
+            std::sort(sorted.begin(), sorted.end());
+            std::cout << std::fixed << std::setprecision(3)
+                      << "  run " << run
+                      << " steps=" << result.steps
+                      << " messages=" << result.messages
+                      << " skipped=" << result.skippedMessages
+                      << " data=" << result.subscribedData
+                      << " sent=" << result.messagesSent
+                      << " wall=" << result.wallSeconds << "s"
+                      << " stepUs p50=" << percentile(sorted, 0.50)
+                      << " p99=" << percentile(sorted, 0.99)
+                      << " max=" << (sorted.empty() ? 0.0 : sorted.back())
+                      << " digest=" << std::hex << std::setw(16) << std::setfill('0') << result.digest
+                      << std::dec << std::setfill(' ')
+                      << (result.digest == firstDigest ? "" : " MISMATCH") << "\n";
+        }
+    }
+    std::cout.flush();
+
+    if (!consistent) {
+        std::cerr << "Replay output differs between runs" << std::endl;
+        return 3;
+    }
+    return 0;
+}
@@ -28,17 +28,31 @@ else {
 
 SOURCES += \
         src/DeviceModelAgent.cpp \
+        src/ModelCapture.cpp \
+        src/SubscribedDataStore.cpp \
         src/mainWithUi.cpp \
         src/mainwindow.cpp \
         ../../src/common/DMLogger.cpp \
+        ../../src/common/SpectrumSlabPool.cpp \
+        ../../src/common/TraceZone.cpp \
         ../../src/devicemodel.cpp \
+        ../../src/FlatSoundList.cpp \
         src/seachartwidget.cpp
 
 HEADERS += \
     src/DeviceModelAgent.h \
+    src/ModelCapture.h \
+    src/SubscribedDataStore.h \
     src/mainwindow.h \
     ../../src/common/DMLogger.h \
     ../../src/devicemodel.h \
+    ../../src/FlatSoundList.h \
+    ../../src/common/SpectrumBuffer.h \
+    ../../src/common/SpectrumSlabPool.h \
+    ../../src/common/MemoryAccount.h \
+    ../../src/common/LatencyHistogram.h \
+    ../../src/common/CounterRng.h \
+    ../../src/common/TraceZone.h \
     src/seachartwidget.h
 
 FORMS += src/mainwindow.ui  # 声明 UI 文件
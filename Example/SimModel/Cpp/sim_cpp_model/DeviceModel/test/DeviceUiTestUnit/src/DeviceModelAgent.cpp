@@ -1,16 +1,23 @@
 #include "DeviceModelAgent.h"
 #include "DeviceTestInOut.h"
+#include "FlatSoundList.h"
+#include "CSimComponentBase.h"
+#include "ModelCapture.h"
 
 #include <iostream>
 #include <iomanip>
 #include <cstring>
 #include <sstream>
 #include <algorithm>
-#include <QDateTime>
+#include <chrono>
 #include "../../DeviceModel/src/common/DMLogger.h"
+#include "../../DeviceModel/src/common/TraceZone.h"
 
 DeviceModelAgent::DeviceModelAgent()
-    : m_enableDebugOutput(true)
+    : m_simTime(-1)
+    , m_step(1000)
+    , m_capture(nullptr)
+    , m_enableDebugOutput(true)
     , m_lastCleanupTime(0)
 {
     // 初始化平台实体
@@ -34,13 +41,15 @@ DeviceModelAgent::~DeviceModelAgent()
     debugLog("DeviceModelAgent destructor called");
 
     // 清理所有数据 - 智能指针会自动释放内存
-    m_subscribedDataMap.clear();
+    m_subscribedData.clear();
 
     debugLog("DeviceModelAgent destroyed, all data cleaned up");
 }
 
 void DeviceModelAgent::publishSimData(CSimData* simData)
 {
+    TRACE_ZONE_ID("agent.publishSimData", m_platform.id);
+
     if (!simData) {
         debugLog("Error: publishSimData called with null simData");
         return;
@@ -57,9 +66,22 @@ void DeviceModelAgent::publishSimData(CSimData* simData)
                     " passive=" + std::to_string(state->passiveWorkingState) + " scouting=" + std::to_string(state->scoutingWorkingState));
         }
     }
+    else if (topic == Data_DevicePerfStats_Topic) {
+        const CData_DevicePerfStats* stats = static_cast<const CData_DevicePerfStats*>(simData->data);
+        if (stats && simData->length >= sizeof(CData_DevicePerfStats)) {
+            // 阶段3为声纳方程
+            debugLog("Perf stats published: steps=" + std::to_string(stats->steps) +
+                    " contacts=" + std::to_string(stats->activeContacts) +
+                    " equation p99=" + std::to_string(stats->phases[3].p99Ns) + "ns");
+        }
+    }
     else {
         debugLog("Published data with unknown topic: " + topic);
     }
+
+    if (m_dataSink) {
+        m_dataSink(simData);
+    }
 }
 
 CSimData* DeviceModelAgent::getSubscribeSimData(const char* topic, int64 platformId)
@@ -69,48 +91,229 @@ CSimData* DeviceModelAgent::getSubscribeSimData(const char* topic, int64 platfor
         return nullptr;
     }
 
-    std::string key = generateDataKey(topic, platformId);
+    // 组合键查找，同时更新访问统计（不分配内存）
+    CSimData* result = m_subscribedData.get(topic, platformId, -1, nowTime());
+    if (m_capture) {
+        m_capture->appendSubscribedData(topic, platformId, -1, result);
+    }
+
+    if (m_enableDebugOutput) {
+        std::string key = generateDataKey(topic, platformId);
+        if (result) {
+            debugLog("Found data for key: " + key + ", timestamp: " + std::to_string(result->time));
+        } else {
+            debugLog("No data found for key: " + key);
+        }
+    }
+    return result;
+}
+
+CSimData* DeviceModelAgent::getSubscribeSimData(const char* topic, int64 platformId, int64 componentId)
+{
+    if (!topic) {
+        debugLog("Error: topic is null in getSubscribeSimData (with componentId)");
+        return nullptr;
+    }
 
-    // 更新访问统计
-    m_dataAccessCount[key]++;
-    m_lastAccessTime[key] = QDateTime::currentMSecsSinceEpoch();
+    CSimData* result = m_subscribedData.get(topic, platformId, componentId, nowTime());
+    if (m_capture) {
+        m_capture->appendSubscribedData(topic, platformId, componentId, result);
+    }
 
     if (m_enableDebugOutput) {
-        debugLog("Looking for data with key: " + key);
+        std::string key = generateDataKey(topic, platformId, componentId);
+        debugLog((result ? "Found data for key with componentId: " : "No data found for key with componentId: ") + key);
     }
+    return result;
+}
 
-    auto it = m_subscribedDataMap.find(key);
-    if (it != m_subscribedDataMap.end() && it->second) {
-        CSimData* result = it->second.get();
-        debugLog("Found data for key: " + key + ", timestamp: " + std::to_string(result->time));
-        return result;
+void DeviceModelAgent::getSubscribeSimDataBatch(const char* const* topics, const int64* platformIds,
+                                                CSimData** results, int32 count)
+{
+    TRACE_ZONE_ID("agent.getSubscribeSimDataBatch", m_platform.id);
+
+    if (!topics || !platformIds || !results) {
+        debugLog("Error: null parameter in getSubscribeSimDataBatch");
+        return;
     }
 
-    debugLog("No data found for key: " + key);
-    return nullptr;
+    int64 now = nowTime();
+    int found = 0;
+    for (int32 i = 0; i < count; i++) {
+        results[i] = topics[i] ? m_subscribedData.get(topics[i], platformIds[i], -1, now) : nullptr;
+        if (results[i]) {
+            found++;
+        }
+        if (m_capture) {
+            m_capture->appendSubscribedData(topics[i], platformIds[i], -1, results[i]);
+        }
+    }
+
+    if (m_enableDebugOutput) {
+        debugLog("Batch lookup: " + std::to_string(found) + "/" + std::to_string(count) + " found");
+    }
 }
 
-CSimData* DeviceModelAgent::getSubscribeSimData(const char* topic, int64 platformId, int64 componentId)
+void DeviceModelAgent::sendMessages(CSimMessage* const* simMessages, int32 count)
 {
-    if (!topic) {
-        debugLog("Error: topic is null in getSubscribeSimData (with componentId)");
+    if (!simMessages) {
+        debugLog("Error: sendMessages called with null array");
+        return;
+    }
+
+    for (int32 i = 0; i < count; i++) {
+        sendMessage(simMessages[i]);
+    }
+}
+
+void DeviceModelAgent::publishSimDataBatch(CSimData* const* simDatas, int32 count)
+{
+    if (!simDatas) {
+        debugLog("Error: publishSimDataBatch called with null array");
+        return;
+    }
+
+    for (int32 i = 0; i < count; i++) {
+        publishSimData(simDatas[i]);
+    }
+}
+
+const CSubscribeFilter* DeviceModelAgent::findMessageFilter(const char* topic) const
+{
+    auto it = m_messageFilters.find(TopicHash::topicHashRuntime(topic, EventTypeLen));
+    if (it == m_messageFilters.end() || strncmp(it->second.topic.c_str(), topic, EventTypeLen) != 0) {
         return nullptr;
     }
+    return &it->second.filter;
+}
 
-    std::string key = generateDataKey(topic, platformId, componentId);
+bool DeviceModelAgent::getOwnHeading(float& heading) const
+{
+    const SubscribedDataStore::DataPtr* motion = m_subscribedData.peek(Data_Motion, m_platform.id, -1);
+    if (!motion || !*motion || !(*motion)->data) {
+        return false;
+    }
+    heading = static_cast<float>(static_cast<const CData_Motion*>((*motion)->data)->rotation);
+    return true;
+}
 
-    // 更新访问统计
-    m_dataAccessCount[key]++;
-    m_lastAccessTime[key] = QDateTime::currentMSecsSinceEpoch();
+void DeviceModelAgent::deliverMessage(CSimComponentBase* component, CSimMessage* simMessage)
+{
+    TRACE_ZONE_ID("agent.deliverMessage", m_platform.id);
 
-    auto it = m_subscribedDataMap.find(key);
-    if (it != m_subscribedDataMap.end() && it->second) {
-        debugLog("Found data for key with componentId: " + key);
-        return it->second.get();
+    if (!component || !simMessage) {
+        debugLog("Error: deliverMessage called with null parameter");
+        return;
     }
 
-    debugLog("No data found for key with componentId: " + key);
-    return nullptr;
+    const CSubscribeFilter* filter = simMessage->data ? findMessageFilter(simMessage->topic) : nullptr;
+    if (!filter) {
+        dispatchMessage(component, simMessage);
+        return;
+    }
+
+    float heading = 0.0f;
+    bool headingKnown = getOwnHeading(heading);
+    size_t total = 0;
+    size_t accepted = 0;
+    CSimMessage filteredMessage = *simMessage;
+
+    if (strncmp(simMessage->topic, MSG_PropagatedContinuousSound, EventTypeLen) == 0) {
+        const CMsg_PropagatedContinuousSoundListStruct* soundList =
+            static_cast<const CMsg_PropagatedContinuousSoundListStruct*>(simMessage->data);
+
+        for (const auto& sound : soundList->propagatedContinuousList) {
+            total++;
+            if (filter->accept(sound.targetDistance, sound.arrivalSideAngle, heading, headingKnown, sound.platType)) {
+                accepted++;
+            }
+        }
+        if (accepted == total) {
+            dispatchMessage(component, simMessage);
+            return;
+        }
+
+        // 列表元素无处记录原始编号：通过过滤的目标转为扁平格式投递，记录的contactId记为其在原始列表中的编号，
+        // 使接收方的目标ID不随过滤结果变化
+        std::shared_ptr<FlatSoundListBuffer> flat = std::make_shared<FlatSoundListBuffer>(FLAT_SOUND_CONTINUOUS);
+        flat->setTime(simMessage->time);
+        flat->reserve(static_cast<uint32>(accepted));
+        uint32 contactId = 0;
+        for (const auto& sound : soundList->propagatedContinuousList) {
+            contactId++;
+            if (filter->accept(sound.targetDistance, sound.arrivalSideAngle, heading, headingKnown, sound.platType)) {
+                CFlatSoundRecord& record = flat->append();
+                record.arrivalSideAngle = sound.arrivalSideAngle;
+                record.arrivalPitchAngle = sound.arrivalPitchAngle;
+                record.targetDistance = sound.targetDistance;
+                record.platType = sound.platType;
+                record.contactId = contactId;
+                memcpy(record.spectrumData, sound.spectrumData, sizeof(record.spectrumData));
+            }
+        }
+        lendMessagePayload(std::shared_ptr<const void>(flat, flat->data()));
+        strncpy(filteredMessage.topic, MSG_PropagatedContinuousSound_Flat, EventTypeLen - 1);
+        filteredMessage.topic[EventTypeLen - 1] = '\0';
+        filteredMessage.data = const_cast<void*>(flat->data());
+        filteredMessage.length = flat->length();
+        dispatchMessage(component, &filteredMessage);
+    }
+    else if (strncmp(simMessage->topic, MSG_PropagatedContinuousSound_Flat, EventTypeLen) == 0) {
+        FlatSoundListView view;
+        if (!view.attach(simMessage->data, simMessage->length)) {
+            dispatchMessage(component, simMessage);   // 由组件报告格式错误
+            return;
+        }
+
+        total = view.count();
+        for (uint32 i = 0; i < view.count(); i++) {
+            const CFlatSoundRecord& record = view.record(i);
+            if (filter->accept(record.targetDistance, record.arrivalSideAngle, heading, headingKnown, record.platType)) {
+                accepted++;
+            }
+        }
+        if (accepted == total) {
+            dispatchMessage(component, simMessage);
+            return;
+        }
+
+        std::shared_ptr<FlatSoundListBuffer> filtered =
+            std::make_shared<FlatSoundListBuffer>(static_cast<FlatSoundKind>(view.kind()));
+        filtered->setTime(view.time());
+        filtered->reserve(static_cast<uint32>(accepted));
+        for (uint32 i = 0; i < view.count(); i++) {
+            const CFlatSoundRecord& record = view.record(i);
+            if (filter->accept(record.targetDistance, record.arrivalSideAngle, heading, headingKnown, record.platType)) {
+                CFlatSoundRecord& copy = filtered->append();
+                memcpy(&copy, &record, sizeof(CFlatSoundRecord));
+                if (copy.contactId == 0) {
+                    copy.contactId = i + 1;
+                }
+            }
+        }
+        lendMessagePayload(std::shared_ptr<const void>(filtered, filtered->data()));
+        filteredMessage.data = const_cast<void*>(filtered->data());
+        filteredMessage.length = filtered->length();
+        dispatchMessage(component, &filteredMessage);
+    }
+    else {
+        // 其他主题暂不支持按目标过滤
+        dispatchMessage(component, simMessage);
+        return;
+    }
+
+    if (m_enableDebugOutput) {
+        debugLog("Filtered " + std::string(simMessage->topic) + ": delivered " + std::to_string(accepted) +
+                 "/" + std::to_string(total) + " contacts");
+    }
+}
+
+void DeviceModelAgent::dispatchMessage(CSimComponentBase* component, CSimMessage* simMessage)
+{
+    if (m_capture) {
+        m_capture->appendMessage(*simMessage);
+    }
+    component->onMessage(simMessage);
 }
 
 void DeviceModelAgent::subscribeSimData(CSubscribeSimData* subscribeSimData)
@@ -124,6 +327,12 @@ void DeviceModelAgent::subscribeSimData(CSubscribeSimData* subscribeSimData)
              " for platform: " + std::to_string(subscribeSimData->platformId));
 }
 
+void DeviceModelAgent::subscribeSimDataFiltered(CSubscribeSimData* simDataSubscription, const CSubscribeFilter* filter)
+{
+    (void)filter;
+    subscribeSimData(simDataSubscription);
+}
+
 void DeviceModelAgent::subscribeCampSimData(CSubscribeSimData* subscribeSimData)
 {
     if (!subscribeSimData) {
@@ -157,11 +366,26 @@ void DeviceModelAgent::unsubscribCampSimData(CSubscribeSimData* subscribeSimData
 
 void DeviceModelAgent::sendMessage(CSimMessage* simMessage)
 {
+    TRACE_ZONE_ID("agent.sendMessage", m_platform.id);
+
     if (!simMessage) {
         debugLog("Error: sendMessage called with null simMessage");
         return;
     }
 
+    // 调试输出关闭时不拼接日志字符串，稳态步进的发送路径不分配内存
+    if (m_enableDebugOutput) {
+        logSentMessage(simMessage);
+    }
+
+    // 交给宿主路由
+    if (m_messageSink) {
+        m_messageSink(simMessage);
+    }
+}
+
+void DeviceModelAgent::logSentMessage(const CSimMessage* simMessage) const
+{
     std::string topic = simMessage->topic;
 
     if (topic == MSG_PassiveSonarResult_Topic) {
@@ -228,9 +452,36 @@ void DeviceModelAgent::subscribeMessage(const char* topic)
         return;
     }
 
+    m_subscribedTopics[TopicHash::topicHashRuntime(topic, EventTypeLen)] = topic;
+    if (m_subscriptionSink) {
+        m_subscriptionSink(topic, true);
+    }
     debugLog("Subscribed to message topic: " + std::string(topic));
 }
 
+void DeviceModelAgent::subscribeMessageFiltered(const char* topic, const CSubscribeFilter* filter)
+{
+    if (!topic) {
+        debugLog("Error: subscribeMessageFiltered called with null topic");
+        return;
+    }
+
+    subscribeMessage(topic);
+
+    uint32_t topicHash = TopicHash::topicHashRuntime(topic, EventTypeLen);
+    if (!filter) {
+        m_messageFilters.erase(topicHash);
+        debugLog("Message filter removed: " + std::string(topic));
+        return;
+    }
+
+    MessageFilterEntry& entry = m_messageFilters[topicHash];
+    entry.topic = topic;
+    entry.filter = *filter;
+    debugLog("Message filter set: " + entry.topic + ", maxRange=" + std::to_string(filter->maxRange) +
+             ", sectors=" + std::to_string(filter->sectorCount) + ", platTypes=" + std::to_string(filter->platTypeCount));
+}
+
 void DeviceModelAgent::unsubscribeMessage(const char* topic)
 {
     if (!topic) {
@@ -238,9 +489,24 @@ void DeviceModelAgent::unsubscribeMessage(const char* topic)
         return;
     }
 
+    m_subscribedTopics.erase(TopicHash::topicHashRuntime(topic, EventTypeLen));
+    m_messageFilters.erase(TopicHash::topicHashRuntime(topic, EventTypeLen));
+    if (m_subscriptionSink) {
+        m_subscriptionSink(topic, false);
+    }
     debugLog("Unsubscribed from message topic: " + std::string(topic));
 }
 
+bool DeviceModelAgent::isMessageSubscribed(const char* topic) const
+{
+    if (!topic) {
+        return false;
+    }
+
+    auto it = m_subscribedTopics.find(TopicHash::topicHashRuntime(topic, EventTypeLen));
+    return it != m_subscribedTopics.end() && strncmp(it->second.c_str(), topic, EventTypeLen) == 0;
+}
+
 void DeviceModelAgent::publishCriticalEvent(CCriticalEvent* criticalEvent)
 {
     if (!criticalEvent) {
@@ -251,6 +517,24 @@ void DeviceModelAgent::publishCriticalEvent(CCriticalEvent* criticalEvent)
     debugLog("Critical event published: " + std::string(criticalEvent->type));
 }
 
+void DeviceModelAgent::setPlatformEntity(int64 platformId, const char* name, int32 campId)
+{
+    m_platform.id = platformId;
+    if (name) {
+        strncpy(m_platform.name, name, sizeof(m_platform.name) - 1);
+        m_platform.name[sizeof(m_platform.name) - 1] = '\0';
+    }
+    m_platform.campId = campId;
+
+    debugLog("Platform entity set: id=" + std::to_string(platformId) + " camp=" + std::to_string(campId));
+}
+
+int64 DeviceModelAgent::nowTime() const
+{
+    return m_simTime >= 0 ? m_simTime : std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
 CSimPlatformEntity* DeviceModelAgent::getPlatformEntity()
 {
     return &m_platform;
@@ -281,21 +565,24 @@ std::vector<CSimPlatformEntity*> DeviceModelAgent::getPlatformEntiysByCampId(int
 
 int64 DeviceModelAgent::getComponentElapseTime()
 {
-    return QDateTime::currentMSecsSinceEpoch();
+    return nowTime();
 }
 
 int64 DeviceModelAgent::getEngineElapseTime()
 {
-    return QDateTime::currentMSecsSinceEpoch();
+    return nowTime();
 }
 
 int32 DeviceModelAgent::getStep()
 {
-    return 1000;  // 默认步长1000ms
+    return m_step;  // 默认步长1000ms
 }
 
 void DeviceModelAgent::setStep(int32 step)
 {
+    if (step > 0) {
+        m_step = step;
+    }
     debugLog("Step size set to: " + std::to_string(step) + "ms");
 }
 
@@ -315,6 +602,49 @@ CSimIntegrationLogger* DeviceModelAgent::getLogger()
     return nullptr;
 }
 
+std::shared_ptr<const void> DeviceModelAgent::retainPayload(const void* data)
+{
+    if (!data) {
+        return std::shared_ptr<const void>();
+    }
+
+    // 以消息形式登记的载荷
+    auto lentIt = m_lentPayloads.find(data);
+    if (lentIt != m_lentPayloads.end()) {
+        std::shared_ptr<const void> payload = lentIt->second.lock();
+        if (!payload) {
+            m_lentPayloads.erase(lentIt);
+        }
+        return payload;
+    }
+
+    // 订阅数据：按载荷索引直接定位条目（不扫描存储），与条目共享引用计数，条目被替换后载荷仍保留到句柄释放
+    const SubscribedDataStore::DataPtr* entry = m_subscribedData.findByPayload(data);
+    if (entry && *entry) {
+        return std::shared_ptr<const void>(*entry, (*entry)->data);
+    }
+
+    return std::shared_ptr<const void>();
+}
+
+void DeviceModelAgent::lendMessagePayload(const std::shared_ptr<const void>& payload)
+{
+    if (!payload) {
+        return;
+    }
+
+    // 顺带清理已失效的登记
+    for (auto it = m_lentPayloads.begin(); it != m_lentPayloads.end();) {
+        if (it->second.expired()) {
+            it = m_lentPayloads.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    m_lentPayloads[payload.get()] = payload;
+}
+
 
 
 void DeviceModelAgent::addSubscribedData(const char* topic, int64 platformId, CSimData* data)
@@ -357,32 +687,27 @@ void DeviceModelAgent::addSubscribedData(const char* topic, int64 platformId, in
     try {
         std::string key = generateDataKey(topic, platformId, componentId);
 
-        // 删除旧数据（如果存在）
-        auto it = m_subscribedDataMap.find(key);
-        if (it != m_subscribedDataMap.end()) {
-            debugLog("Replacing existing data for key: " + key);
-        }
-
         // 创建带自定义删除器的shared_ptr
-        auto customDeleter = [this, topicStr](CSimData* simData) {
+        // 借用句柄可能晚于代理释放，删除器不捕获this
+        auto customDeleter = [topicStr](CSimData* simData) {
             if (simData) {
                 try {
                     if (simData->data) {
-                        safeDeleteDataContent(topicStr, simData->data);
+                        deleteDataContent(topicStr, simData->data);
                     }
                     delete simData;
                 } catch (...) {
-                    debugLog("Exception in custom deleter for topic: " + topicStr);
+                    LOG_WARN("Exception in custom deleter for topic: " + topicStr);
                     delete simData; // 确保simData被删除
                 }
             }
         };
 
-        // 存储新数据
-        m_subscribedDataMap[key] = std::shared_ptr<CSimData>(data, customDeleter);
-
-        // 更新访问时间
-        m_lastAccessTime[key] = QDateTime::currentMSecsSinceEpoch();
+        // 存储新数据（替换时旧数据在最后一个句柄释放后删除）
+        int64 now = nowTime();
+        if (m_subscribedData.put(topic, platformId, componentId, std::shared_ptr<CSimData>(data, customDeleter), now)) {
+            debugLog("Replaced existing data for key: " + key);
+        }
 
         debugLog("Successfully stored data with key: " + key +
                 ", timestamp: " + std::to_string(data->time) +
@@ -391,7 +716,7 @@ void DeviceModelAgent::addSubscribedData(const char* topic, int64 platformId, in
                 (componentId != -1 ? (", componentId: " + std::to_string(componentId)) : ""));
 
         // 定期清理过期数据
-        int64 currentTime = QDateTime::currentMSecsSinceEpoch();
+        int64 currentTime = nowTime();
         if (currentTime - m_lastCleanupTime > CLEANUP_INTERVAL_MS) {
             clearExpiredData();
             m_lastCleanupTime = currentTime;
@@ -428,25 +753,36 @@ void DeviceModelAgent::safeDeleteSimData(CSimData* data)
     }
 }
 
+bool DeviceModelAgent::deleteDataContent(const std::string& topic, const void* dataPtr)
+{
+    if (topic == Data_PlatformSelfSound) {
+        delete static_cast<const CData_PlatformSelfSound*>(dataPtr);
+        return true;
+    }
+    else if (topic == MSG_PropagatedContinuousSound) {
+        delete static_cast<const CMsg_PropagatedContinuousSoundListStruct*>(dataPtr);
+        return true;
+    }
+    else if (topic == MSG_EnvironmentNoiseToSonar) {
+        delete static_cast<const CMsg_EnvironmentNoiseToSonarStruct*>(dataPtr);
+        return true;
+    }
+    else if (topic == Data_Motion) {
+        delete static_cast<const CData_Motion*>(dataPtr);
+        return true;
+    }
+    // 其他数据类型不删除内容
+    return false;
+}
+
 void DeviceModelAgent::safeDeleteDataContent(const std::string& topic, const void* dataPtr)
 {
     if (!dataPtr) return;
 
     try {
-        if (topic == Data_PlatformSelfSound) {
-            delete static_cast<const CData_PlatformSelfSound*>(dataPtr);
-            debugLog("Deleted CData_PlatformSelfSound content");
-        }
-        else if (topic == MSG_PropagatedContinuousSound) {
-            delete static_cast<const CMsg_PropagatedContinuousSoundListStruct*>(dataPtr);
-            debugLog("Deleted PropagatedContinuousSound content");
-        }
-        else if (topic == MSG_EnvironmentNoiseToSonar) {
-            delete static_cast<const CMsg_EnvironmentNoiseToSonarStruct*>(dataPtr);
-            debugLog("Deleted EnvironmentNoise content");
-        }
-        // 其他数据类型的清理
-        else {
+        if (deleteDataContent(topic, dataPtr)) {
+            debugLog("Deleted " + topic + " content");
+        } else {
             debugLog("Unknown data type for topic: " + topic + ", skipping content deletion");
         }
     } catch (const std::exception& e) {
@@ -458,25 +794,16 @@ void DeviceModelAgent::safeDeleteDataContent(const std::string& topic, const voi
 
 void DeviceModelAgent::clearExpiredData(int64 maxAge)
 {
-    int64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    int cleanupCount = 0;
-
-    auto it = m_subscribedDataMap.begin();
-    while (it != m_subscribedDataMap.end()) {
-        if (it->second && (currentTime - it->second->time) > maxAge) {
-            debugLog("Removing expired data for key: " + it->first +
-                    " (age: " + std::to_string(currentTime - it->second->time) + "ms)");
+    int64 currentTime = nowTime();
 
-            // 清理相关的访问统计
-            m_dataAccessCount.erase(it->first);
-            m_lastAccessTime.erase(it->first);
-
-            it = m_subscribedDataMap.erase(it);
-            cleanupCount++;
-        } else {
-            ++it;
-        }
-    }
+    // 过期堆只弹出已过期的条目，不扫描全部数据
+    int cleanupCount = m_subscribedData.expire(currentTime, maxAge,
+        [this, currentTime](const char* topic, int64 platformId, int64 componentId, int64 dataTime) {
+            if (m_enableDebugOutput) {
+                debugLog("Removing expired data for key: " + generateDataKey(topic, platformId, componentId) +
+                        " (age: " + std::to_string(currentTime - dataTime) + "ms)");
+            }
+        });
 
     if (cleanupCount > 0) {
         debugLog("Cleaned up " + std::to_string(cleanupCount) + " expired data entries");
@@ -486,33 +813,27 @@ void DeviceModelAgent::clearExpiredData(int64 maxAge)
 std::string DeviceModelAgent::getDataStatistics() const
 {
     std::stringstream ss;
-    ss << "=== DeviceModelAgent Data Statistics ===\n";
-    ss << "Total stored data entries: " << m_subscribedDataMap.size() << "\n";
-    ss << "Data access statistics:\n";
-
-    for (const auto& pair : m_dataAccessCount) {
-        ss << "  " << pair.first << ": accessed " << pair.second << " times";
+    int64 currentTime = nowTime();
 
-        auto timeIt = m_lastAccessTime.find(pair.first);
-        if (timeIt != m_lastAccessTime.end()) {
-            int64 currentTime = QDateTime::currentMSecsSinceEpoch();
-            int64 ageMs = currentTime - timeIt->second;
-            ss << ", last access " << ageMs << "ms ago";
-        }
-        ss << "\n";
-    }
+    ss << "=== DeviceModelAgent Data Statistics ===\n";
+    ss << "Total stored data entries: " << m_subscribedData.size() << "\n";
+    ss << "Data entries (access statistics):\n";
 
-    ss << "Current data entries:\n";
-    for (const auto& pair : m_subscribedDataMap) {
-        if (pair.second) {
-            int64 currentTime = QDateTime::currentMSecsSinceEpoch();
-            int64 dataAge = currentTime - pair.second->time;
-            ss << "  " << pair.first << ": timestamp=" << pair.second->time
-               << ", age=" << dataAge << "ms\n";
+    m_subscribedData.forEach([this, &ss, currentTime](const char* topic, int64 platformId, int64 componentId,
+                                                      const SubscribedDataStore::DataPtr& data,
+                                                      const SubscribedDataStore::AccessStats& stats) {
+        ss << "  " << generateDataKey(topic, platformId, componentId);
+        if (data) {
+            ss << ": timestamp=" << data->time << ", age=" << (currentTime - data->time) << "ms";
         } else {
-            ss << "  " << pair.first << ": NULL DATA\n";
+            ss << ": NULL DATA";
         }
-    }
+        ss << ", accessed " << stats.accessCount << " times";
+        if (stats.lastAccessTime > 0) {
+            ss << ", last access " << (currentTime - stats.lastAccessTime) << "ms ago";
+        }
+        ss << "\n";
+    });
 
     return ss.str();
 }
@@ -523,20 +844,18 @@ bool DeviceModelAgent::isDataValid(const char* topic, int64 platformId, int64 ma
         return false;
     }
 
-    std::string key = generateDataKey(topic, platformId);
-
-    auto it = m_subscribedDataMap.find(key);
-    if (it == m_subscribedDataMap.end() || !it->second) {
+    const SubscribedDataStore::DataPtr* entry = m_subscribedData.peek(topic, platformId, -1);
+    if (!entry || !*entry) {
         return false;
     }
 
-    int64 currentTime = QDateTime::currentMSecsSinceEpoch();
-    int64 dataAge = currentTime - it->second->time;
+    int64 currentTime = nowTime();
+    int64 dataAge = currentTime - (*entry)->time;
 
     bool valid = dataAge <= maxAge;
 
     if (!valid && m_enableDebugOutput) {
-        debugLog("Data for key " + key + " is expired (age: " + std::to_string(dataAge) +
+        debugLog("Data for key " + generateDataKey(topic, platformId) + " is expired (age: " + std::to_string(dataAge) +
                 "ms, maxAge: " + std::to_string(maxAge) + "ms)");
     }
 
@@ -2,13 +2,18 @@
 #define DEVICEMODELAGENT_H
 
 #include "CSimModelAgentBase.h"
+#include "CSimModelAgentExtension.h"
 #include <map>
 #include <string>
 #include <memory>
 #include <functional>
 #include "../../DeviceModel/src/common/DMLogger.h"
+#include "SubscribedDataStore.h"
 
-class DeviceModelAgent : public CSimModelAgentBase
+class CSimComponentBase;
+namespace ModelCapture { class CaptureWriter; }
+
+class DeviceModelAgent : public CSimModelAgentBase, public CSimModelAgentExtension
 {
 public:
     DeviceModelAgent();
@@ -34,6 +39,11 @@ public:
     */
     void subscribeSimData(CSubscribeSimData* subscribeSimData) override;
 
+    /**
+    * 带过滤条件订阅数据类主题（数据按平台取用，不做目标过滤，等同subscribeSimData）
+    */
+    void subscribeSimDataFiltered(CSubscribeSimData* simDataSubscription, const CSubscribeFilter* filter) override;
+
     /**
     * 订阅阵营数据类主题
     */
@@ -60,6 +70,11 @@ public:
     */
     void subscribeMessage(const char* topic) override;
 
+    /**
+    * 带过滤条件订阅事件类主题（传播声列表按过滤条件在投递前剔除目标）
+    */
+    void subscribeMessageFiltered(const char* topic, const CSubscribeFilter* filter) override;
+
     /**
     * 取消订阅事件类主题
     */
@@ -130,6 +145,52 @@ public:
      */
     CSimIntegrationLogger* getLogger() override;
 
+    /**
+    * 扩展接口版本
+    */
+    int32 extensionVersion() const override { return CSimModelAgentExtension::VERSION; }
+
+    /**
+    * 获取载荷的共享引用（借用模式）
+    * 订阅数据返回与存储条目共享生命周期的句柄；消息载荷需先通过lendMessagePayload登记
+    * @param data 消息/数据载荷指针
+    * @return 载荷句柄，载荷不归本代理管理时返回空
+    */
+    std::shared_ptr<const void> retainPayload(const void* data) override;
+
+    /**
+    * 登记一个以消息形式发送的载荷，使模型可以借用而不拷贝
+    * 代理只保存弱引用，载荷生命周期由调用方和借用方的句柄共同决定
+    * @param payload 消息载荷（发送期间及之后不得再修改）
+    */
+    void lendMessagePayload(const std::shared_ptr<const void>& payload);
+
+    /**
+    * 批量获取已订阅的仿真数据（一次取时间戳，逐项组合键查找）
+    */
+    void getSubscribeSimDataBatch(const char* const* topics, const int64* platformIds,
+                                  CSimData** results, int32 count) override;
+
+    /**
+    * 批量发送交互信息
+    */
+    void sendMessages(CSimMessage* const* simMessages, int32 count) override;
+
+    /**
+    * 批量发布数据信息
+    */
+    void publishSimDataBatch(CSimData* const* simDatas, int32 count) override;
+
+    /**
+    * 向组件投递消息（宿主入口）
+    * 主题登记了过滤条件时，传播声列表（std::list与扁平格式）先剔除不满足条件的目标，
+    * 剔除后的副本登记为可借用载荷再投递；副本统一为扁平格式（MSG_PropagatedContinuousSound_Flat），
+    * 记录的contactId记为目标在原列表中的编号；其他消息原样投递
+    * @param component 接收组件
+    * @param simMessage 消息
+    */
+    void deliverMessage(CSimComponentBase* component, CSimMessage* simMessage);
+
     /**
     * 订阅数据 - 接口方法
     * @param topic 主题
@@ -168,9 +229,53 @@ public:
     */
     bool isDataValid(const char* topic, int64 platformId, int64 maxAge = 5000) const;
 
+    /**
+    * 开关调试输出（关闭后每步的数据查询不再拼接日志字符串）
+    */
+    void setDebugOutputEnabled(bool enabled) { m_enableDebugOutput = enabled; }
+
+    // *** 宿主配置（多平台宿主为每个平台创建一个代理） ***
+
+    /**
+    * 设置本代理对应的平台实体
+    */
+    void setPlatformEntity(int64 platformId, const char* name, int32 campId);
+
+    /**
+    * 设置仿真时间（ms）
+    * 设置后数据时间戳、过期清理与引擎时间均使用仿真时间；未设置时使用系统时间
+    */
+    void setSimulationTime(int64 simTime) { m_simTime = simTime; }
+
+    /**
+    * 设置消息出口：组件发送的每条消息在本地处理后交给出口（消息载荷由发送方持有）
+    */
+    void setMessageSink(const std::function<void(CSimMessage*)>& sink) { m_messageSink = sink; }
+
+    /**
+    * 设置数据出口：组件发布的每条数据在本地处理后交给出口（载荷只在回调期间有效）
+    */
+    void setDataSink(const std::function<void(CSimData*)>& sink) { m_dataSink = sink; }
+
+    /**
+    * 设置订阅出口：订阅/取消订阅事件类主题时通知宿主（true为订阅）
+    */
+    void setSubscriptionSink(const std::function<void(const char*, bool)>& sink) { m_subscriptionSink = sink; }
+
+    /**
+    * 设置输入捕获：投递给组件的消息（过滤后的实际载荷）与组件取到的订阅数据写入捕获文件
+    * 代理不持有写入器，传nullptr关闭捕获
+    */
+    void setCaptureWriter(ModelCapture::CaptureWriter* writer) { m_capture = writer; }
+
+    /**
+    * 是否订阅了该事件类主题
+    */
+    bool isMessageSubscribed(const char* topic) const;
+
 private:
     /**
-    * 生成数据存储的键值
+    * 生成数据键的可读形式（仅用于日志与统计输出）
     * @param topic 主题
     * @param platformId 平台ID
     * @param componentId 组件ID（可选）
@@ -190,6 +295,12 @@ private:
     */
     void debugLog(const std::string& message) const;
 
+    /**
+    * 打印发送消息的摘要（仅在调试输出开启时调用）
+    * @param simMessage 消息
+    */
+    void logSentMessage(const CSimMessage* simMessage) const;
+
 private:
     /**
     * 安全删除数据指针（包括内部data指针）
@@ -204,16 +315,60 @@ private:
     */
     void safeDeleteDataContent(const std::string& topic, const void* dataPtr);
 
+    /**
+    * 根据主题类型删除data->data指针（不依赖代理对象，借用句柄可能晚于代理释放）
+    * @return 已识别主题并删除返回true
+    */
+    static bool deleteDataContent(const std::string& topic, const void* dataPtr);
+
 private:
     CSimPlatformEntity m_platform;
     CSimComponentAttribute m_attribute;
 
-    // 使用shared_ptr替代unique_ptr，避免自定义删除器的复杂性
-    std::map<std::string, std::shared_ptr<CSimData>> m_subscribedDataMap;
+    // 订阅数据存储（组合键开放寻址表，访问统计为原子计数）
+    SubscribedDataStore m_subscribedData;
+
+    // 已登记的消息载荷（弱引用，载荷指针 -> 句柄）
+    std::map<const void*, std::weak_ptr<const void>> m_lentPayloads;
+
+    // 消息过滤条件（主题哈希 -> 主题名与过滤描述）
+    struct MessageFilterEntry {
+        std::string topic;
+        CSubscribeFilter filter;
+    };
+    std::map<uint32_t, MessageFilterEntry> m_messageFilters;
+
+    /**
+    * 查找主题的过滤条件，未登记返回nullptr
+    */
+    const CSubscribeFilter* findMessageFilter(const char* topic) const;
+
+    /**
+    * 把消息交给组件（开启捕获时先记录）
+    */
+    void dispatchMessage(CSimComponentBase* component, CSimMessage* simMessage);
 
-    // 数据访问统计
-    mutable std::map<std::string, int> m_dataAccessCount;
-    mutable std::map<std::string, int64> m_lastAccessTime;
+    /**
+    * 本平台当前航向（取自订阅的Data_Motion）
+    * @return 有机动数据返回true
+    */
+    bool getOwnHeading(float& heading) const;
+
+    // 已订阅的事件类主题（主题哈希 -> 主题名）
+    std::map<uint32_t, std::string> m_subscribedTopics;
+
+    /**
+    * 当前时间：设置了仿真时间时返回仿真时间，否则返回系统时间
+    */
+    int64 nowTime() const;
+
+    // 宿主配置
+    int64 m_simTime;                                    // 仿真时间，-1表示未设置
+    int32 m_step;                                       // 步长（ms）
+    std::function<void(CSimMessage*)> m_messageSink;    // 消息出口
+    std::function<void(CSimData*)> m_dataSink;          // 数据出口
+    std::function<void(const char*, bool)> m_subscriptionSink; // 订阅出口
+    ModelCapture::CaptureWriter* m_capture;             // 输入捕获（不持有）
 
     // 调试开关
     bool m_enableDebugOutput;
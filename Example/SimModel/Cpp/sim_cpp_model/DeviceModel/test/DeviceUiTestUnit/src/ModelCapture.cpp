@@ -0,0 +1,698 @@
+#include "ModelCapture.h"
+#include "DeviceTestInOut.h"
+#include "FlatSoundList.h"
+#include "../../DeviceModel/src/common/DMLogger.h"
+
+#include <algorithm>
+#include <cstring>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ModelCapture {
+
+namespace {
+
+const uint64 INITIAL_CAPACITY = 16 * 1024 * 1024;      // 初始映射大小
+const intptr_t INVALID_HANDLE = -1;
+
+static_assert(sizeof(FileHeader) == 64, "capture file header must stay 64 bytes");
+static_assert(sizeof(RecordHeader) % 8 == 0, "capture record header must keep 8-byte alignment");
+
+uint64 alignUp(uint64 bytes)
+{
+    return (bytes + 7) & ~static_cast<uint64>(7);
+}
+
+bool topicIs(const char* topic, const char* name)
+{
+    return strncmp(topic, name, EventTypeLen) == 0;
+}
+
+/**
+ * 按字节保存的主题：固定结构返回结构大小，扁平列表返回0（按消息length保存）
+ */
+bool rawTopicSize(const char* topic, size_t& size)
+{
+    struct RawTopic {
+        const char* topic;
+        size_t size;
+    };
+    static const RawTopic rawTopics[] = {
+        { MSG_PropagatedContinuousSound_Flat, 0 },
+        { MSG_PropagatedActivePulseSound_Flat, 0 },
+        { MSG_PropagatedCommPulseSound_Flat, 0 },
+        { MSG_PropagatedInstantSound_Flat, 0 },
+        { MSG_EnvironmentNoiseToSonar, sizeof(CMsg_EnvironmentNoiseToSonarStruct) },
+        { Data_Motion, sizeof(CData_Motion) },
+        { MSG_SonarCommandControlOrder, sizeof(CMsg_SonarCommandControlOrder) },
+        { ATTR_PassiveSonarComponent, sizeof(CAttr_PassiveSonarComponent) },
+        { MSG_PassiveSonarControlPara, sizeof(CMsg_PassiveSonarControlPara) },
+        { MSG_ActiveSonarControlPara, sizeof(CMsg_ActiveSonarControlPara) },
+        { MSG_ActiveTransmitControlPara, sizeof(CMsg_ActiveTransmitControlPara) },
+        { MSG_DetectiveSonarControlPara, sizeof(CMsg_DetectiveSonarControlPara) },
+        { MSG_DataCombineControlPara, sizeof(CMsg_DataCombineControlPara) },
+    };
+
+    for (const RawTopic& raw : rawTopics) {
+        if (topicIs(topic, raw.topic)) {
+            size = raw.size;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * 扁平列表须按FLAT_SOUND_LIST_ALIGN对齐，记录只保证8字节对齐，未对齐时拷贝到对齐的内存
+ */
+std::shared_ptr<const void> alignedFlatPayload(const uint8* payload, uint64 bytes)
+{
+    if (reinterpret_cast<uintptr_t>(payload) % FLAT_SOUND_LIST_ALIGN == 0) {
+        return std::shared_ptr<const void>(payload, [](const void*) {});
+    }
+
+    std::shared_ptr<uint8> storage(new uint8[bytes + FLAT_SOUND_LIST_ALIGN], std::default_delete<uint8[]>());
+    uintptr_t address = reinterpret_cast<uintptr_t>(storage.get());
+    uint8* aligned = storage.get() + (FLAT_SOUND_LIST_ALIGN - address % FLAT_SOUND_LIST_ALIGN) % FLAT_SOUND_LIST_ALIGN;
+    memcpy(aligned, payload, bytes);
+    return std::shared_ptr<const void>(storage, aligned);
+}
+
+/**
+ * 列表载荷：元素个数 + 元素字节数 + 元素依次按字节存放（元素须可按字节复制）
+ */
+struct ListPrefix
+{
+    uint32 count;
+    uint32 elementBytes;
+};
+
+template<typename T>
+uint64 listBytes(const std::list<T>& list)
+{
+    return sizeof(ListPrefix) + static_cast<uint64>(list.size()) * sizeof(T);
+}
+
+template<typename T>
+void encodeList(const std::list<T>& list, uint8* dst)
+{
+    ListPrefix prefix;
+    prefix.count = static_cast<uint32>(list.size());
+    prefix.elementBytes = sizeof(T);
+    memcpy(dst, &prefix, sizeof(prefix));
+    dst += sizeof(prefix);
+    for (const T& element : list) {
+        memcpy(dst, &element, sizeof(T));
+        dst += sizeof(T);
+    }
+}
+
+template<typename T>
+bool decodeList(const uint8* src, uint64 bytes, std::list<T>& list)
+{
+    ListPrefix prefix;
+    if (bytes < sizeof(prefix)) {
+        return false;
+    }
+    memcpy(&prefix, src, sizeof(prefix));
+    if (prefix.elementBytes != sizeof(T) || bytes < sizeof(prefix) + static_cast<uint64>(prefix.count) * sizeof(T)) {
+        return false;
+    }
+
+    src += sizeof(prefix);
+    for (uint32 i = 0; i < prefix.count; i++) {
+        list.emplace_back();
+        memcpy(&list.back(), src, sizeof(T));
+        src += sizeof(T);
+    }
+    return true;
+}
+
+/**
+ * 载荷编码后的字节数
+ */
+uint64 encodedBytes(PayloadCodec codec, const char* topic, const void* data, uint32 length)
+{
+    switch (codec) {
+        case CODEC_RAW: {
+            size_t size = 0;
+            rawTopicSize(topic, size);
+            return size > 0 ? size : length;
+        }
+        case CODEC_SELF_SOUND_LIST:
+            return listBytes(static_cast<const CData_PlatformSelfSound*>(data)->selfSoundSpectrumList);
+        case CODEC_CONTINUOUS_LIST:
+            return listBytes(static_cast<const CMsg_PropagatedContinuousSoundListStruct*>(data)->propagatedContinuousList);
+        case CODEC_INSTANT_LIST:
+            return listBytes(static_cast<const CMsg_PropagatedInstantSoundListStruct*>(data)->propagatedInstantSoundList);
+        case CODEC_REVERBERATION_LIST:
+            return listBytes(static_cast<const CMsg_ReverberationSoundStruct*>(data)->RLGraph);
+        default:
+            return 0;
+    }
+}
+
+void encodePayload(PayloadCodec codec, const char* topic, const void* data, uint64 bytes, uint8* dst)
+{
+    switch (codec) {
+        case CODEC_RAW:
+            memcpy(dst, data, bytes);
+            if (topicIs(topic, Data_Motion)) {
+                // 实体名指针在回放进程中无效
+                reinterpret_cast<CData_Motion*>(dst)->name = nullptr;
+            }
+            break;
+        case CODEC_SELF_SOUND_LIST:
+            encodeList(static_cast<const CData_PlatformSelfSound*>(data)->selfSoundSpectrumList, dst);
+            break;
+        case CODEC_CONTINUOUS_LIST:
+            encodeList(static_cast<const CMsg_PropagatedContinuousSoundListStruct*>(data)->propagatedContinuousList, dst);
+            break;
+        case CODEC_INSTANT_LIST:
+            encodeList(static_cast<const CMsg_PropagatedInstantSoundListStruct*>(data)->propagatedInstantSoundList, dst);
+            break;
+        case CODEC_REVERBERATION_LIST:
+            encodeList(static_cast<const CMsg_ReverberationSoundStruct*>(data)->RLGraph, dst);
+            break;
+        default:
+            break;
+    }
+}
+
+void closeFile(intptr_t& file, intptr_t& mapping)
+{
+#ifdef _WIN32
+    if (mapping != INVALID_HANDLE) {
+        CloseHandle(reinterpret_cast<HANDLE>(mapping));
+    }
+    if (file != INVALID_HANDLE) {
+        CloseHandle(reinterpret_cast<HANDLE>(file));
+    }
+#else
+    if (file != INVALID_HANDLE) {
+        ::close(static_cast<int>(file));
+    }
+#endif
+    file = INVALID_HANDLE;
+    mapping = INVALID_HANDLE;
+}
+
+}
+
+PayloadCodec codecForTopic(const char* topic)
+{
+    if (!topic) {
+        return CODEC_UNSUPPORTED;
+    }
+
+    size_t size = 0;
+    if (rawTopicSize(topic, size)) {
+        return CODEC_RAW;
+    }
+    if (topicIs(topic, Data_PlatformSelfSound) || topicIs(topic, Data_PlatformSelfSound_X1)) {
+        return CODEC_SELF_SOUND_LIST;
+    }
+    if (topicIs(topic, MSG_PropagatedContinuousSound)) {
+        return CODEC_CONTINUOUS_LIST;
+    }
+    if (topicIs(topic, MSG_PropagatedInstantSound)) {
+        return CODEC_INSTANT_LIST;
+    }
+    if (topicIs(topic, MSG_ReverberationSound)) {
+        return CODEC_REVERBERATION_LIST;
+    }
+    return CODEC_UNSUPPORTED;
+}
+
+// ==================== CaptureWriter ====================
+
+CaptureWriter::CaptureWriter()
+    : m_file(INVALID_HANDLE)
+    , m_mapping(INVALID_HANDLE)
+    , m_base(nullptr)
+    , m_capacity(0)
+{
+}
+
+CaptureWriter::~CaptureWriter()
+{
+    close();
+}
+
+bool CaptureWriter::open(const std::string& path, int64 platformId, int32 campId, int32 stepMs)
+{
+    close();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_ERRORF("Failed to create capture file: %s", path.c_str());
+        return false;
+    }
+    m_file = reinterpret_cast<intptr_t>(file);
+#else
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        LOG_ERRORF("Failed to create capture file: %s", path.c_str());
+        return false;
+    }
+    m_file = fd;
+#endif
+
+    if (!remapLocked(INITIAL_CAPACITY)) {
+        closeFile(m_file, m_mapping);
+        return false;
+    }
+
+    FileHeader* header = reinterpret_cast<FileHeader*>(m_base);
+    memset(header, 0, sizeof(FileHeader));
+    memcpy(header->magic, FILE_MAGIC, sizeof(header->magic));
+    header->version = FILE_VERSION;
+    header->headerBytes = sizeof(FileHeader);
+    header->platformId = platformId;
+    header->campId = campId;
+    header->stepMs = stepMs;
+    header->committedBytes = sizeof(FileHeader);
+    header->recordCount = 0;
+
+    m_path = path;
+    m_lastSubscribed.clear();
+    m_stats = Stats();
+    m_stats.bytes = sizeof(FileHeader);
+    LOG_INFOF("Model capture opened: %s", path.c_str());
+    return true;
+}
+
+void CaptureWriter::close()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_base) {
+        return;
+    }
+
+    uint64 committed = reinterpret_cast<FileHeader*>(m_base)->committedBytes;
+    unmapLocked();
+
+    // 截断映射时预留的空间
+#ifdef _WIN32
+    LARGE_INTEGER size;
+    size.QuadPart = static_cast<LONGLONG>(committed);
+    HANDLE file = reinterpret_cast<HANDLE>(m_file);
+    if (SetFilePointerEx(file, size, nullptr, FILE_BEGIN)) {
+        SetEndOfFile(file);
+    }
+#else
+    if (ftruncate(static_cast<int>(m_file), static_cast<off_t>(committed)) != 0) {
+        LOG_WARNF("Failed to truncate capture file: %s", m_path.c_str());
+    }
+#endif
+    closeFile(m_file, m_mapping);
+    LOG_INFOF("Model capture closed: %s (%llu bytes)", m_path.c_str(), static_cast<unsigned long long>(committed));
+}
+
+bool CaptureWriter::isOpen() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_base != nullptr;
+}
+
+void CaptureWriter::appendMessage(const CSimMessage& simMessage)
+{
+    PayloadCodec codec = simMessage.data ? codecForTopic(simMessage.topic) : CODEC_NONE;
+    uint64 payloadBytes = (codec == CODEC_UNSUPPORTED) ? 0 :
+                          encodedBytes(codec, simMessage.topic, simMessage.data, simMessage.length);
+    uint64 recordBytes = alignUp(sizeof(RecordHeader) + payloadBytes);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint8* dst = reserveLocked(recordBytes);
+    if (!dst) {
+        return;
+    }
+
+    RecordHeader* header = reinterpret_cast<RecordHeader*>(dst);
+    memset(header, 0, sizeof(RecordHeader));
+    header->recordBytes = static_cast<uint32>(recordBytes);
+    header->kind = RECORD_MESSAGE;
+    header->codec = static_cast<uint16>(codec);
+    header->time = simMessage.time;
+    header->sender = simMessage.sender;
+    header->componentId = simMessage.senderComponentId;
+    header->receiver = simMessage.receiver;
+    header->dataFormat = simMessage.dataFormat;
+    header->length = simMessage.length;
+    header->payloadBytes = static_cast<uint32>(payloadBytes);
+    memcpy(header->topic, simMessage.topic, EventTypeLen);
+    encodePayload(codec, simMessage.topic, simMessage.data, payloadBytes, dst + sizeof(RecordHeader));
+
+    commitLocked(recordBytes);
+    m_stats.messages++;
+    if (codec == CODEC_UNSUPPORTED) {
+        m_stats.unsupported++;
+    }
+}
+
+void CaptureWriter::appendSubscribedData(const char* topic, int64 platformId, int64 componentId, const CSimData* data)
+{
+    if (!topic) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_base) {
+        return;
+    }
+
+    // 与该键上次记录的内容相同（同一对象、同一时间）时不重复记录
+    LastSubscribed* last = nullptr;
+    for (LastSubscribed& entry : m_lastSubscribed) {
+        if (entry.platformId == platformId && entry.componentId == componentId && entry.topic == topic) {
+            last = &entry;
+            break;
+        }
+    }
+    const void* payload = data ? data->data : nullptr;
+    int64 dataTime = data ? data->time : -1;
+    if (last && last->data == payload && last->time == dataTime) {
+        return;
+    }
+    if (!last) {
+        LastSubscribed entry;
+        entry.topic = topic;
+        entry.platformId = platformId;
+        entry.componentId = componentId;
+        m_lastSubscribed.push_back(entry);
+        last = &m_lastSubscribed.back();
+    }
+    last->data = payload;
+    last->time = dataTime;
+
+    PayloadCodec codec = payload ? codecForTopic(topic) : CODEC_NONE;
+    uint64 payloadBytes = (codec == CODEC_UNSUPPORTED) ? 0 : encodedBytes(codec, topic, payload, data ? data->length : 0);
+    uint64 recordBytes = alignUp(sizeof(RecordHeader) + payloadBytes);
+    uint8* dst = reserveLocked(recordBytes);
+    if (!dst) {
+        return;
+    }
+
+    RecordHeader* header = reinterpret_cast<RecordHeader*>(dst);
+    memset(header, 0, sizeof(RecordHeader));
+    header->recordBytes = static_cast<uint32>(recordBytes);
+    header->kind = RECORD_SUBSCRIBED_DATA;
+    header->codec = static_cast<uint16>(codec);
+    header->time = dataTime;
+    header->sender = data ? data->sender : -1;
+    header->componentId = componentId;
+    header->receiver = platformId;
+    header->dataFormat = data ? data->dataFormat : STRUCT;
+    header->length = data ? data->length : 0;
+    header->payloadBytes = static_cast<uint32>(payloadBytes);
+    memcpy(header->topic, topic, strnlen(topic, EventTypeLen));
+    encodePayload(codec, topic, payload, payloadBytes, dst + sizeof(RecordHeader));
+
+    commitLocked(recordBytes);
+    m_stats.subscribedData++;
+    if (codec == CODEC_UNSUPPORTED) {
+        m_stats.unsupported++;
+    }
+}
+
+void CaptureWriter::appendStep(int64 time, int32 step)
+{
+    uint64 recordBytes = alignUp(sizeof(RecordHeader));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint8* dst = reserveLocked(recordBytes);
+    if (!dst) {
+        return;
+    }
+
+    RecordHeader* header = reinterpret_cast<RecordHeader*>(dst);
+    memset(header, 0, sizeof(RecordHeader));
+    header->recordBytes = static_cast<uint32>(recordBytes);
+    header->kind = RECORD_STEP;
+    header->codec = CODEC_NONE;
+    header->time = time;
+    header->length = static_cast<uint32>(step);
+
+    commitLocked(recordBytes);
+    m_stats.steps++;
+}
+
+CaptureWriter::Stats CaptureWriter::stats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+uint8* CaptureWriter::reserveLocked(uint64 recordBytes)
+{
+    if (!m_base) {
+        return nullptr;
+    }
+    if (recordBytes > UINT32_MAX) {
+        LOG_ERRORF("Capture record too large: %llu bytes", static_cast<unsigned long long>(recordBytes));
+        return nullptr;
+    }
+
+    uint64 committed = reinterpret_cast<FileHeader*>(m_base)->committedBytes;
+    if (committed + recordBytes > m_capacity) {
+        uint64 capacity = std::max(m_capacity * 2, alignUp(committed + recordBytes));
+        if (!remapLocked(capacity)) {
+            return nullptr;
+        }
+    }
+    return m_base + committed;
+}
+
+void CaptureWriter::commitLocked(uint64 recordBytes)
+{
+    FileHeader* header = reinterpret_cast<FileHeader*>(m_base);
+    header->committedBytes += recordBytes;
+    header->recordCount++;
+    m_stats.bytes = header->committedBytes;
+}
+
+bool CaptureWriter::remapLocked(uint64 capacity)
+{
+    unmapLocked();
+
+#ifdef _WIN32
+    HANDLE mapping = CreateFileMappingA(reinterpret_cast<HANDLE>(m_file), nullptr, PAGE_READWRITE,
+                                        static_cast<DWORD>(capacity >> 32), static_cast<DWORD>(capacity & 0xFFFFFFFFu), nullptr);
+    if (!mapping) {
+        LOG_ERRORF("Failed to map capture file: %s", m_path.c_str());
+        return false;
+    }
+    void* base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, static_cast<SIZE_T>(capacity));
+    if (!base) {
+        CloseHandle(mapping);
+        LOG_ERRORF("Failed to map capture file: %s", m_path.c_str());
+        return false;
+    }
+    m_mapping = reinterpret_cast<intptr_t>(mapping);
+#else
+    int fd = static_cast<int>(m_file);
+    if (ftruncate(fd, static_cast<off_t>(capacity)) != 0) {
+        LOG_ERRORF("Failed to grow capture file: %s", m_path.c_str());
+        return false;
+    }
+    void* base = mmap(nullptr, static_cast<size_t>(capacity), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        LOG_ERRORF("Failed to map capture file: %s", m_path.c_str());
+        return false;
+    }
+#endif
+
+    m_base = static_cast<uint8*>(base);
+    m_capacity = capacity;
+    return true;
+}
+
+void CaptureWriter::unmapLocked()
+{
+    if (!m_base) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(m_base);
+    if (m_mapping != INVALID_HANDLE) {
+        CloseHandle(reinterpret_cast<HANDLE>(m_mapping));
+        m_mapping = INVALID_HANDLE;
+    }
+#else
+    munmap(m_base, static_cast<size_t>(m_capacity));
+#endif
+    m_base = nullptr;
+    m_capacity = 0;
+}
+
+// ==================== CaptureReader ====================
+
+CaptureReader::CaptureReader()
+    : m_file(INVALID_HANDLE)
+    , m_mapping(INVALID_HANDLE)
+    , m_base(nullptr)
+    , m_size(0)
+    , m_offset(0)
+{
+}
+
+CaptureReader::~CaptureReader()
+{
+    close();
+}
+
+bool CaptureReader::open(const std::string& path)
+{
+    close();
+
+    const void* base = nullptr;
+    uint64 size = 0;
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        LOG_ERRORF("Failed to open capture file: %s", path.c_str());
+        return false;
+    }
+    m_file = reinterpret_cast<intptr_t>(file);
+    LARGE_INTEGER fileSize;
+    if (GetFileSizeEx(file, &fileSize)) {
+        size = static_cast<uint64>(fileSize.QuadPart);
+    }
+    if (size >= sizeof(FileHeader)) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) {
+            m_mapping = reinterpret_cast<intptr_t>(mapping);
+            base = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        }
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        LOG_ERRORF("Failed to open capture file: %s", path.c_str());
+        return false;
+    }
+    m_file = fd;
+    struct stat info;
+    if (fstat(fd, &info) == 0) {
+        size = static_cast<uint64>(info.st_size);
+    }
+    if (size >= sizeof(FileHeader)) {
+        void* mapped = mmap(nullptr, static_cast<size_t>(size), PROT_READ, MAP_PRIVATE, fd, 0);
+        base = (mapped == MAP_FAILED) ? nullptr : mapped;
+    }
+#endif
+
+    if (!base) {
+        LOG_ERRORF("Failed to map capture file: %s", path.c_str());
+        closeFile(m_file, m_mapping);
+        return false;
+    }
+    m_base = static_cast<const uint8*>(base);
+    m_size = size;
+
+    const FileHeader& fileHeader = header();
+    if (memcmp(fileHeader.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || fileHeader.version != FILE_VERSION ||
+        fileHeader.headerBytes < sizeof(FileHeader) || fileHeader.committedBytes > m_size) {
+        LOG_ERRORF("Invalid capture file: %s", path.c_str());
+        close();
+        return false;
+    }
+
+    rewind();
+    return true;
+}
+
+void CaptureReader::close()
+{
+    if (m_base) {
+#ifdef _WIN32
+        UnmapViewOfFile(m_base);
+#else
+        munmap(const_cast<uint8*>(m_base), static_cast<size_t>(m_size));
+#endif
+        m_base = nullptr;
+    }
+    closeFile(m_file, m_mapping);
+    m_size = 0;
+    m_offset = 0;
+}
+
+bool CaptureReader::next(Record& record)
+{
+    if (!m_base) {
+        return false;
+    }
+
+    uint64 committed = header().committedBytes;
+    if (m_offset + sizeof(RecordHeader) > committed) {
+        return false;
+    }
+
+    const RecordHeader* recordHeader = reinterpret_cast<const RecordHeader*>(m_base + m_offset);
+    if (recordHeader->recordBytes < sizeof(RecordHeader) ||
+        m_offset + recordHeader->recordBytes > committed ||
+        sizeof(RecordHeader) + static_cast<uint64>(recordHeader->payloadBytes) > recordHeader->recordBytes) {
+        LOG_ERRORF("Corrupt capture record at offset %llu", static_cast<unsigned long long>(m_offset));
+        return false;
+    }
+
+    record.header = recordHeader;
+    record.payload = m_base + m_offset + sizeof(RecordHeader);
+    m_offset += recordHeader->recordBytes;
+    return true;
+}
+
+void CaptureReader::rewind()
+{
+    m_offset = m_base ? header().headerBytes : 0;
+}
+
+std::shared_ptr<const void> CaptureReader::decodePayload(const Record& record) const
+{
+    const RecordHeader& header = *record.header;
+    const uint8* payload = record.payload;
+    uint64 bytes = header.payloadBytes;
+
+    switch (header.codec) {
+        case CODEC_RAW: {
+            // 指向映射内存，读取器负责生命期
+            size_t size = 0;
+            if (rawTopicSize(header.topic, size) && size == 0) {
+                return alignedFlatPayload(payload, bytes);
+            }
+            return std::shared_ptr<const void>(payload, [](const void*) {});
+        }
+        case CODEC_SELF_SOUND_LIST: {
+            std::shared_ptr<CData_PlatformSelfSound> data = std::make_shared<CData_PlatformSelfSound>();
+            return decodeList(payload, bytes, data->selfSoundSpectrumList) ? data : nullptr;
+        }
+        case CODEC_CONTINUOUS_LIST: {
+            std::shared_ptr<CMsg_PropagatedContinuousSoundListStruct> data =
+                std::make_shared<CMsg_PropagatedContinuousSoundListStruct>();
+            return decodeList(payload, bytes, data->propagatedContinuousList) ? data : nullptr;
+        }
+        case CODEC_INSTANT_LIST: {
+            std::shared_ptr<CMsg_PropagatedInstantSoundListStruct> data =
+                std::make_shared<CMsg_PropagatedInstantSoundListStruct>();
+            return decodeList(payload, bytes, data->propagatedInstantSoundList) ? data : nullptr;
+        }
+        case CODEC_REVERBERATION_LIST: {
+            std::shared_ptr<CMsg_ReverberationSoundStruct> data = std::make_shared<CMsg_ReverberationSoundStruct>();
+            return decodeList(payload, bytes, data->RLGraph) ? data : nullptr;
+        }
+        default:
+            return std::shared_ptr<const void>();
+    }
+}
+
+}
@@ -0,0 +1,211 @@
+#ifndef MODELCAPTURE_H
+#define MODELCAPTURE_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "SimBasicTypes.h"
+#include "CSimData.h"
+#include "CSimMessage.h"
+
+/**
+ * 模型输入捕获文件格式（只追加，内存映射读写）
+ * 文件 = 文件头 + 若干记录，每条记录 = 记录头 + 载荷，按8字节对齐；
+ * 文件头中的committedBytes在每条记录写完后更新，进程异常退出时已提交的记录仍可回放。
+ * 记录三类事件：投递给组件的消息（onMessage）、组件取到的订阅数据、步进结束（prepareStep+commitStep）
+ */
+namespace ModelCapture {
+
+const char FILE_MAGIC[8] = { 'D', 'M', 'C', 'A', 'P', 'T', '0', '1' };
+const uint32 FILE_VERSION = 1;
+
+enum RecordKind
+{
+    RECORD_MESSAGE = 1,             // 投递给组件的消息（过滤后的实际载荷）
+    RECORD_SUBSCRIBED_DATA = 2,     // 组件取到的订阅数据（与上次取到的不同时记录，取不到时记录空载荷）
+    RECORD_STEP = 3                 // 一步结束：回放时在此处调用prepareStep与commitStep
+};
+
+enum PayloadCodec
+{
+    CODEC_NONE = 0,                 // 无载荷（空数据、步进）
+    CODEC_RAW,                      // 平坦结构或扁平列表，按字节保存
+    CODEC_SELF_SOUND_LIST,          // CData_PlatformSelfSound
+    CODEC_CONTINUOUS_LIST,          // CMsg_PropagatedContinuousSoundListStruct
+    CODEC_INSTANT_LIST,             // CMsg_PropagatedInstantSoundListStruct
+    CODEC_REVERBERATION_LIST,       // CMsg_ReverberationSoundStruct
+    CODEC_UNSUPPORTED               // 含嵌套容器等无法按字节保存的载荷，只记录消息头，回放时跳过
+};
+
+#pragma pack(push, 8)
+/**
+ * 文件头（64字节）
+ */
+struct FileHeader
+{
+    char magic[8];
+    uint32 version;
+    uint32 headerBytes;             // 文件头字节数，首条记录的偏移
+    int64 platformId;               // 捕获时代理的平台ID
+    int32 campId;                   // 阵营ID
+    int32 stepMs;                   // 仿真步长（ms）
+    uint64 committedBytes;          // 已提交的字节数（文件头 + 完整记录）
+    uint64 recordCount;             // 已提交的记录数
+    uint8 reserved[16];
+};
+
+/**
+ * 记录头（消息与订阅数据的字段合并存放）
+ */
+struct RecordHeader
+{
+    uint32 recordBytes;             // 记录头 + 载荷 + 对齐填充
+    uint16 kind;                    // RecordKind
+    uint16 codec;                   // PayloadCodec
+    int64 time;                     // 消息/数据时间；步进记录为步进时间
+    int64 sender;                   // 发送者实体ID
+    int64 componentId;              // 消息为发送者组件ID，订阅数据为组件ID
+    int64 receiver;                 // 接收者实体ID；订阅数据为查询的平台ID
+    int32 dataFormat;               // CDataFormat
+    uint32 length;                  // 原消息/数据的length字段；步进记录为步长（ms）
+    uint32 payloadBytes;            // 载荷字节数
+    uint32 reserved;
+    char topic[EventTypeLen];
+};
+#pragma pack(pop)
+
+/**
+ * 主题对应的载荷编码
+ */
+PayloadCodec codecForTopic(const char* topic);
+
+/**
+ * 捕获写入器（单个代理/组件一个文件）
+ * 文件按需倍增并重新映射，close时截断到已提交长度
+ */
+class CaptureWriter
+{
+public:
+    struct Stats
+    {
+        uint64 messages;            // 记录的消息数
+        uint64 subscribedData;      // 记录的订阅数据数
+        uint64 steps;               // 记录的步数
+        uint64 unsupported;         // 只记录了消息头的消息数
+        uint64 bytes;               // 已提交字节数
+
+        Stats() : messages(0), subscribedData(0), steps(0), unsupported(0), bytes(0) {}
+    };
+
+    CaptureWriter();
+    ~CaptureWriter();
+
+    bool open(const std::string& path, int64 platformId, int32 campId, int32 stepMs);
+    void close();
+    bool isOpen() const;
+
+    /**
+     * 记录投递给组件的消息
+     */
+    void appendMessage(const CSimMessage& simMessage);
+
+    /**
+     * 记录组件取到的订阅数据（data为空表示取不到）
+     * 与该键上次记录的数据相同（同一对象、同一时间）时不记录
+     */
+    void appendSubscribedData(const char* topic, int64 platformId, int64 componentId, const CSimData* data);
+
+    /**
+     * 记录一步结束（宿主在commitStep之后调用）
+     */
+    void appendStep(int64 time, int32 step);
+
+    Stats stats() const;
+
+private:
+    // 禁止拷贝和赋值
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    /**
+     * 订阅数据键上次记录的内容
+     */
+    struct LastSubscribed {
+        std::string topic;
+        int64 platformId;
+        int64 componentId;
+        const void* data;
+        int64 time;
+    };
+
+    uint8* reserveLocked(uint64 recordBytes);
+    void commitLocked(uint64 recordBytes);
+    bool remapLocked(uint64 capacity);
+    void unmapLocked();
+
+    mutable std::mutex m_mutex;
+    std::string m_path;
+    intptr_t m_file;                // 文件句柄（Linux为fd）
+    intptr_t m_mapping;             // 映射句柄（仅Windows）
+    uint8* m_base;
+    uint64 m_capacity;
+    std::vector<LastSubscribed> m_lastSubscribed;
+    Stats m_stats;
+};
+
+/**
+ * 捕获读取器：只读映射整个文件，记录按顺序零拷贝访问
+ */
+class CaptureReader
+{
+public:
+    struct Record
+    {
+        const RecordHeader* header;
+        const uint8* payload;
+
+        Record() : header(nullptr), payload(nullptr) {}
+    };
+
+    CaptureReader();
+    ~CaptureReader();
+
+    bool open(const std::string& path);
+    void close();
+
+    const FileHeader& header() const { return *reinterpret_cast<const FileHeader*>(m_base); }
+
+    /**
+     * 读取下一条记录，到达已提交末尾时返回false
+     */
+    bool next(Record& record);
+
+    /**
+     * 回到首条记录
+     */
+    void rewind();
+
+    /**
+     * 把记录载荷还原为主题对应的结构
+     * 按字节保存的载荷直接指向映射内存（读取器关闭前有效），列表载荷解码为新对象
+     * @return 无载荷或不支持的编码返回空
+     */
+    std::shared_ptr<const void> decodePayload(const Record& record) const;
+
+private:
+    // 禁止拷贝和赋值
+    CaptureReader(const CaptureReader&) = delete;
+    CaptureReader& operator=(const CaptureReader&) = delete;
+
+    intptr_t m_file;
+    intptr_t m_mapping;
+    const uint8* m_base;
+    uint64 m_size;
+    uint64 m_offset;
+};
+
+}
+
+#endif // MODELCAPTURE_H
@@ -0,0 +1,457 @@
+#include "SubscribedDataStore.h"
+
+#include <cstring>
+#include <algorithm>
+
+namespace {
+
+const size_t INITIAL_TOPIC_SLOTS = 64;
+const size_t INITIAL_DATA_SLOTS = 64;
+
+// 过期堆比较：数据时间早的在堆顶
+bool expiryLater(int64 lhsTime, int64 rhsTime)
+{
+    return lhsTime > rhsTime;
+}
+
+} // namespace
+
+// ========== TopicInterner ==========
+
+TopicInterner::TopicInterner()
+{
+    Slot empty = { 0, INVALID_TOPIC };
+    m_slots.assign(INITIAL_TOPIC_SLOTS, empty);
+}
+
+size_t TopicInterner::probe(const char* topic, uint32_t hash) const
+{
+    size_t mask = m_slots.size() - 1;
+    size_t index = hash & mask;
+    while (m_slots[index].topicId != INVALID_TOPIC) {
+        const Slot& slot = m_slots[index];
+        if (slot.hash == hash && strncmp(m_names[slot.topicId].c_str(), topic, EventTypeLen) == 0) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return index;
+}
+
+uint16_t TopicInterner::find(const char* topic) const
+{
+    if (!topic) {
+        return INVALID_TOPIC;
+    }
+    uint32_t hash = TopicHash::topicHashRuntime(topic, EventTypeLen);
+    return m_slots[probe(topic, hash)].topicId;
+}
+
+uint16_t TopicInterner::intern(const char* topic)
+{
+    if (!topic) {
+        return INVALID_TOPIC;
+    }
+
+    uint32_t hash = TopicHash::topicHashRuntime(topic, EventTypeLen);
+    size_t index = probe(topic, hash);
+    if (m_slots[index].topicId != INVALID_TOPIC) {
+        return m_slots[index].topicId;
+    }
+
+    if (m_names.size() >= INVALID_TOPIC) {
+        return INVALID_TOPIC;
+    }
+
+    // 负载超过一半时扩容
+    if ((m_names.size() + 1) * 2 > m_slots.size()) {
+        Slot empty = { 0, INVALID_TOPIC };
+        std::vector<Slot> oldSlots(m_slots.size() * 2, empty);
+        oldSlots.swap(m_slots);
+        size_t mask = m_slots.size() - 1;
+        for (const Slot& slot : oldSlots) {
+            if (slot.topicId == INVALID_TOPIC) {
+                continue;
+            }
+            size_t newIndex = slot.hash & mask;
+            while (m_slots[newIndex].topicId != INVALID_TOPIC) {
+                newIndex = (newIndex + 1) & mask;
+            }
+            m_slots[newIndex] = slot;
+        }
+        index = probe(topic, hash);
+    }
+
+    uint16_t topicId = static_cast<uint16_t>(m_names.size());
+    m_names.push_back(std::string(topic, strnlen(topic, EventTypeLen)));
+    m_slots[index].hash = hash;
+    m_slots[index].topicId = topicId;
+    return topicId;
+}
+
+const char* TopicInterner::name(uint16_t topicId) const
+{
+    return topicId < m_names.size() ? m_names[topicId].c_str() : "";
+}
+
+// ========== SubscribedDataStore ==========
+
+SubscribedDataStore::SubscribedDataStore()
+    : m_slots(new Slot[INITIAL_DATA_SLOTS])
+    , m_capacity(INITIAL_DATA_SLOTS)
+    , m_count(0)
+    , m_deleted(0)
+    , m_nextGeneration(1)
+    , m_payloadIndex(new PayloadEntry[INITIAL_DATA_SLOTS * 2]())
+{
+}
+
+SubscribedDataStore::~SubscribedDataStore()
+{
+    clear();
+}
+
+uint64_t SubscribedDataStore::makeKey(uint16_t topicId, int64 platformId, int64 componentId)
+{
+    // 组件ID为-1（未指定）时编码为0
+    return (static_cast<uint64_t>(topicId) << 48)
+         | (static_cast<uint64_t>(static_cast<uint16_t>(componentId + 1)) << 32)
+         | static_cast<uint64_t>(static_cast<uint32_t>(platformId));
+}
+
+size_t SubscribedDataStore::hashKey(uint64_t key)
+{
+    // 64位混合（splitmix64终结步）
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return static_cast<size_t>(key);
+}
+
+size_t SubscribedDataStore::hashPayload(const void* payload)
+{
+    return hashKey(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(payload)));
+}
+
+size_t SubscribedDataStore::findSlot(uint64_t key, int64 platformId, int64 componentId) const
+{
+    size_t mask = m_capacity - 1;
+    size_t index = hashKey(key) & mask;
+    for (size_t probed = 0; probed < m_capacity; probed++) {
+        const Slot& slot = m_slots[index];
+        if (slot.state == SLOT_EMPTY) {
+            return NPOS;
+        }
+        if (slot.state == SLOT_USED && slot.key == key &&
+            slot.platformId == platformId && slot.componentId == componentId) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+    return NPOS;
+}
+
+void SubscribedDataStore::rehash(size_t newCapacity)
+{
+    std::unique_ptr<Slot[]> oldSlots(new Slot[newCapacity]);
+    oldSlots.swap(m_slots);
+    size_t oldCapacity = m_capacity;
+    m_capacity = newCapacity;
+    m_deleted = 0;
+
+    size_t mask = m_capacity - 1;
+    for (size_t i = 0; i < oldCapacity; i++) {
+        Slot& oldSlot = oldSlots[i];
+        if (oldSlot.state != SLOT_USED) {
+            continue;
+        }
+        size_t index = hashKey(oldSlot.key) & mask;
+        while (m_slots[index].state != SLOT_EMPTY) {
+            index = (index + 1) & mask;
+        }
+        Slot& slot = m_slots[index];
+        slot.key = oldSlot.key;
+        slot.platformId = oldSlot.platformId;
+        slot.componentId = oldSlot.componentId;
+        slot.generation = oldSlot.generation;
+        slot.state = SLOT_USED;
+        slot.topicId = oldSlot.topicId;
+        slot.data = std::move(oldSlot.data);
+        slot.accessCount.store(oldSlot.accessCount.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        slot.lastAccessTime.store(oldSlot.lastAccessTime.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    // 槽位已变，载荷索引按新容量重建
+    rebuildPayloadIndex();
+}
+
+void SubscribedDataStore::indexPayload(size_t slotIndex)
+{
+    Slot& slot = m_slots[slotIndex];
+    slot.indexedPayload = slot.data ? slot.data->data : nullptr;
+    if (!slot.indexedPayload) {
+        return;
+    }
+
+    size_t mask = m_capacity * 2 - 1;
+    size_t index = hashPayload(slot.indexedPayload) & mask;
+    while (m_payloadIndex[index].payload) {
+        index = (index + 1) & mask;
+    }
+    m_payloadIndex[index].payload = slot.indexedPayload;
+    m_payloadIndex[index].slotIndex = slotIndex;
+}
+
+void SubscribedDataStore::unindexPayload(size_t slotIndex)
+{
+    // 按登记时的指针删除，写入方之后改动CSimData::data也不会留下失效记录
+    Slot& slot = m_slots[slotIndex];
+    const void* payload = slot.indexedPayload;
+    slot.indexedPayload = nullptr;
+    if (!payload) {
+        return;
+    }
+
+    size_t mask = m_capacity * 2 - 1;
+    size_t index = hashPayload(payload) & mask;
+    while (m_payloadIndex[index].payload) {
+        if (m_payloadIndex[index].payload == payload && m_payloadIndex[index].slotIndex == slotIndex) {
+            break;
+        }
+        index = (index + 1) & mask;
+    }
+    if (!m_payloadIndex[index].payload) {
+        return;
+    }
+
+    // 后移补位：把探测链上后续记录移到空出的位置，保证查找遇空槽即可停止
+    size_t hole = index;
+    size_t next = index;
+    for (;;) {
+        next = (next + 1) & mask;
+        if (!m_payloadIndex[next].payload) {
+            break;
+        }
+        size_t home = hashPayload(m_payloadIndex[next].payload) & mask;
+        bool movable = (hole <= next) ? (home <= hole || home > next) : (home <= hole && home > next);
+        if (movable) {
+            m_payloadIndex[hole] = m_payloadIndex[next];
+            hole = next;
+        }
+    }
+    m_payloadIndex[hole].payload = nullptr;
+    m_payloadIndex[hole].slotIndex = 0;
+}
+
+void SubscribedDataStore::rebuildPayloadIndex()
+{
+    m_payloadIndex.reset(new PayloadEntry[m_capacity * 2]());
+    for (size_t i = 0; i < m_capacity; i++) {
+        if (m_slots[i].state == SLOT_USED) {
+            indexPayload(i);
+        }
+    }
+}
+
+bool SubscribedDataStore::put(const char* topic, int64 platformId, int64 componentId, const DataPtr& data, int64 now)
+{
+    uint16_t topicId = m_topics.intern(topic);
+    if (topicId == TopicInterner::INVALID_TOPIC) {
+        return false;
+    }
+
+    uint64_t key = makeKey(topicId, platformId, componentId);
+    size_t index = findSlot(key, platformId, componentId);
+    bool replaced = (index != NPOS);
+
+    if (!replaced) {
+        // 负载（含墓碑）超过70%时扩容或重建
+        if ((m_count + m_deleted + 1) * 10 > m_capacity * 7) {
+            rehash((m_count + 1) * 10 > m_capacity * 5 ? m_capacity * 2 : m_capacity);
+        }
+
+        size_t mask = m_capacity - 1;
+        index = hashKey(key) & mask;
+        while (m_slots[index].state == SLOT_USED) {
+            index = (index + 1) & mask;
+        }
+        if (m_slots[index].state == SLOT_DELETED) {
+            m_deleted--;
+        }
+        m_count++;
+    }
+    else {
+        unindexPayload(index);
+    }
+
+    Slot& slot = m_slots[index];
+    slot.key = key;
+    slot.platformId = platformId;
+    slot.componentId = componentId;
+    slot.generation = m_nextGeneration++;
+    slot.state = SLOT_USED;
+    slot.topicId = topicId;
+    slot.data = data;
+    slot.lastAccessTime.store(now, std::memory_order_relaxed);
+    if (!replaced) {
+        slot.accessCount.store(0, std::memory_order_relaxed);
+    }
+
+    indexPayload(index);
+    pushExpiry(slot);
+    return replaced;
+}
+
+CSimData* SubscribedDataStore::get(const char* topic, int64 platformId, int64 componentId, int64 now) const
+{
+    uint16_t topicId = m_topics.find(topic);
+    if (topicId == TopicInterner::INVALID_TOPIC) {
+        return nullptr;
+    }
+
+    size_t index = findSlot(makeKey(topicId, platformId, componentId), platformId, componentId);
+    if (index == NPOS) {
+        return nullptr;
+    }
+
+    const Slot& slot = m_slots[index];
+    slot.accessCount.fetch_add(1, std::memory_order_relaxed);
+    slot.lastAccessTime.store(now, std::memory_order_relaxed);
+    return slot.data.get();
+}
+
+const SubscribedDataStore::DataPtr* SubscribedDataStore::peek(const char* topic, int64 platformId, int64 componentId) const
+{
+    uint16_t topicId = m_topics.find(topic);
+    if (topicId == TopicInterner::INVALID_TOPIC) {
+        return nullptr;
+    }
+
+    size_t index = findSlot(makeKey(topicId, platformId, componentId), platformId, componentId);
+    return index == NPOS ? nullptr : &m_slots[index].data;
+}
+
+const SubscribedDataStore::DataPtr* SubscribedDataStore::findByPayload(const void* payload) const
+{
+    if (!payload) {
+        return nullptr;
+    }
+
+    size_t mask = m_capacity * 2 - 1;
+    size_t index = hashPayload(payload) & mask;
+    while (m_payloadIndex[index].payload) {
+        const PayloadEntry& entry = m_payloadIndex[index];
+        if (entry.payload == payload) {
+            // 写入方在登记后改动了CSimData::data时按槽位当前内容校验
+            const Slot& slot = m_slots[entry.slotIndex];
+            if (slot.state == SLOT_USED && slot.data && slot.data->data == payload) {
+                return &slot.data;
+            }
+        }
+        index = (index + 1) & mask;
+    }
+    return nullptr;
+}
+
+void SubscribedDataStore::pushExpiry(const Slot& slot)
+{
+    ExpiryEntry entry;
+    entry.dataTime = slot.data ? slot.data->time : 0;
+    entry.key = slot.key;
+    entry.platformId = slot.platformId;
+    entry.componentId = slot.componentId;
+    entry.generation = slot.generation;
+
+    m_expiryHeap.push_back(entry);
+    std::push_heap(m_expiryHeap.begin(), m_expiryHeap.end(),
+                   [](const ExpiryEntry& a, const ExpiryEntry& b) { return expiryLater(a.dataTime, b.dataTime); });
+
+    // 被替换条目留下的旧记录过多时重建堆
+    if (m_expiryHeap.size() > 4 * m_count + 64) {
+        compactExpiryHeap();
+    }
+}
+
+void SubscribedDataStore::compactExpiryHeap()
+{
+    std::vector<ExpiryEntry> live;
+    live.reserve(m_count);
+    for (const ExpiryEntry& entry : m_expiryHeap) {
+        size_t index = findSlot(entry.key, entry.platformId, entry.componentId);
+        if (index != NPOS && m_slots[index].generation == entry.generation) {
+            live.push_back(entry);
+        }
+    }
+    std::make_heap(live.begin(), live.end(),
+                   [](const ExpiryEntry& a, const ExpiryEntry& b) { return expiryLater(a.dataTime, b.dataTime); });
+    m_expiryHeap.swap(live);
+}
+
+int SubscribedDataStore::expire(int64 now, int64 maxAge,
+                                const std::function<void(const char*, int64, int64, int64)>& onRemove)
+{
+    int removed = 0;
+    auto later = [](const ExpiryEntry& a, const ExpiryEntry& b) { return expiryLater(a.dataTime, b.dataTime); };
+
+    // 只弹出堆顶已过期的记录，未过期条目不被扫描
+    while (!m_expiryHeap.empty() && (now - m_expiryHeap.front().dataTime) > maxAge) {
+        ExpiryEntry entry = m_expiryHeap.front();
+        std::pop_heap(m_expiryHeap.begin(), m_expiryHeap.end(), later);
+        m_expiryHeap.pop_back();
+
+        size_t index = findSlot(entry.key, entry.platformId, entry.componentId);
+        if (index == NPOS || m_slots[index].generation != entry.generation) {
+            continue;   // 条目已被替换或删除
+        }
+
+        Slot& slot = m_slots[index];
+        if (onRemove) {
+            onRemove(m_topics.name(slot.topicId), slot.platformId, slot.componentId, entry.dataTime);
+        }
+        unindexPayload(index);
+        slot.data.reset();
+        slot.state = SLOT_DELETED;
+        slot.accessCount.store(0, std::memory_order_relaxed);
+        slot.lastAccessTime.store(0, std::memory_order_relaxed);
+        m_count--;
+        m_deleted++;
+        removed++;
+    }
+
+    return removed;
+}
+
+void SubscribedDataStore::clear()
+{
+    for (size_t i = 0; i < m_capacity; i++) {
+        Slot& slot = m_slots[i];
+        slot.data.reset();
+        slot.indexedPayload = nullptr;
+        slot.state = SLOT_EMPTY;
+        slot.accessCount.store(0, std::memory_order_relaxed);
+        slot.lastAccessTime.store(0, std::memory_order_relaxed);
+    }
+    for (size_t i = 0; i < m_capacity * 2; i++) {
+        m_payloadIndex[i].payload = nullptr;
+        m_payloadIndex[i].slotIndex = 0;
+    }
+    m_count = 0;
+    m_deleted = 0;
+    m_expiryHeap.clear();
+}
+
+void SubscribedDataStore::forEach(const std::function<void(const char*, int64, int64, const DataPtr&, const AccessStats&)>& visitor) const
+{
+    for (size_t i = 0; i < m_capacity; i++) {
+        const Slot& slot = m_slots[i];
+        if (slot.state != SLOT_USED) {
+            continue;
+        }
+        AccessStats stats;
+        stats.accessCount = slot.accessCount.load(std::memory_order_relaxed);
+        stats.lastAccessTime = slot.lastAccessTime.load(std::memory_order_relaxed);
+        visitor(m_topics.name(slot.topicId), slot.platformId, slot.componentId, slot.data, stats);
+    }
+}
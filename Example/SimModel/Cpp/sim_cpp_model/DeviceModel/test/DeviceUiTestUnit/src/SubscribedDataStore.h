@@ -0,0 +1,176 @@
+#ifndef SUBSCRIBEDDATASTORE_H
+#define SUBSCRIBEDDATASTORE_H
+
+#include "CSimModelAgentBase.h"
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <string>
+#include <functional>
+#include "common/TopicHash.h"
+
+/**
+ * 主题驻留表：主题名 -> 16位主题ID
+ * 查找只做哈希和字符串比较，不分配内存；新主题在首次写入时登记
+ */
+class TopicInterner
+{
+public:
+    static const uint16_t INVALID_TOPIC = 0xFFFF;
+
+    TopicInterner();
+
+    /**
+     * 查找主题ID（不登记），未登记返回INVALID_TOPIC
+     */
+    uint16_t find(const char* topic) const;
+
+    /**
+     * 查找或登记主题ID
+     */
+    uint16_t intern(const char* topic);
+
+    /**
+     * 主题ID对应的主题名
+     */
+    const char* name(uint16_t topicId) const;
+
+    size_t size() const { return m_names.size(); }
+
+private:
+    size_t probe(const char* topic, uint32_t hash) const;
+
+    struct Slot {
+        uint32_t hash;
+        uint16_t topicId;       // INVALID_TOPIC 表示空槽
+    };
+
+    std::vector<Slot> m_slots;                  // 容量为2的幂
+    std::vector<std::string> m_names;           // 主题ID -> 主题名
+};
+
+/**
+ * 订阅数据存储（开放寻址哈希表 + 过期堆 + 载荷索引）
+ * 键为64位组合键：主题ID(16位) | 组件ID(16位) | 平台ID(32位)，槽中另存完整的平台/组件ID用于校验；
+ * 载荷索引按写入时的载荷指针（CSimData::data）登记槽位，随写入、替换、过期与扩容同步维护；
+ * 查找不分配内存，访问统计使用原子计数，可被多个模型并发读取；写入/清理须在同一线程进行
+ */
+class SubscribedDataStore
+{
+public:
+    typedef std::shared_ptr<CSimData> DataPtr;
+
+    /**
+     * 条目访问统计
+     */
+    struct AccessStats {
+        uint64_t accessCount;
+        int64 lastAccessTime;
+    };
+
+    SubscribedDataStore();
+    ~SubscribedDataStore();
+
+    /**
+     * 写入或替换条目
+     * @return 替换已有条目返回true
+     */
+    bool put(const char* topic, int64 platformId, int64 componentId, const DataPtr& data, int64 now);
+
+    /**
+     * 查找条目并记录一次访问（不分配内存）
+     * @return 未找到返回nullptr
+     */
+    CSimData* get(const char* topic, int64 platformId, int64 componentId, int64 now) const;
+
+    /**
+     * 查找条目（不记录访问）
+     */
+    const DataPtr* peek(const char* topic, int64 platformId, int64 componentId) const;
+
+    /**
+     * 查找载荷指针所属的条目（查载荷索引，不扫描槽位；不分配内存）
+     */
+    const DataPtr* findByPayload(const void* payload) const;
+
+    /**
+     * 清理数据时间早于now-maxAge的条目
+     * @param onRemove 每删除一个条目回调一次（主题、平台ID、组件ID、数据时间），可为空
+     * @return 删除的条目数
+     */
+    int expire(int64 now, int64 maxAge,
+               const std::function<void(const char*, int64, int64, int64)>& onRemove = nullptr);
+
+    void clear();
+
+    size_t size() const { return m_count; }
+
+    /**
+     * 遍历所有条目（主题、平台ID、组件ID、数据、访问统计）
+     */
+    void forEach(const std::function<void(const char*, int64, int64, const DataPtr&, const AccessStats&)>& visitor) const;
+
+private:
+    // 禁止拷贝和赋值
+    SubscribedDataStore(const SubscribedDataStore&) = delete;
+    SubscribedDataStore& operator=(const SubscribedDataStore&) = delete;
+
+    enum SlotState { SLOT_EMPTY = 0, SLOT_USED = 1, SLOT_DELETED = 2 };
+
+    struct Slot {
+        uint64_t key;
+        int64 platformId;
+        int64 componentId;
+        uint32_t generation;                        // 每次写入递增，用于识别过期堆中的旧记录
+        uint8_t state;
+        uint16_t topicId;
+        DataPtr data;
+        const void* indexedPayload;                 // 登记到载荷索引的载荷指针，未登记为nullptr
+        mutable std::atomic<uint64_t> accessCount;
+        mutable std::atomic<int64> lastAccessTime;
+
+        Slot() : key(0), platformId(0), componentId(-1), generation(0), state(SLOT_EMPTY),
+                 topicId(TopicInterner::INVALID_TOPIC), indexedPayload(nullptr),
+                 accessCount(0), lastAccessTime(0) {}
+    };
+
+    // 过期堆记录（按数据时间的小顶堆，条目替换后旧记录惰性丢弃）
+    struct ExpiryEntry {
+        int64 dataTime;
+        uint64_t key;
+        int64 platformId;
+        int64 componentId;
+        uint32_t generation;
+    };
+
+    // 载荷索引记录（线性探测，删除时后移补位，不留墓碑；同一载荷可登记多个槽位）
+    struct PayloadEntry {
+        const void* payload;                        // nullptr 表示空槽
+        size_t slotIndex;
+    };
+
+    static uint64_t makeKey(uint16_t topicId, int64 platformId, int64 componentId);
+    static size_t hashKey(uint64_t key);
+    static size_t hashPayload(const void* payload);
+
+    size_t findSlot(uint64_t key, int64 platformId, int64 componentId) const;
+    void rehash(size_t newCapacity);
+    void pushExpiry(const Slot& slot);
+    void indexPayload(size_t slotIndex);
+    void unindexPayload(size_t slotIndex);
+    void rebuildPayloadIndex();
+    void compactExpiryHeap();
+
+    TopicInterner m_topics;
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_capacity;              // 2的幂
+    size_t m_count;                 // 有效条目数
+    size_t m_deleted;               // 墓碑数
+    uint32_t m_nextGeneration;
+    std::vector<ExpiryEntry> m_expiryHeap;
+    std::unique_ptr<PayloadEntry[]> m_payloadIndex; // 容量为m_capacity的2倍，负载不超过35%
+
+    static const size_t NPOS = static_cast<size_t>(-1);
+};
+
+#endif // SUBSCRIBEDDATASTORE_H
@@ -1,5 +1,5 @@
 #include "mainwindow.h"
-#include <random>
+#include "common/CounterRng.h"
 #include <chrono>
 #include <cstring>
 #include <QSplitter>
@@ -20,6 +20,17 @@ const QList<QColor> MainWindow::SONAR_COLORS = {
     QColor(255, 0, 255, 119)     // 细拖声纳 - 洋红色，80%透明
 };
 
+// 合成频谱噪声的随机流子通道（与实体ID组合为流标识）
+enum SyntheticNoiseChannel
+{
+    NOISE_CHANNEL_PROPAGATED = 0,       // 目标传播声
+    NOISE_CHANNEL_ENVIRONMENT = 1,      // 海洋环境噪声
+    NOISE_CHANNEL_SELF_SOUND = 16       // 平台自噪声（加声纳ID）
+};
+
+// 一条频谱的噪声占用的随机块数（每块4个值）
+const uint64_t SPECTRUM_NOISE_BLOCKS = (5296 + 3) / 4;
+
 // 构造函数
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
@@ -35,6 +46,8 @@ MainWindow::MainWindow(QWidget *parent)
     , m_dataGenerationTimer(nullptr)
     , m_platformSelfSoundSent(false)
     , m_environmentNoiseSent(false)
+    , m_scenarioSeed(1)
+    , m_propagatedSoundBatch(0)
 {
     // 设置窗口属性
     setWindowTitle("多目标声纳系统导调平台");
@@ -72,6 +85,12 @@ MainWindow::MainWindow(QWidget *parent)
     if (m_component && m_agent) {
         m_component->init(m_agent, nullptr);
         m_component->start();
+
+        // 代理支持载荷借用，模型直接引用传播声/噪声频谱而不拷贝
+        DeviceModel* deviceModel = dynamic_cast<DeviceModel*>(m_component);
+        if (deviceModel) {
+            deviceModel->setBorrowedPayloadEnabled(true);
+        }
         addLog("多目标声纳模型初始化完成");
     } else {
         addLog("错误：声纳模型初始化失败");
@@ -784,7 +803,10 @@ void MainWindow::generateAndSendPropagatedSoundData(const QVector<ChartPlatform>
 
     try {
         // 即使目标列表为空，也创建并发送数据结构
-        CMsg_PropagatedContinuousSoundListStruct continuousSound = createPropagatedSoundData(targetPlatforms);
+        // 载荷放在堆上并登记到代理，模型可借用频谱直到目标过期或被替换
+        std::shared_ptr<CMsg_PropagatedContinuousSoundListStruct> continuousSound =
+            std::make_shared<CMsg_PropagatedContinuousSoundListStruct>(createPropagatedSoundData(targetPlatforms));
+        m_agent->lendMessagePayload(continuousSound);
 
         // 创建消息
         CSimMessage continuousMsg;
@@ -793,12 +815,12 @@ void MainWindow::generateAndSendPropagatedSoundData(const QVector<ChartPlatform>
         continuousMsg.sender = 1;
         continuousMsg.senderComponentId = 1;
         continuousMsg.receiver = 1;
-        continuousMsg.data = &continuousSound;
-        continuousMsg.length = sizeof(continuousSound);
+        continuousMsg.data = continuousSound.get();
+        continuousMsg.length = sizeof(CMsg_PropagatedContinuousSoundListStruct);
         memcpy(continuousMsg.topic, MSG_PropagatedContinuousSound, strlen(MSG_PropagatedContinuousSound) + 1);
 
-        // 发送给声纳模型
-        m_component->onMessage(&continuousMsg);
+        // 经代理投递给声纳模型（按模型订阅的过滤条件剔除探测范围外的目标）
+        m_agent->deliverMessage(m_component, &continuousMsg);
 
         if (targetPlatforms.isEmpty()) {
             addLog("已发送空的传播声数据（清空目标）");
@@ -820,11 +842,6 @@ CMsg_PropagatedContinuousSoundListStruct MainWindow::createPropagatedSoundData(c
     // 获取本艇位置
     QPointF ownShipPos = m_seaChartWidget->getOwnShipPosition();
 
-    // 随机数生成器
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> signalDist(60.0f, 85.0f); // 信号强度范围
-
     for (const auto& target : targetPlatforms) {
         C_PropagatedContinuousSoundStruct soundData;
 
@@ -857,12 +874,14 @@ CMsg_PropagatedContinuousSoundListStruct MainWindow::createPropagatedSoundData(c
 //        baseSignalLevel = std::max(40.0f, std::min(85.0f, baseSignalLevel)); // 限制在40-85dB范围
         baseSignalLevel = std::max(10.0f, std::min(120.0f, baseSignalLevel));
 
+        // 随机变化：每个目标一条流，每批取流中的下一段，同一种子下整个过程可复现
+        CounterRng rng(m_scenarioSeed, CounterRng::streamOf(target.id, NOISE_CHANNEL_PROPAGATED));
+        rng.seek(m_propagatedSoundBatch * SPECTRUM_NOISE_BLOCKS);
+        rng.fillUniform(soundData.spectrumData, 5296, 5.95f, 8.45f); // 信号强度60~85dB的0.1倍减0.05
+
         for (int i = 0; i < 5296; i++) {
-            // 一些随机变化和频率特性
             float freqFactor = 1.0f + 0.1f * sin(i * 0.01f); // 模拟频率响应
-            float randomVariation = signalDist(gen) * 0.1f - 0.05f; // ±5%随机变化
-
-            soundData.spectrumData[i] = baseSignalLevel * freqFactor + randomVariation;
+            soundData.spectrumData[i] += baseSignalLevel * freqFactor;
         }
 
         soundListStruct.propagatedContinuousList.push_back(soundData);
@@ -873,6 +892,7 @@ CMsg_PropagatedContinuousSoundListStruct MainWindow::createPropagatedSoundData(c
                .arg(bearing, 0, 'f', 1)
                .arg(baseSignalLevel, 0, 'f', 1));
     }
+    m_propagatedSoundBatch++;
 
     return soundListStruct;
 }
@@ -915,10 +935,7 @@ void MainWindow::generateAndSendPlatformSelfSoundData()
 CData_PlatformSelfSound* MainWindow::createPlatformSelfSoundData()
 {
     CData_PlatformSelfSound* platformSelfSound = new CData_PlatformSelfSound();
-
-    // 随机数生成器
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    int64 platformId = m_agent->getPlatformEntity()->id;
 
     // 修正：只为4个声纳位置创建自噪声数据（ID 0-3）
     for (int sonarID = 0; sonarID < 4; sonarID++) {
@@ -948,16 +965,16 @@ CData_PlatformSelfSound* MainWindow::createPlatformSelfSoundData()
                 break;
         }
 
-        std::uniform_real_distribution<float> noiseDist(
-            baseNoiseLevel - noiseVariation/2,
-            baseNoiseLevel + noiseVariation/2
-        );
+        // 噪声级在基准附近均匀分布（每个声纳一条随机流）
+        CounterRng rng(m_scenarioSeed, CounterRng::streamOf(platformId, NOISE_CHANNEL_SELF_SOUND + sonarID));
+        rng.fillUniform(spectrumStruct.spectumData, 5296,
+                        baseNoiseLevel - noiseVariation/2, baseNoiseLevel + noiseVariation/2);
 
         // 生成频谱数据
         for (int i = 0; i < 5296; i++) {
             // 频率相关的噪声特性
             float freqFactor = 1.0f - 0.3f * (i / 5296.0f); // 高频噪声衰减
-            spectrumStruct.spectumData[i] = noiseDist(gen) * freqFactor;
+            spectrumStruct.spectumData[i] *= freqFactor;
         }
 
         platformSelfSound->selfSoundSpectrumList.push_back(spectrumStruct);
@@ -979,7 +996,9 @@ void MainWindow::generateAndSendEnvironmentNoiseData()
 
     try {
         // 创建环境噪声数据
-        CMsg_EnvironmentNoiseToSonarStruct envNoise = createEnvironmentNoiseData();
+        std::shared_ptr<CMsg_EnvironmentNoiseToSonarStruct> envNoise =
+            std::make_shared<CMsg_EnvironmentNoiseToSonarStruct>(createEnvironmentNoiseData());
+        m_agent->lendMessagePayload(envNoise);
 
         // 创建消息
         CSimMessage envMsg;
@@ -988,8 +1007,8 @@ void MainWindow::generateAndSendEnvironmentNoiseData()
         envMsg.sender = 1;
         envMsg.senderComponentId = 1;
         envMsg.receiver = 1;
-        envMsg.data = &envNoise;
-        envMsg.length = sizeof(envNoise);
+        envMsg.data = envNoise.get();
+        envMsg.length = sizeof(CMsg_EnvironmentNoiseToSonarStruct);
         memcpy(envMsg.topic, MSG_EnvironmentNoiseToSonar, strlen(MSG_EnvironmentNoiseToSonar) + 1);
 
         // 发送给声纳模型
@@ -1012,10 +1031,9 @@ CMsg_EnvironmentNoiseToSonarStruct MainWindow::createEnvironmentNoiseData()
     // 设置环境参数
     envNoise.acousticVel = 1500.0f; // 声速 m/s
 
-    // 生成模拟的环境噪声频谱数据
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> envNoiseDist(20.0f, 35.0f);  // 20-35 dB
+    // 生成模拟的环境噪声频谱数据（20-35 dB）
+    CounterRng rng(m_scenarioSeed, CounterRng::streamOf(0, NOISE_CHANNEL_ENVIRONMENT));
+    rng.fillUniform(envNoise.spectrumData, 5296, 20.0f, 35.0f);
 
     for (int i = 0; i < 5296; i++) {
         // 模拟海洋环境噪声的频率特性
@@ -1023,7 +1041,7 @@ CMsg_EnvironmentNoiseToSonarStruct MainWindow::createEnvironmentNoiseData()
         float freqRatio = static_cast<float>(i) / 5296.0f;
         float freqFactor = 1.5f - freqRatio; // 高频衰减
 
-        envNoise.spectrumData[i] = envNoiseDist(gen) * freqFactor;
+        envNoise.spectrumData[i] *= freqFactor;
     }
 
     addLog("环境噪声特性: 20-35dB，低频偏高，高频衰减");
@@ -1092,6 +1110,8 @@ QString MainWindow::formatSonarResults(const std::map<int, std::vector<DeviceMod
                                      .arg(target.equationResult, 0, 'f', 2)
                                      .arg(target.targetDistance / 1000.0, 0, 'f', 1)
                                      .arg(target.targetBearing, 0, 'f', 1);
+                    } else if (target.pruned) {
+                        resultText += QString(" 目标%1: 低于阈值（上界剪枝，未计算X）\n").arg(target.targetId);
                     } else {
                         resultText += QString(" 目标%1: 计算失败\n").arg(target.targetId);
                     }
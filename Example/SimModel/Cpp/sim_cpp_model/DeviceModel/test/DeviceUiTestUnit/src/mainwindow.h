@@ -185,6 +185,8 @@ private:
     QVector<ChartPlatform> m_currentTargets;        // 当前目标列表
     bool m_platformSelfSoundSent;                   // 平台自噪声是否已发送
     bool m_environmentNoiseSent;                    // 环境噪声是否已发送
+    uint64_t m_scenarioSeed;                        // 合成频谱噪声的随机种子（相同种子生成相同数据）
+    uint64_t m_propagatedSoundBatch;                // 已生成的传播声批次（决定每批噪声在随机流中的位置）
 
     //========== 声纳配置信息 ==========//
     static const QStringList SONAR_NAMES;          // 声纳名称列表
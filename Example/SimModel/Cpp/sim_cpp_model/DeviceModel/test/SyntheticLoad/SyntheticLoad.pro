@@ -0,0 +1,36 @@
+TEMPLATE = lib
+# 合成传播声负载发生器：静态库，供压测工具链接（本目录的测试工具直接编入源文件）
+CONFIG += c++11 staticlib
+CONFIG -= qt
+
+INCLUDEPATH += \
+    $$PWD/../../../../../../../SDK/SimModel/Cpp/include/ \
+    $$PWD/../../src/ \
+    $$PWD/src/
+
+win32 {
+    CONFIG(debug,debug|release){
+        DESTDIR = $$PWD/../../../bin2/winDebug/
+    }
+    else {
+        DESTDIR = $$PWD/../../../bin2/winRelease/
+    }
+}
+else {
+    CONFIG(debug,debug|release){
+        DESTDIR = $$PWD/../../../bin2/linuxDebug/
+    }
+    else {
+        DESTDIR = $$PWD/../../../bin2/linuxRelease/
+    }
+}
+
+# 扁平传播声缓冲与发生器一起编入，链接方无需再编组件源文件
+SOURCES += \
+        src/SyntheticLoadGenerator.cpp \
+        ../../src/FlatSoundList.cpp
+
+HEADERS += \
+    src/SyntheticLoadGenerator.h \
+    ../../src/FlatSoundList.h \
+    ../../src/common/CounterRng.h
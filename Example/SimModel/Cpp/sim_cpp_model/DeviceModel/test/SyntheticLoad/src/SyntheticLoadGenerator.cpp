@@ -0,0 +1,217 @@
+#include "SyntheticLoadGenerator.h"
+#include "common/CounterRng.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+const int SyntheticLoadGenerator::SHAPE_COUNT;
+const int SyntheticLoadGenerator::NOISE_POOL_SIZE;
+
+namespace {
+
+const double PI = 3.14159265358979323846;
+
+// 随机流子通道（与步号组合为流标识）
+enum RandomChannel
+{
+    CHANNEL_CONTACTS = 0,       // 目标分布
+    CHANNEL_NOISE_POOL = 1,     // 每步噪声池
+    CHANNEL_NOISE_OFFSET = 2    // 每步各目标的噪声起点
+};
+
+static_assert((SyntheticLoadGenerator::NOISE_POOL_SIZE & (SyntheticLoadGenerator::NOISE_POOL_SIZE - 1)) == 0,
+              "NOISE_POOL_SIZE must be a power of two");
+
+/**
+ * log2近似：拆出指数，尾数m∈[1,2)按 log2(m) = 2/ln2 * atanh(t)，t=(m-1)/(m+1)∈[0,1/3) 取到t^7项，
+ * 截断误差约2e-5（折合扩散损失约5e-5dB）。无分支，可在循环中向量化
+ */
+inline float log2Approx(float value)
+{
+    uint32 bits;
+    memcpy(&bits, &value, sizeof(bits));
+    float exponent = static_cast<float>(static_cast<int>(bits >> 23) - 127);
+    bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+    float mantissa;
+    memcpy(&mantissa, &bits, sizeof(mantissa));
+
+    float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+    float t2 = t * t;
+    float series = t * (1.0f + t2 * (1.0f / 3.0f + t2 * (1.0f / 5.0f + t2 * (1.0f / 7.0f))));
+    return exponent + 2.8853900817779268f * series;   // 2/ln2
+}
+
+}
+
+SyntheticLoadGenerator::SyntheticLoadGenerator(const SyntheticLoadConfig& config)
+    : m_config(config)
+    , m_ownX(0.0)
+    , m_ownY(0.0)
+    , m_tick(0)
+{
+    // 频谱形状：各类型的线谱位置与宽带斜率不同
+    for (int type = 0; type < SHAPE_COUNT; type++) {
+        std::vector<float>& shape = m_shapes[type];
+        shape.resize(FLAT_SOUND_SPECTRUM_SIZE);
+        float slope = 0.15f + 0.05f * type;
+        int lineBin = 200 + 350 * type;
+        for (int i = 0; i < FLAT_SOUND_SPECTRUM_SIZE; i++) {
+            float freqRatio = static_cast<float>(i) / FLAT_SOUND_SPECTRUM_SIZE;
+            float line = (std::abs(i - lineBin) < 4) ? 0.08f : 0.0f;
+            shape[i] = 1.0f - slope * freqRatio + 0.05f * sinf(i * 0.01f * (type + 1)) + line;
+        }
+    }
+}
+
+void SyntheticLoadGenerator::populate()
+{
+    std::vector<SyntheticContact> contacts(static_cast<size_t>(std::max(0, m_config.contacts)));
+
+    CounterRng rng(m_config.seed, CounterRng::streamOf(0, CHANNEL_CONTACTS));
+    for (SyntheticContact& contact : contacts) {
+        double bearingRad = rng.uniform(0.0f, 360.0f) * PI / 180.0;
+        double range = m_config.minRange + (m_config.maxRange - m_config.minRange) * rng.nextFloat();
+        double headingRad = rng.uniform(0.0f, 360.0f) * PI / 180.0;
+        double speed = m_config.minSpeed + (m_config.maxSpeed - m_config.minSpeed) * rng.nextFloat();
+        contact.x = m_ownX + range * sin(bearingRad);
+        contact.y = m_ownY + range * cos(bearingRad);
+        contact.velocityX = speed * sin(headingRad);
+        contact.velocityY = speed * cos(headingRad);
+        contact.sourceLevel = rng.uniform(m_config.minSourceLevel, m_config.maxSourceLevel);
+        contact.platType = static_cast<int>(rng.nextUInt32() % SHAPE_COUNT);
+    }
+    setContacts(contacts);
+}
+
+void SyntheticLoadGenerator::setContacts(const std::vector<SyntheticContact>& contacts)
+{
+    size_t count = contacts.size();
+    m_x.resize(count);
+    m_y.resize(count);
+    m_velocityX.resize(count);
+    m_velocityY.resize(count);
+    m_sourceLevel.resize(count);
+    m_platType.resize(count);
+    m_rangeSquared.resize(count);
+    m_loss.resize(count);
+    m_level.resize(count);
+    m_noiseOffset.resize(count);
+
+    for (size_t i = 0; i < count; i++) {
+        m_x[i] = contacts[i].x;
+        m_y[i] = contacts[i].y;
+        m_velocityX[i] = contacts[i].velocityX;
+        m_velocityY[i] = contacts[i].velocityY;
+        m_sourceLevel[i] = contacts[i].sourceLevel;
+        m_platType[i] = shapeIndex(contacts[i].platType);
+    }
+
+    updateLevels();
+    updateNoise();
+}
+
+void SyntheticLoadGenerator::setOwnPosition(double x, double y)
+{
+    m_ownX = x;
+    m_ownY = y;
+    updateLevels();
+}
+
+void SyntheticLoadGenerator::advance(double dtSeconds)
+{
+    size_t count = m_x.size();
+    for (size_t i = 0; i < count; i++) {
+        m_x[i] += m_velocityX[i] * dtSeconds;
+        m_y[i] += m_velocityY[i] * dtSeconds;
+    }
+
+    m_tick++;
+    updateLevels();
+    updateNoise();
+}
+
+void SyntheticLoadGenerator::sphericalSpreadingLoss(const float* rangeSquared, float* tl, size_t count)
+{
+    // TL = 20*log10(R) = 10*log10(R^2) = 10*log10(2) * log2(R^2)，省去开方
+    const float tenLog10Of2 = 3.0102999566398120f;
+    for (size_t i = 0; i < count; i++) {
+        tl[i] = tenLog10Of2 * log2Approx(std::max(1.0f, rangeSquared[i]));
+    }
+}
+
+void SyntheticLoadGenerator::updateLevels()
+{
+    size_t count = m_x.size();
+    for (size_t i = 0; i < count; i++) {
+        double deltaX = m_x[i] - m_ownX;
+        double deltaY = m_y[i] - m_ownY;
+        m_rangeSquared[i] = static_cast<float>(deltaX * deltaX + deltaY * deltaY);
+    }
+
+    sphericalSpreadingLoss(m_rangeSquared.data(), m_loss.data(), count);
+
+    float minLevel = m_config.minReceivedLevel;
+    float maxLevel = m_config.maxReceivedLevel;
+    for (size_t i = 0; i < count; i++) {
+        m_level[i] = std::max(minLevel, std::min(maxLevel, m_sourceLevel[i] - m_loss[i]));
+    }
+}
+
+void SyntheticLoadGenerator::updateNoise()
+{
+    if (m_config.noiseDb <= 0.0f) {
+        m_noisePool.clear();
+        return;
+    }
+
+    int64 tick = static_cast<int64>(m_tick);
+    m_noisePool.resize(NOISE_POOL_SIZE + FLAT_SOUND_SPECTRUM_SIZE);
+    CounterRng poolRng(m_config.seed, CounterRng::streamOf(tick, CHANNEL_NOISE_POOL));
+    poolRng.fillUniform(m_noisePool.data(), m_noisePool.size(), -m_config.noiseDb, m_config.noiseDb);
+
+    CounterRng offsetRng(m_config.seed, CounterRng::streamOf(tick, CHANNEL_NOISE_OFFSET));
+    offsetRng.fillUInt32(m_noiseOffset.data(), m_noiseOffset.size());
+    for (size_t i = 0; i < m_noiseOffset.size(); i++) {
+        m_noiseOffset[i] &= NOISE_POOL_SIZE - 1;
+    }
+}
+
+void SyntheticLoadGenerator::fillPropagatedSound(FlatSoundListBuffer& buffer, int64 simTime) const
+{
+    buffer.clear();
+    buffer.setTime(simTime);
+    buffer.reserve(static_cast<uint32>(m_x.size()));
+
+    bool noisy = !m_noisePool.empty();
+    for (size_t i = 0; i < m_x.size(); i++) {
+        double deltaX = m_x[i] - m_ownX;
+        double deltaY = m_y[i] - m_ownY;
+        double distance = std::max(1.0, sqrt(deltaX * deltaX + deltaY * deltaY));
+
+        double bearing = atan2(deltaX, deltaY) * 180.0 / PI;
+        if (bearing < 0) bearing += 360.0;
+
+        CFlatSoundRecord& record = buffer.append();
+        record.targetDistance = static_cast<float>(distance);
+        record.arrivalSideAngle = static_cast<float>(bearing);
+        record.arrivalPitchAngle = 0.0f;
+        record.platType = m_platType[i];
+        record.arrivalTime = simTime;
+
+        // 接收级 * 形状 (+ 噪声)
+        float level = m_level[i];
+        const float* shape = m_shapes[m_platType[i]].data();
+        float* spectrum = record.spectrumData;
+        if (noisy) {
+            const float* noise = m_noisePool.data() + m_noiseOffset[i];
+            for (int k = 0; k < FLAT_SOUND_SPECTRUM_SIZE; k++) {
+                spectrum[k] = level * shape[k] + noise[k];
+            }
+        } else {
+            for (int k = 0; k < FLAT_SOUND_SPECTRUM_SIZE; k++) {
+                spectrum[k] = level * shape[k];
+            }
+        }
+    }
+}
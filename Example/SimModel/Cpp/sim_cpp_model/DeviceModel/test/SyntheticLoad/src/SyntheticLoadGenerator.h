@@ -0,0 +1,155 @@
+#ifndef SYNTHETICLOADGENERATOR_H
+#define SYNTHETICLOADGENERATOR_H
+
+#include <vector>
+#include "SimBasicTypes.h"
+#include "FlatSoundList.h"
+
+/**
+ * 合成负载配置
+ */
+struct SyntheticLoadConfig
+{
+    int contacts;                   // populate生成的目标数
+    uint64 seed;                    // 随机种子（目标分布与逐步噪声都由它决定）
+    double minRange;                // 目标初始距离下限（米）
+    double maxRange;                // 目标初始距离上限（米）
+    double minSpeed;                // 目标航速下限（m/s）
+    double maxSpeed;                // 目标航速上限（m/s）
+    float minSourceLevel;           // 辐射噪声源级下限（dB）
+    float maxSourceLevel;           // 辐射噪声源级上限（dB）
+    float minReceivedLevel;         // 接收级下限（dB），扩散损失后截断
+    float maxReceivedLevel;         // 接收级上限（dB）
+    float noiseDb;                  // 逐频点噪声幅度（±dB），0为无噪声
+
+    SyntheticLoadConfig()
+        : contacts(1000)
+        , seed(1)
+        , minRange(1000.0)
+        , maxRange(40000.0)
+        , minSpeed(2.0)
+        , maxSpeed(12.0)
+        , minSourceLevel(110.0f)
+        , maxSourceLevel(145.0f)
+        , minReceivedLevel(10.0f)
+        , maxReceivedLevel(120.0f)
+        , noiseDb(0.5f)
+    {
+    }
+};
+
+/**
+ * 合成目标（场景坐标：东向x、北向y，米）
+ */
+struct SyntheticContact
+{
+    double x;
+    double y;
+    double velocityX;               // 东向速度（m/s）
+    double velocityY;               // 北向速度（m/s）
+    float sourceLevel;              // 辐射噪声源级（dB）
+    int platType;                   // 目标类型（决定频谱形状，0 ~ SHAPE_COUNT-1）
+
+    SyntheticContact() : x(0.0), y(0.0), velocityX(0.0), velocityY(0.0), sourceLevel(0.0f), platType(0) {}
+};
+
+/**
+ * 合成传播声负载发生器：为上千个目标每步生成扁平传播声列表，用于按真实演练规模压测组件
+ * 与界面测试程序逐目标逐频点调用sin()和分布抽样不同，开销集中在三处向量化的循环：
+ * - 频谱形状按目标类型预先成表，逐频点只有一次乘加；
+ * - 球面扩散损失 TL = 10*log10(R^2) 对全部目标成批计算（无分支的对数近似，误差小于0.001dB）；
+ * - 噪声每步成批生成一个噪声池（计数器随机数），各目标从池中按随机偏移取一段。
+ * 目标以结构数组保存。相同配置与种子下每步输出完全相同，与线程和调用时机无关。
+ * 独立于组件与代理（只依赖扁平传播声格式），可编入任何测试工具或单独编为静态库（SyntheticLoad.pro）
+ */
+class SyntheticLoadGenerator
+{
+public:
+    static const int SHAPE_COUNT = 4;               // 频谱形状表数量
+    static const int NOISE_POOL_SIZE = 65536;       // 噪声池中可作为起点的位置数
+
+    explicit SyntheticLoadGenerator(const SyntheticLoadConfig& config);
+
+    /**
+     * 按配置在本平台周围随机生成config.contacts个目标（替换现有目标）
+     */
+    void populate();
+
+    /**
+     * 使用给定目标（替换现有目标），platType超出范围时按取模选形状
+     */
+    void setContacts(const std::vector<SyntheticContact>& contacts);
+
+    /**
+     * 本平台位置（场景坐标，米）
+     */
+    void setOwnPosition(double x, double y);
+
+    /**
+     * 推进dtSeconds秒：各目标航位推算、重算接收级，并生成下一步的噪声
+     */
+    void advance(double dtSeconds);
+
+    /**
+     * 按当前状态生成全部目标的传播声记录（缓冲先清空），不修改发生器状态
+     */
+    void fillPropagatedSound(FlatSoundListBuffer& buffer, int64 simTime) const;
+
+    int contactCount() const { return static_cast<int>(m_x.size()); }
+
+    /**
+     * 已推进的步数（噪声在随机流中的位置）
+     */
+    uint64 tick() const { return m_tick; }
+
+    /**
+     * 某类型的频谱形状表（FLAT_SOUND_SPECTRUM_SIZE点）
+     */
+    const float* spectrumShape(int platType) const { return m_shapes[shapeIndex(platType)].data(); }
+
+    /**
+     * 成批计算球面扩散损失：tl[i] = 10*log10(max(1, rangeSquared[i]))（dB）
+     */
+    static void sphericalSpreadingLoss(const float* rangeSquared, float* tl, size_t count);
+
+private:
+    static int shapeIndex(int platType)
+    {
+        int index = platType % SHAPE_COUNT;
+        return index < 0 ? index + SHAPE_COUNT : index;
+    }
+
+    /**
+     * 按当前几何关系重算各目标的距离平方、接收级
+     */
+    void updateLevels();
+
+    /**
+     * 生成当前步的噪声池与各目标取噪声的偏移
+     */
+    void updateNoise();
+
+    SyntheticLoadConfig m_config;
+    double m_ownX;
+    double m_ownY;
+    uint64 m_tick;
+
+    // 目标（结构数组）
+    std::vector<double> m_x;
+    std::vector<double> m_y;
+    std::vector<double> m_velocityX;
+    std::vector<double> m_velocityY;
+    std::vector<float> m_sourceLevel;
+    std::vector<int> m_platType;
+
+    // 每步派生量
+    std::vector<float> m_rangeSquared;              // 距离平方（米^2）
+    std::vector<float> m_loss;                      // 扩散损失（dB）
+    std::vector<float> m_level;                     // 截断后的接收级（dB）
+    std::vector<uint32> m_noiseOffset;              // 在噪声池中的起点
+
+    std::vector<float> m_shapes[SHAPE_COUNT];       // 各类型目标的频谱形状
+    std::vector<float> m_noisePool;                 // NOISE_POOL_SIZE + 频谱点数
+};
+
+#endif // SYNTHETICLOADGENERATOR_H
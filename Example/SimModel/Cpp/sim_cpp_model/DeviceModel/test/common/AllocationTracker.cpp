@@ -0,0 +1,331 @@
+#include "AllocationTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define ALLOCATION_CALLER() _ReturnAddress()
+#else
+#define ALLOCATION_CALLER() __builtin_return_address(0)
+#endif
+
+#if defined(__GLIBC__) || defined(__linux__)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#define ALLOCATION_HAS_BACKTRACE 1
+#endif
+
+const int AllocationTracker::MAX_SCOPES;
+const int AllocationTracker::STACK_DEPTH;
+const int AllocationTracker::MAX_CALL_SITES;
+
+namespace {
+
+const int MAX_SCOPE_NESTING = 8;
+
+/**
+ * 调用点表项：hash非零即已占用，ready置位后frames可读
+ */
+struct CallSiteSlot
+{
+    std::atomic<uint64_t> hash;
+    std::atomic<bool> ready;
+    std::atomic<uint64_t> allocations;
+    std::atomic<uint64_t> bytes;
+    int scope;
+    int depth;
+    void* frames[AllocationTracker::STACK_DEPTH];
+};
+
+// 静态存储零初始化，首次分配（可能早于main）即可使用
+std::atomic<uint64_t> g_allocations[AllocationTracker::MAX_SCOPES];
+std::atomic<uint64_t> g_bytes[AllocationTracker::MAX_SCOPES];
+std::atomic<bool> g_callSitesEnabled;
+std::atomic<uint64_t> g_droppedCallSites;
+CallSiteSlot g_callSites[AllocationTracker::MAX_CALL_SITES];
+const char* g_scopeNames[AllocationTracker::MAX_SCOPES];
+
+thread_local int t_scopeStack[MAX_SCOPE_NESTING];
+thread_local int t_scopeDepth = 0;
+thread_local bool t_inHook = false;
+thread_local void* t_caller = nullptr;
+
+int currentScope()
+{
+    int depth = std::min(t_scopeDepth, MAX_SCOPE_NESTING);
+    return depth > 0 ? t_scopeStack[depth - 1] : 0;
+}
+
+/**
+ * 取调用栈：frames[0]为调用operator new的位置，其后为外层调用者
+ */
+int captureStack(void* caller, void** frames)
+{
+    int depth = 0;
+#ifdef ALLOCATION_HAS_BACKTRACE
+    void* raw[AllocationTracker::STACK_DEPTH + 8];
+    int count = backtrace(raw, AllocationTracker::STACK_DEPTH + 8);
+    for (int i = 0; i < count; i++) {
+        if (raw[i] == caller) {
+            for (int j = i; j < count && depth < AllocationTracker::STACK_DEPTH; j++) {
+                frames[depth++] = raw[j];
+            }
+            break;
+        }
+    }
+#endif
+    if (depth == 0) {
+        frames[depth++] = caller;
+    }
+    return depth;
+}
+
+void recordCallSite(size_t bytes, int scope, void* caller)
+{
+    void* frames[AllocationTracker::STACK_DEPTH] = {};
+    int depth = captureStack(caller, frames);
+
+    // FNV-1a（栈帧与作用域）
+    uint64_t hash = 1469598103934665603ULL;
+    for (int i = 0; i < depth; i++) {
+        hash = (hash ^ reinterpret_cast<uintptr_t>(frames[i])) * 1099511628211ULL;
+    }
+    hash = (hash ^ static_cast<uint64_t>(scope)) * 1099511628211ULL;
+    if (hash == 0) {
+        hash = 1;
+    }
+
+    for (int probe = 0; probe < AllocationTracker::MAX_CALL_SITES; probe++) {
+        CallSiteSlot& slot = g_callSites[(hash + probe) % AllocationTracker::MAX_CALL_SITES];
+        uint64_t current = slot.hash.load(std::memory_order_acquire);
+        if (current == 0) {
+            uint64_t expected = 0;
+            if (slot.hash.compare_exchange_strong(expected, hash, std::memory_order_acq_rel)) {
+                slot.scope = scope;
+                slot.depth = depth;
+                for (int i = 0; i < AllocationTracker::STACK_DEPTH; i++) {
+                    slot.frames[i] = frames[i];
+                }
+                slot.ready.store(true, std::memory_order_release);
+                current = hash;
+            } else {
+                current = expected;
+            }
+        }
+        if (current == hash) {
+            slot.allocations.fetch_add(1, std::memory_order_relaxed);
+            slot.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            return;
+        }
+    }
+    g_droppedCallSites.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* trackedAllocate(size_t size, void* caller)
+{
+    t_caller = caller;
+    AllocationTracker::recordAllocation(size);
+    return malloc(size > 0 ? size : 1);
+}
+
+}
+
+void AllocationTracker::setScopeName(int scope, const char* name)
+{
+    if (scope >= 0 && scope < MAX_SCOPES) {
+        g_scopeNames[scope] = name;
+    }
+}
+
+const char* AllocationTracker::scopeName(int scope)
+{
+    if (scope < 0 || scope >= MAX_SCOPES) {
+        return "invalid";
+    }
+    return g_scopeNames[scope] ? g_scopeNames[scope] : (scope == 0 ? "untracked" : "unnamed");
+}
+
+void AllocationTracker::enterScope(int scope)
+{
+    if (t_scopeDepth < MAX_SCOPE_NESTING) {
+        t_scopeStack[t_scopeDepth] = (scope >= 0 && scope < MAX_SCOPES) ? scope : 0;
+    }
+    t_scopeDepth++;
+}
+
+void AllocationTracker::leaveScope()
+{
+    if (t_scopeDepth > 0) {
+        t_scopeDepth--;
+    }
+}
+
+void AllocationTracker::setCallSitesEnabled(bool enabled)
+{
+#ifdef ALLOCATION_HAS_BACKTRACE
+    if (enabled) {
+        // 首次backtrace会加载展开库并申请内存，先在记录之外调用一次
+        void* frames[2];
+        backtrace(frames, 2);
+    }
+#endif
+    g_callSitesEnabled.store(enabled, std::memory_order_release);
+}
+
+void AllocationTracker::reset()
+{
+    for (int i = 0; i < MAX_SCOPES; i++) {
+        g_allocations[i].store(0, std::memory_order_relaxed);
+        g_bytes[i].store(0, std::memory_order_relaxed);
+    }
+    for (int i = 0; i < MAX_CALL_SITES; i++) {
+        g_callSites[i].ready.store(false, std::memory_order_relaxed);
+        g_callSites[i].allocations.store(0, std::memory_order_relaxed);
+        g_callSites[i].bytes.store(0, std::memory_order_relaxed);
+        g_callSites[i].hash.store(0, std::memory_order_release);
+    }
+    g_droppedCallSites.store(0, std::memory_order_relaxed);
+}
+
+AllocationTracker::ScopeCounts AllocationTracker::counts(int scope)
+{
+    ScopeCounts result;
+    if (scope >= 0 && scope < MAX_SCOPES) {
+        result.allocations = g_allocations[scope].load(std::memory_order_relaxed);
+        result.bytes = g_bytes[scope].load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+std::vector<AllocationTracker::CallSite> AllocationTracker::callSites()
+{
+    std::vector<CallSite> sites;
+    for (int i = 0; i < MAX_CALL_SITES; i++) {
+        const CallSiteSlot& slot = g_callSites[i];
+        if (!slot.ready.load(std::memory_order_acquire)) {
+            continue;
+        }
+        CallSite site;
+        site.allocations = slot.allocations.load(std::memory_order_relaxed);
+        site.bytes = slot.bytes.load(std::memory_order_relaxed);
+        site.scope = slot.scope;
+        site.depth = slot.depth;
+        for (int j = 0; j < STACK_DEPTH; j++) {
+            site.frames[j] = slot.frames[j];
+        }
+        sites.push_back(site);
+    }
+    std::sort(sites.begin(), sites.end(), [](const CallSite& a, const CallSite& b) {
+        return a.allocations > b.allocations;
+    });
+    return sites;
+}
+
+uint64_t AllocationTracker::droppedCallSites()
+{
+    return g_droppedCallSites.load(std::memory_order_relaxed);
+}
+
+std::string AllocationTracker::describeFrame(void* frame)
+{
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), "%p", frame);
+    std::string text = buffer;
+
+#ifdef ALLOCATION_HAS_BACKTRACE
+    // 返回地址指向调用指令之后，减1落在调用所在的行
+    Dl_info info;
+    if (frame && dladdr(static_cast<char*>(frame) - 1, &info)) {
+        if (info.dli_sname) {
+            int status = 0;
+            char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+            text = (status == 0 && demangled) ? demangled : info.dli_sname;
+            free(demangled);
+            snprintf(buffer, sizeof(buffer), "+0x%lx",
+                     static_cast<unsigned long>(static_cast<char*>(frame) - static_cast<char*>(info.dli_saddr)));
+            text += buffer;
+        }
+        if (info.dli_fname) {
+            const char* module = info.dli_fname;
+            const char* slash = strrchr(module, '/');
+            snprintf(buffer, sizeof(buffer), "+0x%lx)",
+                     static_cast<unsigned long>(static_cast<char*>(frame) - static_cast<char*>(info.dli_fbase) - 1));
+            text += std::string(" (") + (slash ? slash + 1 : module) + buffer;
+        }
+    }
+#endif
+    return text;
+}
+
+void AllocationTracker::recordAllocation(size_t bytes)
+{
+    if (t_inHook) {
+        return;
+    }
+    t_inHook = true;
+
+    int scope = currentScope();
+    g_allocations[scope].fetch_add(1, std::memory_order_relaxed);
+    g_bytes[scope].fetch_add(bytes, std::memory_order_relaxed);
+    if (g_callSitesEnabled.load(std::memory_order_acquire)) {
+        recordCallSite(bytes, scope, t_caller);
+    }
+
+    t_inHook = false;
+}
+
+// *** 替换全局operator new/delete ***
+
+void* operator new(std::size_t size)
+{
+    void* memory = trackedAllocate(size, ALLOCATION_CALLER());
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* memory = trackedAllocate(size, ALLOCATION_CALLER());
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return trackedAllocate(size, ALLOCATION_CALLER());
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return trackedAllocate(size, ALLOCATION_CALLER());
+}
+
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    free(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    free(memory);
+}
@@ -0,0 +1,112 @@
+#ifndef ALLOCATIONTRACKER_H
+#define ALLOCATIONTRACKER_H
+
+#include <string>
+#include <vector>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * 全局分配统计（测试与基准工具专用）
+ * 链接AllocationTracker.cpp即替换全局operator new/delete，模型代码无需改动；不链接时本类不可用。
+ * 每次分配按当前线程所在的作用域（可嵌套，记入最内层）累计次数与字节数，作用域0为未标注区域；
+ * 开启调用点记录后另取调用栈前几帧，按调用栈归并计数。记录过程不分配内存（调用点为定长表，
+ * 表满后新的调用点只计入溢出数），可在任意线程上进行
+ */
+class AllocationTracker
+{
+public:
+    static const int MAX_SCOPES = 16;       // 作用域数（含未标注区域0）
+    static const int STACK_DEPTH = 6;       // 每个调用点记录的栈帧数
+    static const int MAX_CALL_SITES = 512;  // 调用点表容量
+
+    /**
+     * 作用域计数
+     */
+    struct ScopeCounts
+    {
+        uint64_t allocations;
+        uint64_t bytes;
+
+        ScopeCounts() : allocations(0), bytes(0) {}
+    };
+
+    /**
+     * 调用点计数（frames[0]为调用operator new的位置）
+     */
+    struct CallSite
+    {
+        uint64_t allocations;
+        uint64_t bytes;
+        int scope;
+        int depth;
+        void* frames[STACK_DEPTH];
+
+        CallSite() : allocations(0), bytes(0), scope(0), depth(0)
+        {
+            for (int i = 0; i < STACK_DEPTH; i++) {
+                frames[i] = nullptr;
+            }
+        }
+    };
+
+    /**
+     * 作用域名称（name须为字面量或长期有效的字符串）
+     */
+    static void setScopeName(int scope, const char* name);
+    static const char* scopeName(int scope);
+
+    /**
+     * 当前线程进入/离开作用域（嵌套深度上限为8，超出部分记入外层）
+     */
+    static void enterScope(int scope);
+    static void leaveScope();
+
+    /**
+     * 开启/关闭调用点记录（开启时取调用栈，分配明显变慢）
+     */
+    static void setCallSitesEnabled(bool enabled);
+
+    /**
+     * 清零作用域计数与调用点表
+     */
+    static void reset();
+
+    static ScopeCounts counts(int scope);
+
+    /**
+     * 已记录的调用点（按分配次数降序）
+     */
+    static std::vector<CallSite> callSites();
+
+    /**
+     * 表满未能记录的分配次数
+     */
+    static uint64_t droppedCallSites();
+
+    /**
+     * 栈帧的可读形式：函数名+偏移（可解析时）与模块内偏移（供addr2line使用）
+     */
+    static std::string describeFrame(void* frame);
+
+    /**
+     * 记录一次分配（由替换的operator new调用）
+     */
+    static void recordAllocation(size_t bytes);
+
+    /**
+     * 作用域守卫
+     */
+    class Scope
+    {
+    public:
+        explicit Scope(int scope) { enterScope(scope); }
+        ~Scope() { leaveScope(); }
+
+    private:
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    };
+};
+
+#endif // ALLOCATIONTRACKER_H
@@ -0,0 +1,107 @@
+#ifndef DEVICEMODELTESTACCESS_H
+#define DEVICEMODELTESTACCESS_H
+
+#include "devicemodel.h"
+
+/**
+ * 测试工具访问DeviceModel内部计算函数的入口（DeviceModel的友元）
+ * 只做转发，不改变被调函数的行为；组件本身不使用
+ */
+class DeviceModelTestAccess
+{
+public:
+    static const int SPECTRUM_SIZE = DeviceModel::SPECTRUM_DATA_SIZE;
+    static const int MAX_TARGETS_PER_SONAR = DeviceModel::MAX_TARGETS_PER_SONAR;
+
+    typedef DeviceModel::TargetData TargetData;
+    typedef DeviceModel::MultiTargetSonarEquationCache EquationCache;
+
+    static double spectrumSumByFreqRange(DeviceModel& model, const SpectrumBuffer& spectrum, int sonarID)
+    {
+        return model.calculateSpectrumSumByFreqRange(spectrum, sonarID);
+    }
+
+    static double medianFrequencyFromSpectrum(DeviceModel& model, const SpectrumBuffer& spectrum, int sonarID)
+    {
+        return model.calculateMedianFrequencyFromSpectrum(spectrum, sonarID);
+    }
+
+    static double dynamicDI(DeviceModel& model, int sonarID, double dynamicFrequency)
+    {
+        return model.calculateDynamicDI(sonarID, dynamicFrequency);
+    }
+
+    static bool targetInSonarRange(DeviceModel& model, int sonarID, float targetBearing, float targetDistance,
+                                   float ownShipHeading)
+    {
+        return model.isTargetInSonarRange(sonarID, targetBearing, targetDistance, ownShipHeading);
+    }
+
+    static int spectrumIndexFromFrequency(DeviceModel& model, int frequencyHz)
+    {
+        return model.getSpectrumIndexFromFrequency(frequencyHz);
+    }
+
+    static bool sonarBandIndexRange(DeviceModel& model, int sonarID, int& startIndex, int& endIndex)
+    {
+        return model.getSonarBandIndexRange(sonarID, startIndex, endIndex);
+    }
+
+    static float bandPeakLevel(DeviceModel& model, const SpectrumBuffer& spectrum, int sonarID)
+    {
+        return model.calculateBandPeakLevel(spectrum, sonarID);
+    }
+
+    /**
+     * 参考路径：逐目标标量计算声纳方程
+     */
+    static double referenceEquation(DeviceModel& model, int sonarID, const TargetData& targetData,
+                                    const EquationCache& cache)
+    {
+        return model.calculateTargetSonarEquation(sonarID, targetData, cache);
+    }
+
+    /**
+     * 优化路径：组件实际使用的批量计算（按组件当前配置启用上界剪枝等），结果写入cache
+     */
+    static void evaluateEquations(DeviceModel& model, EquationCache& cache)
+    {
+        model.performMultiTargetSonarEquationCalculation(cache);
+    }
+
+    static double effectiveThreshold(const DeviceModel& model, int sonarID)
+    {
+        return model.getEffectiveThreshold(sonarID);
+    }
+
+    static double boundPruningMarginDb()
+    {
+        return DeviceModel::BOUND_PRUNING_MARGIN_DB;
+    }
+
+    /**
+     * 组件当前的方程缓存（严格步进模式下prepareStep之后为本步输入与结果）
+     */
+    static const EquationCache& equationCache(const DeviceModel& model)
+    {
+        return model.m_multiTargetCache;
+    }
+
+    /**
+     * 设置声纳阵列与被动功能的开关（未经init的组件默认全部关闭）
+     */
+    static void setSonarPassiveEnabled(DeviceModel& model, int sonarID, bool enabled)
+    {
+        CData_SonarState& state = model.m_sonarStates[sonarID];
+        state.sonarID = sonarID;
+        state.arrayWorkingState = enabled ? 1 : 0;
+        state.passiveWorkingState = enabled ? 1 : 0;
+    }
+
+    static void fillMockSpectrumData(DeviceModel& model, float* spectrumData, int targetId)
+    {
+        model.fillMockSpectrumData(spectrumData, targetId);
+    }
+};
+
+#endif // DEVICEMODELTESTACCESS_H
@@ -0,0 +1,95 @@
+#include "PerfCounters.h"
+
+#include <cstring>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef __linux__
+int openCounter(uint32_t type, uint64_t config)
+{
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.exclude_kernel = 1;    // perf_event_paranoid为2时只允许用户态计数
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+}
+#endif
+
+}
+
+PerfCounters::PerfCounters()
+    : m_multiplexed(false)
+{
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        m_fds[i] = -1;
+    }
+
+#ifdef __linux__
+    m_fds[CYCLES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+    m_fds[INSTRUCTIONS] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+    m_fds[L1D_MISSES] = openCounter(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D |
+                                    (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                    (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    m_fds[LLC_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    m_fds[BRANCH_MISSES] = openCounter(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        if (m_fds[i] >= 0) {
+            close(m_fds[i]);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::anyAvailable() const
+{
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        if (m_fds[i] >= 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+PerfCounters::Sample PerfCounters::read() const
+{
+    Sample sample;
+#ifdef __linux__
+    for (int i = 0; i < EVENT_COUNT; i++) {
+        // 读数格式：计数值、启用时间、实际计数时间
+        uint64_t values[3] = { 0, 0, 0 };
+        if (m_fds[i] < 0 || ::read(m_fds[i], values, sizeof(values)) != sizeof(values)) {
+            continue;
+        }
+        if (values[2] > 0 && values[2] < values[1]) {
+            m_multiplexed = true;
+            sample.values[i] = static_cast<uint64_t>(static_cast<double>(values[0]) * values[1] / values[2]);
+        } else {
+            sample.values[i] = values[0];
+        }
+    }
+#endif
+    return sample;
+}
+
+const char* PerfCounters::eventName(Event event)
+{
+    static const char* const names[EVENT_COUNT] = {
+        "cycles", "instructions", "l1dMisses", "llcMisses", "branchMisses"
+    };
+    return (event >= 0 && event < EVENT_COUNT) ? names[event] : "unknown";
+}
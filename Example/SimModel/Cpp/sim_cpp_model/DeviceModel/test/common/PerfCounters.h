@@ -0,0 +1,67 @@
+#ifndef PERFCOUNTERS_H
+#define PERFCOUNTERS_H
+
+#include <stdint.h>
+
+/**
+ * 当前线程的硬件性能计数（Linux perf_event_open，仅统计用户态）
+ * 各计数独立打开，内核不支持、权限不足或容器内不可用的计数标记为不可用，其余照常工作；
+ * 非Linux平台全部不可用。计数在构造时开始累计，两次read之差即区间计数。
+ * 同时打开的计数多于硬件计数器时内核分时复用，读数按实际计数时间占比折算为估计值
+ */
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        CYCLES = 0,         // CPU周期
+        INSTRUCTIONS,       // 退役指令数
+        L1D_MISSES,         // L1数据缓存读缺失
+        LLC_MISSES,         // 末级缓存缺失
+        BRANCH_MISSES,      // 分支预测失败
+        EVENT_COUNT
+    };
+
+    /**
+     * 一次读数（累计值）
+     */
+    struct Sample
+    {
+        uint64_t values[EVENT_COUNT];
+
+        Sample()
+        {
+            for (int i = 0; i < EVENT_COUNT; i++) {
+                values[i] = 0;
+            }
+        }
+    };
+
+    PerfCounters();
+    ~PerfCounters();
+
+    bool available(Event event) const { return m_fds[event] >= 0; }
+    bool anyAvailable() const;
+
+    /**
+     * 读取各计数的当前累计值（不可用的计数为0）
+     */
+    Sample read() const;
+
+    /**
+     * 是否有计数发生过分时复用（读数为折算值）
+     */
+    bool multiplexed() const { return m_multiplexed; }
+
+    static const char* eventName(Event event);
+
+private:
+    // 禁止拷贝和赋值
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    int m_fds[EVENT_COUNT];
+    mutable bool m_multiplexed;
+};
+
+#endif // PERFCOUNTERS_H
@@ -3,7 +3,39 @@ TEMPLATE = subdirs
 SUBDIRS += \
     DeviceModel \
     #DeviceModel/test/DeviceTestUnit \
-    DeviceModel/test/DeviceUiTestUnit
+    DeviceModel/test/DeviceUiTestUnit \
+    SyntheticLoad \
+    DeviceReplay \
+    DeviceEquivalence \
+    DeviceHeadlessEngine \
+    DeviceBenchmark \
+    DeviceKernelBench \
+    DeviceAllocCheck
+
+# 以下测试工具不依赖Qt，各自直接编入所需的组件源文件
+# 合成负载发生器静态库
+SyntheticLoad.subdir = DeviceModel/test/SyntheticLoad
+
+# 捕获回放工具
+DeviceReplay.subdir = DeviceModel/test/DeviceReplay
+
+# 差分对照工具：复用回放工具的回放代理并可读取其捕获文件，排在其后构建
+DeviceEquivalence.subdir = DeviceModel/test/DeviceEquivalence
+DeviceEquivalence.depends = DeviceReplay
+
+# 多平台无界面引擎
+DeviceHeadlessEngine.subdir = DeviceModel/test/DeviceHeadlessEngine
+
+# 压测驱动：场景由合成负载发生器生成
+DeviceBenchmark.subdir = DeviceModel/test/DeviceBenchmark
+DeviceBenchmark.depends = SyntheticLoad
+
+# 核心算子微基准
+DeviceKernelBench.subdir = DeviceModel/test/DeviceKernelBench
+
+# 稳态零分配检查：复用压测驱动的场景
+DeviceAllocCheck.subdir = DeviceModel/test/DeviceAllocCheck
+DeviceAllocCheck.depends = DeviceBenchmark
 
 CONFIG += qt
 
@@ -0,0 +1,88 @@
+#pragma once
+
+
+#include "CSimMessage.h"
+#include "CSimData.h"
+#include "CSubscribeSimData.h"
+#include "CSimModelAgentBase.h"
+
+#include <memory>
+
+
+/**
+* 模型代理扩展接口（可选）
+* 批量、过滤与借用载荷接口不加入CSimModelAgentBase：SimSdk以预编译库发布，基类追加虚函数会改变其虚表，
+* 按旧头文件编译的宿主没有对应的表项。支持扩展的宿主让代理类同时继承CSimModelAgentBase与本接口，
+* 模型通过querySimModelAgentExtension查询，取不到（旧宿主）时改用基类的逐个接口。
+* 本接口只有头文件，不依赖SimSdk的导出符号；此后新增接口时递增VERSION并追加在末尾，
+* 调用方先用extensionVersion()判断宿主实现到哪一版
+*/
+class CSimModelAgentExtension
+{
+public:
+    static const int32 VERSION = 1;
+
+    virtual ~CSimModelAgentExtension() {}
+
+    /**
+    * 宿主实现的扩展接口版本（实现本版接口的宿主返回VERSION）
+    */
+    virtual int32 extensionVersion() const = 0;
+
+    /**
+    * 获取载荷的共享引用（借用模式）
+    * 宿主管理该载荷时返回持有它的引用计数句柄，句柄释放前载荷保持有效且不被修改；
+    * 载荷不归宿主管理时返回空，调用方需自行拷贝
+    * @param data 消息/数据载荷指针（CSimMessage::data 或 CSimData::data）
+    */
+    virtual std::shared_ptr<const void> retainPayload(const void* data) = 0;
+
+    /**
+    * 批量获取已订阅的仿真数据
+    * @param topics 主题数组
+    * @param platformIds 平台ID数组
+    * @param results 输出数组，未找到的位置为nullptr
+    * @param count 数量
+    */
+    virtual void getSubscribeSimDataBatch(const char* const* topics, const int64* platformIds,
+                                          CSimData** results, int32 count) = 0;
+
+    /**
+    * 批量发送交互信息
+    * @param simMessages 消息数组
+    * @param count 数量
+    */
+    virtual void sendMessages(CSimMessage* const* simMessages, int32 count) = 0;
+
+    /**
+    * 批量发布数据信息
+    * @param simDatas 数据数组
+    * @param count 数量
+    */
+    virtual void publishSimDataBatch(CSimData* const* simDatas, int32 count) = 0;
+
+    /**
+    * 带过滤条件订阅事件类主题
+    * 重复调用同一主题时替换过滤条件，filter为空时取消过滤
+    * @param topic 消息主题
+    * @param filter 过滤描述，可为空
+    */
+    virtual void subscribeMessageFiltered(const char* topic, const CSubscribeFilter* filter) = 0;
+
+    /**
+    * 带过滤条件订阅数据类主题
+    * @param simDataSubscription 订阅数据
+    * @param filter 过滤描述，可为空
+    */
+    virtual void subscribeSimDataFiltered(CSubscribeSimData* simDataSubscription, const CSubscribeFilter* filter) = 0;
+};
+
+/**
+* 查询代理的扩展接口
+* @param agent 模型代理
+* @return 代理实现了扩展接口时返回该接口，否则（含旧宿主）返回nullptr
+*/
+inline CSimModelAgentExtension* querySimModelAgentExtension(CSimModelAgentBase* agent)
+{
+    return dynamic_cast<CSimModelAgentExtension*>(agent);
+}
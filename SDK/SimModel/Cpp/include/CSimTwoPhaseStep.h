@@ -0,0 +1,48 @@
+#pragma once
+
+
+#include "CSimTypes.h"
+#include "CSimComponentBase.h"
+
+
+/**
+* 两阶段步进接口（可选）
+* 不加入CSimComponentBase：SimSdk以预编译库发布，基类追加虚函数会改变其虚表，
+* 按旧头文件编译的模型没有对应的表项。支持两阶段步进的模型让组件类同时继承CSimComponentBase与本接口，
+* 宿主通过querySimTwoPhaseStep查询，取不到（旧模型）时按原方式串行调用step。
+* 本接口只有头文件，不依赖SimSdk的导出符号
+*/
+class CSimTwoPhaseStep
+{
+public:
+    virtual ~CSimTwoPhaseStep() {}
+
+    /**
+    * 是否支持两阶段步进（prepareStep可与其他组件并行执行）
+    * 返回false时宿主应串行调用prepareStep
+    */
+    virtual bool supportsTwoPhaseStep() const = 0;
+
+    /**
+    * 两阶段步进-准备阶段：只读取输入并计算，不发送消息、不发布数据
+    * curTime:当期仿真时间（ms）
+    * step:步长（ms）
+    */
+    virtual void prepareStep(int64 curTime, int32 step) = 0;
+
+    /**
+    * 两阶段步进-提交阶段：发送准备阶段产生的消息与数据
+    * 宿主在所有组件的准备阶段完成后按固定顺序串行调用
+    */
+    virtual void commitStep() = 0;
+};
+
+/**
+* 查询组件的两阶段步进接口
+* @param component 模型组件
+* @return 组件实现了两阶段步进接口时返回该接口，否则（含旧模型）返回nullptr
+*/
+inline CSimTwoPhaseStep* querySimTwoPhaseStep(CSimComponentBase* component)
+{
+    return dynamic_cast<CSimTwoPhaseStep*>(component);
+}
@@ -3,6 +3,8 @@
 
 #include "SimBasicTypes.h"
 
+#include <cmath>
+
 #define EventTypeLen (64)
 
 class CSubscribeSimData
@@ -14,3 +16,97 @@ public:
         int64 targetId;              // 目标id,目标平台id或者阵营id
 	char topic[EventTypeLen];	 // 主题
 };
+
+#define SUBSCRIBE_FILTER_MAX_SECTORS	(8)
+#define SUBSCRIBE_FILTER_MAX_PLATTYPES	(8)
+
+/**
+* 订阅过滤描述（可选）
+* 宿主据此在上游剔除接收方不关心的目标，各条件为“与”关系，未设置的条件不过滤；
+* 过滤只做保守剔除，接收方仍按自身规则做精确判断
+*/
+class CSubscribeFilter
+{
+public:
+    float maxRange;											// 最大距离（米），<=0不限
+    int32 sectorCount;										// 方位扇区数，0不限
+    float sectorStart[SUBSCRIBE_FILTER_MAX_SECTORS];		// 扇区起始方位（度），起始大于终止表示跨越±180°
+    float sectorEnd[SUBSCRIBE_FILTER_MAX_SECTORS];			// 扇区终止方位（度）
+    bool sectorRelativeToHeading;							// true：扇区相对本平台航向；false：大地方位
+    float sectorMargin;										// 扇区两侧放宽量（度），吸收航向更新的时差
+    int32 platTypeCount;									// 平台类型数，0不限
+    int32 platTypes[SUBSCRIBE_FILTER_MAX_PLATTYPES];		// 接收的平台类型
+
+    CSubscribeFilter() : maxRange(0.0f)
+        , sectorCount(0)
+        , sectorRelativeToHeading(true)
+        , sectorMargin(0.0f)
+        , platTypeCount(0)
+    {
+        for (int32 i = 0; i < SUBSCRIBE_FILTER_MAX_SECTORS; i++) {
+            sectorStart[i] = 0.0f;
+            sectorEnd[i] = 0.0f;
+        }
+        for (int32 i = 0; i < SUBSCRIBE_FILTER_MAX_PLATTYPES; i++) {
+            platTypes[i] = 0;
+        }
+    }
+
+    /**
+    * 判断目标是否通过过滤
+    * @param distance 目标距离（米）
+    * @param bearing 目标方位（度，大地方位）
+    * @param heading 本平台航向（度）
+    * @param headingKnown 航向是否可用，不可用时相对扇区条件不过滤
+    * @param platType 目标平台类型
+    */
+    bool accept(float distance, float bearing, float heading, bool headingKnown, int32 platType) const
+    {
+        // 距离或方位无效（NaN/无穷）的目标无法判断，一律剔除
+        if (!std::isfinite(distance) || !std::isfinite(bearing)) {
+            return false;
+        }
+        if (maxRange > 0.0f && distance > maxRange) {
+            return false;
+        }
+
+        if (platTypeCount > 0) {
+            bool typeMatched = false;
+            for (int32 i = 0; i < platTypeCount && i < SUBSCRIBE_FILTER_MAX_PLATTYPES; i++) {
+                if (platTypes[i] == platType) {
+                    typeMatched = true;
+                    break;
+                }
+            }
+            if (!typeMatched) {
+                return false;
+            }
+        }
+
+        if (sectorCount <= 0 || (sectorRelativeToHeading && (!headingKnown || !std::isfinite(heading)))) {
+            return true;
+        }
+
+        float angle = sectorRelativeToHeading ? bearing - heading : bearing;
+        for (int32 i = 0; i < sectorCount && i < SUBSCRIBE_FILTER_MAX_SECTORS; i++) {
+            // 以扇区起点为基准的顺时针偏移，与扇区跨度比较（自然处理跨越±180°的扇区）
+            float span = wrap360(sectorEnd[i] - sectorStart[i]) + 2.0f * sectorMargin;
+            if (span >= 360.0f || wrap360(angle - (sectorStart[i] - sectorMargin)) <= span) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+private:
+    // 角度归一化到[0, 360)，调用方保证angle有限
+    static float wrap360(float angle)
+    {
+        float wrapped = std::fmod(angle, 360.0f);
+        if (wrapped < 0.0f) {
+            wrapped += 360.0f;
+        }
+        // -1e-8等极小负值加360后舍入为360
+        return wrapped >= 360.0f ? 0.0f : wrapped;
+    }
+};